@@ -64,8 +64,7 @@ def dir(o):
     pPmObj_t po;
     pPmObj_t pk;
     pPmObj_t pl;
-    pSeglist_t psl;
-    int16_t i;
+    uint16_t index = 0;
     uint8_t objid;
 
     /* Use globals if no arg given */
@@ -126,11 +125,8 @@ def dir(o):
         PM_RETURN_IF_ERROR(retval);
 
         /* Copy dict's keys to the list */
-        psl = ((pPmDict_t)po)->d_keys;
-        for (i = 0; i < ((pPmDict_t)po)->length; i++)
+        while (dict_next(po, &index, &pk, C_NULL) == PM_RET_OK)
         {
-            retval = seglist_getItem(psl, i, &pk);
-            PM_RETURN_IF_ERROR(retval);
             heap_gcPushTempRoot(pl, &objid);
             retval = list_append(pl, pk);
             heap_gcPopTempRoot(objid);
@@ -253,8 +249,53 @@ def filter(f, s):
     return [x for x in s if f(x)]
 
 
+def frozenset(s):
+    """__NATIVE__ strviews
+    PmReturn_t retval = PM_RET_OK;
+#ifdef HAVE_SET
+    pPmObj_t pset;
+    uint8_t objid;
+
+    /* If wrong number of args, raise TypeError */
+    if (NATIVE_GET_NUM_ARGS() > 1)
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    /* A frozenset can not change, so it is returned as is */
+    if ((NATIVE_GET_NUM_ARGS() == 1)
+        && (OBJ_GET_TYPE(NATIVE_GET_LOCAL(0)) == OBJ_TYPE_SET)
+        && SET_IS_FROZEN(NATIVE_GET_LOCAL(0)))
+    {
+        NATIVE_SET_TOS(NATIVE_GET_LOCAL(0));
+        return retval;
+    }
+
+    retval = set_new(C_TRUE, &pset);
+    PM_RETURN_IF_ERROR(retval);
+
+    /* Add the items of the iterable, if one is given */
+    if (NATIVE_GET_NUM_ARGS() == 1)
+    {
+        heap_gcPushTempRoot(pset, &objid);
+        retval = set_update(pset, NATIVE_GET_LOCAL(0));
+        heap_gcPopTempRoot(objid);
+        PM_RETURN_IF_ERROR(retval);
+    }
+
+    NATIVE_SET_TOS(pset);
+    return retval;
+#else
+    PM_RAISE(retval, PM_RET_EX_SYS);
+    return retval;
+#endif /* HAVE_SET */
+    """
+    pass
+
+
 def globals():
-    """__NATIVE__
+    """__NATIVE__ noalloc
     pPmObj_t pr = C_NULL;
     PmReturn_t retval;
 
@@ -306,7 +347,7 @@ def id(o):
 
 
 def len(s):
-    """__NATIVE__
+    """__NATIVE__ strviews
     PmReturn_t retval;
     pPmObj_t ps = C_NULL;
     pPmObj_t pr = C_NULL;
@@ -322,7 +363,7 @@ def len(s):
     ps = NATIVE_GET_LOCAL(0);
 
 #ifdef HAVE_BYTEARRAY
-    /* If object is an instance, get the thing it contains */
+    /* If object is a bytearray or array instance, get the thing it contains */
     if (OBJ_GET_TYPE(ps) == OBJ_TYPE_CLI)
     {
         retval = dict_getItem((pPmObj_t)((pPmInstance_t)ps)->cli_attrs,
@@ -332,6 +373,15 @@ def len(s):
         /* If None wasn't in attributes, obj is wrong type for len() */
         if (retval == PM_RET_EX_KEY) retval = PM_RET_EX_TYPE;
         PM_RETURN_IF_ERROR(retval);
+        if ((OBJ_GET_TYPE(pr) != OBJ_TYPE_BYA)
+#ifdef HAVE_ARRAY
+            && (OBJ_GET_TYPE(pr) != OBJ_TYPE_BYS)
+#endif /* HAVE_ARRAY */
+           )
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
         ps = pr;
     }
 #endif /* HAVE_BYTEARRAY */
@@ -340,7 +390,8 @@ def len(s):
     switch (OBJ_GET_TYPE(ps))
     {
         case OBJ_TYPE_STR:
-            retval = int_new(((pPmString_t)ps)->length, &pr);
+        case OBJ_TYPE_SVW:
+            retval = int_new(STRING_GET_LENGTH(ps), &pr);
             break;
 
         case OBJ_TYPE_TUP:
@@ -355,12 +406,28 @@ def len(s):
             retval = int_new(((pPmDict_t)ps)->length, &pr);
             break;
 
+#ifdef HAVE_SET
+        case OBJ_TYPE_SET:
+            retval = int_new(SET_GET_LENGTH(ps), &pr);
+            break;
+#endif /* HAVE_SET */
+
+        case OBJ_TYPE_XRG:
+            retval = int_new(((pPmXrange_t)ps)->xr_length, &pr);
+            break;
+
 #ifdef HAVE_BYTEARRAY
         case OBJ_TYPE_BYA:
             retval = int_new(((pPmBytearray_t)ps)->length, &pr);
             break;
 #endif /* HAVE_BYTEARRAY */
 
+#ifdef HAVE_ARRAY
+        case OBJ_TYPE_BYS:
+            retval = int_new(ARRAY_GET_LENGTH(ps), &pr);
+            break;
+#endif /* HAVE_ARRAY */
+
         default:
             /* If not a string or sequence type, raise TypeError */
             PM_RAISE(retval, PM_RET_EX_TYPE);
@@ -542,6 +609,54 @@ def range(a, b, c):
     pass
 
 
+def set(s):
+    """__NATIVE__ strviews
+    PmReturn_t retval;
+#ifdef HAVE_SET
+    pPmObj_t pset;
+    uint8_t objid;
+
+    /* If wrong number of args, raise TypeError */
+    if (NATIVE_GET_NUM_ARGS() > 1)
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    retval = set_new(C_FALSE, &pset);
+    PM_RETURN_IF_ERROR(retval);
+
+    /* Add the items of the iterable, if one is given */
+    if (NATIVE_GET_NUM_ARGS() == 1)
+    {
+        heap_gcPushTempRoot(pset, &objid);
+        retval = set_update(pset, NATIVE_GET_LOCAL(0));
+        heap_gcPopTempRoot(objid);
+        PM_RETURN_IF_ERROR(retval);
+    }
+
+    NATIVE_SET_TOS(pset);
+    return retval;
+#else
+    PM_RAISE(retval, PM_RET_EX_SYS);
+    return retval;
+#endif /* HAVE_SET */
+    """
+    pass
+
+
+def sorted(s, key=None):
+    # Copy the items to a new list and sort it with the list module
+    import list
+    l = [None,] * len(s)
+    i = 0
+    for a in s:
+        l[i] = a
+        i += 1
+    list.sort(l, key)
+    return l
+
+
 def sum(s):
     """__NATIVE__
     pPmObj_t ps;
@@ -670,14 +785,56 @@ def type(o):
     pass
 
 
-# At this time, xrange() works in a for loop, but not in a generator expression
-# Yes: for i in xrange(42): pass
-# No:  [x for x in xrange(42)]
-#def xrange(n):
-#    i = 0
-#    while i < n:
-#        yield i
-#        i += 1
+#
+# Returns an xrange object; its ints are computed as they are needed
+#
+def xrange(a, b, c):
+    """__NATIVE__
+    PmReturn_t retval;
+    pPmObj_t pr = C_NULL;
+    int32_t start = 0;
+    int32_t stop;
+    int32_t step = 1;
+    uint8_t i;
+
+    /* If wrong number of args, raise TypeError */
+    if ((NATIVE_GET_NUM_ARGS() < 1) || (NATIVE_GET_NUM_ARGS() > 3))
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    /* Raise TypeError if any arg is not an int */
+    for (i = 0; i < NATIVE_GET_NUM_ARGS(); i++)
+    {
+        if (OBJ_GET_TYPE(NATIVE_GET_LOCAL(i)) != OBJ_TYPE_INT)
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+    }
+
+    /* xrange(stop), xrange(start, stop) or xrange(start, stop, step) */
+    if (NATIVE_GET_NUM_ARGS() == 1)
+    {
+        stop = ((pPmInt_t)NATIVE_GET_LOCAL(0))->val;
+    }
+    else
+    {
+        start = ((pPmInt_t)NATIVE_GET_LOCAL(0))->val;
+        stop = ((pPmInt_t)NATIVE_GET_LOCAL(1))->val;
+        if (NATIVE_GET_NUM_ARGS() == 3)
+        {
+            step = ((pPmInt_t)NATIVE_GET_LOCAL(2))->val;
+        }
+    }
+
+    /* xrange_new() raises ValueError if step is zero */
+    retval = xrange_new(start, stop, step, &pr);
+    NATIVE_SET_TOS(pr);
+    return retval;
+    """
+    pass
 
 
 #
@@ -740,8 +897,10 @@ AssertionError.code = 0xE4
 
 
 #
-# Generator class - used by the vm for generator-iterators,
-# generator-expressions and generator-coroutines
+# Generator class - holds the methods of the vm's generator-iterators,
+# generator-expressions and generator-coroutines.
+# Calling a generator function creates a generator object (OBJ_TYPE_GEN),
+# not an instance of this class; LOAD_ATTR finds its methods here.
 #
 # #207: Add support for the yield keyword
 #
@@ -749,71 +908,49 @@ AssertionError.code = 0xE4
 #
 class Generator(object):
 
-    def __init__(self, fa):
-        """__NATIVE__
+    def next(self,):
+        """__NATIVE__ noalloc
         PmReturn_t retval;
         pPmObj_t pself;
-        pPmObj_t pfa;
-        pPmObj_t pfunc;
-        pPmObj_t pframe;
-        uint8_t i;
-        uint8_t objid;
+        pPmFrame_t pgenframe;
 
         /* Raise TypeError if wrong number of args */
-        if (NATIVE_GET_NUM_ARGS() != 2)
+        if (NATIVE_GET_NUM_ARGS() != 1)
         {
             PM_RAISE(retval, PM_RET_EX_TYPE);
             return retval;
         }
 
-        /* Raise ValueError if first args are not: instance, tuple */
+        /* Raise ValueError if arg is not a generator */
         pself = NATIVE_GET_LOCAL(0);
-        pfa = NATIVE_GET_LOCAL(1);
-        if (OBJ_GET_TYPE(pself) != OBJ_TYPE_CLI)
-        {
-            PM_RAISE(retval, PM_RET_EX_VAL);
-            return retval;
-        }
-        if (OBJ_GET_TYPE(pfa) != OBJ_TYPE_TUP)
+        if (OBJ_GET_TYPE(pself) != OBJ_TYPE_GEN)
         {
             PM_RAISE(retval, PM_RET_EX_VAL);
             return retval;
         }
 
-        /* Create a new frame for the function */
-        pfunc = ((pPmTuple_t)pfa)->val[0];
-        retval = frame_new(pfunc, &pframe);
-        PM_RETURN_IF_ERROR(retval);
+        /* Push None onto generator's frame's stack */
+        pgenframe = ((pPmGenerator_t)pself)->g_frame;
+        *(pgenframe->fo_sp) = PM_NONE;
+        pgenframe->fo_sp++;
 
-        /* Copy args into frame's locals */
-        for (i = 0; i < ((pPmTuple_t)pfa)->length - 1; i++)
-        {
-            /* The pfa tuple is (func, [arg0, ... argN]) */
-            ((pPmFrame_t)pframe)->fo_locals[i] = ((pPmTuple_t)pfa)->val[i + 1];
-        }
+        /* Set generator's frame's fo_back so yielded value goes to caller */
+        pgenframe->fo_back = NATIVE_GET_PFRAME();
+        pgenframe->fo_isForIter = 0;
 
-        /* Store frame in None attr of instance */
-        heap_gcPushTempRoot(pframe, &objid);
-        retval = dict_setItem((pPmObj_t)((pPmInstance_t)pself)->cli_attrs,
-                              PM_NONE, pframe);
-        heap_gcPopTempRoot(objid);
+        /* Set active frame to run generator */
+        NATIVE_GET_PFRAME() = pgenframe;
 
-        NATIVE_SET_TOS(PM_NONE);
-        return retval;
+        return PM_RET_FRAME_SWITCH;
         """
         pass
 
 
-    def next(self,):
-        return self.send(None)
-
-
     def send(self, arg):
-        """__NATIVE__
+        """__NATIVE__ noalloc
         PmReturn_t retval;
         pPmObj_t pself;
-        pPmObj_t parg;
-        pPmObj_t pgenframe;
+        pPmFrame_t pgenframe;
 
         /* Raise TypeError if wrong number of args */
         if (NATIVE_GET_NUM_ARGS() != 2)
@@ -822,29 +959,25 @@ class Generator(object):
             return retval;
         }
 
-        /* Raise ValueError if first arg is not an instance */
+        /* Raise ValueError if first arg is not a generator */
         pself = NATIVE_GET_LOCAL(0);
-        parg = NATIVE_GET_LOCAL(1);
-        if (OBJ_GET_TYPE(pself) != OBJ_TYPE_CLI)
+        if (OBJ_GET_TYPE(pself) != OBJ_TYPE_GEN)
         {
             PM_RAISE(retval, PM_RET_EX_VAL);
             return retval;
         }
 
-        /* Get the generator's frame */
-        retval = dict_getItem((pPmObj_t)((pPmInstance_t)pself)->cli_attrs,
-                              PM_NONE, &pgenframe);
-        PM_RETURN_IF_ERROR(retval);
-
         /* Push argument onto generator's frame's stack */
-        *(((pPmFrame_t)pgenframe)->fo_sp) = parg;
-        ((pPmFrame_t)pgenframe)->fo_sp++;
+        pgenframe = ((pPmGenerator_t)pself)->g_frame;
+        *(pgenframe->fo_sp) = NATIVE_GET_LOCAL(1);
+        pgenframe->fo_sp++;
 
         /* Set generator's frame's fo_back so yielded value goes to caller */
-        ((pPmFrame_t)pgenframe)->fo_back = NATIVE_GET_PFRAME();
+        pgenframe->fo_back = NATIVE_GET_PFRAME();
+        pgenframe->fo_isForIter = 0;
 
         /* Set active frame to run generator */
-        NATIVE_GET_PFRAME() = (pPmFrame_t)pgenframe;
+        NATIVE_GET_PFRAME() = pgenframe;
 
         return PM_RET_FRAME_SWITCH;
         """
@@ -910,7 +1043,7 @@ class Generator(object):
 # Returns True if called within a module being run as the main; False otherwise
 #
 def ismain():
-    """__NATIVE__
+    """__NATIVE__ noalloc
 
     NATIVE_SET_TOS((NATIVE_GET_PFRAME()->fo_isImport) ? PM_FALSE : PM_TRUE);
 
@@ -919,51 +1052,170 @@ def ismain():
     pass
 
 
-#ifdef HAVE_BYTEARRAY
-#class bytearray(object):
-#    def __init__(self, o):
-#        """__NATIVE__
-#        PmReturn_t retval;
-#        pPmObj_t pself;
-#        pPmObj_t po;
-#        pPmObj_t pba;
-#        uint8_t objid;
-#
-#        /* If only the self arg, create zero-length bytearray */
-#        if (NATIVE_GET_NUM_ARGS() == 1)
-#        {
-#            po = PM_ZERO;
-#        }
-#
-#        /* If two args, get the second arg */
-#        else if (NATIVE_GET_NUM_ARGS() == 2)
-#        {
-#            po = NATIVE_GET_LOCAL(1);
-#        }
 #
-#        /* Raise TypeError if wrong number of args */
-#        else
-#        {
-#            PM_RAISE(retval, PM_RET_EX_TYPE);
-#            return retval;
-#        }
-#        pself = NATIVE_GET_LOCAL(0);
+# Bytearray class - holds the bytes (OBJ_TYPE_BYA) in its None attribute.
+# Without HAVE_BYTEARRAY, its methods raise SystemError.
 #
-#        /* Create new bytearray object */
-#        retval = bytearray_new(po, &pba);
-#        PM_RETURN_IF_ERROR(retval);
+# #289: Create bytearray datatype
 #
-#        /* Store bytearray in None attr of instance */
-#        heap_gcPushTempRoot(pba, &objid);
-#        retval = dict_setItem((pPmObj_t)((pPmInstance_t)pself)->cli_attrs,
-#                              PM_NONE, pba);
-#        heap_gcPopTempRoot(objid);
-#
-#        NATIVE_SET_TOS(PM_NONE);
-#        return retval;
-#        """
-#        pass
+class bytearray(object):
+    def __init__(self, o):
+        """__NATIVE__
+        PmReturn_t retval;
+#ifdef HAVE_BYTEARRAY
+        pPmObj_t pself;
+        pPmObj_t po;
+        pPmObj_t pba;
+        uint8_t objid;
+
+        /* If only the self arg, create zero-length bytearray */
+        if (NATIVE_GET_NUM_ARGS() == 1)
+        {
+            po = PM_ZERO;
+        }
+
+        /* If two args, get the second arg */
+        else if (NATIVE_GET_NUM_ARGS() == 2)
+        {
+            po = NATIVE_GET_LOCAL(1);
+        }
+
+        /* Raise TypeError if wrong number of args */
+        else
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+        pself = NATIVE_GET_LOCAL(0);
+
+        /* Create new bytearray object */
+        retval = bytearray_new(po, &pba);
+        PM_RETURN_IF_ERROR(retval);
+
+        /* Store bytearray in None attr of instance */
+        heap_gcPushTempRoot(pba, &objid);
+        retval = dict_setItem((pPmObj_t)((pPmInstance_t)pself)->cli_attrs,
+                              PM_NONE, pba);
+        heap_gcPopTempRoot(objid);
+
+        NATIVE_SET_TOS(PM_NONE);
+        return retval;
+#else
+        PM_RAISE(retval, PM_RET_EX_SYS);
+        return retval;
 #endif /* HAVE_BYTEARRAY */
+        """
+        pass
+
+    def extend(self, o):
+        """__NATIVE__
+        PmReturn_t retval;
+#ifdef HAVE_BYTEARRAY
+        pPmObj_t pba;
+
+        /* Raise TypeError if wrong number of args */
+        if (NATIVE_GET_NUM_ARGS() != 2)
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+
+        retval = bytearray_unwrap(NATIVE_GET_LOCAL(0), &pba);
+        PM_RETURN_IF_ERROR(retval);
+
+        /* Append the bytes of the bytearray, string, list or tuple */
+        retval = bytearray_extend(pba, NATIVE_GET_LOCAL(1));
+
+        NATIVE_SET_TOS(PM_NONE);
+        return retval;
+#else
+        PM_RAISE(retval, PM_RET_EX_SYS);
+        return retval;
+#endif /* HAVE_BYTEARRAY */
+        """
+        pass
+
+    def fill(self, v, start, end):
+        """__NATIVE__
+        PmReturn_t retval;
+#ifdef HAVE_BYTEARRAY
+        pPmObj_t pba;
+        pPmObj_t pstart = PM_ZERO;
+        pPmObj_t pend = PM_NONE;
+
+        /* Raise TypeError if wrong number of args */
+        if ((NATIVE_GET_NUM_ARGS() < 2) || (NATIVE_GET_NUM_ARGS() > 4))
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+
+        retval = bytearray_unwrap(NATIVE_GET_LOCAL(0), &pba);
+        PM_RETURN_IF_ERROR(retval);
+
+        /* Fill all of the bytearray unless a start (and end) is given */
+        if (NATIVE_GET_NUM_ARGS() > 2)
+        {
+            pstart = NATIVE_GET_LOCAL(2);
+        }
+        if (NATIVE_GET_NUM_ARGS() > 3)
+        {
+            pend = NATIVE_GET_LOCAL(3);
+        }
+        retval = bytearray_fill(pba, NATIVE_GET_LOCAL(1), pstart, pend);
+
+        NATIVE_SET_TOS(PM_NONE);
+        return retval;
+#else
+        PM_RAISE(retval, PM_RET_EX_SYS);
+        return retval;
+#endif /* HAVE_BYTEARRAY */
+        """
+        pass
+
+    def find(self, sub, start):
+        """__NATIVE__
+        PmReturn_t retval;
+#ifdef HAVE_BYTEARRAY
+        pPmObj_t pba;
+        pPmObj_t pn;
+        int16_t start = 0;
+        int16_t index;
+
+        /* Raise TypeError if wrong number of args */
+        if ((NATIVE_GET_NUM_ARGS() < 2) || (NATIVE_GET_NUM_ARGS() > 3))
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+
+        retval = bytearray_unwrap(NATIVE_GET_LOCAL(0), &pba);
+        PM_RETURN_IF_ERROR(retval);
+
+        /* Look from the start unless a start index is given */
+        if (NATIVE_GET_NUM_ARGS() == 3)
+        {
+            pn = NATIVE_GET_LOCAL(2);
+            if (OBJ_GET_TYPE(pn) != OBJ_TYPE_INT)
+            {
+                PM_RAISE(retval, PM_RET_EX_TYPE);
+                return retval;
+            }
+            start = (int16_t)((pPmInt_t)pn)->val;
+        }
+
+        retval = bytearray_find(pba, NATIVE_GET_LOCAL(1), start, &index);
+        PM_RETURN_IF_ERROR(retval);
+
+        retval = int_new(index, &pn);
+        NATIVE_SET_TOS(pn);
+        return retval;
+#else
+        PM_RAISE(retval, PM_RET_EX_SYS);
+        return retval;
+#endif /* HAVE_BYTEARRAY */
+        """
+        pass
 
 
 # #178 Fix import so modules are reused
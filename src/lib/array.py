@@ -0,0 +1,395 @@
+# This file is Copyright 2013 Dean Hall.
+# This file is part of the Python-on-a-Chip libraries.
+# This software is licensed under the MIT License.
+# See the LICENSE file for details.
+
+## @file
+#  @copybrief array
+
+## @package array
+#  @brief Provides PyMite's array module.
+#
+# An array holds ints or floats of one C type, unboxed and side by side,
+# where a list holds a pointer to a separate object for each item.
+# Typecodes are 'b' (int8), 'h' (int16), 'i' (int32) and 'f' (float32).
+#
+# Notes:
+# - len(a), a[i] and a[i] = v work; a value that does not fit
+#   the type raises OverflowError.  Use tolist() to iterate.
+# - Int results (sum, dot, scale, add, mul) wrap as C ints do.
+# - An array holds at most about 2 KB of items.
+# - Built only with HAVE_ARRAY, which needs HAVE_BYTEARRAY.
+
+
+"""__NATIVE__
+/* Stores the array in the None attr of a new instance of the class */
+static PmReturn_t
+_array_wrap(pPmObj_t pclass, pPmObj_t parr, pPmObj_t *r_pobj)
+{
+    PmReturn_t retval;
+    pPmObj_t pcli;
+    uint8_t objid;
+    uint8_t objid2;
+
+    heap_gcPushTempRoot(parr, &objid);
+    retval = class_instantiate(pclass, &pcli);
+    if (retval == PM_RET_OK)
+    {
+        heap_gcPushTempRoot(pcli, &objid2);
+        retval = dict_setItem((pPmObj_t)((pPmInstance_t)pcli)->cli_attrs,
+                              PM_NONE, parr);
+    }
+    heap_gcPopTempRoot(objid);
+    PM_RETURN_IF_ERROR(retval);
+
+    *r_pobj = pcli;
+    return retval;
+}
+"""
+
+
+__name__ = "array"
+
+
+class array(object):
+
+    def __init__(self, typecode, init):
+        """__NATIVE__ strviews
+        PmReturn_t retval;
+        pPmObj_t pself;
+        pPmObj_t ptc;
+        pPmObj_t pinit;
+        pPmObj_t parr;
+        pPmObj_t pitem;
+        uint16_t length;
+        uint16_t i;
+        uint8_t objid;
+        uint8_t objid2;
+
+        /* Raise TypeError if wrong number of args or typecode is not a str */
+        pself = NATIVE_GET_LOCAL(0);
+        ptc = NATIVE_GET_LOCAL(1);
+        pinit = NATIVE_GET_LOCAL(2);
+        if ((NATIVE_GET_NUM_ARGS() != 3) || (OBJ_GET_TYPE(pself) != OBJ_TYPE_CLI)
+            || !STRING_IS_STRING(ptc) || (STRING_GET_LENGTH(ptc) != 1))
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+
+        /* An int is the number of zeros, else copy a sequence (or array) */
+        if (OBJ_GET_TYPE(pinit) == OBJ_TYPE_INT)
+        {
+            if (((pPmInt_t)pinit)->val < 0)
+            {
+                PM_RAISE(retval, PM_RET_EX_VAL);
+                return retval;
+            }
+            if (((pPmInt_t)pinit)->val > 0xFFFF)
+            {
+                PM_RAISE(retval, PM_RET_EX_MEM);
+                return retval;
+            }
+            length = (uint16_t)((pPmInt_t)pinit)->val;
+            pinit = C_NULL;
+        }
+        else
+        {
+            if (OBJ_GET_TYPE(pinit) == OBJ_TYPE_CLI)
+            {
+                retval = array_unwrap(pinit, &pinit);
+                PM_RETURN_IF_ERROR(retval);
+            }
+            retval = seq_getLength(pinit, &length);
+            PM_RETURN_IF_ERROR(retval);
+        }
+
+        /* Raises ValueError if the typecode is unknown */
+        retval = array_new(STRING_GET_VAL(ptc)[0], length, &parr);
+        PM_RETURN_IF_ERROR(retval);
+
+        heap_gcPushTempRoot(parr, &objid);
+        for (i = 0; (pinit != C_NULL) && (i < length); i++)
+        {
+            retval = seq_getSubscript(pinit, (int16_t)i, &pitem);
+            PM_BREAK_IF_ERROR(retval);
+            heap_gcPushTempRoot(pitem, &objid2);
+            retval = array_setItem(parr, (int16_t)i, pitem);
+            heap_gcPopTempRoot(objid2);
+            PM_BREAK_IF_ERROR(retval);
+        }
+        if (retval == PM_RET_OK)
+        {
+            retval = dict_setItem((pPmObj_t)((pPmInstance_t)pself)->cli_attrs,
+                                  PM_NONE, parr);
+        }
+        heap_gcPopTempRoot(objid);
+
+        NATIVE_SET_TOS(PM_NONE);
+        return retval;
+        """
+        pass
+
+
+    def tolist(self,):
+        """__NATIVE__
+        PmReturn_t retval;
+        pPmObj_t parr;
+        pPmObj_t plist;
+        pPmObj_t pitem;
+        uint16_t i;
+        uint8_t objid;
+        uint8_t objid2;
+
+        /* Raise TypeError if wrong number of args or self holds no array */
+        if (NATIVE_GET_NUM_ARGS() != 1)
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+        retval = array_unwrap(NATIVE_GET_LOCAL(0), &parr);
+        PM_RETURN_IF_ERROR(retval);
+
+        retval = list_new(&plist);
+        PM_RETURN_IF_ERROR(retval);
+        heap_gcPushTempRoot(plist, &objid);
+        for (i = 0; i < ARRAY_GET_LENGTH(parr); i++)
+        {
+            retval = array_getItem(parr, (int16_t)i, &pitem);
+            PM_BREAK_IF_ERROR(retval);
+            heap_gcPushTempRoot(pitem, &objid2);
+            retval = list_append(plist, pitem);
+            heap_gcPopTempRoot(objid2);
+            PM_BREAK_IF_ERROR(retval);
+        }
+        heap_gcPopTempRoot(objid);
+        PM_RETURN_IF_ERROR(retval);
+
+        NATIVE_SET_TOS(plist);
+        return retval;
+        """
+        pass
+
+
+    def sum(self,):
+        """__NATIVE__
+        PmReturn_t retval;
+        pPmObj_t parr;
+        pPmObj_t pr;
+
+        /* Raise TypeError if wrong number of args or self holds no array */
+        if (NATIVE_GET_NUM_ARGS() != 1)
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+        retval = array_unwrap(NATIVE_GET_LOCAL(0), &parr);
+        PM_RETURN_IF_ERROR(retval);
+
+        retval = array_sum(parr, &pr);
+        PM_RETURN_IF_ERROR(retval);
+
+        NATIVE_SET_TOS(pr);
+        return retval;
+        """
+        pass
+
+
+    def min(self,):
+        """__NATIVE__
+        PmReturn_t retval;
+        pPmObj_t parr;
+        pPmObj_t pr;
+
+        /* Raise TypeError if wrong number of args or self holds no array */
+        if (NATIVE_GET_NUM_ARGS() != 1)
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+        retval = array_unwrap(NATIVE_GET_LOCAL(0), &parr);
+        PM_RETURN_IF_ERROR(retval);
+
+        /* Raises ValueError if the array is empty */
+        retval = array_minMax(parr, C_FALSE, &pr);
+        PM_RETURN_IF_ERROR(retval);
+
+        NATIVE_SET_TOS(pr);
+        return retval;
+        """
+        pass
+
+
+    def max(self,):
+        """__NATIVE__
+        PmReturn_t retval;
+        pPmObj_t parr;
+        pPmObj_t pr;
+
+        /* Raise TypeError if wrong number of args or self holds no array */
+        if (NATIVE_GET_NUM_ARGS() != 1)
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+        retval = array_unwrap(NATIVE_GET_LOCAL(0), &parr);
+        PM_RETURN_IF_ERROR(retval);
+
+        /* Raises ValueError if the array is empty */
+        retval = array_minMax(parr, C_TRUE, &pr);
+        PM_RETURN_IF_ERROR(retval);
+
+        NATIVE_SET_TOS(pr);
+        return retval;
+        """
+        pass
+
+
+    def dot(self, other):
+        """__NATIVE__
+        PmReturn_t retval;
+        pPmObj_t parr1;
+        pPmObj_t parr2;
+        pPmObj_t pr;
+
+        /* Raise TypeError if wrong number of args or either holds no array */
+        if (NATIVE_GET_NUM_ARGS() != 2)
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+        retval = array_unwrap(NATIVE_GET_LOCAL(0), &parr1);
+        PM_RETURN_IF_ERROR(retval);
+        retval = array_unwrap(NATIVE_GET_LOCAL(1), &parr2);
+        PM_RETURN_IF_ERROR(retval);
+
+        retval = array_dot(parr1, parr2, &pr);
+        PM_RETURN_IF_ERROR(retval);
+
+        NATIVE_SET_TOS(pr);
+        return retval;
+        """
+        pass
+
+
+    def scale(self, mul, offset=0):
+        """__NATIVE__
+        PmReturn_t retval;
+        pPmObj_t parr;
+
+        /* Raise TypeError if wrong number of args or self holds no array */
+        if ((NATIVE_GET_NUM_ARGS() < 2) || (NATIVE_GET_NUM_ARGS() > 3))
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+        retval = array_unwrap(NATIVE_GET_LOCAL(0), &parr);
+        PM_RETURN_IF_ERROR(retval);
+
+        retval = array_scale(parr, NATIVE_GET_LOCAL(1),
+                             (NATIVE_GET_NUM_ARGS() == 3)
+                             ? NATIVE_GET_LOCAL(2) : PM_ZERO);
+        PM_RETURN_IF_ERROR(retval);
+
+        NATIVE_SET_TOS(PM_NONE);
+        return retval;
+        """
+        pass
+
+
+    def add(self, other):
+        """__NATIVE__
+        PmReturn_t retval;
+        pPmObj_t parr1;
+        pPmObj_t parr2;
+
+        /* Raise TypeError if wrong number of args or either holds no array */
+        if (NATIVE_GET_NUM_ARGS() != 2)
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+        retval = array_unwrap(NATIVE_GET_LOCAL(0), &parr1);
+        PM_RETURN_IF_ERROR(retval);
+        retval = array_unwrap(NATIVE_GET_LOCAL(1), &parr2);
+        PM_RETURN_IF_ERROR(retval);
+
+        retval = array_op(parr1, parr2, '+');
+        PM_RETURN_IF_ERROR(retval);
+
+        NATIVE_SET_TOS(PM_NONE);
+        return retval;
+        """
+        pass
+
+
+    def mul(self, other):
+        """__NATIVE__
+        PmReturn_t retval;
+        pPmObj_t parr1;
+        pPmObj_t parr2;
+
+        /* Raise TypeError if wrong number of args or either holds no array */
+        if (NATIVE_GET_NUM_ARGS() != 2)
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+        retval = array_unwrap(NATIVE_GET_LOCAL(0), &parr1);
+        PM_RETURN_IF_ERROR(retval);
+        retval = array_unwrap(NATIVE_GET_LOCAL(1), &parr2);
+        PM_RETURN_IF_ERROR(retval);
+
+        retval = array_op(parr1, parr2, '*');
+        PM_RETURN_IF_ERROR(retval);
+
+        NATIVE_SET_TOS(PM_NONE);
+        return retval;
+        """
+        pass
+
+
+    def movingAverage(self, n):
+        """__NATIVE__
+        PmReturn_t retval;
+        pPmObj_t pself;
+        pPmObj_t pn;
+        pPmObj_t parr;
+        pPmObj_t pnew;
+        pPmObj_t pr;
+
+        /* Raise TypeError if wrong number of args or n is not an int */
+        pself = NATIVE_GET_LOCAL(0);
+        pn = NATIVE_GET_LOCAL(1);
+        if ((NATIVE_GET_NUM_ARGS() != 2) || (OBJ_GET_TYPE(pn) != OBJ_TYPE_INT))
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+        retval = array_unwrap(pself, &parr);
+        PM_RETURN_IF_ERROR(retval);
+
+        /* Raise ValueError if n is not in 1..len(self) */
+        if ((((pPmInt_t)pn)->val < 1)
+            || (((pPmInt_t)pn)->val > ARRAY_GET_LENGTH(parr)))
+        {
+            PM_RAISE(retval, PM_RET_EX_VAL);
+            return retval;
+        }
+
+        retval = array_movingAverage(parr, (uint16_t)((pPmInt_t)pn)->val,
+                                     &pnew);
+        PM_RETURN_IF_ERROR(retval);
+
+        /* The means are an array of the same class as self */
+        retval = _array_wrap((pPmObj_t)((pPmInstance_t)pself)->cli_class,
+                             pnew, &pr);
+        PM_RETURN_IF_ERROR(retval);
+
+        NATIVE_SET_TOS(pr);
+        return retval;
+        """
+        pass
+
+
+# :mode=c:
@@ -8,6 +8,12 @@
 
 ## @package dict
 #  @brief Provides PyMite's dict module.
+#
+# Notes:
+# - iterkeys(), itervalues() and iteritems() walk the dict without copying
+#   it; changing the dict's length during the loop raises RuntimeError.
+#   The iterators work in for loops, but have no next() method.
+
 
 __name__ = "dict"
 
@@ -25,6 +31,15 @@ class _Autobox:
     def values(self):
         return values(self.obj)
 
+    def iteritems(self):
+        return iteritems(self.obj)
+
+    def iterkeys(self):
+        return iterkeys(self.obj)
+
+    def itervalues(self):
+        return itervalues(self.obj)
+
 
 def clear(d):
     """__NATIVE__
@@ -55,8 +70,7 @@ def keys(d):
     pPmObj_t pd;
     pPmObj_t pl;
     pPmObj_t pk;
-    pSeglist_t psl;
-    uint16_t i;
+    uint16_t index = 0;
     PmReturn_t retval = PM_RET_OK;
     uint8_t objid;
 
@@ -72,13 +86,10 @@ def keys(d):
     retval = list_new(&pl);
     PM_RETURN_IF_ERROR(retval);
 
-    /* Iterate through the keys seglist */
-    psl = ((pPmDict_t)pd)->d_keys;
-    for (i = 0; i < ((pPmDict_t)pd)->length; i++)
+    /* Iterate through the dict's keys */
+    while (dict_next(pd, &index, &pk, C_NULL) == PM_RET_OK)
     {
-        /* Get the key and append it to the list */
-        retval = seglist_getItem(psl, i, &pk);
-        PM_RETURN_IF_ERROR(retval);
+        /* Append the key to the list */
         heap_gcPushTempRoot(pl, &objid);
         retval = list_append(pl, pk);
         heap_gcPopTempRoot(objid);
@@ -101,9 +112,9 @@ def values(d):
     """__NATIVE__
     pPmObj_t pd;
     pPmObj_t pl;
+    pPmObj_t pk;
     pPmObj_t pv;
-    pSeglist_t psl;
-    uint16_t i;
+    uint16_t index = 0;
     PmReturn_t retval = PM_RET_OK;
     uint8_t objid;
 
@@ -119,13 +130,10 @@ def values(d):
     retval = list_new(&pl);
     PM_RETURN_IF_ERROR(retval);
 
-    /* Iterate through the values seglist */
-    psl = ((pPmDict_t)pd)->d_vals;
-    for (i = 0; i < ((pPmDict_t)pd)->length; i++)
+    /* Iterate through the dict's values */
+    while (dict_next(pd, &index, &pk, &pv) == PM_RET_OK)
     {
-        /* Get the value and append it to the list */
-        retval = seglist_getItem(psl, i, &pv);
-        PM_RETURN_IF_ERROR(retval);
+        /* Append the value to the list */
         heap_gcPushTempRoot(pl, &objid);
         retval = list_append(pl, pv);
         heap_gcPopTempRoot(objid);
@@ -140,6 +148,72 @@ def values(d):
     pass
 
 
+def iteritems(d):
+    """__NATIVE__
+    pPmObj_t pi;
+    PmReturn_t retval;
+
+    /* Raise TypeError if wrong number of args */
+    if (NATIVE_GET_NUM_ARGS() != 1)
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    /* Make an iterator over the (key, value) pairs in place; raises TypeError if not a dict */
+    retval = seqiter_newDict(NATIVE_GET_LOCAL(0), SEQITER_ITEMS, &pi);
+    PM_RETURN_IF_ERROR(retval);
+
+    NATIVE_SET_TOS(pi);
+    return retval;
+    """
+    pass
+
+
+def iterkeys(d):
+    """__NATIVE__
+    pPmObj_t pi;
+    PmReturn_t retval;
+
+    /* Raise TypeError if wrong number of args */
+    if (NATIVE_GET_NUM_ARGS() != 1)
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    /* Make an iterator over the keys in place; raises TypeError if not a dict */
+    retval = seqiter_newDict(NATIVE_GET_LOCAL(0), SEQITER_KEYS, &pi);
+    PM_RETURN_IF_ERROR(retval);
+
+    NATIVE_SET_TOS(pi);
+    return retval;
+    """
+    pass
+
+
+def itervalues(d):
+    """__NATIVE__
+    pPmObj_t pi;
+    PmReturn_t retval;
+
+    /* Raise TypeError if wrong number of args */
+    if (NATIVE_GET_NUM_ARGS() != 1)
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    /* Make an iterator over the values in place; raises TypeError if not a dict */
+    retval = seqiter_newDict(NATIVE_GET_LOCAL(0), SEQITER_VALUES, &pi);
+    PM_RETURN_IF_ERROR(retval);
+
+    NATIVE_SET_TOS(pi);
+    return retval;
+    """
+    pass
+
+
 def update(d1, d2):
     # Updates dict d1 with the contents of d2.  Returns None
     """__NATIVE__
@@ -26,6 +26,13 @@ def co_names(f):
     }
 
     pfunc = NATIVE_GET_LOCAL(0);
+
+    /* A func that was never called may not have loaded its code obj yet */
+    if (OBJ_GET_TYPE(((pPmFunc_t)pfunc)->f_co) == OBJ_TYPE_COB)
+    {
+        retval = co_resolve(((pPmFunc_t)pfunc)->f_co);
+        PM_RETURN_IF_ERROR(retval);
+    }
     NATIVE_SET_TOS((pPmObj_t)((pPmFunc_t)pfunc)->f_co->co_names);
 
     return retval;
@@ -49,6 +56,13 @@ def co_consts(f):
     }
 
     pfunc = NATIVE_GET_LOCAL(0);
+
+    /* A func that was never called may not have loaded its code obj yet */
+    if (OBJ_GET_TYPE(((pPmFunc_t)pfunc)->f_co) == OBJ_TYPE_COB)
+    {
+        retval = co_resolve(((pPmFunc_t)pfunc)->f_co);
+        PM_RETURN_IF_ERROR(retval);
+    }
     NATIVE_SET_TOS((pPmObj_t)((pPmFunc_t)pfunc)->f_co->co_consts);
 
     return retval;
@@ -11,6 +11,7 @@
 #
 # Notes:
 # - index(l, o) does not offer start and stop arguments.
+# - sort(l, key) does not offer cmp and reverse arguments.
 
 
 __name__ = "list"
@@ -40,6 +41,9 @@ class _Autobox:
     def remove(self, v):
         return remove(self.obj, v)
 
+    def sort(self, key=None):
+        return sort(self.obj, key)
+
 
 def append(l, o):
     """__NATIVE__
@@ -234,11 +238,59 @@ def remove(l, v):
     pass
 
 
+def sort(l, key=None):
+    # Call the key function here, in the interpreter, once per item.
+    # The list of keys is held by this frame, so the GC keeps it.
+    if key == None:
+        return _sort(l, None)
+    return _sort(l, map(key, l))
+
+
+def _sort(l, keys):
+    """__NATIVE__
+    pPmObj_t pl;
+    pPmObj_t pkeys;
+    PmReturn_t retval = PM_RET_OK;
+
+    /* Raise TypeError if it's not a list or wrong number of args */
+    pl = NATIVE_GET_LOCAL(0);
+    if ((OBJ_GET_TYPE(pl) != OBJ_TYPE_LST) || (NATIVE_GET_NUM_ARGS() != 2))
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    /* Sort by the keys, or by the items if there are no keys */
+    pkeys = NATIVE_GET_LOCAL(1);
+    if (pkeys == PM_NONE)
+    {
+        pkeys = C_NULL;
+    }
+    retval = list_sort(pl, pkeys);
+
+#ifdef HAVE_GC
+    /*
+     * A native does not run the GC when the heap is full, so the sort's
+     * buffer may not fit.  The list is not changed until it does, so
+     * collect (the args are roots) and try once more.
+     */
+    if (retval == PM_RET_EX_MEM)
+    {
+        retval = heap_gcRun();
+        PM_RETURN_IF_ERROR(retval);
+        retval = list_sort(pl, pkeys);
+    }
+#endif /* HAVE_GC */
+    PM_RETURN_IF_ERROR(retval);
+
+    NATIVE_SET_TOS(PM_NONE);
+
+    return retval;
+    """
+    pass
 
 
 # TODO:
 # L.reverse() -- reverse *IN PLACE*
-# L.sort(cmp=None, key=None, reverse=False) -- stable sort *IN PLACE*;
-#    cmp(x, y) -> -1, 0, 1
 
 # :mode=c:
@@ -0,0 +1,202 @@
+# This file is Copyright 2013 Dean Hall.
+# This file is part of the Python-on-a-Chip libraries.
+# This software is licensed under the MIT License.
+# See the LICENSE file for details.
+
+## @file
+#  @copybrief sets
+
+## @package sets
+#  @brief Provides PyMite's sets module.
+#
+# Sets and frozensets are made by the builtins set() and frozenset().
+# This module holds their methods, so it must be imported to call them.
+#
+# Notes:
+# - A method that would change a frozenset raises TypeError.
+# - union() and intersection() take one iterable argument.
+
+
+__name__ = "sets"
+
+
+class _Autobox:
+    def add(self, o):
+        return add(self.obj, o)
+
+    def clear(self):
+        return clear(self.obj)
+
+    def discard(self, o):
+        return discard(self.obj, o)
+
+    def intersection(self, s):
+        return intersection(self.obj, s)
+
+    def remove(self, o):
+        return remove(self.obj, o)
+
+    def union(self, s):
+        return union(self.obj, s)
+
+
+def add(s, o):
+    """__NATIVE__ strviews
+    pPmObj_t ps;
+    PmReturn_t retval = PM_RET_OK;
+
+    /* Raise TypeError if it's not a set or wrong number of args */
+    ps = NATIVE_GET_LOCAL(0);
+    if ((OBJ_GET_TYPE(ps) != OBJ_TYPE_SET) || (NATIVE_GET_NUM_ARGS() != 2)
+        || SET_IS_FROZEN(ps))
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    /* Add the object; raises TypeError if it is not hashable */
+    retval = set_add(ps, NATIVE_GET_LOCAL(1));
+
+    NATIVE_SET_TOS(PM_NONE);
+
+    return retval;
+    """
+    pass
+
+
+def clear(s):
+    """__NATIVE__
+    pPmObj_t ps;
+    PmReturn_t retval = PM_RET_OK;
+
+    /* Raise TypeError if it's not a set or wrong number of args */
+    ps = NATIVE_GET_LOCAL(0);
+    if ((OBJ_GET_TYPE(ps) != OBJ_TYPE_SET) || (NATIVE_GET_NUM_ARGS() != 1)
+        || SET_IS_FROZEN(ps))
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    /* Clear the dict of members */
+    retval = dict_clear((pPmObj_t)((pPmSet_t)ps)->s_dict);
+    PM_RETURN_IF_ERROR(retval);
+
+    NATIVE_SET_TOS(PM_NONE);
+
+    return retval;
+    """
+    pass
+
+
+def discard(s, o):
+    """__NATIVE__ strviews
+    pPmObj_t ps;
+    PmReturn_t retval = PM_RET_OK;
+
+    /* Raise TypeError if it's not a set or wrong number of args */
+    ps = NATIVE_GET_LOCAL(0);
+    if ((OBJ_GET_TYPE(ps) != OBJ_TYPE_SET) || (NATIVE_GET_NUM_ARGS() != 2)
+        || SET_IS_FROZEN(ps))
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+#ifdef HAVE_DEL
+    /* Remove the object if it is a member */
+    retval = set_remove(ps, NATIVE_GET_LOCAL(1));
+    if (retval == PM_RET_EX_KEY)
+    {
+        retval = PM_RET_OK;
+    }
+#else
+    /* Removing is not configured in pmfeatures.h */
+    PM_RAISE(retval, PM_RET_EX_SYS);
+#endif /* HAVE_DEL */
+
+    NATIVE_SET_TOS(PM_NONE);
+
+    return retval;
+    """
+    pass
+
+
+def intersection(s, t):
+    """__NATIVE__ strviews
+    pPmObj_t ps;
+    pPmObj_t pr = C_NULL;
+    PmReturn_t retval = PM_RET_OK;
+
+    /* Raise TypeError if it's not a set or wrong number of args */
+    ps = NATIVE_GET_LOCAL(0);
+    if ((OBJ_GET_TYPE(ps) != OBJ_TYPE_SET) || (NATIVE_GET_NUM_ARGS() != 2))
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    retval = set_intersection(ps, NATIVE_GET_LOCAL(1), &pr);
+    PM_RETURN_IF_ERROR(retval);
+
+    NATIVE_SET_TOS(pr);
+
+    return retval;
+    """
+    pass
+
+
+def remove(s, o):
+    """__NATIVE__ strviews
+    pPmObj_t ps;
+    PmReturn_t retval = PM_RET_OK;
+
+    /* Raise TypeError if it's not a set or wrong number of args */
+    ps = NATIVE_GET_LOCAL(0);
+    if ((OBJ_GET_TYPE(ps) != OBJ_TYPE_SET) || (NATIVE_GET_NUM_ARGS() != 2)
+        || SET_IS_FROZEN(ps))
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+#ifdef HAVE_DEL
+    /* Raises KeyError if the object is not a member */
+    retval = set_remove(ps, NATIVE_GET_LOCAL(1));
+#else
+    /* Removing is not configured in pmfeatures.h */
+    PM_RAISE(retval, PM_RET_EX_SYS);
+#endif /* HAVE_DEL */
+
+    NATIVE_SET_TOS(PM_NONE);
+
+    return retval;
+    """
+    pass
+
+
+def union(s, t):
+    """__NATIVE__ strviews
+    pPmObj_t ps;
+    pPmObj_t pr = C_NULL;
+    PmReturn_t retval = PM_RET_OK;
+
+    /* Raise TypeError if it's not a set or wrong number of args */
+    ps = NATIVE_GET_LOCAL(0);
+    if ((OBJ_GET_TYPE(ps) != OBJ_TYPE_SET) || (NATIVE_GET_NUM_ARGS() != 2))
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    retval = set_union(ps, NATIVE_GET_LOCAL(1), &pr);
+    PM_RETURN_IF_ERROR(retval);
+
+    NATIVE_SET_TOS(pr);
+
+    return retval;
+    """
+    pass
+
+
+# :mode=c:
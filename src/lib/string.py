@@ -13,6 +13,49 @@
 """__NATIVE__
 #include <stdlib.h>
 #include <string.h>
+
+
+/*
+ * Makes room for n more bytes in a StringBuilder's buffer,
+ * which is kept in the None attr of the instance.
+ * If the buffer is replaced by a bigger one, frees the old one.
+ */
+static PmReturn_t
+_builder_reserve(pPmObj_t pself, uint16_t n, pPmString_t *r_pbuf)
+{
+    PmReturn_t retval;
+    pPmObj_t pattrs;
+    pPmObj_t pbuf;
+    pPmObj_t pnewbuf;
+    uint8_t objid;
+
+    /* Raise TypeError if self is not an instance */
+    if (OBJ_GET_TYPE(pself) != OBJ_TYPE_CLI)
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    pattrs = (pPmObj_t)((pPmInstance_t)pself)->cli_attrs;
+    retval = dict_getItem(pattrs, PM_NONE, &pbuf);
+    PM_RETURN_IF_ERROR(retval);
+
+    retval = string_bufReserve(pbuf, n, &pnewbuf);
+    PM_RETURN_IF_ERROR(retval);
+    if (pnewbuf != pbuf)
+    {
+        heap_gcPushTempRoot(pnewbuf, &objid);
+        retval = dict_setItem(pattrs, PM_NONE, pnewbuf);
+        heap_gcPopTempRoot(objid);
+        PM_RETURN_IF_ERROR(retval);
+
+        retval = heap_freeChunk(pbuf);
+        PM_RETURN_IF_ERROR(retval);
+    }
+
+    *r_pbuf = (pPmString_t)pnewbuf;
+    return retval;
+}
 """
 
 
@@ -21,7 +64,7 @@ __name__ = "string"
 
 class _Autobox:
     def join(self, l):
-        return join(self.obj, l)
+        return join(l, self.obj)
 
     def count(self, s):
         return count(self.obj, s)
@@ -196,12 +239,13 @@ def count(s1, s2):
 # WARNING: Does not accept optional start,end arguments.
 #
 def find(s1, s2):
-    """__NATIVE__
+    """__NATIVE__ strviews
     pPmObj_t ps1;
     pPmObj_t ps2;
-    uint8_t *pc1;
-    uint8_t *pc2;
-    uint8_t *pmatch;
+    uint8_t const *pc1;
+    uint8_t const *pc2;
+    uint8_t const *pmatch;
+    uint8_t const *plast;
     uint16_t pc1len;
     uint16_t pc2len;
     int32_t n;
@@ -211,17 +255,18 @@ def find(s1, s2):
     /* Raise TypeError if it's not a string or wrong number of args, */
     ps1 = NATIVE_GET_LOCAL(0);
     ps2 = NATIVE_GET_LOCAL(1);
-    if ((OBJ_GET_TYPE(ps1) != OBJ_TYPE_STR) || (NATIVE_GET_NUM_ARGS() != 2)
-        || (OBJ_GET_TYPE(ps2) != OBJ_TYPE_STR))
+    if ((NATIVE_GET_NUM_ARGS() != 2) || !STRING_IS_STRING(ps1)
+        || !STRING_IS_STRING(ps2))
     {
         PM_RAISE(retval, PM_RET_EX_TYPE);
         return retval;
     }
 
-    pc1 = ((pPmString_t)ps1)->val;
-    pc2 = ((pPmString_t)ps2)->val;
-    pc1len = ((pPmString_t)ps1)->length;
-    pc2len = ((pPmString_t)ps2)->length;
+    /* Either may be a view, so its chars are not null terminated */
+    pc1 = STRING_GET_VAL(ps1);
+    pc2 = STRING_GET_VAL(ps2);
+    pc1len = STRING_GET_LENGTH(ps1);
+    pc2len = STRING_GET_LENGTH(ps2);
     n = -1;
 
     /* Handle a quick special case */
@@ -231,16 +276,24 @@ def find(s1, s2):
     }
 
     /* Try to find the index of the substring */
-    else
+    else if (pc2len <= pc1len)
     {
-        /* Find the next possible start */
-        pmatch = (uint8_t *)memchr(pc1, pc2[0], pc1len);
-        if (pmatch != C_NULL)
+        /* Check each possible start that has room for the substring */
+        plast = pc1 + (pc1len - pc2len);
+        for (pmatch = pc1; pmatch <= plast; pmatch++)
         {
+            /* Find the next possible start */
+            pmatch = (uint8_t *)memchr(pmatch, pc2[0], plast - pmatch + 1);
+            if (pmatch == C_NULL)
+            {
+                break;
+            }
+
             /* If it matches, calculate the index */
             if (memcmp(pmatch, pc2, pc2len) == 0)
             {
                 n = pmatch - pc1;
+                break;
             }
         }
     }
@@ -254,16 +307,206 @@ def find(s1, s2):
     pass
 
 
+#
+# Returns the strings in the list or tuple s (or the characters of the
+# string s) joined by sep.
+# Sums the lengths first, so the result is made with one allocation.
+#
 def join(s, sep=' '):
-    len_s = len(s)
-    if len_s == 0:
-        return ''
-    rs = s[0]
-    i = 1
-    while i < len_s:
-        rs = rs + sep + s[i]
-        i += 1
-    return rs
+    """__NATIVE__
+    pPmObj_t ps;
+    pPmObj_t psep;
+    pPmObj_t pstr;
+    PmReturn_t retval;
+    uint8_t objid;
+
+    /* Raise TypeError if wrong number of args */
+    if ((NATIVE_GET_NUM_ARGS() < 1) || (NATIVE_GET_NUM_ARGS() > 2))
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+    ps = NATIVE_GET_LOCAL(0);
+
+    /* Natives do not get default args, so make the default separator */
+    if (NATIVE_GET_NUM_ARGS() == 2)
+    {
+        psep = NATIVE_GET_LOCAL(1);
+    }
+    else
+    {
+        retval = string_newFromChar(' ', &psep);
+        PM_RETURN_IF_ERROR(retval);
+    }
+
+    /* Raise TypeError if the separator is not a string */
+    if (OBJ_GET_TYPE(psep) != OBJ_TYPE_STR)
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    heap_gcPushTempRoot(psep, &objid);
+    retval = string_join((pPmString_t)psep, ps, &pstr);
+    heap_gcPopTempRoot(objid);
+    PM_RETURN_IF_ERROR(retval);
+
+    NATIVE_SET_TOS(pstr);
+    return retval;
+    """
+    pass
+
+
+#
+# Builds a string from pieces in a buffer that doubles as it fills,
+# so appending n bytes in all costs O(n) copying,
+# where s = s + piece in a loop costs O(n*n).
+# getvalue() returns the contents as a new string.
+#
+class StringBuilder(object):
+
+    def __init__(self,):
+        """__NATIVE__
+        PmReturn_t retval;
+        pPmObj_t pself;
+        pPmObj_t pbuf;
+        uint8_t objid;
+
+        /* Raise TypeError if wrong number of args or self is not an instance */
+        pself = NATIVE_GET_LOCAL(0);
+        if ((NATIVE_GET_NUM_ARGS() != 1) || (OBJ_GET_TYPE(pself) != OBJ_TYPE_CLI))
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+
+        /* Store an empty buffer in the None attr of the instance */
+        retval = string_bufReserve(C_NULL, 0, &pbuf);
+        PM_RETURN_IF_ERROR(retval);
+        heap_gcPushTempRoot(pbuf, &objid);
+        retval = dict_setItem((pPmObj_t)((pPmInstance_t)pself)->cli_attrs,
+                              PM_NONE, pbuf);
+        heap_gcPopTempRoot(objid);
+
+        NATIVE_SET_TOS(PM_NONE);
+        return retval;
+        """
+        pass
+
+
+    def append(self, s):
+        """__NATIVE__ strviews
+        PmReturn_t retval;
+        pPmObj_t ps;
+        pPmString_t pbuf;
+
+        /* Raise TypeError if wrong number of args or s is not a string */
+        ps = NATIVE_GET_LOCAL(1);
+        if ((NATIVE_GET_NUM_ARGS() != 2) || !STRING_IS_STRING(ps))
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+
+        retval = _builder_reserve(NATIVE_GET_LOCAL(0),
+                                  STRING_GET_LENGTH(ps), &pbuf);
+        PM_RETURN_IF_ERROR(retval);
+        sli_memcpy(&pbuf->val[pbuf->length], STRING_GET_VAL(ps),
+                   STRING_GET_LENGTH(ps));
+        pbuf->length += STRING_GET_LENGTH(ps);
+
+        NATIVE_SET_TOS(PM_NONE);
+        return retval;
+        """
+        pass
+
+
+    def extend(self, l):
+        """__NATIVE__
+        PmReturn_t retval;
+        pPmObj_t pl;
+        pPmObj_t pitem;
+        pPmString_t pbuf;
+        uint32_t len;
+        uint16_t n;
+        uint16_t i;
+
+        /* Raise TypeError if wrong number of args or l is not a sequence */
+        pl = NATIVE_GET_LOCAL(1);
+        if ((NATIVE_GET_NUM_ARGS() != 2)
+            || ((OBJ_GET_TYPE(pl) != OBJ_TYPE_LST)
+                && (OBJ_GET_TYPE(pl) != OBJ_TYPE_TUP)))
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+
+        /* Sum the lengths; raise TypeError if an item is not a string */
+        retval = seq_getLength(pl, &n);
+        PM_RETURN_IF_ERROR(retval);
+        len = 0;
+        for (i = 0; i < n; i++)
+        {
+            retval = seq_getSubscript(pl, i, &pitem);
+            PM_RETURN_IF_ERROR(retval);
+            if (!STRING_IS_STRING(pitem))
+            {
+                PM_RAISE(retval, PM_RET_EX_TYPE);
+                return retval;
+            }
+            len += STRING_GET_LENGTH(pitem);
+        }
+
+        /* Raise MemoryError if the pieces can not fit in one buffer */
+        if (len > HEAP_MAX_LIVE_CHUNK_SIZE)
+        {
+            PM_RAISE(retval, PM_RET_EX_MEM);
+            return retval;
+        }
+
+        /* Make room once, then copy the pieces */
+        retval = _builder_reserve(NATIVE_GET_LOCAL(0), (uint16_t)len, &pbuf);
+        PM_RETURN_IF_ERROR(retval);
+        for (i = 0; i < n; i++)
+        {
+            retval = seq_getSubscript(pl, i, &pitem);
+            PM_RETURN_IF_ERROR(retval);
+            sli_memcpy(&pbuf->val[pbuf->length], STRING_GET_VAL(pitem),
+                       STRING_GET_LENGTH(pitem));
+            pbuf->length += STRING_GET_LENGTH(pitem);
+        }
+
+        NATIVE_SET_TOS(PM_NONE);
+        return retval;
+        """
+        pass
+
+
+    def getvalue(self,):
+        """__NATIVE__
+        PmReturn_t retval;
+        pPmObj_t pself;
+        pPmObj_t pbuf;
+        pPmObj_t pstr;
+
+        /* Raise TypeError if wrong number of args or self is not an instance */
+        pself = NATIVE_GET_LOCAL(0);
+        if ((NATIVE_GET_NUM_ARGS() != 1) || (OBJ_GET_TYPE(pself) != OBJ_TYPE_CLI))
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+
+        retval = dict_getItem((pPmObj_t)((pPmInstance_t)pself)->cli_attrs,
+                              PM_NONE, &pbuf);
+        PM_RETURN_IF_ERROR(retval);
+        retval = string_bufGetValue(pbuf, &pstr);
+        PM_RETURN_IF_ERROR(retval);
+
+        NATIVE_SET_TOS(pstr);
+        return retval;
+        """
+        pass
 
 
 # :mode=c:
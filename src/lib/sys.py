@@ -152,11 +152,166 @@ def heap():
     pass
 
 
+#
+# Returns the bytecode statistics as (reschedules, [(bytecode, count, cycles)])
+# sorted by descending cycles, then clears them if the optional arg is true.
+# Returns None if the VM was built without HAVE_OPSTATS.
+#
+def opstats(clear):
+    """__NATIVE__
+    PmReturn_t retval = PM_RET_OK;
+    pPmObj_t pstats = PM_NONE;
+
+    /* If wrong number of args, raise TypeError */
+    if (NATIVE_GET_NUM_ARGS() > 1)
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+#ifdef HAVE_OPSTATS
+    retval = interp_getOpStats(&pstats);
+    PM_RETURN_IF_ERROR(retval);
+
+    if ((NATIVE_GET_NUM_ARGS() == 1) && !obj_isFalse(NATIVE_GET_LOCAL(0)))
+    {
+        interp_clearOpStats();
+    }
+#endif /* HAVE_OPSTATS */
+
+    NATIVE_SET_TOS(pstats);
+    return retval;
+    """
+    pass
+
+
+#
+# Starts the sampling profiler if the arg is true, stops it if false.
+# Starting discards the previous profile.
+# Raises SystemError if the VM was built without HAVE_PROFILER.
+#
+def profile(on):
+    """__NATIVE__
+    PmReturn_t retval = PM_RET_OK;
+
+    /* If wrong number of args, raise TypeError */
+    if (NATIVE_GET_NUM_ARGS() != 1)
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+#ifdef HAVE_PROFILER
+    prof_enable(!obj_isFalse(NATIVE_GET_LOCAL(0)));
+#else
+    PM_RAISE(retval, PM_RET_EX_SYS);
+#endif /* HAVE_PROFILER */
+
+    NATIVE_SET_TOS(PM_NONE);
+    return retval;
+    """
+    pass
+
+
+#
+# Prints the profile gathered by profile() in the format given by the
+# optional arg: 0 flat, 1 call tree, 2 collapsed stacks (default).
+# Raises SystemError if the VM was built without HAVE_PROFILER.
+#
+def profdump(fmt):
+    """__NATIVE__
+    PmReturn_t retval = PM_RET_OK;
+    uint8_t fmt = 2;
+    pPmObj_t pfmt;
+
+    /* If wrong number of args, raise TypeError */
+    if (NATIVE_GET_NUM_ARGS() > 1)
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    if (NATIVE_GET_NUM_ARGS() == 1)
+    {
+        /* If arg is not an int, raise TypeError */
+        pfmt = NATIVE_GET_LOCAL(0);
+        if (OBJ_GET_TYPE(pfmt) != OBJ_TYPE_INT)
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+        fmt = (uint8_t)((pPmInt_t)pfmt)->val;
+    }
+
+#ifdef HAVE_PROFILER
+    retval = prof_print(fmt);
+    PM_RETURN_IF_ERROR(retval);
+#else
+    (void)fmt;
+    PM_RAISE(retval, PM_RET_EX_SYS);
+#endif /* HAVE_PROFILER */
+
+    NATIVE_SET_TOS(PM_NONE);
+    return retval;
+    """
+    pass
+
+
+#
+# Sets the number of backward jumps and calls (1..65535) a thread may run
+# before it is rescheduled.  If the optional second arg is false, the timer
+# no longer ends timeslices early, so threads interleave deterministically.
+# Raises SystemError if the VM was built without HAVE_BUDGET_SCHED.
+#
+def budget(n, timed):
+    """__NATIVE__
+    PmReturn_t retval = PM_RET_OK;
+    pPmObj_t pn;
+
+    /* If wrong number of args, raise TypeError */
+    if ((NATIVE_GET_NUM_ARGS() < 1) || (NATIVE_GET_NUM_ARGS() > 2))
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    /* If arg is not an int, raise TypeError */
+    pn = NATIVE_GET_LOCAL(0);
+    if (OBJ_GET_TYPE(pn) != OBJ_TYPE_INT)
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    /* If the budget is out of range, raise ValueError */
+    if ((((pPmInt_t)pn)->val < 1) || (((pPmInt_t)pn)->val > 65535))
+    {
+        PM_RAISE(retval, PM_RET_EX_VAL);
+        return retval;
+    }
+
+#ifdef HAVE_BUDGET_SCHED
+    gVmGlobal.budget = (uint16_t)((pPmInt_t)pn)->val;
+    gVmGlobal.budgetTimed = (NATIVE_GET_NUM_ARGS() == 1)
+                            || !obj_isFalse(NATIVE_GET_LOCAL(1));
+
+    /* End this timeslice so the new budget applies right away */
+    interp_setRescheduleFlag((uint8_t)1);
+#else
+    PM_RAISE(retval, PM_RET_EX_SYS);
+#endif /* HAVE_BUDGET_SCHED */
+
+    NATIVE_SET_TOS(PM_NONE);
+    return retval;
+    """
+    pass
+
+
 #
 # Sends the LSB of the integer out the platform's default I/O
 #
 def putb(b):
-    """__NATIVE__
+    """__NATIVE__ noalloc
     uint8_t b;
     pPmObj_t pb;
     PmReturn_t retval;
@@ -186,15 +341,20 @@ def putb(b):
 
 
 #
-# Runs the given function in a thread sharing the current global namespace
+# Runs the given function in a thread sharing the current global namespace.
+# The optional priority (0 is the lowest, default 1) must be less than
+# PM_THREAD_NUM_PRIORITIES (4); a ready thread of higher priority always
+# runs before those of lower priority.
 #
-def runInThread(f):
+def runInThread(f, priority):
     """__NATIVE__
     PmReturn_t retval;
     pPmObj_t pf;
+    pPmObj_t ppri;
+    uint8_t pri = PM_THREAD_PRIORITY_DEFAULT;
 
     /* If wrong number of args, raise TypeError */
-    if (NATIVE_GET_NUM_ARGS() != 1)
+    if ((NATIVE_GET_NUM_ARGS() < 1) || (NATIVE_GET_NUM_ARGS() > 2))
     {
         PM_RAISE(retval, PM_RET_EX_TYPE);
         return retval;
@@ -208,7 +368,27 @@ def runInThread(f):
         return retval;
     }
 
-    retval = interp_addThread((pPmFunc_t)pf);
+    if (NATIVE_GET_NUM_ARGS() == 2)
+    {
+        /* If priority is not an int, raise TypeError */
+        ppri = NATIVE_GET_LOCAL(1);
+        if (OBJ_GET_TYPE(ppri) != OBJ_TYPE_INT)
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+
+        /* If priority is out of range, raise ValueError */
+        if ((((pPmInt_t)ppri)->val < 0)
+            || (((pPmInt_t)ppri)->val >= PM_THREAD_NUM_PRIORITIES))
+        {
+            PM_RAISE(retval, PM_RET_EX_VAL);
+            return retval;
+        }
+        pri = (uint8_t)((pPmInt_t)ppri)->val;
+    }
+
+    retval = interp_addThreadAtPriority((pPmFunc_t)pf, pri, 0);
     NATIVE_SET_TOS(PM_NONE);
     return retval;
     """
@@ -254,12 +434,100 @@ def time():
 
 
 #
-# Waits in a busy loop for the given number of milliseconds
+# Suspends the calling thread for the given number of milliseconds.
+# Other threads run meanwhile; when all threads sleep, the VM idles.
+#
+def sleep(ms):
+    """__NATIVE__
+    PmReturn_t retval;
+    pPmObj_t pms;
+
+    /* If wrong number of args, raise TypeError */
+    if (NATIVE_GET_NUM_ARGS() != 1)
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    /* If arg is not an int, raise TypeError */
+    pms = NATIVE_GET_LOCAL(0);
+    if (OBJ_GET_TYPE(pms) != OBJ_TYPE_INT)
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    /* If the time is negative, raise ValueError */
+    if (((pPmInt_t)pms)->val < 0)
+    {
+        PM_RAISE(retval, PM_RET_EX_VAL);
+        return retval;
+    }
+
+    /* Move the calling thread from its ready queue to the sleepers */
+    retval = thread_dequeue(gVmGlobal.pthread);
+    PM_RETURN_IF_ERROR(retval);
+    retval = thread_sleep(gVmGlobal.pthread, (uint32_t)((pPmInt_t)pms)->val);
+    PM_RETURN_IF_ERROR(retval);
+
+    /* Switch to another thread before this one executes again */
+    interp_setRescheduleFlag((uint8_t)1);
+    NATIVE_SET_TOS(PM_NONE);
+    return retval;
+    """
+    pass
+
+
+#
+# Runs the given function in a new thread after the given number of
+# milliseconds
+#
+def after(ms, f):
+    """__NATIVE__
+    PmReturn_t retval;
+    pPmObj_t pms;
+    pPmObj_t pf;
+
+    /* If wrong number of args, raise TypeError */
+    if (NATIVE_GET_NUM_ARGS() != 2)
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    /* If args are not an int and a function, raise TypeError */
+    pms = NATIVE_GET_LOCAL(0);
+    pf = NATIVE_GET_LOCAL(1);
+    if ((OBJ_GET_TYPE(pms) != OBJ_TYPE_INT)
+        || (OBJ_GET_TYPE(pf) != OBJ_TYPE_FXN))
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    /* If the time is negative, raise ValueError */
+    if (((pPmInt_t)pms)->val < 0)
+    {
+        PM_RAISE(retval, PM_RET_EX_VAL);
+        return retval;
+    }
+
+    retval = interp_addThreadAtPriority((pPmFunc_t)pf,
+                                        PM_THREAD_PRIORITY_DEFAULT,
+                                        (uint32_t)((pPmInt_t)pms)->val);
+    NATIVE_SET_TOS(PM_NONE);
+    return retval;
+    """
+    pass
+
+
+#
+# Waits for the given number of milliseconds by sleeping
+# (returns at once if ms is not positive)
 #
 def wait(ms):
-    t = time() + ms
-    while time() < t:
-        pass
+    if ms > 0:
+        sleep(ms)
 
 
 # :mode=c:
@@ -226,8 +226,8 @@ plat_getMsTicks(uint32_t *r_ticks)
 
 
 #ifdef HAVE_DEBUG_INFO
-#define LEN_FNLOOKUP 26
-#define LEN_EXNLOOKUP 18
+#define LEN_FNLOOKUP 29
+#define LEN_EXNLOOKUP 19
 #define FN_MAX_LEN 15
 #define EXN_MAX_LEN 18
 #ifndef MAX
@@ -261,6 +261,9 @@ static char fnstr_22[] PROGMEM = "thread.c";
 static char fnstr_23[] PROGMEM = "float.c";
 static char fnstr_24[] PROGMEM = "class.c";
 static char fnstr_25[] PROGMEM = "bytearray.c";
+static char fnstr_26[] PROGMEM = "prof.c";
+static char fnstr_27[] PROGMEM = "set.c";
+static char fnstr_28[] PROGMEM = "array.c";
 
 static PGM_P fnlookup[LEN_FNLOOKUP] PROGMEM =
 {
@@ -270,7 +273,8 @@ static PGM_P fnlookup[LEN_FNLOOKUP] PROGMEM =
     fnstr_12, fnstr_13, fnstr_14, fnstr_15,
     fnstr_16, fnstr_17, fnstr_18, fnstr_19,
     fnstr_20, fnstr_21, fnstr_22, fnstr_23,
-    fnstr_24, fnstr_25
+    fnstr_24, fnstr_25, fnstr_26, fnstr_27,
+    fnstr_28
 };
 
 /* This table should match src/vm/pm.h PmReturn_t */
@@ -292,6 +296,7 @@ static char exnstr_14[] PROGMEM = "ValueError";
 static char exnstr_15[] PROGMEM = "StopIteration";
 static char exnstr_16[] PROGMEM = "Warning";
 static char exnstr_17[] PROGMEM = "OverflowError";
+static char exnstr_18[] PROGMEM = "RuntimeError";
 
 static PGM_P exnlookup[LEN_EXNLOOKUP] PROGMEM =
 {
@@ -299,7 +304,7 @@ static PGM_P exnlookup[LEN_EXNLOOKUP] PROGMEM =
     exnstr_04, exnstr_05, exnstr_06, exnstr_07,
     exnstr_08, exnstr_09, exnstr_10, exnstr_11,
     exnstr_12, exnstr_13, exnstr_14, exnstr_15,
-    exnstr_16, exnstr_17
+    exnstr_16, exnstr_17, exnstr_18
 };
 #endif /* HAVE_DEBUG_INFO */
 
@@ -24,6 +24,7 @@
 #include <unistd.h>
 #include <signal.h>
 #include <string.h>
+#include <time.h>
 
 #include "pm.h"
 
@@ -144,13 +145,29 @@ plat_getMsTicks(uint32_t *r_ticks)
 }
 
 
+void
+plat_idle(uint32_t until)
+{
+    struct timespec ts;
+    int32_t ms;
+
+    /* SIGALRM advances the ticks and cuts each sleep short */
+    while ((ms = (int32_t)(until - pm_timerMsTicks)) > 0)
+    {
+        ts.tv_sec = ms / 1000;
+        ts.tv_nsec = (ms % 1000) * 1000000L;
+        nanosleep(&ts, C_NULL);
+    }
+}
+
+
 void
 plat_reportError(PmReturn_t result)
 {
 
 #ifdef HAVE_DEBUG_INFO
-#define LEN_FNLOOKUP 26
-#define LEN_EXNLOOKUP 18
+#define LEN_FNLOOKUP 29
+#define LEN_EXNLOOKUP 19
 
     uint8_t res;
     pPmFrame_t pframe;
@@ -191,6 +208,9 @@ plat_reportError(PmReturn_t result)
         "float.c",
         "class.c",
         "bytearray.c",
+        "prof.c",
+        "set.c",
+        "array.c",
     };
 
     /* This table should match src/vm/pm.h PmReturn_t */
@@ -213,6 +233,7 @@ plat_reportError(PmReturn_t result)
         "StopIteration",
         "Warning",
         "OverflowError",
+        "RuntimeError",
     };
 
     /* Print traceback */
@@ -18,5 +18,7 @@
 #define PM_FLOAT_LITTLE_ENDIAN
 #define PM_PLAT_POINTER_SIZE 4
 #define PM_PLAT_HEAP_ATTR __attribute__((aligned (4)))
+#define PM_PLAT_PROGMEM_DIRECT 1
+#define PM_PLAT_HAS_IDLE 1
 \
 #endif /* _PLAT_H_ */
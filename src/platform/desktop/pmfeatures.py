@@ -29,4 +29,6 @@ PM_FEATURES = {
     "HAVE_SNPRINTF_FORMAT": False,
     "HAVE_AUTOBOX": False,
     "HAVE_SLICE": True,
+    "HAVE_SET": True,
+    "HAVE_ARRAY": False,
 }
@@ -24,10 +24,26 @@
 #include <unistd.h>
 #include <signal.h>
 #include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
 
 #include "pm.h"
 
 
+#ifdef __linux__
+/* Older C libraries lack the name of this struct sigevent field */
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+/** The millisecond timer of this thread's VM */
+static PM_PLAT_TLS timer_t platTimer;
+#endif /* __linux__ */
+
+
 void plat_sigalrm_handler(int signal);
 
 
@@ -35,13 +51,38 @@ void plat_sigalrm_handler(int signal);
 PmReturn_t
 plat_init(void)
 {
+#ifdef __linux__
+    struct sigevent sev;
+    struct itimerspec its;
+#endif /* __linux__ */
+
     /* Let POSIX' SIGALRM fire every full millisecond. */
     /*
      * #67 Using sigaction complicates the use of getchar (below),
      * so signal() is used instead.
      */
     signal(SIGALRM, plat_sigalrm_handler);
+
+#ifdef __linux__
+    /*
+     * The VM state is thread-local, so send the signal to this thread only;
+     * the handler then ticks this thread's VM.
+     */
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_THREAD_ID;
+    sev.sigev_signo = SIGALRM;
+    sev.sigev_notify_thread_id = (pid_t)syscall(SYS_gettid);
+    if (timer_create(CLOCK_MONOTONIC, &sev, &platTimer) != 0)
+    {
+        return PM_RET_ERR;
+    }
+    its.it_value.tv_sec = 0;
+    its.it_value.tv_nsec = 1000000L;
+    its.it_interval = its.it_value;
+    timer_settime(platTimer, 0, &its, C_NULL);
+#else
     ualarm(1000, 1000);
+#endif /* __linux__ */
 
     return PM_RET_OK;
 }
@@ -51,9 +92,14 @@ plat_init(void)
 PmReturn_t
 plat_deinit(void)
 {
+#ifdef __linux__
+    /* Delete this VM's timer; other VMs may still need the handler */
+    timer_delete(platTimer);
+#else
     /* Cancel alarm and set the alarm handler to the default */
     ualarm(0, 0);
     signal(SIGALRM, SIG_DFL);
+#endif /* __linux__ */
 
     return PM_RET_OK;
 }
@@ -144,13 +190,62 @@ plat_getMsTicks(uint32_t *r_ticks)
 }
 
 
+void
+plat_idle(uint32_t until)
+{
+    struct timespec ts;
+    int32_t ms;
+
+    /* SIGALRM advances the ticks and cuts each sleep short */
+    while ((ms = (int32_t)(until - pm_timerMsTicks)) > 0)
+    {
+        ts.tv_sec = ms / 1000;
+        ts.tv_nsec = (ms % 1000) * 1000000L;
+        nanosleep(&ts, C_NULL);
+    }
+}
+
+
+#ifdef HAVE_OPSTATS
+uint32_t
+plat_getCycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    uint32_t lo;
+    uint32_t hi;
+
+    __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+    return lo;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000000UL + ts.tv_nsec);
+#endif
+}
+#endif /* HAVE_OPSTATS */
+
+
+#ifdef HAVE_JIT
+uint8_t *
+plat_jitMap(uint32_t size)
+{
+    void *p;
+
+    p = mmap(C_NULL, size, PROT_READ | PROT_WRITE | PROT_EXEC,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return (p == MAP_FAILED) ? C_NULL : (uint8_t *)p;
+}
+#endif /* HAVE_JIT */
+
+
 void
 plat_reportError(PmReturn_t result)
 {
 
 #ifdef HAVE_DEBUG_INFO
-#define LEN_FNLOOKUP 26
-#define LEN_EXNLOOKUP 18
+#define LEN_FNLOOKUP 29
+#define LEN_EXNLOOKUP 19
 
     uint8_t res;
     pPmFrame_t pframe;
@@ -191,6 +286,9 @@ plat_reportError(PmReturn_t result)
         "float.c",
         "class.c",
         "bytearray.c",
+        "prof.c",
+        "set.c",
+        "array.c",
     };
 
     /* This table should match src/vm/pm.h PmReturn_t */
@@ -213,6 +311,7 @@ plat_reportError(PmReturn_t result)
         "StopIteration",
         "Warning",
         "OverflowError",
+        "RuntimeError",
     };
 
     /* Print traceback */
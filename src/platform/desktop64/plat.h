@@ -18,5 +18,18 @@
 #define PM_FLOAT_LITTLE_ENDIAN
 #define PM_PLAT_POINTER_SIZE 8
 #define PM_PLAT_HEAP_ATTR __attribute__((aligned (8)))
+#define PM_PLAT_PROGMEM_DIRECT 1
+#define PM_PLAT_HAS_IDLE 1
+#define PM_PLAT_HAS_CYCLES 1
+
+/* The JIT's templates are x86-64 machine code */
+#ifdef __x86_64__
+#define PM_PLAT_HAS_JIT 1
+#endif
+
+/* On Linux each OS thread can run its own VM (see plat_init) */
+#ifdef __linux__
+#define PM_PLAT_TLS __thread
+#endif
 
 #endif /* _PLAT_H_ */
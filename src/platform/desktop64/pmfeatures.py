@@ -24,9 +24,15 @@ PM_FEATURES = {
     "HAVE_BACKTICK": True,
     "HAVE_STRING_FORMAT": True,
     "HAVE_CLOSURES": True,
-    "HAVE_BYTEARRAY": False,
+    "HAVE_BYTEARRAY": True,
     "HAVE_DEBUG_INFO": True,
     "HAVE_SNPRINTF_FORMAT": False,
     "HAVE_AUTOBOX": True,
     "HAVE_SLICE": True,
+    "HAVE_SET": True,
+    "HAVE_ARRAY": True,
+    "HAVE_OPSTATS": False,
+    "HAVE_PROFILER": False,
+    "HAVE_BUDGET_SCHED": False,
+    "HAVE_JIT": True,
 }
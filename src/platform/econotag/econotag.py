@@ -272,9 +272,9 @@ def tx_packet(p):
     PmReturn_t retval = PM_RET_OK;
 	volatile packet_t *p;
 	pPmObj_t ppkt;
-	pPmBytearray_t pba;
-	pPmString_t pstr;
 	pPmInt_t pn;
+	uint8_t *pbuf;
+	uint16_t len;
 
     /* Raise TypeError if wrong number of args */
     if (NATIVE_GET_NUM_ARGS() != 1)
@@ -285,22 +285,11 @@ def tx_packet(p):
 
     ppkt = NATIVE_GET_LOCAL(0);
 
-    /* If object is an instance, get the thing it is containing */
-    if (OBJ_GET_TYPE(ppkt) == OBJ_TYPE_CLI)
-    {
-        retval = dict_getItem((pPmObj_t)((pPmInstance_t)ppkt)->cli_attrs,
-                              PM_NONE,
-                              (pPmObj_t *)&pba);
-        PM_RETURN_IF_ERROR(retval);
-        ppkt = (pPmObj_t)pba;
-    }
-
     /* Raise TypeError if arg is not a string or bytearray */
-    if ((OBJ_GET_TYPE(ppkt) != OBJ_TYPE_STR)
-        && (OBJ_GET_TYPE(ppkt) != OBJ_TYPE_BYA))
+    retval = bytearray_getBuffer(ppkt, C_FALSE, &pbuf, &len);
+    if (retval != PM_RET_OK)
     {
         NATIVE_SET_TOS(PM_NONE);
-        PM_RAISE(retval, PM_RET_EX_TYPE);
         return retval;
     }
 
@@ -312,26 +301,10 @@ def tx_packet(p):
         return retval;
     }
 
-    /* Copy bytes from string arg to packet */
+    /* Copy bytes from string or bytearray arg to packet */
     p->offset = 0;
-    if (OBJ_GET_TYPE(ppkt) == OBJ_TYPE_STR)
-    {
-        pstr = (pPmString_t)ppkt;
-        sli_memcpy((unsigned char *)&(p->data[0]),
-                   (unsigned char *)&(pstr->val[0]),
-                   (unsigned int)pstr->length);
-        p->length = pstr->length;
-    }
-
-    /* Copy bytes from bytearray arg to packet */
-    else
-    {
-        pba = (pPmBytearray_t)ppkt;
-        sli_memcpy((unsigned char *)&(p->data[0]),
-                   (unsigned char *)&(pba->val->val[0]),
-                   (unsigned int)pba->length);
-        p->length = pba->length;
-    }
+    sli_memcpy((unsigned char *)&(p->data[0]), pbuf, (unsigned int)len);
+    p->length = len;
 
     retval = int_new(p->length, &pn);
     NATIVE_SET_TOS(pn);
@@ -349,8 +322,7 @@ def rx_packet():
     volatile packet_t *p;
     pPmBytearray_t pba;
     pPmInt_t pn;
-    uint8_t objid, objid2;
-    pPmObj_t pbaclass;
+    uint8_t objid;
     pPmObj_t pcli;
 
     p = rx_packet();
@@ -379,28 +351,14 @@ def rx_packet():
     heap_freeChunk(pn);
 
     /* Copy packet payload to bytearray */
-    sli_memcpy((unsigned char *)&(pba->val->val[0]),
+    sli_memcpy(BYTEARRAY_GET_VAL(pba),
                (unsigned char *)&(p->data[p->offset]),
                (unsigned int)p->length);
     free_packet(p);
 
     /* Create an instance of bytearray to hold the bytearray struct */
-    retval = dict_getItem(PM_PBUILTINS, PM_BYTEARRAY_STR, &pbaclass);
+    retval = bytearray_wrap((pPmObj_t)pba, &pcli);
     PM_RETURN_IF_ERROR(retval);
-    heap_gcPushTempRoot((pPmObj_t)pba, &objid);
-    retval = class_instantiate(pbaclass, &pcli);
-    if (retval != PM_RET_OK)
-    {
-        heap_gcPopTempRoot(objid);
-        return retval;
-    }
-
-    /* Store bytearray struct in the instance's None attribute */
-    heap_gcPushTempRoot(pcli, &objid2);
-    retval = dict_setItem((pPmObj_t)((pPmInstance_t)pcli)->cli_attrs,
-                          PM_NONE,
-                          (pPmObj_t)pba);
-    heap_gcPopTempRoot(objid);
 
     NATIVE_SET_TOS(pcli);
     return retval;
@@ -130,8 +130,8 @@ plat_reportError(PmReturn_t result)
 {
 
 #ifdef HAVE_DEBUG_INFO
-#define LEN_FNLOOKUP 26
-#define LEN_EXNLOOKUP 18
+#define LEN_FNLOOKUP 29
+#define LEN_EXNLOOKUP 19
 
     uint8_t res;
     pPmFrame_t pframe;
@@ -172,6 +172,9 @@ plat_reportError(PmReturn_t result)
         "float.c",
         "class.c",
         "bytearray.c",
+        "prof.c",
+        "set.c",
+        "array.c",
     };
 
     /* This table should match src/vm/pm.h PmReturn_t */
@@ -194,6 +197,7 @@ plat_reportError(PmReturn_t result)
         "StopIteration",
         "Warning",
         "OverflowError",
+        "RuntimeError",
     };
 
     /* Print traceback */
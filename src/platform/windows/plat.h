@@ -25,5 +25,6 @@
 
 #define PM_FLOAT_LITTLE_ENDIAN
 #define PM_PLAT_POINTER_SIZE 4
+#define PM_PLAT_PROGMEM_DIRECT 1
 
 #endif /* _PLAT_H_ */
@@ -0,0 +1,72 @@
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+
+#
+# System Test 424
+# Natives declared with stackargs read more than eight args in place
+# from the caller's stack; noalloc natives skip the pre-call GC check.
+#
+
+
+def sum10(a, b, c, d, e, f, g, h, i, j):
+    """__NATIVE__ stackargs
+    pPmObj_t *pargv;
+    pPmObj_t pr;
+    int32_t n = 0;
+    uint8_t i;
+    PmReturn_t retval;
+
+    if (NATIVE_GET_NUM_ARGS() != 10)
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    pargv = NATIVE_GET_ARGV();
+    for (i = 0; i < NATIVE_GET_NUM_ARGS(); i++)
+    {
+        if (OBJ_GET_TYPE(pargv[i]) != OBJ_TYPE_INT)
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+            return retval;
+        }
+        n += ((pPmInt_t)pargv[i])->val;
+    }
+
+    retval = int_new(n, &pr);
+    NATIVE_SET_TOS(pr);
+    return retval;
+    """
+    pass
+
+
+def last(a, b, c, d, e, f, g, h, i):
+    """__NATIVE__ stackargs noalloc
+    if (NATIVE_GET_NUM_ARGS() != 9)
+    {
+        PmReturn_t retval;
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    NATIVE_SET_TOS(NATIVE_GET_LOCAL(8));
+    return PM_RET_OK;
+    """
+    pass
+
+
+i = 0
+while i < 200:
+    s = "s%d" % i
+    assert sum10(i, 1, 2, 3, 4, 5, 6, 7, 8, 9) == i + 45
+    assert last(0, 1, 2, 3, 4, 5, 6, 7, s) is s
+    i += 1
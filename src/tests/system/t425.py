@@ -0,0 +1,36 @@
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+
+#
+# System Test 425
+# A thread started at a higher priority preempts the main thread,
+# one at a lower priority does not run while the main thread is ready.
+#
+
+import sys
+
+
+log = []
+
+def lo():
+    log.append("lo")
+
+def hi():
+    log.append("hi")
+
+sys.runInThread(lo, 0)
+sys.runInThread(hi, 3)
+
+# Wait for the scheduler to switch to the high priority thread
+while len(log) == 0:
+    pass
+assert log == ["hi"]
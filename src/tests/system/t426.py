@@ -0,0 +1,39 @@
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+
+#
+# System Test 426
+# sys.sleep() suspends only the calling thread;
+# sys.after() runs a function in a new thread after a delay.
+#
+
+import sys
+
+
+log = []
+
+def sleeper():
+    sys.sleep(40)
+    log.append("sleeper")
+
+def callback():
+    log.append("after")
+
+t0 = sys.time()
+sys.runInThread(sleeper)
+sys.after(20, callback)
+
+# The other threads wait, so the main thread runs on meanwhile
+log.append("main")
+sys.sleep(80)
+assert log == ["main", "after", "sleeper"]
+assert sys.time() - t0 >= 80
@@ -0,0 +1,68 @@
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+
+#
+# System Test 427
+# Generator objects: FOR_ITER resumes the generator's frame directly,
+# next() and send() still work and an exhausted generator stays exhausted.
+#
+
+
+def count(n, step=1):
+    for i in range(n):
+        yield i * step
+
+def double(src):
+    for x in src:
+        yield 2 * x
+
+def acc():
+    total = 0
+    while True:
+        v = yield total
+        total += v
+
+
+# A pipeline of generators
+s = 0
+for x in double(count(5)):
+    s += x
+assert s == 20
+
+# Default args and next()
+g = count(3, 10)
+assert g.next() == 0
+assert g.next() == 10
+assert g.next() == 20
+
+# An exhausted generator ends every loop over it
+n = 0
+for x in g:
+    n += 1
+for x in g:
+    n += 1
+assert n == 0
+
+# send()
+a = acc()
+assert a.next() == 0
+assert a.send(5) == 5
+assert a.send(7) == 12
+
+# A generator-expression that uses a free variable
+k = 3
+s = 0
+for x in (x + k for x in [1, 2, 3]):
+    s += x
+assert s == 15
+
+print "Generators OK"
@@ -0,0 +1,62 @@
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+
+#
+# System Test 428
+# xrange() computes its ints on demand, so a for loop over an xrange
+# does not build a list.
+#
+
+
+x = xrange(2, 11, 3)
+assert len(x) == 3
+assert x[0] == 2
+assert x[2] == 8
+assert x[-1] == 8
+assert 5 in x
+assert 6 not in x
+assert 11 not in x
+
+assert len(xrange(10, 0, -3)) == 4
+assert len(xrange(5, 1)) == 0
+assert not xrange(0)
+
+# An xrange can be iterated more than once
+n = 0
+for i in x:
+    n += i
+for i in x:
+    n += i
+assert n == 30
+
+# A loop far longer than a list that fits in the heap
+n = 0
+for i in xrange(20000):
+    n += 1
+assert n == 20000
+
+n = 0
+for i in range(10, 0, -2):
+    n += i
+assert n == 30
+
+# range() returns a list
+r = range(3)
+assert r == [0, 1, 2]
+assert type(r) == type([])
+
+# The length of a huge xrange is computed without overflowing
+assert len(xrange(-2000000000, 2000000000, 1000000000)) == 4
+assert len(xrange(2000000000, -2000000000, -3)) == 1333333334
+assert len(xrange(-0x7FFFFFFF, 0x7FFFFFFF, 0x7FFFFFFF)) == 2
+
+print "xrange OK"
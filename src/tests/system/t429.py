@@ -0,0 +1,66 @@
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+
+#
+# System Test 429
+# A long enough slice of a string is a view that shares the parent's chars;
+# it compares, hashes, prints and is found like the equal string.
+#
+
+import string
+import sys
+
+
+line = "alpha=beta-gamma;delta=epsilon-zeta"
+a = line[0:16]
+b = a[6:16]
+assert a == "alpha=beta-gamma"
+assert "alpha=beta-gamma" == a
+assert b == "beta-gamma"
+assert a != "alpha=beta-gammA"
+assert len(a) == 16
+assert type(a) == type("")
+assert a[0] == "a" and a[-1] == "a"
+assert ("g" in a) and ("z" not in a)
+assert (a, b) == ("alpha=beta-gamma", "beta-gamma")
+assert a + "!" == "alpha=beta-gamma!"
+assert a + line[16:35] == line
+assert line[0:35] is line
+
+# A view is a dict key equal to the string, and is stored as a string
+d = {}
+d[a] = 1
+d["alpha=beta-gamma"] = 2
+assert len(d) == 1
+assert d[line[0:16]] == 2
+assert line[17:35] not in d
+
+# Natives get a view as a string unless they take views
+assert string.find(a, "gamma") == 11
+assert string.find(line[17:35], "zeta") == 14
+assert string.find(a, "delta") == -1
+assert string.find("abcabd", "abd") == 3
+assert string.atoi("12345678901"[1:9]) == 23456789
+assert string.join([a, b], "/") == "alpha=beta-gamma/beta-gamma"
+assert "%s|%s" % (a, b) == "alpha=beta-gamma|beta-gamma"
+
+s = ""
+for c in line[17:25]:
+    s = s + c
+assert s == "delta=ep"
+
+# A view keeps its parent alive
+k = line[17:35]
+line = None
+sys.gc()
+assert k == "delta=epsilon-zeta"
+print a, b, k
@@ -0,0 +1,73 @@
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+
+#
+# System Test 430
+# A long string constant is loaded as a view of the code image; it compares,
+# hashes, concatenates, slices and is found like a string built at run time.
+#
+
+import string
+import sys
+
+
+MSG = "a long string constant in the image"
+
+class LongConstantHolder:
+    def __init__(self):
+        self.text = "another long constant, set in __init__"
+
+    def getText(self):
+        return self.text
+
+
+def getMsg():
+    return "a long string constant in the image"
+
+
+# Equal to the same constant in another code object and to a built string
+assert MSG == getMsg()
+built = string.join(["a long string", "constant in the image"], " ")
+assert built == MSG
+assert MSG == built
+assert len(MSG) == 35
+assert MSG != "a long string constant in the imagE"
+
+# Works as a dict key both ways
+d = {}
+d[MSG] = 1
+d[built] = 2
+assert len(d) == 1
+assert d[getMsg()] == 2
+d["a third long string constant"] = 3
+assert d[string.join(["a third", "long string constant"], " ")] == 3
+
+# Found, concatenated, sliced and formatted
+assert string.find(MSG, "constant") == 14
+assert string.find("the needle is near the end", "end") == 23
+s = MSG + "!"
+assert s == "a long string constant in the image!"
+assert MSG[2:22] == "long string constant"
+assert MSG[-5:] == "image"
+assert "<%s>" % MSG == "<a long string constant in the image>"
+assert MSG * 2 == built + built
+
+# In a class
+h = LongConstantHolder()
+assert h.getText() == "another long constant, set in __init__"
+assert string.find(h.getText(), "__init__") == 30
+
+# Survives a collection
+sys.gc()
+assert MSG == getMsg()
+assert d[MSG] == 2
+assert h.getText()[:7] == "another"
@@ -0,0 +1,64 @@
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+
+#
+# System Test 431
+# A code object's names and consts are loaded when it is first run,
+# so functions, methods and closures work whether or not
+# they were first called before or after a collection.
+#
+
+import sys
+
+
+def neverCalled():
+    return "this function is never called"
+
+
+def outer(a):
+    b = a * 2
+    def inner(c):
+        return a + b + c
+    return inner
+
+
+def withConsts():
+    return (1, "two", 3)
+
+
+class Counter:
+    def __init__(self, n):
+        self.n = n
+
+    def step(self):
+        self.n += 1
+        return self.n
+
+    def unused(self):
+        return "an unused method"
+
+
+sys.gc()
+assert withConsts() == (1, "two", 3)
+f = outer(1)
+assert f(3) == 6
+assert outer(2)(0) == 6
+sys.gc()
+assert f(4) == 7
+
+k = Counter(5)
+sys.gc()
+assert k.step() == 6
+assert k.step() == 7
+assert Counter(1).step() == 2
+g = neverCalled
+assert g is neverCalled
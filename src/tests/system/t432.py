@@ -0,0 +1,117 @@
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+
+#
+# System Test 432
+# Tests the native set and frozenset types: the set() and frozenset()
+# builtins, the methods in the sets module, membership, iteration,
+# the | and & operators and using a frozenset as a dict key or set member.
+#
+
+import sets
+import sys
+
+
+# Make sets from each kind of iterable
+s = set()
+assert len(s) == 0
+assert not s
+s = set([1, 2, 3, 2, 1])
+assert len(s) == 3
+assert s
+assert len(set((4, 5))) == 2
+assert len(set("hello")) == 4
+assert len(set({"a": 1, "b": 2})) == 2
+assert len(set(s)) == 3
+assert len(set(xrange(10))) == 10
+
+# Membership
+assert 1 in s
+assert 3 in s
+assert 4 not in s
+assert "l" in set("hello")
+assert "z" not in set("hello")
+
+# Methods
+s.add(4)
+s.add(4)
+assert len(s) == 4
+assert 4 in s
+s.discard(4)
+s.discard(4)
+assert len(s) == 3
+assert 4 not in s
+s.remove(3)
+assert 3 not in s
+assert len(s) == 2
+s.clear()
+assert len(s) == 0
+
+# Iteration visits each member once
+s = set([10, 20, 30])
+total = 0
+for i in s:
+    total += i
+assert total == 60
+
+# Equality does not depend on order or frozenness
+assert set([1, 2, 3]) == set([3, 2, 1])
+assert set([1, 2]) != set([1, 2, 3])
+assert set([1, 2]) == frozenset([2, 1])
+
+# Union and intersection
+a = set([1, 2, 3])
+b = set([2, 3, 4])
+assert a.union(b) == set([1, 2, 3, 4])
+assert a.union([5]) == set([1, 2, 3, 5])
+assert a.intersection(b) == set([2, 3])
+assert a.intersection((3, 4, 5)) == set([3])
+assert a | b == set([1, 2, 3, 4])
+assert a & b == set([2, 3])
+assert a == set([1, 2, 3])
+
+# In-place operators change the set
+c = a
+c |= b
+assert a == set([1, 2, 3, 4])
+c &= set([1, 4, 9])
+assert a == set([1, 4])
+
+# Frozensets are hashable and keep their members
+f = frozenset([1, 2])
+assert frozenset(f) is f
+assert len(f) == 2
+g = f | set([3])
+assert g == frozenset([1, 2, 3])
+f |= set([3])
+assert f == g
+d = {}
+d[frozenset([1, 2])] = "one two"
+assert d[frozenset([2, 1])] == "one two"
+s = set()
+s.add(frozenset("ab"))
+assert frozenset("ba") in s
+
+# Printing
+print set()
+print set([7])
+print frozenset(["x"])
+
+# Sets survive a collection
+s = set(xrange(50))
+sys.gc()
+assert len(s) == 50
+assert 49 in s
+s.remove(0)
+assert 0 not in s
+
+print "PASS"
@@ -0,0 +1,117 @@
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+
+#
+# System Test 433
+# Tests the bytearray's bulk operations: slicing shares the bytes until
+# either bytearray is changed, extend, fill, find and comparing bytes.
+# Needs HAVE_BYTEARRAY and the bytearray class in __bi.py.
+#
+
+import sys
+
+
+b = bytearray("hello world")
+
+# A slice has the bytes of its range
+s = b[6:]
+assert len(s) == 5
+assert s == bytearray("world")
+assert b[:5] == bytearray("hello")
+assert b[-5:-2] == bytearray("wor")
+assert len(b[8:3]) == 0
+assert len(b[100:]) == 0
+
+# Changing a slice does not change its parent, nor the parent the slice
+s[0] = 'W'
+assert s == bytearray("World")
+assert b[6] == ord('w')
+b[7] = 'O'
+assert s == bytearray("World")
+assert b == bytearray("hello wOrld")
+
+# A copy is a slice of the whole bytearray
+c = b[:]
+assert c == b
+c[0] = 'H'
+assert b[0] == ord('h')
+
+# With several sharers, each write copies until one sharer is left
+a = bytearray("abcd")
+s1 = a[:]
+s2 = a[1:]
+s1[0] = 'x'
+a[0] = 'y'
+assert s2 == bytearray("bcd")
+s2[0] = 'z'
+a[1] = 'q'
+assert a == bytearray("yqcd")
+assert s1 == bytearray("xbcd")
+assert s2 == bytearray("zcd")
+
+# Comparing looks at every byte, including zero bytes
+assert bytearray([0, 1]) != bytearray([0, 2])
+assert bytearray([0, 1]) == bytearray([0, 1])
+assert bytearray([1, 2]) != bytearray([1, 2, 3])
+
+# Extend from bytearrays, strings, lists, tuples and itself
+e = bytearray()
+e.extend("ab")
+e.extend(bytearray([99]))
+e.extend([100, 'e'])
+e.extend((102,))
+assert e == bytearray("abcdef")
+e.extend(e)
+assert e == bytearray("abcdefabcdef")
+t = e[0:3]
+t.extend("xyz")
+assert t == bytearray("abcxyz")
+assert e == bytearray("abcdefabcdef")
+i = 0
+while i < 100:
+    e.extend("0123456789")
+    i += 1
+assert len(e) == 1012
+assert e[1011] == ord('9')
+
+# Fill all, a range or a negative range
+f = bytearray(8)
+f.fill(7)
+assert f == bytearray([7, 7, 7, 7, 7, 7, 7, 7])
+f.fill(0, 2, 5)
+assert f == bytearray([7, 7, 0, 0, 0, 7, 7, 7])
+f.fill('a', -2)
+assert f == bytearray([7, 7, 0, 0, 0, 7, 97, 97])
+g = f[1:4]
+g.fill(1)
+assert f[1] == 7
+assert g == bytearray([1, 1, 1])
+
+# Find bytes, a string or a bytearray
+p = bytearray("abcabc\x00d")
+assert p.find(98) == 1
+assert p.find("ca") == 2
+assert p.find(bytearray("bc"), 2) == 4
+assert p.find("bc", -3) == -1
+assert p.find(0) == 6
+assert p.find("x") == -1
+assert p.find("") == 0
+assert p.find("abcabc\x00dz") == -1
+
+# Slices keep their bytes after a collection
+b = bytearray("0123456789")
+s = b[2:6]
+b = None
+sys.gc()
+assert s == bytearray("2345")
+
+print "PASS"
@@ -0,0 +1,101 @@
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+
+#
+# System Test 434
+# Tests the typed numeric array: making, indexing and printing arrays,
+# and the sum, min/max, dot, scale, add, mul and moving average kernels.
+#
+
+import array
+
+
+# An int makes zeros, a sequence is copied
+a = array.array('h', 5)
+assert len(a) == 5
+assert a.tolist() == [0, 0, 0, 0, 0]
+a = array.array('h', [3, -1, 4, 1, -5, 9, 2, 6, 5, 3, 5])
+assert len(a) == 11
+assert a[0] == 3
+assert a[-1] == 5
+a[1] = 1000
+assert a[1] == 1000
+a[1] = -1
+b = array.array('i', xrange(20))
+assert b.tolist() == range(20)
+c = array.array('h', a)
+c[0] = 0
+assert a[0] == 3
+print a
+
+# Sums wrap as C ints do; items that do not fit their type are refused
+assert a.sum() == 32
+assert b.sum() == 190
+assert a.min() == -5
+assert a.max() == 9
+e = array.array('b', [127, 127, 127])
+assert e.sum() == 381
+assert e.dot(e) == 48387
+big = array.array('i', [0x7FFFFFFF, 1])
+assert big.sum() == -0x80000000
+
+# Dot products of every length, so the SIMD and scalar tails both run
+n = 0
+while n < 20:
+    x = array.array('h', xrange(n))
+    y = array.array('h', xrange(n))
+    y.scale(-1, 7)
+    total = 0
+    i = 0
+    while i < n:
+        total += i * (7 - i)
+        i += 1
+    assert x.dot(y) == total
+    n += 1
+
+# Scale, add and mul work in place and keep the low bits of int results
+d = array.array('h', xrange(10))
+d.scale(3)
+assert d.tolist() == [0, 3, 6, 9, 12, 15, 18, 21, 24, 27]
+d.scale(2, -5)
+assert d.tolist() == [-5, 1, 7, 13, 19, 25, 31, 37, 43, 49]
+d.add(d)
+assert d[9] == 98
+d.mul(array.array('h', [1, 2, 3, 4, 5, 6, 7, 8, 9, 10]))
+assert d.tolist() == [-10, 4, 42, 104, 190, 300, 434, 592, 774, 980]
+e.add(array.array('b', [1, 1, 1]))
+assert e.tolist() == [-128, -128, -128]
+
+# Moving averages are floored as the / operator does
+m = a.movingAverage(3)
+assert len(m) == 9
+assert m.tolist() == [2, 1, 0, 1, 2, 5, 4, 4, 4]
+assert array.array('i', [-1, -2]).movingAverage(2).tolist() == [-2]
+assert a.movingAverage(11).tolist() == [2]
+assert a.movingAverage(1).tolist() == a.tolist()
+print m
+
+# Floats, with values that sum exactly in any order
+f = array.array('f', [0.5, 1.5, -2.0, 4.0, 0.25])
+assert f.sum() == 4.25
+assert f.max() == 4.0
+assert f.min() == -2.0
+assert f.dot(f) == 22.5625
+f.scale(2.0, 1)
+assert f.tolist() == [2.0, 4.0, -3.0, 9.0, 1.5]
+f.add(f)
+f.mul(array.array('f', [1, 1, 1, 1, 2]))
+assert f.tolist() == [4.0, 8.0, -6.0, 18.0, 6.0]
+assert f.movingAverage(2).tolist() == [6.0, 1.0, 6.0, 12.0]
+f[0] = 3
+assert f[0] == 3.0
+print f
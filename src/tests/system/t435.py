@@ -0,0 +1,67 @@
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+
+#
+# System Test 435
+# Tests that the array kernels give the same results as the same work
+# done on lists.  tools/arrayBench.py times the two.
+#
+
+import array
+
+
+N = 128
+
+l1 = range(N)
+l2 = range(N)
+i = 0
+while i < N:
+    l2[i] = (i * 7) % 31 - 15
+    i += 1
+a1 = array.array('h', l1)
+a2 = array.array('h', l2)
+
+# Sum and dot product
+s = 0
+for v in l1:
+    s += v
+assert a1.sum() == s
+d = 0
+i = 0
+while i < N:
+    d += l1[i] * l2[i]
+    i += 1
+assert a1.dot(a2) == d
+
+# Scale and add
+z = l1[:]
+i = 0
+while i < N:
+    z[i] = l1[i] * 3 + l2[i]
+    i += 1
+az = array.array('h', a1)
+az.scale(3)
+az.add(a2)
+i = 0
+while i < N:
+    assert az[i] == z[i]
+    i += 1
+
+# Moving average
+m = az.movingAverage(4)
+assert len(m) == N - 3
+i = 0
+while i < N - 3:
+    assert m[i] == (z[i] + z[i + 1] + z[i + 2] + z[i + 3]) / 4
+    i += 1
+
+print "done"
@@ -0,0 +1,116 @@
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+
+#
+# System Test 436
+# Tests the native stable list sort: list.sort() and sorted(), with and
+# without a key function, over lists long enough to be merged.
+# The last statement raises TypeError, which t436.c expects.
+#
+
+import list, sys
+
+
+# A plain insertion sort of the keys and items, to check the native sort
+def ref_sort(l, key):
+    ks = []
+    out = []
+    for x in l:
+        k = x
+        if key != None:
+            k = key(x)
+        j = len(out)
+        ks.append(k)
+        out.append(x)
+        while j > 0 and ks[j - 1] > k:
+            ks[j] = ks[j - 1]
+            out[j] = out[j - 1]
+            j -= 1
+        ks[j] = k
+        out[j] = x
+    return out
+
+
+# Pseudo-random ints with many repeats
+seed = 12345
+def rand(n):
+    global seed
+    seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF
+    return (seed >> 8) % n
+
+
+# Every length up to 40 runs insertion runs, merges and their tails
+# (natives such as append do not collect, so collect on each pass)
+n = 0
+while n <= 40:
+    sys.gc()
+    l = []
+    i = 0
+    while i < n:
+        l.append(rand(10))
+        i += 1
+    s = sorted(l)
+    assert s == ref_sort(l, None)
+    l.sort()
+    assert l == s
+    n += 1
+
+# Sorted and reverse-sorted input
+l = range(100)
+l.sort()
+assert l == range(100)
+l = range(99, -1, -1)
+l.sort()
+assert l == range(100)
+
+# The sort is stable: items with equal keys keep their order
+l = []
+i = 0
+while i < 60:
+    l.append((rand(5), i))
+    i += 1
+def first(t):
+    return t[0]
+s = sorted(l, first)
+assert s == ref_sort(l, first)
+l.sort(first)
+assert l == s
+
+# A key function that allocates, so the GC may run while keys are made
+def name(i):
+    return "item" + chr(65 + i % 7) + "." + chr(65 + i / 7)
+l = range(70)
+l.sort(name)
+r = []
+i = 0
+while i < 7:
+    r.extend(range(i, 70, 7))
+    i += 1
+assert l == r
+
+# Strings, floats mixed with ints, tuples, and other iterables
+assert sorted(["pear", "fig", "apple", "figs", ""]) == \
+    ["", "apple", "fig", "figs", "pear"]
+assert sorted([2, 1.5, -3, True, 0.25]) == [-3, 0.25, True, 1.5, 2]
+assert sorted([(2, "b"), (1, "z"), (2, "a"), (1,)]) == \
+    [(1,), (1, "z"), (2, "a"), (2, "b")]
+assert sorted("banana") == ["a", "a", "a", "b", "n", "n"]
+assert sorted(xrange(5), lambda x: -x) == [4, 3, 2, 1, 0]
+assert sorted({3: "c", 1: "a", 2: "b"}) == [1, 2, 3]
+assert sorted(()) == []
+l = []
+l.sort()
+assert l == []
+print "done"
+
+# Items that cannot be ordered against each other raise TypeError
+sorted([1, "a", None])
@@ -0,0 +1,84 @@
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+
+#
+# System Test 437
+# Tests the dict iterators iterkeys(), itervalues() and iteritems(),
+# and that changing a dict's length while looping over it raises
+# RuntimeError.
+#
+
+import dict, list
+
+
+# Fill a dict past one table, and punch holes in it
+d = {}
+i = 0
+while i < 60:
+    d[i] = i * 10
+    i += 1
+i = 0
+while i < 60:
+    del d[i]
+    i += 3
+
+# The iterators give what keys() and values() copy, in the same order
+l = []
+for k in d.iterkeys():
+    l.append(k)
+assert l == d.keys()
+assert len(l) == 40
+
+l = []
+for v in d.itervalues():
+    l.append(v)
+assert l == d.values()
+
+n = 0
+for k, v in d.iteritems():
+    assert v == k * 10
+    assert d[k] == v
+    n += 1
+assert n == 40
+
+# A plain for loop walks the keys the same way
+l = []
+for k in d:
+    l.append(k)
+assert l == d.keys()
+
+# Changing values (not the length) during the loop is allowed
+for k in d.iterkeys():
+    d[k] = -k
+for k, v in d.iteritems():
+    assert v == -k
+
+# An iterator is used up once
+it = d.itervalues()
+n = 0
+for v in it:
+    n += 1
+for v in it:
+    n += 1
+assert n == 40
+
+# Empty dicts and sets
+for k in {}.iterkeys():
+    assert False
+for x in set([]):
+    assert False
+
+print "done"
+
+# Adding a key during the loop raises RuntimeError (checked by t437.c)
+for k in d:
+    d[k + 1000] = 0
@@ -0,0 +1,112 @@
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+
+#
+# System Test 438
+# Tests code that the image creator's peephole pass rewrites.
+# t439 runs this module from an image made with --no-optimize,
+# so both images must give the same results.
+#
+
+# Folded integer and string constants give the values computed at run time
+a = 6
+b = 3
+assert 2 * 3 == a
+assert a * b == 2 * 3 * 3
+assert 7 / 2 == b
+assert 7 % 4 == b
+assert (1 << 4) - 10 == a
+assert -(-6) == a
+assert ~5 == -a
+assert 2 ** 3 == a + 2
+assert 0x7FFFFFFF + 0 == 2147483647
+s = "ab"
+assert "a" + "b" == s
+assert "a" + "b" + "c" == s + "c"
+
+# Int, float and bool constants with equal values stay distinct
+i = 2 - 1
+f = 1.0
+t = True
+assert type(i) == type(1)
+assert type(f) == type(0.5)
+assert type(t) == type(False)
+assert type(i) != type(f)
+assert type(i) != type(t)
+z = -0.0
+assert type(z) == type(0.5)
+assert z == 0.0
+
+# Conditions on constants
+n = 0
+if 1:
+    n += 1
+if 0:
+    n += 100
+if 2 > 1:
+    n += 1
+if "a" == "b":
+    n += 100
+if not 0:
+    n += 1
+while 0:
+    n += 100
+assert n == 3
+
+# Fused conditional jumps with and/or
+x = 5
+y = 0
+if x > 1 and x < 10:
+    y += 1
+if x < 1 or x > 4:
+    y += 1
+if not (x < 1 or x > 9):
+    y += 1
+if x and y and x > y:
+    y += 1
+r = x or y
+assert r == 5
+r = y and x
+assert r == 5
+r = 0 and x
+assert r == 0
+assert y == 4
+
+# Loops with jumps to jumps
+total = 0
+i = 0
+while i < 10:
+    if i % 2:
+        i += 1
+        continue
+    total += i
+    i += 1
+assert total == 20
+
+j = 0
+while True:
+    j += 1
+    if j > 4:
+        break
+assert j == 5
+
+# Function defaults and returns of folded constants
+def f1(k=2 * 8):
+    if k > 10:
+        return k - 1
+    else:
+        return k + 1
+    return 0
+assert f1() == 15
+assert f1(1) == 2
+
+print "done"
@@ -30,6 +30,11 @@ CuSuite *getSuite_testIntObj(void);
 CuSuite *getSuite_testInterp(void);
 CuSuite *getSuite_testStringObj(void);
 CuSuite *getSuite_testTupleObj(void);
+CuSuite *getSuite_testSetObj(void);
+CuSuite *getSuite_testArrayObj(void);
+CuSuite *getSuite_testProf(void);
+CuSuite *getSuite_testPm(void);
+CuSuite *getSuite_testJit(void);
 
 
 int main(void)
@@ -47,6 +52,11 @@ int main(void)
     CuSuiteAddSuite(suite, getSuite_testInterp());
     CuSuiteAddSuite(suite, getSuite_testStringObj());
     CuSuiteAddSuite(suite, getSuite_testTupleObj());
+    CuSuiteAddSuite(suite, getSuite_testSetObj());
+    CuSuiteAddSuite(suite, getSuite_testArrayObj());
+    CuSuiteAddSuite(suite, getSuite_testProf());
+    CuSuiteAddSuite(suite, getSuite_testPm());
+    CuSuiteAddSuite(suite, getSuite_testJit());
 
     CuSuiteRun(suite);
     CuSuiteSummary(suite, output);
@@ -0,0 +1,167 @@
+/*
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+*/
+
+
+/**
+ * Array Object Unit Tests
+ * Tests the Array Object implementation.
+ */
+
+
+#include "CuTest.h"
+#include "pm.h"
+
+
+#define HEAP_SIZE 0x4000
+
+
+#ifdef HAVE_ARRAY
+/**
+ * Tests array_new():
+ *      retval is OK and the items are zeros
+ *      the items follow the header in the bytes container, aligned
+ *      an unknown typecode raises ValueError
+ *      too many items for one chunk raises MemoryError
+ */
+void
+ut_array_new_000(CuTest *tc)
+{
+    uint8_t heap[HEAP_SIZE];
+    pPmObj_t parr;
+    pPmObj_t pitem;
+    PmReturn_t retval;
+
+    pm_init(heap, HEAP_SIZE, MEMSPACE_RAM, C_NULL);
+
+    retval = array_new('h', 10, &parr);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc, OBJ_GET_TYPE(parr) == OBJ_TYPE_BYS);
+    CuAssertTrue(tc, ARRAY_GET_LENGTH(parr) == 10);
+    CuAssertTrue(tc, ARRAY_GET_TYPECODE(parr) == 'h');
+    CuAssertTrue(tc, ((pPmBytes_t)parr)->length == ARRAY_HDR_SIZE + 20);
+    CuAssertTrue(tc, ((uintptr_t)ARRAY_GET_ITEMS(parr) & 3) == 0);
+    retval = array_getItem(parr, 9, &pitem);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc, ((pPmInt_t)pitem)->val == 0);
+
+    retval = array_new('x', 10, &parr);
+    CuAssertTrue(tc, retval == PM_RET_EX_VAL);
+
+    retval = array_new('i', ARRAY_MAX_BYTES / 4 + 1, &parr);
+    CuAssertTrue(tc, retval == PM_RET_EX_MEM);
+}
+
+
+/**
+ * Tests array_setItem() and array_getItem():
+ *      negative indices count from the end
+ *      an int that does not fit the type raises OverflowError
+ *      an index out of range raises IndexError
+ */
+void
+ut_array_setItem_000(CuTest *tc)
+{
+    uint8_t heap[HEAP_SIZE];
+    pPmObj_t parr;
+    pPmObj_t pint;
+    pPmObj_t pitem;
+    PmReturn_t retval;
+
+    pm_init(heap, HEAP_SIZE, MEMSPACE_RAM, C_NULL);
+
+    retval = array_new('b', 4, &parr);
+    retval = int_new(-128, &pint);
+    retval = array_setItem(parr, -1, pint);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = array_getItem(parr, 3, &pitem);
+    CuAssertTrue(tc, ((pPmInt_t)pitem)->val == -128);
+
+    retval = int_new(128, &pint);
+    retval = array_setItem(parr, 0, pint);
+    CuAssertTrue(tc, retval == PM_RET_EX_OFLOW);
+
+    retval = array_getItem(parr, 4, &pitem);
+    CuAssertTrue(tc, retval == PM_RET_EX_INDX);
+}
+
+
+/**
+ * Tests array_dot(), array_sum() and array_op() on every length up to 40,
+ * so that both the vector loops and their scalar tails are run:
+ *      results equal a plain loop over the items
+ */
+void
+ut_array_dot_000(CuTest *tc)
+{
+    uint8_t heap[HEAP_SIZE];
+    pPmObj_t parr1;
+    pPmObj_t parr2;
+    pPmObj_t pr;
+    PmReturn_t retval;
+    int32_t dot;
+    int32_t sum;
+    uint16_t n;
+    uint16_t i;
+
+    pm_init(heap, HEAP_SIZE, MEMSPACE_RAM, C_NULL);
+
+    for (n = 0; n <= 40; n++)
+    {
+        retval = array_new('h', n, &parr1);
+        retval = array_new('h', n, &parr2);
+        dot = 0;
+        sum = 0;
+        for (i = 0; i < n; i++)
+        {
+            ((int16_t *)ARRAY_GET_ITEMS(parr1))[i] = (int16_t)(i * 1000 - 20000);
+            ((int16_t *)ARRAY_GET_ITEMS(parr2))[i] = (int16_t)(7 - i);
+            dot += (i * 1000 - 20000) * (7 - i);
+            sum += (i * 1000 - 20000) + (7 - i);
+        }
+
+        retval = array_dot(parr1, parr2, &pr);
+        CuAssertTrue(tc, retval == PM_RET_OK);
+        CuAssertTrue(tc, ((pPmInt_t)pr)->val == dot);
+
+        retval = array_op(parr1, parr2, '+');
+        CuAssertTrue(tc, retval == PM_RET_OK);
+        retval = array_sum(parr1, &pr);
+        CuAssertTrue(tc, ((pPmInt_t)pr)->val == sum);
+    }
+
+    retval = array_new('h', 3, &parr2);
+    retval = array_dot(parr1, parr2, &pr);
+    CuAssertTrue(tc, retval == PM_RET_EX_VAL);
+    retval = array_new('i', 3, &parr2);
+    retval = array_op(parr2, parr1, '*');
+    CuAssertTrue(tc, retval == PM_RET_EX_TYPE);
+}
+
+
+#endif /* HAVE_ARRAY */
+
+
+/** Make a suite from all tests in this file */
+CuSuite *getSuite_testArrayObj(void)
+{
+    CuSuite* suite = CuSuiteNew();
+
+#ifdef HAVE_ARRAY
+    SUITE_ADD_TEST(suite, ut_array_new_000);
+    SUITE_ADD_TEST(suite, ut_array_setItem_000);
+    SUITE_ADD_TEST(suite, ut_array_dot_000);
+#endif /* HAVE_ARRAY */
+
+    return suite;
+}
@@ -224,6 +224,7 @@ uint8_t const test_code_image0[] =
  * Tests co_loadFromImg():
  *      retval is OK
  *      pimg points to one byte past the end of the image after image is loaded
+ *      names and consts are not loaded until co_resolve()
  */
 void
 ut_co_loadFromImg_000(CuTest *tc)
@@ -247,7 +248,14 @@ ut_co_loadFromImg_000(CuTest *tc)
 
     /* Check that pimg now points to one byte past the end of the image */
     CuAssertTrue(tc, pimg == (test_code_image0 + size));
-    
+
+    /* Check that names and consts are loaded on resolve */
+    CuAssertTrue(tc, ((pPmCo_t)pcodeobject)->co_consts == C_NULL);
+    retval = co_resolve((pPmCo_t)pcodeobject);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc, ((pPmCo_t)pcodeobject)->co_names != C_NULL);
+    CuAssertTrue(tc, ((pPmCo_t)pcodeobject)->co_consts != C_NULL);
+
 #ifdef HAVE_DEBUG_INFO
     CuAssertTrue(tc, ((pPmCo_t)pcodeobject)->co_filename != C_NULL);
     CuAssertTrue(tc, ((pPmCo_t)pcodeobject)->co_lnotab != C_NULL);
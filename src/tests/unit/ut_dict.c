@@ -104,6 +104,71 @@ ut_dict_setItem_001(CuTest* tc)
 }
 
 
+/**
+ * Test dict_setItem() with more keys than fit in the largest dict table:
+ *      Set n int keys; expect length is n,
+ *          expect every key gets its value,
+ *          expect dict_next() walks the keys in insertion order.
+ *      Delete the even keys; expect length is n/2,
+ *          expect the odd keys still get their values,
+ *          expect the even keys raise KeyError.
+ */
+void
+ut_dict_setItem_002(CuTest* tc)
+{
+    uint8_t heap[0x8000];
+    pPmObj_t pobj = C_NULL;
+    pPmObj_t pkey;
+    pPmObj_t pval;
+    PmReturn_t retval;
+    uint16_t index = 0;
+    int16_t i;
+
+    retval = pm_init(heap, sizeof(heap), MEMSPACE_RAM, C_NULL);
+    retval = dict_new(&pobj);
+
+    for (i = 0; i < 200; i++)
+    {
+        retval = int_new(i, &pkey);
+        retval = dict_setItem(pobj, pkey, pkey);
+        CuAssertTrue(tc, retval == PM_RET_OK);
+    }
+    CuAssertTrue(tc, ((pPmDict_t)pobj)->length == 200);
+    CuAssertPtrNotNull(tc, ((pPmDict_t)pobj)->d_table->dt_next);
+
+    for (i = 0; i < 200; i++)
+    {
+        retval = int_new(i, &pkey);
+        retval = dict_getItem(pobj, pkey, &pval);
+        CuAssertTrue(tc, retval == PM_RET_OK);
+        CuAssertTrue(tc, ((pPmInt_t)pval)->val == i);
+    }
+
+    for (i = 0; dict_next(pobj, &index, &pkey, &pval) == PM_RET_OK; i++)
+    {
+        CuAssertTrue(tc, ((pPmInt_t)pkey)->val == i);
+    }
+    CuAssertTrue(tc, i == 200);
+
+#ifdef HAVE_DEL
+    for (i = 0; i < 200; i += 2)
+    {
+        retval = int_new(i, &pkey);
+        retval = dict_delItem(pobj, pkey);
+        CuAssertTrue(tc, retval == PM_RET_OK);
+    }
+    CuAssertTrue(tc, ((pPmDict_t)pobj)->length == 100);
+
+    for (i = 0; i < 200; i++)
+    {
+        retval = int_new(i, &pkey);
+        retval = dict_getItem(pobj, pkey, &pval);
+        CuAssertTrue(tc, retval == ((i & 1) ? PM_RET_OK : PM_RET_EX_KEY));
+    }
+#endif /* HAVE_DEL */
+}
+
+
 /**
  * Test dict_clear():
  *      Pass non-dict object; expect TypeError
@@ -364,6 +429,7 @@ CuSuite *getSuite_testDict(void)
     SUITE_ADD_TEST(suite, ut_dict_new_000);
     SUITE_ADD_TEST(suite, ut_dict_setItem_000);
     SUITE_ADD_TEST(suite, ut_dict_setItem_001);
+    SUITE_ADD_TEST(suite, ut_dict_setItem_002);
     SUITE_ADD_TEST(suite, ut_dict_clear_000);
     SUITE_ADD_TEST(suite, ut_dict_getItem_000);
 
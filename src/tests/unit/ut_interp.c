@@ -88,12 +88,487 @@ ut_interp_interpret_000(CuTest *tc)
 /* END unit tests ported from Snarf */
 
 
+/**
+ * The following source code was compiled to an image using pmImgCreator.py
+ * using this command line:
+ *
+ *      ../../tools/pmImgCreator.py -f pmfeatures.py -c -s -o utsched.img.c utsched.py
+ *
+
+log = [0, 0, 0, 0, 0, 0, 0, 0]
+pos = [0]
+
+def a():
+    i = 0
+    while i < 4:
+        log[pos[0]] = 1
+        pos[0] += 1
+        i += 1
+
+def b():
+    i = 0
+    while i < 4:
+        log[pos[0]] = 2
+        pos[0] += 1
+        i += 1
+
+ */
+uint8_t const test_sched_image0[] =
+{
+#if !defined(HAVE_CLOSURES) && !defined(HAVE_DEBUG_INFO)
+/* utsched.py */
+    0x0A, 0x51, 0x01, 0x00, 0x40, 0x08, 0x00, 0x04, 
+    0x05, 0x03, 0x03, 0x00, 0x6C, 0x6F, 0x67, 0x03, 
+    0x03, 0x00, 0x70, 0x6F, 0x73, 0x03, 0x01, 0x00, 
+    0x61, 0x03, 0x01, 0x00, 0x62, 0x03, 0x07, 0x00, 
+    0x75, 0x74, 0x73, 0x63, 0x68, 0x65, 0x64, 0x04, 
+    0x04, 0x01, 0x00, 0x00, 0x00, 0x00, 0x0A, 0x70, 
+    0x00, 0x00, 0x43, 0x04, 0x01, 0x04, 0x03, 0x03, 
+    0x03, 0x00, 0x6C, 0x6F, 0x67, 0x03, 0x03, 0x00, 
+    0x70, 0x6F, 0x73, 0x03, 0x01, 0x00, 0x61, 0x04, 
+    0x04, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 
+    0x04, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 
+    0x00, 0x64, 0x01, 0x00, 0x7D, 0x00, 0x00, 0x78, 
+    0x38, 0x00, 0x7C, 0x00, 0x00, 0x64, 0x02, 0x00, 
+    0x6A, 0x00, 0x00, 0x72, 0x40, 0x00, 0x64, 0x03, 
+    0x00, 0x74, 0x00, 0x00, 0x74, 0x01, 0x00, 0x64, 
+    0x01, 0x00, 0x19, 0x3C, 0x74, 0x01, 0x00, 0x64, 
+    0x01, 0x00, 0x63, 0x02, 0x00, 0x19, 0x64, 0x03, 
+    0x00, 0x37, 0x03, 0x3C, 0x7C, 0x00, 0x00, 0x64, 
+    0x03, 0x00, 0x37, 0x7D, 0x00, 0x00, 0x71, 0x09, 
+    0x00, 0x57, 0x64, 0x00, 0x00, 0x53, 0x0A, 0x75, 
+    0x00, 0x00, 0x43, 0x04, 0x01, 0x04, 0x03, 0x03, 
+    0x03, 0x00, 0x6C, 0x6F, 0x67, 0x03, 0x03, 0x00, 
+    0x70, 0x6F, 0x73, 0x03, 0x01, 0x00, 0x62, 0x04, 
+    0x05, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 
+    0x04, 0x00, 0x00, 0x00, 0x01, 0x02, 0x00, 0x00, 
+    0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x64, 0x01, 
+    0x00, 0x7D, 0x00, 0x00, 0x78, 0x38, 0x00, 0x7C, 
+    0x00, 0x00, 0x64, 0x02, 0x00, 0x6A, 0x00, 0x00, 
+    0x72, 0x40, 0x00, 0x64, 0x03, 0x00, 0x74, 0x00, 
+    0x00, 0x74, 0x01, 0x00, 0x64, 0x01, 0x00, 0x19, 
+    0x3C, 0x74, 0x01, 0x00, 0x64, 0x01, 0x00, 0x63, 
+    0x02, 0x00, 0x19, 0x64, 0x04, 0x00, 0x37, 0x03, 
+    0x3C, 0x7C, 0x00, 0x00, 0x64, 0x04, 0x00, 0x37, 
+    0x7D, 0x00, 0x00, 0x71, 0x09, 0x00, 0x57, 0x64, 
+    0x00, 0x00, 0x53, 0x00, 0x64, 0x00, 0x00, 0x64, 
+    0x00, 0x00, 0x64, 0x00, 0x00, 0x64, 0x00, 0x00, 
+    0x64, 0x00, 0x00, 0x64, 0x00, 0x00, 0x64, 0x00, 
+    0x00, 0x64, 0x00, 0x00, 0x67, 0x08, 0x00, 0x5A, 
+    0x00, 0x00, 0x64, 0x00, 0x00, 0x67, 0x01, 0x00, 
+    0x5A, 0x01, 0x00, 0x64, 0x01, 0x00, 0x84, 0x00, 
+    0x00, 0x5A, 0x02, 0x00, 0x64, 0x02, 0x00, 0x84, 
+    0x00, 0x00, 0x5A, 0x03, 0x00, 0x64, 0x03, 0x00, 
+    0x53, 
+#endif
+#if defined(HAVE_CLOSURES) && !defined(HAVE_DEBUG_INFO)
+/* utsched.py */
+    0x0A, 0x5A, 0x01, 0x00, 0x40, 0x08, 0x00, 0x00, 
+    0x04, 0x05, 0x03, 0x03, 0x00, 0x6C, 0x6F, 0x67, 
+    0x03, 0x03, 0x00, 0x70, 0x6F, 0x73, 0x03, 0x01, 
+    0x00, 0x61, 0x03, 0x01, 0x00, 0x62, 0x03, 0x07, 
+    0x00, 0x75, 0x74, 0x73, 0x63, 0x68, 0x65, 0x64, 
+    0x04, 0x04, 0x01, 0x00, 0x00, 0x00, 0x00, 0x0A, 
+    0x73, 0x00, 0x00, 0x43, 0x04, 0x01, 0x00, 0x04, 
+    0x03, 0x03, 0x03, 0x00, 0x6C, 0x6F, 0x67, 0x03, 
+    0x03, 0x00, 0x70, 0x6F, 0x73, 0x03, 0x01, 0x00, 
+    0x61, 0x04, 0x04, 0x00, 0x01, 0x00, 0x00, 0x00, 
+    0x00, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x01, 
+    0x00, 0x00, 0x00, 0x04, 0x00, 0x64, 0x01, 0x00, 
+    0x7D, 0x00, 0x00, 0x78, 0x38, 0x00, 0x7C, 0x00, 
+    0x00, 0x64, 0x02, 0x00, 0x6A, 0x00, 0x00, 0x72, 
+    0x40, 0x00, 0x64, 0x03, 0x00, 0x74, 0x00, 0x00, 
+    0x74, 0x01, 0x00, 0x64, 0x01, 0x00, 0x19, 0x3C, 
+    0x74, 0x01, 0x00, 0x64, 0x01, 0x00, 0x63, 0x02, 
+    0x00, 0x19, 0x64, 0x03, 0x00, 0x37, 0x03, 0x3C, 
+    0x7C, 0x00, 0x00, 0x64, 0x03, 0x00, 0x37, 0x7D, 
+    0x00, 0x00, 0x71, 0x09, 0x00, 0x57, 0x64, 0x00, 
+    0x00, 0x53, 0x0A, 0x78, 0x00, 0x00, 0x43, 0x04, 
+    0x01, 0x00, 0x04, 0x03, 0x03, 0x03, 0x00, 0x6C, 
+    0x6F, 0x67, 0x03, 0x03, 0x00, 0x70, 0x6F, 0x73, 
+    0x03, 0x01, 0x00, 0x62, 0x04, 0x05, 0x00, 0x01, 
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x04, 0x00, 0x00, 
+    0x00, 0x01, 0x02, 0x00, 0x00, 0x00, 0x01, 0x01, 
+    0x00, 0x00, 0x00, 0x04, 0x00, 0x64, 0x01, 0x00, 
+    0x7D, 0x00, 0x00, 0x78, 0x38, 0x00, 0x7C, 0x00, 
+    0x00, 0x64, 0x02, 0x00, 0x6A, 0x00, 0x00, 0x72, 
+    0x40, 0x00, 0x64, 0x03, 0x00, 0x74, 0x00, 0x00, 
+    0x74, 0x01, 0x00, 0x64, 0x01, 0x00, 0x19, 0x3C, 
+    0x74, 0x01, 0x00, 0x64, 0x01, 0x00, 0x63, 0x02, 
+    0x00, 0x19, 0x64, 0x04, 0x00, 0x37, 0x03, 0x3C, 
+    0x7C, 0x00, 0x00, 0x64, 0x04, 0x00, 0x37, 0x7D, 
+    0x00, 0x00, 0x71, 0x09, 0x00, 0x57, 0x64, 0x00, 
+    0x00, 0x53, 0x00, 0x04, 0x00, 0x64, 0x00, 0x00, 
+    0x64, 0x00, 0x00, 0x64, 0x00, 0x00, 0x64, 0x00, 
+    0x00, 0x64, 0x00, 0x00, 0x64, 0x00, 0x00, 0x64, 
+    0x00, 0x00, 0x64, 0x00, 0x00, 0x67, 0x08, 0x00, 
+    0x5A, 0x00, 0x00, 0x64, 0x00, 0x00, 0x67, 0x01, 
+    0x00, 0x5A, 0x01, 0x00, 0x64, 0x01, 0x00, 0x84, 
+    0x00, 0x00, 0x5A, 0x02, 0x00, 0x64, 0x02, 0x00, 
+    0x84, 0x00, 0x00, 0x5A, 0x03, 0x00, 0x64, 0x03, 
+    0x00, 0x53, 
+#endif
+#if !defined(HAVE_CLOSURES) && defined(HAVE_DEBUG_INFO)
+/* utsched.py */
+    0x0A, 0xA4, 0x01, 0x00, 0x40, 0x08, 0x00, 0x01, 
+    0x00, 0x04, 0x05, 0x03, 0x03, 0x00, 0x6C, 0x6F, 
+    0x67, 0x03, 0x03, 0x00, 0x70, 0x6F, 0x73, 0x03, 
+    0x01, 0x00, 0x61, 0x03, 0x01, 0x00, 0x62, 0x03, 
+    0x07, 0x00, 0x75, 0x74, 0x73, 0x63, 0x68, 0x65, 
+    0x64, 0x03, 0x06, 0x00, 0x1E, 0x01, 0x09, 0x02, 
+    0x09, 0x07, 0x03, 0x0B, 0x00, 0x75, 0x74, 0x73, 
+    0x63, 0x68, 0x65, 0x64, 0x2E, 0x70, 0x79, 0x00, 
+    0x04, 0x04, 0x01, 0x00, 0x00, 0x00, 0x00, 0x0A, 
+    0x8D, 0x00, 0x00, 0x43, 0x04, 0x01, 0x04, 0x00, 
+    0x04, 0x03, 0x03, 0x03, 0x00, 0x6C, 0x6F, 0x67, 
+    0x03, 0x03, 0x00, 0x70, 0x6F, 0x73, 0x03, 0x01, 
+    0x00, 0x61, 0x03, 0x0A, 0x00, 0x00, 0x01, 0x06, 
+    0x01, 0x0F, 0x01, 0x0D, 0x01, 0x10, 0x01, 0x03, 
+    0x0B, 0x00, 0x75, 0x74, 0x73, 0x63, 0x68, 0x65, 
+    0x64, 0x2E, 0x70, 0x79, 0x00, 0x04, 0x04, 0x00, 
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 0x04, 0x00, 
+    0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x64, 
+    0x01, 0x00, 0x7D, 0x00, 0x00, 0x78, 0x38, 0x00, 
+    0x7C, 0x00, 0x00, 0x64, 0x02, 0x00, 0x6A, 0x00, 
+    0x00, 0x72, 0x40, 0x00, 0x64, 0x03, 0x00, 0x74, 
+    0x00, 0x00, 0x74, 0x01, 0x00, 0x64, 0x01, 0x00, 
+    0x19, 0x3C, 0x74, 0x01, 0x00, 0x64, 0x01, 0x00, 
+    0x63, 0x02, 0x00, 0x19, 0x64, 0x03, 0x00, 0x37, 
+    0x03, 0x3C, 0x7C, 0x00, 0x00, 0x64, 0x03, 0x00, 
+    0x37, 0x7D, 0x00, 0x00, 0x71, 0x09, 0x00, 0x57, 
+    0x64, 0x00, 0x00, 0x53, 0x0A, 0x92, 0x00, 0x00, 
+    0x43, 0x04, 0x01, 0x0B, 0x00, 0x04, 0x03, 0x03, 
+    0x03, 0x00, 0x6C, 0x6F, 0x67, 0x03, 0x03, 0x00, 
+    0x70, 0x6F, 0x73, 0x03, 0x01, 0x00, 0x62, 0x03, 
+    0x0A, 0x00, 0x00, 0x01, 0x06, 0x01, 0x0F, 0x01, 
+    0x0D, 0x01, 0x10, 0x01, 0x03, 0x0B, 0x00, 0x75, 
+    0x74, 0x73, 0x63, 0x68, 0x65, 0x64, 0x2E, 0x70, 
+    0x79, 0x00, 0x04, 0x05, 0x00, 0x01, 0x00, 0x00, 
+    0x00, 0x00, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 
+    0x02, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 
+    0x00, 0x64, 0x01, 0x00, 0x7D, 0x00, 0x00, 0x78, 
+    0x38, 0x00, 0x7C, 0x00, 0x00, 0x64, 0x02, 0x00, 
+    0x6A, 0x00, 0x00, 0x72, 0x40, 0x00, 0x64, 0x03, 
+    0x00, 0x74, 0x00, 0x00, 0x74, 0x01, 0x00, 0x64, 
+    0x01, 0x00, 0x19, 0x3C, 0x74, 0x01, 0x00, 0x64, 
+    0x01, 0x00, 0x63, 0x02, 0x00, 0x19, 0x64, 0x04, 
+    0x00, 0x37, 0x03, 0x3C, 0x7C, 0x00, 0x00, 0x64, 
+    0x04, 0x00, 0x37, 0x7D, 0x00, 0x00, 0x71, 0x09, 
+    0x00, 0x57, 0x64, 0x00, 0x00, 0x53, 0x00, 0x64, 
+    0x00, 0x00, 0x64, 0x00, 0x00, 0x64, 0x00, 0x00, 
+    0x64, 0x00, 0x00, 0x64, 0x00, 0x00, 0x64, 0x00, 
+    0x00, 0x64, 0x00, 0x00, 0x64, 0x00, 0x00, 0x67, 
+    0x08, 0x00, 0x5A, 0x00, 0x00, 0x64, 0x00, 0x00, 
+    0x67, 0x01, 0x00, 0x5A, 0x01, 0x00, 0x64, 0x01, 
+    0x00, 0x84, 0x00, 0x00, 0x5A, 0x02, 0x00, 0x64, 
+    0x02, 0x00, 0x84, 0x00, 0x00, 0x5A, 0x03, 0x00, 
+    0x64, 0x03, 0x00, 0x53, 
+#endif
+#if defined(HAVE_CLOSURES) && defined(HAVE_DEBUG_INFO)
+/* utsched.py */
+    0x0A, 0xAD, 0x01, 0x00, 0x40, 0x08, 0x00, 0x00, 
+    0x01, 0x00, 0x04, 0x05, 0x03, 0x03, 0x00, 0x6C, 
+    0x6F, 0x67, 0x03, 0x03, 0x00, 0x70, 0x6F, 0x73, 
+    0x03, 0x01, 0x00, 0x61, 0x03, 0x01, 0x00, 0x62, 
+    0x03, 0x07, 0x00, 0x75, 0x74, 0x73, 0x63, 0x68, 
+    0x65, 0x64, 0x03, 0x06, 0x00, 0x1E, 0x01, 0x09, 
+    0x02, 0x09, 0x07, 0x03, 0x0B, 0x00, 0x75, 0x74, 
+    0x73, 0x63, 0x68, 0x65, 0x64, 0x2E, 0x70, 0x79, 
+    0x00, 0x04, 0x04, 0x01, 0x00, 0x00, 0x00, 0x00, 
+    0x0A, 0x90, 0x00, 0x00, 0x43, 0x04, 0x01, 0x00, 
+    0x04, 0x00, 0x04, 0x03, 0x03, 0x03, 0x00, 0x6C, 
+    0x6F, 0x67, 0x03, 0x03, 0x00, 0x70, 0x6F, 0x73, 
+    0x03, 0x01, 0x00, 0x61, 0x03, 0x0A, 0x00, 0x00, 
+    0x01, 0x06, 0x01, 0x0F, 0x01, 0x0D, 0x01, 0x10, 
+    0x01, 0x03, 0x0B, 0x00, 0x75, 0x74, 0x73, 0x63, 
+    0x68, 0x65, 0x64, 0x2E, 0x70, 0x79, 0x00, 0x04, 
+    0x04, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 
+    0x04, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 
+    0x00, 0x04, 0x00, 0x64, 0x01, 0x00, 0x7D, 0x00, 
+    0x00, 0x78, 0x38, 0x00, 0x7C, 0x00, 0x00, 0x64, 
+    0x02, 0x00, 0x6A, 0x00, 0x00, 0x72, 0x40, 0x00, 
+    0x64, 0x03, 0x00, 0x74, 0x00, 0x00, 0x74, 0x01, 
+    0x00, 0x64, 0x01, 0x00, 0x19, 0x3C, 0x74, 0x01, 
+    0x00, 0x64, 0x01, 0x00, 0x63, 0x02, 0x00, 0x19, 
+    0x64, 0x03, 0x00, 0x37, 0x03, 0x3C, 0x7C, 0x00, 
+    0x00, 0x64, 0x03, 0x00, 0x37, 0x7D, 0x00, 0x00, 
+    0x71, 0x09, 0x00, 0x57, 0x64, 0x00, 0x00, 0x53, 
+    0x0A, 0x95, 0x00, 0x00, 0x43, 0x04, 0x01, 0x00, 
+    0x0B, 0x00, 0x04, 0x03, 0x03, 0x03, 0x00, 0x6C, 
+    0x6F, 0x67, 0x03, 0x03, 0x00, 0x70, 0x6F, 0x73, 
+    0x03, 0x01, 0x00, 0x62, 0x03, 0x0A, 0x00, 0x00, 
+    0x01, 0x06, 0x01, 0x0F, 0x01, 0x0D, 0x01, 0x10, 
+    0x01, 0x03, 0x0B, 0x00, 0x75, 0x74, 0x73, 0x63, 
+    0x68, 0x65, 0x64, 0x2E, 0x70, 0x79, 0x00, 0x04, 
+    0x05, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 
+    0x04, 0x00, 0x00, 0x00, 0x01, 0x02, 0x00, 0x00, 
+    0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x04, 0x00, 
+    0x64, 0x01, 0x00, 0x7D, 0x00, 0x00, 0x78, 0x38, 
+    0x00, 0x7C, 0x00, 0x00, 0x64, 0x02, 0x00, 0x6A, 
+    0x00, 0x00, 0x72, 0x40, 0x00, 0x64, 0x03, 0x00, 
+    0x74, 0x00, 0x00, 0x74, 0x01, 0x00, 0x64, 0x01, 
+    0x00, 0x19, 0x3C, 0x74, 0x01, 0x00, 0x64, 0x01, 
+    0x00, 0x63, 0x02, 0x00, 0x19, 0x64, 0x04, 0x00, 
+    0x37, 0x03, 0x3C, 0x7C, 0x00, 0x00, 0x64, 0x04, 
+    0x00, 0x37, 0x7D, 0x00, 0x00, 0x71, 0x09, 0x00, 
+    0x57, 0x64, 0x00, 0x00, 0x53, 0x00, 0x04, 0x00, 
+    0x64, 0x00, 0x00, 0x64, 0x00, 0x00, 0x64, 0x00, 
+    0x00, 0x64, 0x00, 0x00, 0x64, 0x00, 0x00, 0x64, 
+    0x00, 0x00, 0x64, 0x00, 0x00, 0x64, 0x00, 0x00, 
+    0x67, 0x08, 0x00, 0x5A, 0x00, 0x00, 0x64, 0x00, 
+    0x00, 0x67, 0x01, 0x00, 0x5A, 0x01, 0x00, 0x64, 
+    0x01, 0x00, 0x84, 0x00, 0x00, 0x5A, 0x02, 0x00, 
+    0x64, 0x02, 0x00, 0x84, 0x00, 0x00, 0x5A, 0x03, 
+    0x00, 0x64, 0x03, 0x00, 0x53, 
+#endif
+
+/* img-list-terminator */
+    0xFF, 
+};
+
+
+/**
+ * Loads test_sched_image0 and interprets its module code,
+ * which defines log, pos, a() and b().
+ * The module is pushed as a temp root so it outlives the interpreter run.
+ */
+PmReturn_t
+ut_interp_loadSched(pPmObj_t *r_pmod)
+{
+    PmReturn_t retval;
+    uint8_t const *pimg = test_sched_image0;
+    pPmObj_t pcodeobject;
+    uint8_t objid;
+
+    retval = obj_loadFromImg(MEMSPACE_PROG, &pimg, &pcodeobject);
+    PM_RETURN_IF_ERROR(retval);
+    retval = mod_new(pcodeobject, r_pmod);
+    PM_RETURN_IF_ERROR(retval);
+    heap_gcPushTempRoot(*r_pmod, &objid);
+    retval = interp_addThread((pPmFunc_t)*r_pmod);
+    PM_RETURN_IF_ERROR(retval);
+    return interpret(C_TRUE);
+}
+
+
+/** Gets the module's global with the given name */
+PmReturn_t
+ut_interp_getSchedAttr(pPmObj_t pmod, char const *name, pPmObj_t *r_pobj)
+{
+    PmReturn_t retval;
+    pPmObj_t pkey;
+
+    retval = string_new(&name, &pkey);
+    PM_RETURN_IF_ERROR(retval);
+    return dict_getItem((pPmObj_t)((pPmFunc_t)pmod)->f_attrs, pkey, r_pobj);
+}
+
+
+/** Adds a thread that runs the module's function with the given name */
+PmReturn_t
+ut_interp_addSchedThread(pPmObj_t pmod, char const *name)
+{
+    PmReturn_t retval;
+    pPmObj_t pfunc;
+
+    retval = ut_interp_getSchedAttr(pmod, name, &pfunc);
+    PM_RETURN_IF_ERROR(retval);
+    return interp_addThread((pPmFunc_t)pfunc);
+}
+
+
+#ifdef HAVE_OPSTATS
+/* Gets the count of the bytecode from the stats list; 0 if it is absent */
+static int32_t
+ut_interp_getOpCount(pPmObj_t plist, uint8_t bc)
+{
+    pPmObj_t ptup;
+    int16_t i;
+
+    for (i = 0; i < ((pPmList_t)plist)->length; i++)
+    {
+        list_getItem(plist, i, &ptup);
+        if (((pPmInt_t)((pPmTuple_t)ptup)->val[0])->val == bc)
+        {
+            return ((pPmInt_t)((pPmTuple_t)ptup)->val[1])->val;
+        }
+    }
+    return 0;
+}
+
+
+/**
+ * Tests interp_getOpStats() and interp_clearOpStats():
+ *      the list is empty after clearing
+ *      each bytecode is counted once per dispatch
+ *      the list is sorted by descending cycles
+ */
+void
+ut_interp_opstats_000(CuTest *tc)
+{
+    uint8_t heap[HEAP_SIZE];
+    PmReturn_t retval;
+    pPmObj_t pmod;
+    pPmObj_t pstats;
+    pPmObj_t plist;
+    pPmObj_t ptup;
+    int32_t cycles;
+    int16_t i;
+
+    pm_init(heap, HEAP_SIZE, MEMSPACE_RAM, C_NULL);
+    retval = ut_interp_loadSched(&pmod);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+
+    interp_clearOpStats();
+    retval = interp_getOpStats(&pstats);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc, OBJ_GET_TYPE(pstats) == OBJ_TYPE_TUP);
+    plist = ((pPmTuple_t)pstats)->val[1];
+    CuAssertTrue(tc, ((pPmList_t)plist)->length == 0);
+
+    /* Each thread loops 4 times: 5 compares and 4 backward jumps */
+    retval = ut_interp_addSchedThread(pmod, "a");
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = ut_interp_addSchedThread(pmod, "b");
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = interpret(C_TRUE);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+
+    retval = interp_getOpStats(&pstats);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    plist = ((pPmTuple_t)pstats)->val[1];
+    CuAssertTrue(tc, ut_interp_getOpCount(plist, COMPARE_OP) == 10);
+    CuAssertTrue(tc, ut_interp_getOpCount(plist, JUMP_ABSOLUTE) == 8);
+    CuAssertTrue(tc, ut_interp_getOpCount(plist, RETURN_VALUE) == 2);
+    CuAssertTrue(tc, ut_interp_getOpCount(plist, BUILD_LIST) == 0);
+
+    cycles = 0x7FFFFFFF;
+    for (i = 0; i < ((pPmList_t)plist)->length; i++)
+    {
+        list_getItem(plist, i, &ptup);
+        CuAssertTrue(tc,
+                     ((pPmInt_t)((pPmTuple_t)ptup)->val[2])->val <= cycles);
+        cycles = ((pPmInt_t)((pPmTuple_t)ptup)->val[2])->val;
+    }
+}
+#endif /* HAVE_OPSTATS */
+
+
+#ifdef HAVE_BUDGET_SCHED
+/**
+ * Tests the budget scheduler with the timer turned off:
+ *      a budget of one lets a() and b() take turns every loop
+ *      a budget of two lets them take turns every two loops
+ *      a budget larger than a loop count runs a() to its end first
+ */
+void
+ut_interp_budget_000(CuTest *tc)
+{
+    uint8_t heap[HEAP_SIZE];
+    PmReturn_t retval;
+    pPmObj_t pmod;
+    pPmObj_t plog;
+    pPmObj_t pint;
+    uint8_t i;
+    uint8_t j;
+    uint16_t const budgets[3] = {1, 2, 100};
+    int8_t const logs[3][8] =
+    {
+        {1, 2, 1, 2, 1, 2, 1, 2},
+        {1, 1, 2, 2, 1, 1, 2, 2},
+        {1, 1, 1, 1, 2, 2, 2, 2},
+    };
+
+    for (i = 0; i < 3; i++)
+    {
+        pm_init(heap, HEAP_SIZE, MEMSPACE_RAM, C_NULL);
+        gVmGlobal.budget = budgets[i];
+        gVmGlobal.budgetTimed = C_FALSE;
+        retval = ut_interp_loadSched(&pmod);
+        CuAssertTrue(tc, retval == PM_RET_OK);
+        retval = ut_interp_addSchedThread(pmod, "a");
+        CuAssertTrue(tc, retval == PM_RET_OK);
+        retval = ut_interp_addSchedThread(pmod, "b");
+        CuAssertTrue(tc, retval == PM_RET_OK);
+        retval = interpret(C_TRUE);
+        CuAssertTrue(tc, retval == PM_RET_OK);
+
+        /* log holds the order in which the threads ran their loops */
+        retval = ut_interp_getSchedAttr(pmod, "log", &plog);
+        CuAssertTrue(tc, retval == PM_RET_OK);
+        for (j = 0; j < 8; j++)
+        {
+            list_getItem(plog, j, &pint);
+            CuAssertTrue(tc, ((pPmInt_t)pint)->val == logs[i][j]);
+        }
+    }
+}
+
+
+/**
+ * Tests that a thread's timeslice starts with the whole budget:
+ *      the first thread scheduled gets the whole budget
+ *      when a thread sleeps part way through its timeslice
+ *      (as sys.sleep() does), the next thread gets the whole budget
+ */
+void
+ut_interp_budget_001(CuTest *tc)
+{
+    uint8_t heap[HEAP_SIZE];
+    PmReturn_t retval;
+    pPmObj_t pmod;
+    pPmObj_t pb;
+    pPmThread_t pthread;
+
+    pm_init(heap, HEAP_SIZE, MEMSPACE_RAM, C_NULL);
+    gVmGlobal.budget = 3;
+    gVmGlobal.budgetTimed = C_FALSE;
+    retval = ut_interp_loadSched(&pmod);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = ut_interp_getSchedAttr(pmod, "b", &pb);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = ut_interp_addSchedThread(pmod, "a");
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = ut_interp_addSchedThread(pmod, "b");
+    CuAssertTrue(tc, retval == PM_RET_OK);
+
+    retval = interp_reschedule();
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc, gVmGlobal.budgetLeft == 3);
+
+    /* a() spends part of its budget, then sleeps like sys.sleep() */
+    gVmGlobal.budgetLeft = 1;
+    pthread = gVmGlobal.pthread;
+    retval = thread_dequeue(pthread);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = thread_sleep(pthread, 1000);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    interp_setRescheduleFlag((uint8_t)1);
+
+    retval = interp_reschedule();
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc, gVmGlobal.pthread->pframe->fo_func == (pPmFunc_t)pb);
+    CuAssertTrue(tc, gVmGlobal.budgetLeft == 3);
+
+    /* Leave no thread for the timer tick */
+    gVmGlobal.pthread = C_NULL;
+}
+#endif /* HAVE_BUDGET_SCHED */
+
+
 /** Make a suite from all tests in this file */
 CuSuite *getSuite_testInterp(void)
 {
     CuSuite* suite = CuSuiteNew();
 
     SUITE_ADD_TEST(suite, ut_interp_interpret_000);
+#ifdef HAVE_OPSTATS
+    SUITE_ADD_TEST(suite, ut_interp_opstats_000);
+#endif /* HAVE_OPSTATS */
+#ifdef HAVE_BUDGET_SCHED
+    SUITE_ADD_TEST(suite, ut_interp_budget_000);
+    SUITE_ADD_TEST(suite, ut_interp_budget_001);
+#endif /* HAVE_BUDGET_SCHED */
 
     return suite;
 }
@@ -0,0 +1,700 @@
+/*
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+*/
+
+
+/**
+ * JIT Unit Tests
+ * Tests that compiled loops compute what the interpreter computes.
+ */
+
+
+#include "CuTest.h"
+#include "pm.h"
+
+
+#define HEAP_SIZE 0x2000
+
+
+#ifdef HAVE_JIT
+/* See ut_interp.c */
+PmReturn_t ut_interp_getSchedAttr(pPmObj_t pmod, char const *name,
+                                  pPmObj_t *r_pobj);
+PmReturn_t ut_interp_addSchedThread(pPmObj_t pmod, char const *name);
+
+
+/**
+ * The following source code was compiled to an image using pmImgCreator.py
+ * using this command line:
+ *
+ *      ../../tools/pmImgCreator.py -f pmfeatures.py -c -s -o utjit.img.c utjit.py
+ *
+
+res = [0, 0]
+log = [0, 0]
+pos = [0]
+
+def c():
+    i = 0
+    s = 0
+    while i < 1000:
+        s = s + i * 2 - 1
+        i += 1
+    res[0] = s
+
+def f():
+    i = 0
+    s = 0
+    while i < 100:
+        if i == 80:
+            s = s + 0.5
+        s = s + 1
+        i += 1
+    res[1] = s
+
+def e():
+    i = 0
+    s = 0
+    while i < 100:
+        if i == 80:
+            s = s + "a"
+        s = s + 1
+        i += 1
+
+def a():
+    i = 0
+    while i < 1000:
+        i += 1
+    log[pos[0]] = 1
+    pos[0] += 1
+
+def b():
+    i = 0
+    while i < 10:
+        i += 1
+    log[pos[0]] = 2
+    pos[0] += 1
+
+ */
+static uint8_t const test_jit_image0[] =
+{
+#if !defined(HAVE_CLOSURES) && !defined(HAVE_DEBUG_INFO)
+/* utjit.py */
+    0x0A, 0xE4, 0x02, 0x00, 0x40, 0x02, 0x00, 0x04, 
+    0x09, 0x03, 0x03, 0x00, 0x72, 0x65, 0x73, 0x03, 
+    0x03, 0x00, 0x6C, 0x6F, 0x67, 0x03, 0x03, 0x00, 
+    0x70, 0x6F, 0x73, 0x03, 0x01, 0x00, 0x63, 0x03, 
+    0x01, 0x00, 0x66, 0x03, 0x01, 0x00, 0x65, 0x03, 
+    0x01, 0x00, 0x61, 0x03, 0x01, 0x00, 0x62, 0x03, 
+    0x05, 0x00, 0x75, 0x74, 0x6A, 0x69, 0x74, 0x04, 
+    0x07, 0x01, 0x00, 0x00, 0x00, 0x00, 0x0A, 0x73, 
+    0x00, 0x00, 0x43, 0x03, 0x02, 0x04, 0x02, 0x03, 
+    0x03, 0x00, 0x72, 0x65, 0x73, 0x03, 0x01, 0x00, 
+    0x63, 0x04, 0x05, 0x00, 0x01, 0x00, 0x00, 0x00, 
+    0x00, 0x01, 0xE8, 0x03, 0x00, 0x00, 0x01, 0x02, 
+    0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 
+    0x64, 0x01, 0x00, 0x7D, 0x00, 0x00, 0x64, 0x01, 
+    0x00, 0x7D, 0x01, 0x00, 0x78, 0x2C, 0x00, 0x7C, 
+    0x00, 0x00, 0x64, 0x02, 0x00, 0x6A, 0x00, 0x00, 
+    0x72, 0x3A, 0x00, 0x7C, 0x01, 0x00, 0x7C, 0x00, 
+    0x00, 0x64, 0x03, 0x00, 0x14, 0x17, 0x64, 0x04, 
+    0x00, 0x18, 0x7D, 0x01, 0x00, 0x7C, 0x00, 0x00, 
+    0x64, 0x04, 0x00, 0x37, 0x7D, 0x00, 0x00, 0x71, 
+    0x0F, 0x00, 0x57, 0x7C, 0x01, 0x00, 0x74, 0x00, 
+    0x00, 0x64, 0x01, 0x00, 0x3C, 0x64, 0x00, 0x00, 
+    0x53, 0x0A, 0x86, 0x00, 0x00, 0x43, 0x03, 0x02, 
+    0x04, 0x02, 0x03, 0x03, 0x00, 0x72, 0x65, 0x73, 
+    0x03, 0x01, 0x00, 0x66, 0x04, 0x06, 0x00, 0x01, 
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x64, 0x00, 0x00, 
+    0x00, 0x01, 0x50, 0x00, 0x00, 0x00, 0x02, 0x00, 
+    0x00, 0x00, 0x3F, 0x01, 0x01, 0x00, 0x00, 0x00, 
+    0x64, 0x01, 0x00, 0x7D, 0x00, 0x00, 0x64, 0x01, 
+    0x00, 0x7D, 0x01, 0x00, 0x78, 0x3A, 0x00, 0x7C, 
+    0x00, 0x00, 0x64, 0x02, 0x00, 0x6A, 0x00, 0x00, 
+    0x72, 0x48, 0x00, 0x7C, 0x00, 0x00, 0x64, 0x03, 
+    0x00, 0x6A, 0x02, 0x00, 0x72, 0x31, 0x00, 0x7C, 
+    0x01, 0x00, 0x64, 0x04, 0x00, 0x17, 0x7D, 0x01, 
+    0x00, 0x7C, 0x01, 0x00, 0x64, 0x05, 0x00, 0x17, 
+    0x7D, 0x01, 0x00, 0x7C, 0x00, 0x00, 0x64, 0x05, 
+    0x00, 0x37, 0x7D, 0x00, 0x00, 0x71, 0x0F, 0x00, 
+    0x57, 0x7C, 0x01, 0x00, 0x74, 0x00, 0x00, 0x64, 
+    0x05, 0x00, 0x3C, 0x64, 0x00, 0x00, 0x53, 0x0A, 
+    0x75, 0x00, 0x00, 0x43, 0x02, 0x02, 0x04, 0x01, 
+    0x03, 0x01, 0x00, 0x65, 0x04, 0x06, 0x00, 0x01, 
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x64, 0x00, 0x00, 
+    0x00, 0x01, 0x50, 0x00, 0x00, 0x00, 0x03, 0x01, 
+    0x00, 0x61, 0x01, 0x01, 0x00, 0x00, 0x00, 0x64, 
+    0x01, 0x00, 0x7D, 0x00, 0x00, 0x64, 0x01, 0x00, 
+    0x7D, 0x01, 0x00, 0x78, 0x3A, 0x00, 0x7C, 0x00, 
+    0x00, 0x64, 0x02, 0x00, 0x6A, 0x00, 0x00, 0x72, 
+    0x48, 0x00, 0x7C, 0x00, 0x00, 0x64, 0x03, 0x00, 
+    0x6A, 0x02, 0x00, 0x72, 0x31, 0x00, 0x7C, 0x01, 
+    0x00, 0x64, 0x04, 0x00, 0x17, 0x7D, 0x01, 0x00, 
+    0x7C, 0x01, 0x00, 0x64, 0x05, 0x00, 0x17, 0x7D, 
+    0x01, 0x00, 0x7C, 0x00, 0x00, 0x64, 0x05, 0x00, 
+    0x37, 0x7D, 0x00, 0x00, 0x71, 0x0F, 0x00, 0x57, 
+    0x64, 0x00, 0x00, 0x53, 0x0A, 0x70, 0x00, 0x00, 
+    0x43, 0x04, 0x01, 0x04, 0x03, 0x03, 0x03, 0x00, 
+    0x6C, 0x6F, 0x67, 0x03, 0x03, 0x00, 0x70, 0x6F, 
+    0x73, 0x03, 0x01, 0x00, 0x61, 0x04, 0x04, 0x00, 
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 0xE8, 0x03, 
+    0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x64, 
+    0x01, 0x00, 0x7D, 0x00, 0x00, 0x78, 0x1A, 0x00, 
+    0x7C, 0x00, 0x00, 0x64, 0x02, 0x00, 0x6A, 0x00, 
+    0x00, 0x72, 0x22, 0x00, 0x7C, 0x00, 0x00, 0x64, 
+    0x03, 0x00, 0x37, 0x7D, 0x00, 0x00, 0x71, 0x09, 
+    0x00, 0x57, 0x64, 0x03, 0x00, 0x74, 0x00, 0x00, 
+    0x74, 0x01, 0x00, 0x64, 0x01, 0x00, 0x19, 0x3C, 
+    0x74, 0x01, 0x00, 0x64, 0x01, 0x00, 0x63, 0x02, 
+    0x00, 0x19, 0x64, 0x03, 0x00, 0x37, 0x03, 0x3C, 
+    0x64, 0x00, 0x00, 0x53, 0x0A, 0x75, 0x00, 0x00, 
+    0x43, 0x04, 0x01, 0x04, 0x03, 0x03, 0x03, 0x00, 
+    0x6C, 0x6F, 0x67, 0x03, 0x03, 0x00, 0x70, 0x6F, 
+    0x73, 0x03, 0x01, 0x00, 0x62, 0x04, 0x05, 0x00, 
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 0x0A, 0x00, 
+    0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x01, 
+    0x02, 0x00, 0x00, 0x00, 0x64, 0x01, 0x00, 0x7D, 
+    0x00, 0x00, 0x78, 0x1A, 0x00, 0x7C, 0x00, 0x00, 
+    0x64, 0x02, 0x00, 0x6A, 0x00, 0x00, 0x72, 0x22, 
+    0x00, 0x7C, 0x00, 0x00, 0x64, 0x03, 0x00, 0x37, 
+    0x7D, 0x00, 0x00, 0x71, 0x09, 0x00, 0x57, 0x64, 
+    0x04, 0x00, 0x74, 0x00, 0x00, 0x74, 0x01, 0x00, 
+    0x64, 0x01, 0x00, 0x19, 0x3C, 0x74, 0x01, 0x00, 
+    0x64, 0x01, 0x00, 0x63, 0x02, 0x00, 0x19, 0x64, 
+    0x03, 0x00, 0x37, 0x03, 0x3C, 0x64, 0x00, 0x00, 
+    0x53, 0x00, 0x64, 0x00, 0x00, 0x64, 0x00, 0x00, 
+    0x67, 0x02, 0x00, 0x5A, 0x00, 0x00, 0x64, 0x00, 
+    0x00, 0x64, 0x00, 0x00, 0x67, 0x02, 0x00, 0x5A, 
+    0x01, 0x00, 0x64, 0x00, 0x00, 0x67, 0x01, 0x00, 
+    0x5A, 0x02, 0x00, 0x64, 0x01, 0x00, 0x84, 0x00, 
+    0x00, 0x5A, 0x03, 0x00, 0x64, 0x02, 0x00, 0x84, 
+    0x00, 0x00, 0x5A, 0x04, 0x00, 0x64, 0x03, 0x00, 
+    0x84, 0x00, 0x00, 0x5A, 0x05, 0x00, 0x64, 0x04, 
+    0x00, 0x84, 0x00, 0x00, 0x5A, 0x06, 0x00, 0x64, 
+    0x05, 0x00, 0x84, 0x00, 0x00, 0x5A, 0x07, 0x00, 
+    0x64, 0x06, 0x00, 0x53,
+#endif
+#if defined(HAVE_CLOSURES) && !defined(HAVE_DEBUG_INFO)
+/* utjit.py */
+    0x0A, 0xF6, 0x02, 0x00, 0x40, 0x02, 0x00, 0x00, 
+    0x04, 0x09, 0x03, 0x03, 0x00, 0x72, 0x65, 0x73, 
+    0x03, 0x03, 0x00, 0x6C, 0x6F, 0x67, 0x03, 0x03, 
+    0x00, 0x70, 0x6F, 0x73, 0x03, 0x01, 0x00, 0x63, 
+    0x03, 0x01, 0x00, 0x66, 0x03, 0x01, 0x00, 0x65, 
+    0x03, 0x01, 0x00, 0x61, 0x03, 0x01, 0x00, 0x62, 
+    0x03, 0x05, 0x00, 0x75, 0x74, 0x6A, 0x69, 0x74, 
+    0x04, 0x07, 0x01, 0x00, 0x00, 0x00, 0x00, 0x0A, 
+    0x76, 0x00, 0x00, 0x43, 0x03, 0x02, 0x00, 0x04, 
+    0x02, 0x03, 0x03, 0x00, 0x72, 0x65, 0x73, 0x03, 
+    0x01, 0x00, 0x63, 0x04, 0x05, 0x00, 0x01, 0x00, 
+    0x00, 0x00, 0x00, 0x01, 0xE8, 0x03, 0x00, 0x00, 
+    0x01, 0x02, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 
+    0x00, 0x00, 0x04, 0x00, 0x64, 0x01, 0x00, 0x7D, 
+    0x00, 0x00, 0x64, 0x01, 0x00, 0x7D, 0x01, 0x00, 
+    0x78, 0x2C, 0x00, 0x7C, 0x00, 0x00, 0x64, 0x02, 
+    0x00, 0x6A, 0x00, 0x00, 0x72, 0x3A, 0x00, 0x7C, 
+    0x01, 0x00, 0x7C, 0x00, 0x00, 0x64, 0x03, 0x00, 
+    0x14, 0x17, 0x64, 0x04, 0x00, 0x18, 0x7D, 0x01, 
+    0x00, 0x7C, 0x00, 0x00, 0x64, 0x04, 0x00, 0x37, 
+    0x7D, 0x00, 0x00, 0x71, 0x0F, 0x00, 0x57, 0x7C, 
+    0x01, 0x00, 0x74, 0x00, 0x00, 0x64, 0x01, 0x00, 
+    0x3C, 0x64, 0x00, 0x00, 0x53, 0x0A, 0x89, 0x00, 
+    0x00, 0x43, 0x03, 0x02, 0x00, 0x04, 0x02, 0x03, 
+    0x03, 0x00, 0x72, 0x65, 0x73, 0x03, 0x01, 0x00, 
+    0x66, 0x04, 0x06, 0x00, 0x01, 0x00, 0x00, 0x00, 
+    0x00, 0x01, 0x64, 0x00, 0x00, 0x00, 0x01, 0x50, 
+    0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x3F, 
+    0x01, 0x01, 0x00, 0x00, 0x00, 0x04, 0x00, 0x64, 
+    0x01, 0x00, 0x7D, 0x00, 0x00, 0x64, 0x01, 0x00, 
+    0x7D, 0x01, 0x00, 0x78, 0x3A, 0x00, 0x7C, 0x00, 
+    0x00, 0x64, 0x02, 0x00, 0x6A, 0x00, 0x00, 0x72, 
+    0x48, 0x00, 0x7C, 0x00, 0x00, 0x64, 0x03, 0x00, 
+    0x6A, 0x02, 0x00, 0x72, 0x31, 0x00, 0x7C, 0x01, 
+    0x00, 0x64, 0x04, 0x00, 0x17, 0x7D, 0x01, 0x00, 
+    0x7C, 0x01, 0x00, 0x64, 0x05, 0x00, 0x17, 0x7D, 
+    0x01, 0x00, 0x7C, 0x00, 0x00, 0x64, 0x05, 0x00, 
+    0x37, 0x7D, 0x00, 0x00, 0x71, 0x0F, 0x00, 0x57, 
+    0x7C, 0x01, 0x00, 0x74, 0x00, 0x00, 0x64, 0x05, 
+    0x00, 0x3C, 0x64, 0x00, 0x00, 0x53, 0x0A, 0x78, 
+    0x00, 0x00, 0x43, 0x02, 0x02, 0x00, 0x04, 0x01, 
+    0x03, 0x01, 0x00, 0x65, 0x04, 0x06, 0x00, 0x01, 
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x64, 0x00, 0x00, 
+    0x00, 0x01, 0x50, 0x00, 0x00, 0x00, 0x03, 0x01, 
+    0x00, 0x61, 0x01, 0x01, 0x00, 0x00, 0x00, 0x04, 
+    0x00, 0x64, 0x01, 0x00, 0x7D, 0x00, 0x00, 0x64, 
+    0x01, 0x00, 0x7D, 0x01, 0x00, 0x78, 0x3A, 0x00, 
+    0x7C, 0x00, 0x00, 0x64, 0x02, 0x00, 0x6A, 0x00, 
+    0x00, 0x72, 0x48, 0x00, 0x7C, 0x00, 0x00, 0x64, 
+    0x03, 0x00, 0x6A, 0x02, 0x00, 0x72, 0x31, 0x00, 
+    0x7C, 0x01, 0x00, 0x64, 0x04, 0x00, 0x17, 0x7D, 
+    0x01, 0x00, 0x7C, 0x01, 0x00, 0x64, 0x05, 0x00, 
+    0x17, 0x7D, 0x01, 0x00, 0x7C, 0x00, 0x00, 0x64, 
+    0x05, 0x00, 0x37, 0x7D, 0x00, 0x00, 0x71, 0x0F, 
+    0x00, 0x57, 0x64, 0x00, 0x00, 0x53, 0x0A, 0x73, 
+    0x00, 0x00, 0x43, 0x04, 0x01, 0x00, 0x04, 0x03, 
+    0x03, 0x03, 0x00, 0x6C, 0x6F, 0x67, 0x03, 0x03, 
+    0x00, 0x70, 0x6F, 0x73, 0x03, 0x01, 0x00, 0x61, 
+    0x04, 0x04, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 
+    0x01, 0xE8, 0x03, 0x00, 0x00, 0x01, 0x01, 0x00, 
+    0x00, 0x00, 0x04, 0x00, 0x64, 0x01, 0x00, 0x7D, 
+    0x00, 0x00, 0x78, 0x1A, 0x00, 0x7C, 0x00, 0x00, 
+    0x64, 0x02, 0x00, 0x6A, 0x00, 0x00, 0x72, 0x22, 
+    0x00, 0x7C, 0x00, 0x00, 0x64, 0x03, 0x00, 0x37, 
+    0x7D, 0x00, 0x00, 0x71, 0x09, 0x00, 0x57, 0x64, 
+    0x03, 0x00, 0x74, 0x00, 0x00, 0x74, 0x01, 0x00, 
+    0x64, 0x01, 0x00, 0x19, 0x3C, 0x74, 0x01, 0x00, 
+    0x64, 0x01, 0x00, 0x63, 0x02, 0x00, 0x19, 0x64, 
+    0x03, 0x00, 0x37, 0x03, 0x3C, 0x64, 0x00, 0x00, 
+    0x53, 0x0A, 0x78, 0x00, 0x00, 0x43, 0x04, 0x01, 
+    0x00, 0x04, 0x03, 0x03, 0x03, 0x00, 0x6C, 0x6F, 
+    0x67, 0x03, 0x03, 0x00, 0x70, 0x6F, 0x73, 0x03, 
+    0x01, 0x00, 0x62, 0x04, 0x05, 0x00, 0x01, 0x00, 
+    0x00, 0x00, 0x00, 0x01, 0x0A, 0x00, 0x00, 0x00, 
+    0x01, 0x01, 0x00, 0x00, 0x00, 0x01, 0x02, 0x00, 
+    0x00, 0x00, 0x04, 0x00, 0x64, 0x01, 0x00, 0x7D, 
+    0x00, 0x00, 0x78, 0x1A, 0x00, 0x7C, 0x00, 0x00, 
+    0x64, 0x02, 0x00, 0x6A, 0x00, 0x00, 0x72, 0x22, 
+    0x00, 0x7C, 0x00, 0x00, 0x64, 0x03, 0x00, 0x37, 
+    0x7D, 0x00, 0x00, 0x71, 0x09, 0x00, 0x57, 0x64, 
+    0x04, 0x00, 0x74, 0x00, 0x00, 0x74, 0x01, 0x00, 
+    0x64, 0x01, 0x00, 0x19, 0x3C, 0x74, 0x01, 0x00, 
+    0x64, 0x01, 0x00, 0x63, 0x02, 0x00, 0x19, 0x64, 
+    0x03, 0x00, 0x37, 0x03, 0x3C, 0x64, 0x00, 0x00, 
+    0x53, 0x00, 0x04, 0x00, 0x64, 0x00, 0x00, 0x64, 
+    0x00, 0x00, 0x67, 0x02, 0x00, 0x5A, 0x00, 0x00, 
+    0x64, 0x00, 0x00, 0x64, 0x00, 0x00, 0x67, 0x02, 
+    0x00, 0x5A, 0x01, 0x00, 0x64, 0x00, 0x00, 0x67, 
+    0x01, 0x00, 0x5A, 0x02, 0x00, 0x64, 0x01, 0x00, 
+    0x84, 0x00, 0x00, 0x5A, 0x03, 0x00, 0x64, 0x02, 
+    0x00, 0x84, 0x00, 0x00, 0x5A, 0x04, 0x00, 0x64, 
+    0x03, 0x00, 0x84, 0x00, 0x00, 0x5A, 0x05, 0x00, 
+    0x64, 0x04, 0x00, 0x84, 0x00, 0x00, 0x5A, 0x06, 
+    0x00, 0x64, 0x05, 0x00, 0x84, 0x00, 0x00, 0x5A, 
+    0x07, 0x00, 0x64, 0x06, 0x00, 0x53,
+#endif
+#if !defined(HAVE_CLOSURES) && defined(HAVE_DEBUG_INFO)
+/* utjit.py */
+    0x0A, 0x96, 0x03, 0x00, 0x40, 0x02, 0x00, 0x01, 
+    0x00, 0x04, 0x09, 0x03, 0x03, 0x00, 0x72, 0x65, 
+    0x73, 0x03, 0x03, 0x00, 0x6C, 0x6F, 0x67, 0x03, 
+    0x03, 0x00, 0x70, 0x6F, 0x73, 0x03, 0x01, 0x00, 
+    0x63, 0x03, 0x01, 0x00, 0x66, 0x03, 0x01, 0x00, 
+    0x65, 0x03, 0x01, 0x00, 0x61, 0x03, 0x01, 0x00, 
+    0x62, 0x03, 0x05, 0x00, 0x75, 0x74, 0x6A, 0x69, 
+    0x74, 0x03, 0x0E, 0x00, 0x0C, 0x01, 0x0C, 0x01, 
+    0x09, 0x02, 0x09, 0x08, 0x09, 0x0A, 0x09, 0x09, 
+    0x09, 0x07, 0x03, 0x09, 0x00, 0x75, 0x74, 0x6A, 
+    0x69, 0x74, 0x2E, 0x70, 0x79, 0x00, 0x04, 0x07, 
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x0A, 0x90, 0x00, 
+    0x00, 0x43, 0x03, 0x02, 0x05, 0x00, 0x04, 0x02, 
+    0x03, 0x03, 0x00, 0x72, 0x65, 0x73, 0x03, 0x01, 
+    0x00, 0x63, 0x03, 0x0C, 0x00, 0x00, 0x01, 0x06, 
+    0x01, 0x06, 0x01, 0x0F, 0x01, 0x12, 0x01, 0x0D, 
+    0x01, 0x03, 0x09, 0x00, 0x75, 0x74, 0x6A, 0x69, 
+    0x74, 0x2E, 0x70, 0x79, 0x00, 0x04, 0x05, 0x00, 
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 0xE8, 0x03, 
+    0x00, 0x00, 0x01, 0x02, 0x00, 0x00, 0x00, 0x01, 
+    0x01, 0x00, 0x00, 0x00, 0x64, 0x01, 0x00, 0x7D, 
+    0x00, 0x00, 0x64, 0x01, 0x00, 0x7D, 0x01, 0x00, 
+    0x78, 0x2C, 0x00, 0x7C, 0x00, 0x00, 0x64, 0x02, 
+    0x00, 0x6A, 0x00, 0x00, 0x72, 0x3A, 0x00, 0x7C, 
+    0x01, 0x00, 0x7C, 0x00, 0x00, 0x64, 0x03, 0x00, 
+    0x14, 0x17, 0x64, 0x04, 0x00, 0x18, 0x7D, 0x01, 
+    0x00, 0x7C, 0x00, 0x00, 0x64, 0x04, 0x00, 0x37, 
+    0x7D, 0x00, 0x00, 0x71, 0x0F, 0x00, 0x57, 0x7C, 
+    0x01, 0x00, 0x74, 0x00, 0x00, 0x64, 0x01, 0x00, 
+    0x3C, 0x64, 0x00, 0x00, 0x53, 0x0A, 0xA7, 0x00, 
+    0x00, 0x43, 0x03, 0x02, 0x0D, 0x00, 0x04, 0x02, 
+    0x03, 0x03, 0x00, 0x72, 0x65, 0x73, 0x03, 0x01, 
+    0x00, 0x66, 0x03, 0x10, 0x00, 0x00, 0x01, 0x06, 
+    0x01, 0x06, 0x01, 0x0F, 0x01, 0x0C, 0x01, 0x0A, 
+    0x01, 0x0A, 0x01, 0x0D, 0x01, 0x03, 0x09, 0x00, 
+    0x75, 0x74, 0x6A, 0x69, 0x74, 0x2E, 0x70, 0x79, 
+    0x00, 0x04, 0x06, 0x00, 0x01, 0x00, 0x00, 0x00, 
+    0x00, 0x01, 0x64, 0x00, 0x00, 0x00, 0x01, 0x50, 
+    0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x3F, 
+    0x01, 0x01, 0x00, 0x00, 0x00, 0x64, 0x01, 0x00, 
+    0x7D, 0x00, 0x00, 0x64, 0x01, 0x00, 0x7D, 0x01, 
+    0x00, 0x78, 0x3A, 0x00, 0x7C, 0x00, 0x00, 0x64, 
+    0x02, 0x00, 0x6A, 0x00, 0x00, 0x72, 0x48, 0x00, 
+    0x7C, 0x00, 0x00, 0x64, 0x03, 0x00, 0x6A, 0x02, 
+    0x00, 0x72, 0x31, 0x00, 0x7C, 0x01, 0x00, 0x64, 
+    0x04, 0x00, 0x17, 0x7D, 0x01, 0x00, 0x7C, 0x01, 
+    0x00, 0x64, 0x05, 0x00, 0x17, 0x7D, 0x01, 0x00, 
+    0x7C, 0x00, 0x00, 0x64, 0x05, 0x00, 0x37, 0x7D, 
+    0x00, 0x00, 0x71, 0x0F, 0x00, 0x57, 0x7C, 0x01, 
+    0x00, 0x74, 0x00, 0x00, 0x64, 0x05, 0x00, 0x3C, 
+    0x64, 0x00, 0x00, 0x53, 0x0A, 0x94, 0x00, 0x00, 
+    0x43, 0x02, 0x02, 0x17, 0x00, 0x04, 0x01, 0x03, 
+    0x01, 0x00, 0x65, 0x03, 0x0E, 0x00, 0x00, 0x01, 
+    0x06, 0x01, 0x06, 0x01, 0x0F, 0x01, 0x0C, 0x01, 
+    0x0A, 0x01, 0x0A, 0x01, 0x03, 0x09, 0x00, 0x75, 
+    0x74, 0x6A, 0x69, 0x74, 0x2E, 0x70, 0x79, 0x00, 
+    0x04, 0x06, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 
+    0x01, 0x64, 0x00, 0x00, 0x00, 0x01, 0x50, 0x00, 
+    0x00, 0x00, 0x03, 0x01, 0x00, 0x61, 0x01, 0x01, 
+    0x00, 0x00, 0x00, 0x64, 0x01, 0x00, 0x7D, 0x00, 
+    0x00, 0x64, 0x01, 0x00, 0x7D, 0x01, 0x00, 0x78, 
+    0x3A, 0x00, 0x7C, 0x00, 0x00, 0x64, 0x02, 0x00, 
+    0x6A, 0x00, 0x00, 0x72, 0x48, 0x00, 0x7C, 0x00, 
+    0x00, 0x64, 0x03, 0x00, 0x6A, 0x02, 0x00, 0x72, 
+    0x31, 0x00, 0x7C, 0x01, 0x00, 0x64, 0x04, 0x00, 
+    0x17, 0x7D, 0x01, 0x00, 0x7C, 0x01, 0x00, 0x64, 
+    0x05, 0x00, 0x17, 0x7D, 0x01, 0x00, 0x7C, 0x00, 
+    0x00, 0x64, 0x05, 0x00, 0x37, 0x7D, 0x00, 0x00, 
+    0x71, 0x0F, 0x00, 0x57, 0x64, 0x00, 0x00, 0x53, 
+    0x0A, 0x8B, 0x00, 0x00, 0x43, 0x04, 0x01, 0x20, 
+    0x00, 0x04, 0x03, 0x03, 0x03, 0x00, 0x6C, 0x6F, 
+    0x67, 0x03, 0x03, 0x00, 0x70, 0x6F, 0x73, 0x03, 
+    0x01, 0x00, 0x61, 0x03, 0x0A, 0x00, 0x00, 0x01, 
+    0x06, 0x01, 0x0F, 0x01, 0x0D, 0x01, 0x0E, 0x01, 
+    0x03, 0x09, 0x00, 0x75, 0x74, 0x6A, 0x69, 0x74, 
+    0x2E, 0x70, 0x79, 0x00, 0x04, 0x04, 0x00, 0x01, 
+    0x00, 0x00, 0x00, 0x00, 0x01, 0xE8, 0x03, 0x00, 
+    0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x64, 0x01, 
+    0x00, 0x7D, 0x00, 0x00, 0x78, 0x1A, 0x00, 0x7C, 
+    0x00, 0x00, 0x64, 0x02, 0x00, 0x6A, 0x00, 0x00, 
+    0x72, 0x22, 0x00, 0x7C, 0x00, 0x00, 0x64, 0x03, 
+    0x00, 0x37, 0x7D, 0x00, 0x00, 0x71, 0x09, 0x00, 
+    0x57, 0x64, 0x03, 0x00, 0x74, 0x00, 0x00, 0x74, 
+    0x01, 0x00, 0x64, 0x01, 0x00, 0x19, 0x3C, 0x74, 
+    0x01, 0x00, 0x64, 0x01, 0x00, 0x63, 0x02, 0x00, 
+    0x19, 0x64, 0x03, 0x00, 0x37, 0x03, 0x3C, 0x64, 
+    0x00, 0x00, 0x53, 0x0A, 0x90, 0x00, 0x00, 0x43, 
+    0x04, 0x01, 0x27, 0x00, 0x04, 0x03, 0x03, 0x03, 
+    0x00, 0x6C, 0x6F, 0x67, 0x03, 0x03, 0x00, 0x70, 
+    0x6F, 0x73, 0x03, 0x01, 0x00, 0x62, 0x03, 0x0A, 
+    0x00, 0x00, 0x01, 0x06, 0x01, 0x0F, 0x01, 0x0D, 
+    0x01, 0x0E, 0x01, 0x03, 0x09, 0x00, 0x75, 0x74, 
+    0x6A, 0x69, 0x74, 0x2E, 0x70, 0x79, 0x00, 0x04, 
+    0x05, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 
+    0x0A, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 
+    0x00, 0x01, 0x02, 0x00, 0x00, 0x00, 0x64, 0x01, 
+    0x00, 0x7D, 0x00, 0x00, 0x78, 0x1A, 0x00, 0x7C, 
+    0x00, 0x00, 0x64, 0x02, 0x00, 0x6A, 0x00, 0x00, 
+    0x72, 0x22, 0x00, 0x7C, 0x00, 0x00, 0x64, 0x03, 
+    0x00, 0x37, 0x7D, 0x00, 0x00, 0x71, 0x09, 0x00, 
+    0x57, 0x64, 0x04, 0x00, 0x74, 0x00, 0x00, 0x74, 
+    0x01, 0x00, 0x64, 0x01, 0x00, 0x19, 0x3C, 0x74, 
+    0x01, 0x00, 0x64, 0x01, 0x00, 0x63, 0x02, 0x00, 
+    0x19, 0x64, 0x03, 0x00, 0x37, 0x03, 0x3C, 0x64, 
+    0x00, 0x00, 0x53, 0x00, 0x64, 0x00, 0x00, 0x64, 
+    0x00, 0x00, 0x67, 0x02, 0x00, 0x5A, 0x00, 0x00, 
+    0x64, 0x00, 0x00, 0x64, 0x00, 0x00, 0x67, 0x02, 
+    0x00, 0x5A, 0x01, 0x00, 0x64, 0x00, 0x00, 0x67, 
+    0x01, 0x00, 0x5A, 0x02, 0x00, 0x64, 0x01, 0x00, 
+    0x84, 0x00, 0x00, 0x5A, 0x03, 0x00, 0x64, 0x02, 
+    0x00, 0x84, 0x00, 0x00, 0x5A, 0x04, 0x00, 0x64, 
+    0x03, 0x00, 0x84, 0x00, 0x00, 0x5A, 0x05, 0x00, 
+    0x64, 0x04, 0x00, 0x84, 0x00, 0x00, 0x5A, 0x06, 
+    0x00, 0x64, 0x05, 0x00, 0x84, 0x00, 0x00, 0x5A, 
+    0x07, 0x00, 0x64, 0x06, 0x00, 0x53,
+#endif
+#if defined(HAVE_CLOSURES) && defined(HAVE_DEBUG_INFO)
+/* utjit.py */
+    0x0A, 0xA8, 0x03, 0x00, 0x40, 0x02, 0x00, 0x00, 
+    0x01, 0x00, 0x04, 0x09, 0x03, 0x03, 0x00, 0x72, 
+    0x65, 0x73, 0x03, 0x03, 0x00, 0x6C, 0x6F, 0x67, 
+    0x03, 0x03, 0x00, 0x70, 0x6F, 0x73, 0x03, 0x01, 
+    0x00, 0x63, 0x03, 0x01, 0x00, 0x66, 0x03, 0x01, 
+    0x00, 0x65, 0x03, 0x01, 0x00, 0x61, 0x03, 0x01, 
+    0x00, 0x62, 0x03, 0x05, 0x00, 0x75, 0x74, 0x6A, 
+    0x69, 0x74, 0x03, 0x0E, 0x00, 0x0C, 0x01, 0x0C, 
+    0x01, 0x09, 0x02, 0x09, 0x08, 0x09, 0x0A, 0x09, 
+    0x09, 0x09, 0x07, 0x03, 0x09, 0x00, 0x75, 0x74, 
+    0x6A, 0x69, 0x74, 0x2E, 0x70, 0x79, 0x00, 0x04, 
+    0x07, 0x01, 0x00, 0x00, 0x00, 0x00, 0x0A, 0x93, 
+    0x00, 0x00, 0x43, 0x03, 0x02, 0x00, 0x05, 0x00, 
+    0x04, 0x02, 0x03, 0x03, 0x00, 0x72, 0x65, 0x73, 
+    0x03, 0x01, 0x00, 0x63, 0x03, 0x0C, 0x00, 0x00, 
+    0x01, 0x06, 0x01, 0x06, 0x01, 0x0F, 0x01, 0x12, 
+    0x01, 0x0D, 0x01, 0x03, 0x09, 0x00, 0x75, 0x74, 
+    0x6A, 0x69, 0x74, 0x2E, 0x70, 0x79, 0x00, 0x04, 
+    0x05, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 
+    0xE8, 0x03, 0x00, 0x00, 0x01, 0x02, 0x00, 0x00, 
+    0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x04, 0x00, 
+    0x64, 0x01, 0x00, 0x7D, 0x00, 0x00, 0x64, 0x01, 
+    0x00, 0x7D, 0x01, 0x00, 0x78, 0x2C, 0x00, 0x7C, 
+    0x00, 0x00, 0x64, 0x02, 0x00, 0x6A, 0x00, 0x00, 
+    0x72, 0x3A, 0x00, 0x7C, 0x01, 0x00, 0x7C, 0x00, 
+    0x00, 0x64, 0x03, 0x00, 0x14, 0x17, 0x64, 0x04, 
+    0x00, 0x18, 0x7D, 0x01, 0x00, 0x7C, 0x00, 0x00, 
+    0x64, 0x04, 0x00, 0x37, 0x7D, 0x00, 0x00, 0x71, 
+    0x0F, 0x00, 0x57, 0x7C, 0x01, 0x00, 0x74, 0x00, 
+    0x00, 0x64, 0x01, 0x00, 0x3C, 0x64, 0x00, 0x00, 
+    0x53, 0x0A, 0xAA, 0x00, 0x00, 0x43, 0x03, 0x02, 
+    0x00, 0x0D, 0x00, 0x04, 0x02, 0x03, 0x03, 0x00, 
+    0x72, 0x65, 0x73, 0x03, 0x01, 0x00, 0x66, 0x03, 
+    0x10, 0x00, 0x00, 0x01, 0x06, 0x01, 0x06, 0x01, 
+    0x0F, 0x01, 0x0C, 0x01, 0x0A, 0x01, 0x0A, 0x01, 
+    0x0D, 0x01, 0x03, 0x09, 0x00, 0x75, 0x74, 0x6A, 
+    0x69, 0x74, 0x2E, 0x70, 0x79, 0x00, 0x04, 0x06, 
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 0x64, 
+    0x00, 0x00, 0x00, 0x01, 0x50, 0x00, 0x00, 0x00, 
+    0x02, 0x00, 0x00, 0x00, 0x3F, 0x01, 0x01, 0x00, 
+    0x00, 0x00, 0x04, 0x00, 0x64, 0x01, 0x00, 0x7D, 
+    0x00, 0x00, 0x64, 0x01, 0x00, 0x7D, 0x01, 0x00, 
+    0x78, 0x3A, 0x00, 0x7C, 0x00, 0x00, 0x64, 0x02, 
+    0x00, 0x6A, 0x00, 0x00, 0x72, 0x48, 0x00, 0x7C, 
+    0x00, 0x00, 0x64, 0x03, 0x00, 0x6A, 0x02, 0x00, 
+    0x72, 0x31, 0x00, 0x7C, 0x01, 0x00, 0x64, 0x04, 
+    0x00, 0x17, 0x7D, 0x01, 0x00, 0x7C, 0x01, 0x00, 
+    0x64, 0x05, 0x00, 0x17, 0x7D, 0x01, 0x00, 0x7C, 
+    0x00, 0x00, 0x64, 0x05, 0x00, 0x37, 0x7D, 0x00, 
+    0x00, 0x71, 0x0F, 0x00, 0x57, 0x7C, 0x01, 0x00, 
+    0x74, 0x00, 0x00, 0x64, 0x05, 0x00, 0x3C, 0x64, 
+    0x00, 0x00, 0x53, 0x0A, 0x97, 0x00, 0x00, 0x43, 
+    0x02, 0x02, 0x00, 0x17, 0x00, 0x04, 0x01, 0x03, 
+    0x01, 0x00, 0x65, 0x03, 0x0E, 0x00, 0x00, 0x01, 
+    0x06, 0x01, 0x06, 0x01, 0x0F, 0x01, 0x0C, 0x01, 
+    0x0A, 0x01, 0x0A, 0x01, 0x03, 0x09, 0x00, 0x75, 
+    0x74, 0x6A, 0x69, 0x74, 0x2E, 0x70, 0x79, 0x00, 
+    0x04, 0x06, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 
+    0x01, 0x64, 0x00, 0x00, 0x00, 0x01, 0x50, 0x00, 
+    0x00, 0x00, 0x03, 0x01, 0x00, 0x61, 0x01, 0x01, 
+    0x00, 0x00, 0x00, 0x04, 0x00, 0x64, 0x01, 0x00, 
+    0x7D, 0x00, 0x00, 0x64, 0x01, 0x00, 0x7D, 0x01, 
+    0x00, 0x78, 0x3A, 0x00, 0x7C, 0x00, 0x00, 0x64, 
+    0x02, 0x00, 0x6A, 0x00, 0x00, 0x72, 0x48, 0x00, 
+    0x7C, 0x00, 0x00, 0x64, 0x03, 0x00, 0x6A, 0x02, 
+    0x00, 0x72, 0x31, 0x00, 0x7C, 0x01, 0x00, 0x64, 
+    0x04, 0x00, 0x17, 0x7D, 0x01, 0x00, 0x7C, 0x01, 
+    0x00, 0x64, 0x05, 0x00, 0x17, 0x7D, 0x01, 0x00, 
+    0x7C, 0x00, 0x00, 0x64, 0x05, 0x00, 0x37, 0x7D, 
+    0x00, 0x00, 0x71, 0x0F, 0x00, 0x57, 0x64, 0x00, 
+    0x00, 0x53, 0x0A, 0x8E, 0x00, 0x00, 0x43, 0x04, 
+    0x01, 0x00, 0x20, 0x00, 0x04, 0x03, 0x03, 0x03, 
+    0x00, 0x6C, 0x6F, 0x67, 0x03, 0x03, 0x00, 0x70, 
+    0x6F, 0x73, 0x03, 0x01, 0x00, 0x61, 0x03, 0x0A, 
+    0x00, 0x00, 0x01, 0x06, 0x01, 0x0F, 0x01, 0x0D, 
+    0x01, 0x0E, 0x01, 0x03, 0x09, 0x00, 0x75, 0x74, 
+    0x6A, 0x69, 0x74, 0x2E, 0x70, 0x79, 0x00, 0x04, 
+    0x04, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 
+    0xE8, 0x03, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 
+    0x00, 0x04, 0x00, 0x64, 0x01, 0x00, 0x7D, 0x00, 
+    0x00, 0x78, 0x1A, 0x00, 0x7C, 0x00, 0x00, 0x64, 
+    0x02, 0x00, 0x6A, 0x00, 0x00, 0x72, 0x22, 0x00, 
+    0x7C, 0x00, 0x00, 0x64, 0x03, 0x00, 0x37, 0x7D, 
+    0x00, 0x00, 0x71, 0x09, 0x00, 0x57, 0x64, 0x03, 
+    0x00, 0x74, 0x00, 0x00, 0x74, 0x01, 0x00, 0x64, 
+    0x01, 0x00, 0x19, 0x3C, 0x74, 0x01, 0x00, 0x64, 
+    0x01, 0x00, 0x63, 0x02, 0x00, 0x19, 0x64, 0x03, 
+    0x00, 0x37, 0x03, 0x3C, 0x64, 0x00, 0x00, 0x53, 
+    0x0A, 0x93, 0x00, 0x00, 0x43, 0x04, 0x01, 0x00, 
+    0x27, 0x00, 0x04, 0x03, 0x03, 0x03, 0x00, 0x6C, 
+    0x6F, 0x67, 0x03, 0x03, 0x00, 0x70, 0x6F, 0x73, 
+    0x03, 0x01, 0x00, 0x62, 0x03, 0x0A, 0x00, 0x00, 
+    0x01, 0x06, 0x01, 0x0F, 0x01, 0x0D, 0x01, 0x0E, 
+    0x01, 0x03, 0x09, 0x00, 0x75, 0x74, 0x6A, 0x69, 
+    0x74, 0x2E, 0x70, 0x79, 0x00, 0x04, 0x05, 0x00, 
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 0x0A, 0x00, 
+    0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x01, 
+    0x02, 0x00, 0x00, 0x00, 0x04, 0x00, 0x64, 0x01, 
+    0x00, 0x7D, 0x00, 0x00, 0x78, 0x1A, 0x00, 0x7C, 
+    0x00, 0x00, 0x64, 0x02, 0x00, 0x6A, 0x00, 0x00, 
+    0x72, 0x22, 0x00, 0x7C, 0x00, 0x00, 0x64, 0x03, 
+    0x00, 0x37, 0x7D, 0x00, 0x00, 0x71, 0x09, 0x00, 
+    0x57, 0x64, 0x04, 0x00, 0x74, 0x00, 0x00, 0x74, 
+    0x01, 0x00, 0x64, 0x01, 0x00, 0x19, 0x3C, 0x74, 
+    0x01, 0x00, 0x64, 0x01, 0x00, 0x63, 0x02, 0x00, 
+    0x19, 0x64, 0x03, 0x00, 0x37, 0x03, 0x3C, 0x64, 
+    0x00, 0x00, 0x53, 0x00, 0x04, 0x00, 0x64, 0x00, 
+    0x00, 0x64, 0x00, 0x00, 0x67, 0x02, 0x00, 0x5A, 
+    0x00, 0x00, 0x64, 0x00, 0x00, 0x64, 0x00, 0x00, 
+    0x67, 0x02, 0x00, 0x5A, 0x01, 0x00, 0x64, 0x00, 
+    0x00, 0x67, 0x01, 0x00, 0x5A, 0x02, 0x00, 0x64, 
+    0x01, 0x00, 0x84, 0x00, 0x00, 0x5A, 0x03, 0x00, 
+    0x64, 0x02, 0x00, 0x84, 0x00, 0x00, 0x5A, 0x04, 
+    0x00, 0x64, 0x03, 0x00, 0x84, 0x00, 0x00, 0x5A, 
+    0x05, 0x00, 0x64, 0x04, 0x00, 0x84, 0x00, 0x00, 
+    0x5A, 0x06, 0x00, 0x64, 0x05, 0x00, 0x84, 0x00, 
+    0x00, 0x5A, 0x07, 0x00, 0x64, 0x06, 0x00, 0x53,
+#endif
+
+/* img-list-terminator */
+    0xFF, 
+};
+
+
+/*
+ * Loads test_jit_image0 and interprets its module code,
+ * which defines res, log, pos and the functions.
+ * The module is pushed as a temp root so it outlives the interpreter run.
+ */
+static PmReturn_t
+ut_jit_load(pPmObj_t *r_pmod)
+{
+    PmReturn_t retval;
+    uint8_t const *pimg = test_jit_image0;
+    pPmObj_t pcodeobject;
+    uint8_t objid;
+
+    retval = obj_loadFromImg(MEMSPACE_PROG, &pimg, &pcodeobject);
+    PM_RETURN_IF_ERROR(retval);
+    retval = mod_new(pcodeobject, r_pmod);
+    PM_RETURN_IF_ERROR(retval);
+    heap_gcPushTempRoot(*r_pmod, &objid);
+    retval = interp_addThread((pPmFunc_t)*r_pmod);
+    PM_RETURN_IF_ERROR(retval);
+    return interpret(C_TRUE);
+}
+
+
+/* Gets item i of the module's res list */
+static pPmObj_t
+ut_jit_getRes(CuTest *tc, pPmObj_t pmod, int16_t i)
+{
+    PmReturn_t retval;
+    pPmObj_t pres;
+    pPmObj_t pobj;
+
+    retval = ut_interp_getSchedAttr(pmod, "res", &pres);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = list_getItem(pres, i, &pobj);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    return pobj;
+}
+
+
+/**
+ * Tests jit_run() and jit_compile():
+ *      a loop compiles once it has jumped back PM_JIT_THRESHOLD times
+ *      the compiled loop computes the same sum as the interpreter
+ *      compiling a compiled code object does nothing
+ */
+void
+ut_jit_compile_000(CuTest *tc)
+{
+    uint8_t heap[HEAP_SIZE];
+    PmReturn_t retval;
+    pPmObj_t pmod;
+    pPmObj_t pc;
+    pPmObj_t pobj;
+    pPmJitCode_t pjc;
+
+    pm_init(heap, HEAP_SIZE, MEMSPACE_RAM, C_NULL);
+    retval = ut_jit_load(&pmod);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = ut_interp_getSchedAttr(pmod, "c", &pc);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc, ((pPmFunc_t)pc)->f_co->co_jitcode == C_NULL);
+
+    retval = ut_interp_addSchedThread(pmod, "c");
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = interpret(C_TRUE);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+
+    pjc = ((pPmFunc_t)pc)->f_co->co_jitcode;
+    CuAssertPtrNotNull(tc, pjc);
+    pobj = ut_jit_getRes(tc, pmod, 0);
+    CuAssertTrue(tc, OBJ_GET_TYPE(pobj) == OBJ_TYPE_INT);
+    CuAssertTrue(tc, ((pPmInt_t)pobj)->val == 998000);
+
+    CuAssertTrue(tc, jit_compile(((pPmFunc_t)pc)->f_co) == C_TRUE);
+    CuAssertTrue(tc, ((pPmFunc_t)pc)->f_co->co_jitcode == pjc);
+}
+
+
+/**
+ * Tests bailing out of compiled code:
+ *      an operand of another type returns to the interpreter,
+ *      which computes the float sum
+ *      an exception raised for such an operand reaches interpret()
+ */
+void
+ut_jit_bailout_000(CuTest *tc)
+{
+    uint8_t heap[HEAP_SIZE];
+    PmReturn_t retval;
+    pPmObj_t pmod;
+    pPmObj_t pf;
+    pPmObj_t pobj;
+
+    pm_init(heap, HEAP_SIZE, MEMSPACE_RAM, C_NULL);
+    retval = ut_jit_load(&pmod);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = ut_interp_getSchedAttr(pmod, "f", &pf);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+
+    /* f() adds 0.5 after its loop is compiled */
+    retval = ut_interp_addSchedThread(pmod, "f");
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = interpret(C_TRUE);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertPtrNotNull(tc, ((pPmFunc_t)pf)->f_co->co_jitcode);
+    pobj = ut_jit_getRes(tc, pmod, 1);
+    CuAssertTrue(tc, OBJ_GET_TYPE(pobj) == OBJ_TYPE_FLT);
+    CuAssertTrue(tc, ((pPmFloat_t)pobj)->val == 100.5);
+
+    /* e() adds a string after its loop is compiled */
+    retval = ut_interp_addSchedThread(pmod, "e");
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = interpret(C_TRUE);
+    CuAssertTrue(tc, retval == PM_RET_EX_TYPE);
+    gVmGlobal.pthread = C_NULL;
+}
+
+
+#ifdef HAVE_BUDGET_SCHED
+/**
+ * Tests that compiled loops spend the budget:
+ *      with the timer off, a() is rescheduled part way through its
+ *      compiled loop, so b() logs before a() does
+ */
+void
+ut_jit_budget_000(CuTest *tc)
+{
+    uint8_t heap[HEAP_SIZE];
+    PmReturn_t retval;
+    pPmObj_t pmod;
+    pPmObj_t plog;
+    pPmObj_t pint;
+
+    pm_init(heap, HEAP_SIZE, MEMSPACE_RAM, C_NULL);
+    gVmGlobal.budget = 100;
+    gVmGlobal.budgetTimed = C_FALSE;
+    retval = ut_jit_load(&pmod);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = ut_interp_addSchedThread(pmod, "a");
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = ut_interp_addSchedThread(pmod, "b");
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = interpret(C_TRUE);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+
+    retval = ut_interp_getSchedAttr(pmod, "log", &plog);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    list_getItem(plog, 0, &pint);
+    CuAssertTrue(tc, ((pPmInt_t)pint)->val == 2);
+    list_getItem(plog, 1, &pint);
+    CuAssertTrue(tc, ((pPmInt_t)pint)->val == 1);
+}
+#endif /* HAVE_BUDGET_SCHED */
+#endif /* HAVE_JIT */
+
+
+/** Make a suite from all tests in this file */
+CuSuite *getSuite_testJit(void)
+{
+    CuSuite* suite = CuSuiteNew();
+
+#ifdef HAVE_JIT
+    SUITE_ADD_TEST(suite, ut_jit_compile_000);
+    SUITE_ADD_TEST(suite, ut_jit_bailout_000);
+#ifdef HAVE_BUDGET_SCHED
+    SUITE_ADD_TEST(suite, ut_jit_budget_000);
+#endif /* HAVE_BUDGET_SCHED */
+#endif /* HAVE_JIT */
+
+    return suite;
+}
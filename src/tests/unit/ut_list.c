@@ -52,6 +52,58 @@ ut_list_new_000(CuTest *tc)
 }
 
 
+/**
+ * Test list_newFromArray():
+ *      Pass zero items,
+ *          expect retval is OK,
+ *          expect list length be 0.
+ *      Pass more items than fit in two segments,
+ *          expect list length be the number of items,
+ *          expect the items in order,
+ *          expect appending after them works,
+ *          expect a copy of it to compare the same.
+ */
+void
+ut_list_newFromArray_000(CuTest *tc)
+{
+    uint8_t heap[HEAP_SIZE];
+    pPmObj_t items[2 * SEGLIST_OBJS_PER_SEG + 3];
+    pPmObj_t pobj = C_NULL;
+    pPmObj_t pval;
+    PmReturn_t retval;
+    int16_t i;
+
+    retval = pm_init(heap, HEAP_SIZE, MEMSPACE_RAM, C_NULL);
+    retval = list_newFromArray(items, 0, &pobj);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc, OBJ_GET_TYPE(pobj) == OBJ_TYPE_LST);
+    CuAssertTrue(tc, ((pPmList_t)pobj)->length == 0);
+
+    for (i = 0; i < 2 * SEGLIST_OBJS_PER_SEG + 3; i++)
+    {
+        retval = int_new(i, &items[i]);
+    }
+    retval = list_newFromArray(items, 2 * SEGLIST_OBJS_PER_SEG + 3, &pobj);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc,
+                 ((pPmList_t)pobj)->length == 2 * SEGLIST_OBJS_PER_SEG + 3);
+    for (i = 0; i < 2 * SEGLIST_OBJS_PER_SEG + 3; i++)
+    {
+        retval = list_getItem(pobj, i, &pval);
+        CuAssertTrue(tc, pval == items[i]);
+    }
+
+    retval = list_append(pobj, PM_ONE);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = list_getItem(pobj, -1, &pval);
+    CuAssertTrue(tc, pval == PM_ONE);
+
+    retval = list_copy(pobj, &pval);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc, obj_compare(pval, pobj) == C_SAME);
+}
+
+
 /**
  * Test list_append():
  *      Append to non-list object, expect a TypeError
@@ -614,12 +666,71 @@ ut_list_index_000(CuTest *tc)
 }
 
 
+/**
+ * Test seqiter_getNext() on a list
+ *      Iterate over a list that spans several segments,
+ *          expect retval is OK and the items in order,
+ *      Then expect StopIteration,
+ *      Iterate over a list that is shortened during the loop,
+ *          expect StopIteration at the new length
+ */
+void
+ut_list_seqiter_000(CuTest *tc)
+{
+    uint8_t heap[0x8000];
+    pPmObj_t plist;
+    pPmObj_t pint;
+    pPmObj_t piter;
+    pPmObj_t pitem;
+    PmReturn_t retval;
+    int16_t i;
+
+    retval = pm_init(heap, sizeof(heap), MEMSPACE_RAM, C_NULL);
+    retval = list_new(&plist);
+    for (i = 0; i < 3 * SEGLIST_OBJS_PER_SEG + 1; i++)
+    {
+        retval = int_new(i, &pint);
+        retval = list_append(plist, pint);
+    }
+
+    /* The seqiter functions assert their return args are not null */
+    piter = plist;
+    pitem = plist;
+    retval = seqiter_new(plist, &piter);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    for (i = 0; i < 3 * SEGLIST_OBJS_PER_SEG + 1; i++)
+    {
+        retval = seqiter_getNext(piter, &pitem);
+        CuAssertTrue(tc, retval == PM_RET_OK);
+        CuAssertTrue(tc, ((pPmInt_t)pitem)->val == i);
+    }
+    retval = seqiter_getNext(piter, &pitem);
+    CuAssertTrue(tc, retval == PM_RET_EX_STOP);
+
+    /* Remove items during the loop */
+    retval = seqiter_new(plist, &piter);
+    for (i = 0; i < SEGLIST_OBJS_PER_SEG; i++)
+    {
+        retval = seqiter_getNext(piter, &pitem);
+        CuAssertTrue(tc, retval == PM_RET_OK);
+        retval = list_delItem(plist, 0);
+    }
+    i = 0;
+    while (seqiter_getNext(piter, &pitem) == PM_RET_OK)
+    {
+        i++;
+    }
+    CuAssertTrue(tc, i == SEGLIST_OBJS_PER_SEG + 1);
+}
+
+
 /** Make a suite from all tests in this file */
 CuSuite *getSuite_testList(void)
 {
     CuSuite* suite = CuSuiteNew();
 
     SUITE_ADD_TEST(suite, ut_list_new_000);
+    SUITE_ADD_TEST(suite, ut_list_newFromArray_000);
     SUITE_ADD_TEST(suite, ut_list_append_000);
     SUITE_ADD_TEST(suite, ut_list_getItem_000);
     SUITE_ADD_TEST(suite, ut_list_getItem_001);
@@ -631,6 +742,7 @@ CuSuite *getSuite_testList(void)
     SUITE_ADD_TEST(suite, ut_list_removeItem_000);
     SUITE_ADD_TEST(suite, ut_list_insert_000);
     SUITE_ADD_TEST(suite, ut_list_index_000);
+    SUITE_ADD_TEST(suite, ut_list_seqiter_000);
 
     return suite;
 }
@@ -0,0 +1,168 @@
+/*
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+*/
+
+
+/**
+ * VM Instance Unit Tests
+ * Tests running independent VMs on separate OS threads (see PM_PLAT_TLS).
+ */
+
+
+#include <pthread.h>
+#include <stdio.h>
+
+#include "CuTest.h"
+#include "pm.h"
+
+
+#define HEAP_SIZE 0x2000
+
+
+/* See ut_interp.c */
+PmReturn_t ut_interp_loadSched(pPmObj_t *r_pmod);
+PmReturn_t ut_interp_getSchedAttr(pPmObj_t pmod, char const *name,
+                                  pPmObj_t *r_pobj);
+PmReturn_t ut_interp_addSchedThread(pPmObj_t pmod, char const *name);
+
+
+/** One VM run by ut_pm_runVm() */
+typedef struct UtVm_s
+{
+    /** Name of the function to run in the VM's only thread */
+    char const *name;
+
+    /** Lets both VMs finish loading before either runs */
+    pthread_barrier_t *pbarrier;
+
+    /** Status of the run */
+    PmReturn_t retval;
+
+    /** Contents of the module's log list after the run */
+    int32_t log[8];
+} UtVm_t;
+
+
+/* Returns the address of the calling OS thread's VM globals */
+static void *
+ut_pm_getGlobal(void *arg)
+{
+    return (void *)&gVmGlobal;
+}
+
+
+/* Loads and runs a VM on the calling OS thread */
+static void *
+ut_pm_runVm(void *arg)
+{
+    UtVm_t *pvm = (UtVm_t *)arg;
+    uint8_t heap[HEAP_SIZE];
+    PmReturn_t retval;
+    pPmObj_t pmod = C_NULL;
+    pPmObj_t plog;
+    pPmObj_t pint;
+    int16_t i;
+
+    retval = pm_init(heap, HEAP_SIZE, MEMSPACE_RAM, C_NULL);
+    if (retval == PM_RET_OK)
+    {
+        retval = ut_interp_loadSched(&pmod);
+    }
+    if (retval == PM_RET_OK)
+    {
+        retval = ut_interp_addSchedThread(pmod, pvm->name);
+    }
+
+    /* Initializing one VM must not disturb the other */
+    pthread_barrier_wait(pvm->pbarrier);
+
+    if (retval == PM_RET_OK)
+    {
+        retval = interpret(C_TRUE);
+    }
+    if (retval == PM_RET_OK)
+    {
+        retval = ut_interp_getSchedAttr(pmod, "log", &plog);
+    }
+    for (i = 0; (retval == PM_RET_OK) && (i < 8); i++)
+    {
+        retval = list_getItem(plog, i, &pint);
+        pvm->log[i] = ((pPmInt_t)pint)->val;
+    }
+
+    plat_deinit();
+    pvm->retval = retval;
+    return C_NULL;
+}
+
+
+/**
+ * Tests two VMs running in parallel on separate OS threads:
+ *      each VM runs its own thread and module globals
+ *      neither VM sees the other's log
+ * Skipped (with a message) if the platform does not make the VM state
+ * thread-local; "make check-features" builds on a platform that does.
+ */
+void
+ut_pm_twoVms_000(CuTest *tc)
+{
+    pthread_t threads[2];
+    pthread_barrier_t barrier;
+    UtVm_t vms[2];
+    void *pglobal;
+    int32_t i;
+
+    /* Two VMs would share one state without PM_PLAT_TLS */
+    pthread_create(&threads[0], C_NULL, ut_pm_getGlobal, C_NULL);
+    pthread_join(threads[0], &pglobal);
+    if (pglobal == (void *)&gVmGlobal)
+    {
+        printf("ut_pm_twoVms_000 skipped: PM_PLAT_TLS is not defined\n");
+        return;
+    }
+
+    pthread_barrier_init(&barrier, C_NULL, 2);
+    vms[0].name = "a";
+    vms[1].name = "b";
+    for (i = 0; i < 2; i++)
+    {
+        vms[i].pbarrier = &barrier;
+        vms[i].retval = PM_RET_ERR;
+        pthread_create(&threads[i], C_NULL, ut_pm_runVm, &vms[i]);
+    }
+    for (i = 0; i < 2; i++)
+    {
+        pthread_join(threads[i], C_NULL);
+    }
+    pthread_barrier_destroy(&barrier);
+
+    /* a() logs 1 four times and b() logs 2 four times, each in its own VM */
+    CuAssertTrue(tc, vms[0].retval == PM_RET_OK);
+    CuAssertTrue(tc, vms[1].retval == PM_RET_OK);
+    for (i = 0; i < 8; i++)
+    {
+        CuAssertTrue(tc, vms[0].log[i] == ((i < 4) ? 1 : 0));
+        CuAssertTrue(tc, vms[1].log[i] == ((i < 4) ? 2 : 0));
+    }
+}
+
+
+/** Make a suite from all tests in this file */
+CuSuite *getSuite_testPm(void)
+{
+    CuSuite* suite = CuSuiteNew();
+
+    SUITE_ADD_TEST(suite, ut_pm_twoVms_000);
+
+    return suite;
+}
@@ -0,0 +1,151 @@
+/*
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+*/
+
+
+/**
+ * Profiler Unit Tests
+ * Tests the sampling profiler's table of call stacks.
+ */
+
+
+#include "CuTest.h"
+#include "pm.h"
+
+
+#define HEAP_SIZE 0x2000
+
+
+#ifdef HAVE_PROFILER
+/* See ut_interp.c */
+PmReturn_t ut_interp_loadSched(pPmObj_t *r_pmod);
+PmReturn_t ut_interp_getSchedAttr(pPmObj_t pmod, char const *name,
+                                  pPmObj_t *r_pobj);
+PmReturn_t ut_interp_addSchedThread(pPmObj_t pmod, char const *name);
+
+
+/**
+ * Tests prof_sample() and prof_drain():
+ *      samples of the same frame share one call stack entry
+ *      a sample of another code object makes a new entry
+ *      a sample has one frame per frame in the thread's chain
+ *      samples taken while the ring is full are dropped
+ */
+void
+ut_prof_sample_000(CuTest *tc)
+{
+    uint8_t heap[HEAP_SIZE];
+    PmReturn_t retval;
+    pPmObj_t pmod;
+    pPmObj_t pa;
+    pPmObj_t pb;
+    uint16_t i;
+
+    pm_init(heap, HEAP_SIZE, MEMSPACE_RAM, C_NULL);
+    retval = ut_interp_loadSched(&pmod);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = ut_interp_getSchedAttr(pmod, "a", &pa);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = ut_interp_getSchedAttr(pmod, "b", &pb);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = ut_interp_addSchedThread(pmod, "a");
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = ut_interp_addSchedThread(pmod, "b");
+    CuAssertTrue(tc, retval == PM_RET_OK);
+
+    /* Make a() the running thread and sample it; more than the ring holds */
+    prof_enable(C_TRUE);
+    retval = interp_reschedule();
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    for (i = 0; i < PROF_RING_SIZE + 4; i++)
+    {
+        prof_sample();
+    }
+    prof_drain();
+    CuAssertTrue(tc, prof_getNumStacks() == 1);
+    CuAssertTrue(tc, prof_getCo(0) == ((pPmFunc_t)pa)->f_co);
+    CuAssertTrue(tc, prof_getCo(1) == C_NULL);
+    CuAssertTrue(tc, prof_getCo(PROF_MAX_DEPTH) == C_NULL);
+
+    /* Round robin makes b() the running thread */
+    retval = interp_reschedule();
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    prof_sample();
+    prof_drain();
+    CuAssertTrue(tc, prof_getNumStacks() == 2);
+    CuAssertTrue(tc, prof_getCo(0) == ((pPmFunc_t)pa)->f_co);
+    CuAssertTrue(tc, prof_getCo(PROF_MAX_DEPTH) == ((pPmFunc_t)pb)->f_co);
+    CuAssertTrue(tc, prof_getCo(2 * PROF_MAX_DEPTH) == C_NULL);
+
+    /* Leave no thread for the timer tick to sample */
+    gVmGlobal.pthread = C_NULL;
+    prof_enable(C_FALSE);
+}
+
+
+/**
+ * Tests prof_enable():
+ *      no samples are taken while disabled
+ *      enabling discards the previous profile
+ */
+void
+ut_prof_enable_000(CuTest *tc)
+{
+    uint8_t heap[HEAP_SIZE];
+    PmReturn_t retval;
+    pPmObj_t pmod;
+
+    pm_init(heap, HEAP_SIZE, MEMSPACE_RAM, C_NULL);
+    retval = ut_interp_loadSched(&pmod);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = ut_interp_addSchedThread(pmod, "a");
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = interp_reschedule();
+    CuAssertTrue(tc, retval == PM_RET_OK);
+
+    prof_enable(C_TRUE);
+    prof_sample();
+    prof_drain();
+    CuAssertTrue(tc, prof_getCo(0) != C_NULL);
+
+    /* Without a running thread, the timer tick cannot add a sample */
+    gVmGlobal.pthread = C_NULL;
+    prof_enable(C_TRUE);
+    prof_drain();
+    CuAssertTrue(tc, prof_getNumStacks() == 0);
+    CuAssertTrue(tc, prof_getCo(0) == C_NULL);
+
+    /* The disabled profiler ignores samples */
+    prof_enable(C_FALSE);
+    retval = interp_reschedule();
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    prof_sample();
+    prof_drain();
+    CuAssertTrue(tc, prof_getCo(0) == C_NULL);
+    gVmGlobal.pthread = C_NULL;
+}
+#endif /* HAVE_PROFILER */
+
+
+/** Make a suite from all tests in this file */
+CuSuite *getSuite_testProf(void)
+{
+    CuSuite* suite = CuSuiteNew();
+
+#ifdef HAVE_PROFILER
+    SUITE_ADD_TEST(suite, ut_prof_sample_000);
+    SUITE_ADD_TEST(suite, ut_prof_enable_000);
+#endif /* HAVE_PROFILER */
+
+    return suite;
+}
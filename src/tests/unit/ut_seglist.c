@@ -335,6 +335,92 @@ ut_seglist_removeItem_000(CuTest *tc)
     CuAssertTrue(tc, pobj == item[2]);
 }
 
+/**
+ * Tests seglist_insertItem() and seglist_removeItem() past one segment:
+ *      append enough items to need more than one full-size segment,
+ *      insert at the front and at the start of the second segment,
+ *      remove those two items again,
+ *      then remove items from the end until one segment is enough,
+ *      expect every item at its index after each step
+ *      and the trailing segments to be freed
+ */
+void
+ut_seglist_removeItem_001(CuTest *tc)
+{
+    uint8_t heap[0x8000];
+    PmReturn_t retval;
+    pSeglist_t pseglist;
+    pPmObj_t pobj;
+    pPmObj_t pnew;
+    pPmObj_t item[3];
+    int16_t i;
+    int16_t n = 2 * SEGLIST_OBJS_PER_SEG + 3;
+
+    retval = pm_init(heap, sizeof(heap), MEMSPACE_RAM, C_NULL);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    item[0] = PM_ZERO;
+    item[1] = PM_ONE;
+    item[2] = PM_NEGONE;
+    retval = int_new(2, &pnew);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+
+    retval = seglist_new(&pseglist);
+    for (i = 0; i < n; i++)
+    {
+        retval = seglist_appendItem(pseglist, item[i % 3]);
+        CuAssertTrue(tc, retval == PM_RET_OK);
+    }
+    CuAssertTrue(tc, pseglist->sl_length == n);
+    CuAssertTrue(tc, pseglist->sl_capacity
+                     == 2 * SEGLIST_OBJS_PER_SEG + SEGLIST_MIN_OBJS);
+
+    retval = seglist_insertItem(pseglist, pnew, 0);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = seglist_insertItem(pseglist, pnew, SEGLIST_OBJS_PER_SEG);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc, pseglist->sl_length == n + 2);
+    for (i = 0; i < n + 2; i++)
+    {
+        retval = seglist_getItem(pseglist, i, &pobj);
+        if ((i == 0) || (i == SEGLIST_OBJS_PER_SEG))
+        {
+            CuAssertTrue(tc, pobj == pnew);
+        }
+        else if (i < SEGLIST_OBJS_PER_SEG)
+        {
+            CuAssertTrue(tc, pobj == item[(i - 1) % 3]);
+        }
+        else
+        {
+            CuAssertTrue(tc, pobj == item[(i - 2) % 3]);
+        }
+    }
+
+    retval = seglist_removeItem(pseglist, SEGLIST_OBJS_PER_SEG);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = seglist_removeItem(pseglist, 0);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc, pseglist->sl_length == n);
+    for (i = 0; i < n; i++)
+    {
+        retval = seglist_getItem(pseglist, i, &pobj);
+        CuAssertTrue(tc, pobj == item[i % 3]);
+    }
+
+    while (pseglist->sl_length > SEGLIST_OBJS_PER_SEG / 2)
+    {
+        retval = seglist_removeItem(pseglist, pseglist->sl_length - 1);
+        CuAssertTrue(tc, retval == PM_RET_OK);
+    }
+    CuAssertTrue(tc, pseglist->sl_capacity == SEGLIST_OBJS_PER_SEG);
+    for (i = 0; i < pseglist->sl_length; i++)
+    {
+        retval = seglist_getItem(pseglist, i, &pobj);
+        CuAssertTrue(tc, pobj == item[i % 3]);
+    }
+}
+
+
 /** Make a suite from all tests in this file */
 CuSuite *getSuite_testSeglist(void)
 {
@@ -349,6 +435,7 @@ CuSuite *getSuite_testSeglist(void)
     SUITE_ADD_TEST(suite, ut_seglist_getItem_000);
     SUITE_ADD_TEST(suite, ut_seglist_getItem_001);
     SUITE_ADD_TEST(suite, ut_seglist_removeItem_000);
+    SUITE_ADD_TEST(suite, ut_seglist_removeItem_001);
 
     return suite;
 }
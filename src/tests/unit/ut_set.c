@@ -0,0 +1,183 @@
+/*
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+*/
+
+
+/**
+ * Set Object Unit Tests
+ * Tests the Set Object implementation.
+ */
+
+
+#include "CuTest.h"
+#include "pm.h"
+
+
+#define HEAP_SIZE 0x2000
+
+
+#ifdef HAVE_SET
+/**
+ * Tests set_new():
+ *      retval is OK
+ *      set is empty
+ *      frozen flag is kept
+ */
+void
+ut_set_new_000(CuTest *tc)
+{
+    uint8_t heap[HEAP_SIZE];
+    pPmObj_t pset;
+    PmReturn_t retval;
+
+    pm_init(heap, HEAP_SIZE, MEMSPACE_RAM, C_NULL);
+
+    retval = set_new(C_FALSE, &pset);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc, OBJ_GET_TYPE(pset) == OBJ_TYPE_SET);
+    CuAssertTrue(tc, SET_GET_LENGTH(pset) == 0);
+    CuAssertTrue(tc, !SET_IS_FROZEN(pset));
+
+    retval = set_new(C_TRUE, &pset);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc, SET_IS_FROZEN(pset));
+}
+
+
+/**
+ * Tests set_add() and set_isIn():
+ *      adding a member twice keeps one
+ *      a member is found and a non-member is not
+ *      an unhashable item raises TypeError
+ */
+void
+ut_set_add_000(CuTest *tc)
+{
+    uint8_t heap[HEAP_SIZE];
+    pPmObj_t pset;
+    pPmObj_t pint;
+    pPmObj_t pint2;
+    pPmObj_t plist;
+    PmReturn_t retval;
+
+    pm_init(heap, HEAP_SIZE, MEMSPACE_RAM, C_NULL);
+
+    retval = set_new(C_FALSE, &pset);
+    retval = int_new(42, &pint);
+    retval = int_new(7, &pint2);
+    retval = list_new(&plist);
+
+    retval = set_add(pset, pint);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    retval = set_add(pset, pint);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc, SET_GET_LENGTH(pset) == 1);
+
+    CuAssertTrue(tc, set_isIn(pset, pint) == PM_RET_OK);
+    CuAssertTrue(tc, set_isIn(pset, pint2) == PM_RET_NO);
+
+    retval = set_add(pset, plist);
+    CuAssertTrue(tc, retval == PM_RET_EX_TYPE);
+}
+
+
+/**
+ * Tests set_union() and set_intersection():
+ *      results have the expected members
+ *      the original set is unchanged
+ */
+void
+ut_set_union_000(CuTest *tc)
+{
+    uint8_t heap[HEAP_SIZE];
+    pPmObj_t pset1;
+    pPmObj_t pset2;
+    pPmObj_t pr;
+    pPmObj_t pint1;
+    pPmObj_t pint2;
+    pPmObj_t pint3;
+    PmReturn_t retval;
+
+    pm_init(heap, HEAP_SIZE, MEMSPACE_RAM, C_NULL);
+
+    retval = int_new(1, &pint1);
+    retval = int_new(2, &pint2);
+    retval = int_new(3, &pint3);
+    retval = set_new(C_FALSE, &pset1);
+    retval = set_add(pset1, pint1);
+    retval = set_add(pset1, pint2);
+    retval = set_new(C_FALSE, &pset2);
+    retval = set_add(pset2, pint2);
+    retval = set_add(pset2, pint3);
+
+    retval = set_union(pset1, pset2, &pr);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc, SET_GET_LENGTH(pr) == 3);
+    CuAssertTrue(tc, SET_GET_LENGTH(pset1) == 2);
+
+    retval = set_intersection(pset1, pset2, &pr);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc, SET_GET_LENGTH(pr) == 1);
+    CuAssertTrue(tc, set_isIn(pr, pint2) == PM_RET_OK);
+    CuAssertTrue(tc, set_isIn(pr, pint1) == PM_RET_NO);
+}
+
+
+/**
+ * Tests set_compare() and set_hash():
+ *      sets with the same members are the same
+ *      their hashes match whatever the order of adding
+ */
+void
+ut_set_compare_000(CuTest *tc)
+{
+    uint8_t heap[HEAP_SIZE];
+    pPmObj_t pset1;
+    pPmObj_t pset2;
+    pPmObj_t pint1;
+    pPmObj_t pint2;
+    PmReturn_t retval;
+
+    pm_init(heap, HEAP_SIZE, MEMSPACE_RAM, C_NULL);
+
+    retval = int_new(1, &pint1);
+    retval = int_new(2, &pint2);
+    retval = set_new(C_TRUE, &pset1);
+    retval = set_add(pset1, pint1);
+    retval = set_add(pset1, pint2);
+    retval = set_new(C_TRUE, &pset2);
+    retval = set_add(pset2, pint2);
+    CuAssertTrue(tc, set_compare(pset1, pset2) == C_DIFFER);
+
+    retval = set_add(pset2, pint1);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc, set_compare(pset1, pset2) == C_SAME);
+    CuAssertTrue(tc, set_hash(pset1) == set_hash(pset2));
+}
+#endif /* HAVE_SET */
+
+
+/** Make a suite from all tests in this file */
+CuSuite *getSuite_testSetObj(void)
+{
+    CuSuite* suite = CuSuiteNew();
+
+#ifdef HAVE_SET
+    SUITE_ADD_TEST(suite, ut_set_new_000);
+    SUITE_ADD_TEST(suite, ut_set_add_000);
+    SUITE_ADD_TEST(suite, ut_set_union_000);
+    SUITE_ADD_TEST(suite, ut_set_compare_000);
+#endif /* HAVE_SET */
+
+    return suite;
+}
@@ -71,6 +71,168 @@ ut_string_newFromChar_000(CuTest *tc)
 }
 
 
+/**
+ * Tests the string cache:
+ *      a string made by concatenation is the cached twin of a new string,
+ *      strings in more buckets than the cache has are all found again,
+ *      a null character string is not the empty string.
+ */
+void
+ut_string_cache_000(CuTest *tc)
+{
+    uint8_t heap[HEAP_SIZE];
+    pPmObj_t pstring;
+    pPmObj_t pfor;
+    pPmObj_t pty;
+    pPmObj_t pforty;
+    pPmObj_t pstrings[2 * STRING_CACHE_NUM_BUCKETS];
+    uint8_t cstring[] = "forty";
+    uint8_t const *pcstring;
+    uint8_t cbuf[4];
+    PmReturn_t retval;
+    int16_t i;
+
+    pm_init(heap, HEAP_SIZE, MEMSPACE_RAM, C_NULL);
+
+    pcstring = cstring;
+    retval = string_new(&pcstring, &pforty);
+    pcstring = cstring;
+    retval = string_newWithLen(&pcstring, 3, &pfor);
+    pcstring = &cstring[3];
+    retval = string_new(&pcstring, &pty);
+    retval = string_concat(pfor, pty, &pstring);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertPtrEquals(tc, pforty, pstring);
+
+#if USE_STRING_CACHE
+    for (i = 0; i < 2 * STRING_CACHE_NUM_BUCKETS; i++)
+    {
+        cbuf[0] = 'a' + (i & 0x0F);
+        cbuf[1] = 'a' + (i >> 4);
+        cbuf[2] = '\0';
+        pcstring = cbuf;
+        retval = string_new(&pcstring, &pstrings[i]);
+        CuAssertTrue(tc, retval == PM_RET_OK);
+    }
+    for (i = 0; i < 2 * STRING_CACHE_NUM_BUCKETS; i++)
+    {
+        cbuf[0] = 'a' + (i & 0x0F);
+        cbuf[1] = 'a' + (i >> 4);
+        cbuf[2] = '\0';
+        pcstring = cbuf;
+        retval = string_new(&pcstring, &pstring);
+        CuAssertPtrEquals(tc, pstrings[i], pstring);
+    }
+#endif /* USE_STRING_CACHE */
+
+    cbuf[0] = '\0';
+    pcstring = cbuf;
+    retval = string_new(&pcstring, &pstring);
+    CuAssertTrue(tc, ((pPmString_t)pstring)->length == 0);
+    retval = string_newFromChar('\0', &pfor);
+    CuAssertTrue(tc, ((pPmString_t)pfor)->length == 1);
+    CuAssertTrue(tc, obj_compare(pfor, pstring) == C_DIFFER);
+}
+
+/**
+ * Tests string_join() and the string buffer:
+ *      a joined list is the cached twin of the same new string,
+ *      the characters of a string are joined,
+ *      a buffer grows in place until full and keeps its contents when moved.
+ */
+void
+ut_string_join_000(CuTest *tc)
+{
+    uint8_t heap[HEAP_SIZE];
+    pPmObj_t pstring;
+    pPmObj_t psep;
+    pPmObj_t plist;
+    pPmObj_t pitem;
+    pPmObj_t pbuf;
+    pPmObj_t pbuf2;
+    uint8_t cstring[] = "ab-c";
+    uint8_t const *pcstring;
+    PmReturn_t retval;
+    uint8_t objid;
+
+    pm_init(heap, HEAP_SIZE, MEMSPACE_RAM, C_NULL);
+
+    retval = string_newFromChar('-', &psep);
+    retval = list_new(&plist);
+    heap_gcPushTempRoot(plist, &objid);
+    pcstring = cstring;
+    retval = string_newWithLen(&pcstring, 2, &pitem);
+    retval = list_append(plist, pitem);
+    pcstring = &cstring[3];
+    retval = string_new(&pcstring, &pitem);
+    retval = list_append(plist, pitem);
+    retval = string_join((pPmString_t)psep, plist, &pstring);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    pcstring = cstring;
+    retval = string_new(&pcstring, &pitem);
+    CuAssertPtrEquals(tc, pitem, pstring);
+
+    retval = string_join((pPmString_t)psep, pitem, &pstring);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc, ((pPmString_t)pstring)->length == 7);
+    CuAssertTrue(tc, ((pPmString_t)pstring)->val[6] == 'c');
+
+    retval = string_join((pPmString_t)psep, PM_NONE, &pstring);
+    CuAssertTrue(tc, retval == PM_RET_EX_TYPE);
+
+    retval = string_bufReserve(C_NULL, 4, &pbuf);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    sli_memcpy(((pPmString_t)pbuf)->val, cstring, 4);
+    ((pPmString_t)pbuf)->length = 4;
+    retval = string_bufReserve(pbuf, 4, &pbuf2);
+    CuAssertPtrEquals(tc, pbuf, pbuf2);
+    retval = string_bufReserve(pbuf, 100, &pbuf2);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc, pbuf != pbuf2);
+    retval = string_bufGetValue(pbuf2, &pstring);
+    CuAssertPtrEquals(tc, pitem, pstring);
+    heap_gcPopTempRoot(objid);
+}
+
+
+#ifdef HAVE_SLICE
+/**
+ * Tests string_slice():
+ *      a positive stride picks every stride-th char,
+ *      a zero or negative stride raises ValueError.
+ */
+void
+ut_string_slice_000(CuTest *tc)
+{
+    uint8_t heap[HEAP_SIZE];
+    pPmObj_t pstring;
+    pPmObj_t pstride;
+    pPmObj_t pslice;
+    uint8_t cstring[] = "abcdef";
+    uint8_t const *pcstring = cstring;
+    PmReturn_t retval;
+    uint8_t objid;
+
+    pm_init(heap, HEAP_SIZE, MEMSPACE_RAM, C_NULL);
+
+    retval = string_new(&pcstring, &pstring);
+    heap_gcPushTempRoot(pstring, &objid);
+    retval = int_new(2, &pstride);
+    retval = string_slice(pstring, PM_ZERO, PM_NONE, pstride, &pslice);
+    CuAssertTrue(tc, retval == PM_RET_OK);
+    CuAssertTrue(tc, ((pPmString_t)pslice)->length == 3);
+    CuAssertTrue(tc, ((pPmString_t)pslice)->val[1] == 'c');
+
+    retval = string_slice(pstring, PM_ZERO, PM_NONE, PM_ZERO, &pslice);
+    CuAssertTrue(tc, retval == PM_RET_EX_VAL);
+
+    retval = string_slice(pstring, PM_ZERO, PM_NONE, PM_NEGONE, &pslice);
+    CuAssertTrue(tc, retval == PM_RET_EX_VAL);
+    heap_gcPopTempRoot(objid);
+}
+#endif /* HAVE_SLICE */
+
+
 /** Make a suite from all tests in this file */
 CuSuite *getSuite_testStringObj(void)
 {
@@ -78,6 +240,11 @@ CuSuite *getSuite_testStringObj(void)
 
     SUITE_ADD_TEST(suite, ut_string_new_000);
     SUITE_ADD_TEST(suite, ut_string_newFromChar_000);
+    SUITE_ADD_TEST(suite, ut_string_cache_000);
+    SUITE_ADD_TEST(suite, ut_string_join_000);
+#ifdef HAVE_SLICE
+    SUITE_ADD_TEST(suite, ut_string_slice_000);
+#endif /* HAVE_SLICE */
 
     return suite;
 }
@@ -0,0 +1,22 @@
+# This file is Copyright 2013 Dean Hall.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+
+#
+# Features for "make check-features": the desktop64 features plus the
+# optional features whose unit tests are otherwise not built.
+#
+
+execfile("../../platform/desktop64/pmfeatures.py")
+
+PM_FEATURES["HAVE_OPSTATS"] = True
+PM_FEATURES["HAVE_PROFILER"] = True
+PM_FEATURES["HAVE_BUDGET_SCHED"] = True
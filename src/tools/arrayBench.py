@@ -0,0 +1,99 @@
+# This file is Copyright 2013 Dean Hall.
+# This file is part of the Python-on-a-Chip tools.
+# This software is licensed under the MIT License.
+# See the LICENSE file for details.
+
+"""
+PyMite Array Benchmark
+======================
+
+Times the array module's C kernels against the same work done on lists.
+This is a PyMite program, not a host tool.  Build it into a platform's
+user image and run it from ipm, for example on desktop64::
+
+    make -C src/platform/desktop64 \\
+        PM_USR_SOURCES="main.py ../../tools/arrayBench.py"
+    ./src/platform/desktop64/main.out
+    ipm> import arrayBench
+    ipm> arrayBench.run(50)
+
+The times are in platform ticks (milliseconds on desktop).  On a 64-bit
+host the lists need a heap of about 32 KB, so raise HEAP_SIZE in the
+platform's main.c to 0x8000 first.
+"""
+
+## @file
+#  @copybrief arrayBench
+
+## @package arrayBench
+#  @brief PyMite Array Benchmark
+#
+#  Times the array kernels against the same work done on lists.
+
+
+import array, sys
+
+
+N = 128
+
+
+def list_kernels(x, y):
+    s = 0
+    for v in x:
+        s += v
+    d = 0
+    i = 0
+    while i < N:
+        d += x[i] * y[i]
+        i += 1
+    z = x[:]
+    i = 0
+    while i < N:
+        z[i] = x[i] * 3 + y[i]
+        i += 1
+    w = 0
+    i = 0
+    while i < N - 4:
+        w += (z[i] + z[i + 1] + z[i + 2] + z[i + 3]) / 4
+        i += 1
+    return s + d + w
+
+
+def array_kernels(x, y):
+    s = x.sum()
+    d = x.dot(y)
+    z = array.array('h', x)
+    z.scale(3)
+    z.add(y)
+    w = z.movingAverage(4).sum() - z.movingAverage(4)[-1]
+    return s + d + w
+
+
+def run(loops):
+    l1 = range(N)
+    l2 = range(N)
+    i = 0
+    while i < N:
+        l2[i] = (i * 7) % 31 - 15
+        i += 1
+    a1 = array.array('h', l1)
+    a2 = array.array('h', l2)
+
+    t0 = sys.time()
+    n = 0
+    while n < loops:
+        # Natives do not run the GC, so collect the last loop's garbage here
+        sys.gc()
+        rl = list_kernels(l1, l2)
+        n += 1
+    t1 = sys.time()
+    n = 0
+    while n < loops:
+        sys.gc()
+        ra = array_kernels(a1, a2)
+        n += 1
+    t2 = sys.time()
+
+    assert rl == ra
+    print "list  kernels:", t1 - t0, "ticks"
+    print "array kernels:", t2 - t1, "ticks"
@@ -217,7 +217,7 @@ def PmObjectClass(dumpversion, features):
             PmTypeInfo('NON', ""),
             PmTypeInfo("INT", "val:i"),
             PmTypeInfo("FLT", "val:f"),
-            PmTypeInfo("STR", "len:H,"+
+            PmTypeInfo("STR", "len:H,hash:H,"+
                        (features.USE_STRING_CACHE and "cache_next:P," or "") +
                        "val:B:len"),
             PmTypeInfo("TUP", "len:H,items:P:len"),
@@ -233,28 +233,32 @@ def PmObjectClass(dumpversion, features):
             PmTypeInfo("CIM", "data:B:*"),
             PmTypeInfo("NIM", ""),
             PmTypeInfo("NOB", "argcount:B,funcidx:H"),
-            PmTypeInfo("THR", "frame:P,interpctrl:I"),
-            PmTypeInfo("x", ""),
+            PmTypeInfo("THR", "frame:P,interpctrl:I,next:P,prev:P,"
+                              "priority:B,wake:I"),
+            PmTypeInfo("SVW", "len:H,hash:H,val:P,str:P"),
             PmTypeInfo("BOL", "val:i"),
             PmTypeInfo("CIO", "data:B:*"),
             PmTypeInfo("MTH", "instance:P,func:P,attrs:P"),
             PmTypeInfo("LST", "len:H,sgl:P"),
-            PmTypeInfo("DIC", "len:H,keys:P,vals:P"),
-            PmTypeInfo("x", ""),
-            PmTypeInfo("x", ""),
-            PmTypeInfo("x", ""),
-            PmTypeInfo("x", ""),
+            PmTypeInfo("DIC", "len:H,table:P"),
             PmTypeInfo("x", ""),
+            PmTypeInfo("GEN", "frame:P"),
+            PmTypeInfo("XRG", "start:i,step:i,length:i"),
+            PmTypeInfo("SET", "frozen:B,dict:P"),
+            # An array's data starts with its typecode (see array.h)
+            PmTypeInfo("BYS", "length:H,users:B,data:B:*"),
             PmTypeInfo("FRM", "back:P,func:P,memspace:B,ip:P,blockstack:P,"
-                              "attrs:P,globals:P,sp:P,isImport:.," +
+                              "attrs:P,globals:P,sp:P,isImport:.,isForIter:.," +
                        (features.HAVE_CLASSES and "isInit:.," or "") +
                        "locals:P:<sp"),
             PmTypeInfo("BLK", "sp:P,handler:P,type:B,next:P"),
-            PmTypeInfo("SEG", "items:P:8,next:P"),
-            PmTypeInfo("SGL", "length:H,rootseg:P,lastseg:P"),
-            PmTypeInfo("SQI", "sequence:P,index:H"),
+            PmTypeInfo("SEG", "items:P:*"),
+            PmTypeInfo("SGL", "length:H,capacity:H,dirsize:H,rootseg:P"),
+            PmTypeInfo("SQI", "sequence:P,index:H,length:H,kind:B"),
             PmTypeInfo("NFM", "back:P,func:P,stack:P,active:B,numlocals:B,"
                               "locals:P:8"),
+            PmTypeInfo("DTB", "nslots:H,capacity:H,used:H,length:H,next:P,"
+                              "entries:P:*"),
             )
 
         FREE_TYPE = PmTypeInfo("FRE", "prev:P,next:P")
@@ -396,13 +400,6 @@ def PmObjectClass(dumpversion, features):
 
             d = self.data
 
-            #mark dic vals segment for upside-down display
-            if self.type == 'dic' and d['len']>0:
-                seg = self.heap.data[d['vals']].data['rootseg']
-                while seg:
-                    self.heap.data[seg].is_dotrev = True
-                    seg = self.heap.data[seg].data['next']
-
             result = []
 
             result.append('"0x%x" [style=filled, fillcolor=%s, colorscheme=svg,'
@@ -412,12 +409,13 @@ def PmObjectClass(dumpversion, features):
                              self._dot_label()))
 
             if (self.type == "sgl" and d['rootseg'] in self.heap.data
-                and d['rootseg'] != d['lastseg']):
+                and d['dirsize'] != 0):
+                # The root segment is a directory of full-size segments
                 result.append("{ rank=same;")
-                seg = d['rootseg']
-                while seg in self.heap.data:
-                    result.append(self.heap.data[seg].dotstring())
-                    seg = self.heap.data[seg].data['next']
+                nsegs = d['capacity'] >> 7 # SEGLIST_SEG_SHIFT
+                for seg in self.heap.data[d['rootseg']].data['items'][:nsegs]:
+                    if seg in self.heap.data:
+                        result.append(self.heap.data[seg].dotstring())
                 result.append('}')
             return "\n".join(result)
 
@@ -484,29 +482,22 @@ def PmObjectClass(dumpversion, features):
                         continue
                     result.append(self._dotedge(f.name, d[f.name]))
                 else:
-                    for i, m in enumerate(d[f.name]):
+                    items = d[f.name]
+                    if self.type == "dtb" and f.name == "entries":
+                        items = items[:2 * d['used']]
+                    for i, m in enumerate(items):
                         if m == 0:
                             continue
                         result.append(self._dotedge(f.name, m, str(i)))
 
-            if self.type == "dic" and d['len'] > 0:
-                i = 0
-                sgls = tuple(map(lambda p: self.heap.data[d[p]],
-                                 ("keys", "vals")))
-                segs = tuple(map(lambda l: self.heap.data[l.data['rootseg']],
-                                 sgls))
-                iters = tuple(map(lambda s: iter(s.data['items']), segs))
-                while i < d['len']:
-                    try:
-                        key, val = tuple(map(next, iters))
-                        result.append('"0x%x" -> "0x%x" '
-                                      '[style=dotted, weight=50];'%(key, val))
-                        i += 1
-                    except StopIteration:
-                        segs = tuple(map(
-                            lambda s: self.heap.data[s.data['next']] , segs))
-                        iters = tuple(map(
-                            lambda s: iter(s.data['items']), segs))
+            if self.type == "dtb":
+                # Entries are key,val pointer pairs; index slots follow them
+                entries = d['entries'][:2 * d['used']]
+                for key, val in zip(entries[0::2], entries[1::2]):
+                    if key == 0:
+                        continue
+                    result.append('"0x%x" -> "0x%x" '
+                                  '[style=dotted, weight=50];'%(key, val))
 
             return "\n".join(result)
 
@@ -578,7 +569,7 @@ class PmHeap(UserDict.UserDict):
          roots['CodeStr'],
          roots['Builtins'],
          roots['NativeFrame'],
-         roots['ThreadList']) = \
+         roots['Thread']) = \
             unpack_fp(self.endianchr + (self.ptrchr * num_roots), fp)
         self.roots = roots
         self.PmObjectClass = PmObjectClass(self.version, self.features)
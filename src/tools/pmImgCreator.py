@@ -51,6 +51,10 @@ __usage__ = """USAGE:
                             file with native functions from the python files.
     --memspace=ram|flash    Sets the memory space in which the image will be
                             placed (default is "ram")
+    --no-optimize           Skip the peephole optimizer; the bytecode is
+                            copied into the image as CPython compiled it
+    --verbose               Print the bytecode size and instruction count
+                            of each module before and after the optimizer
     """
 
 
@@ -90,7 +94,7 @@ OBJ_TYPE_NOB = 0x0C     # Native func obj
 # All types after this never appear in an image
 
 # Number of bytes in a native image (constant)
-NATIVE_IMG_SIZE = 4
+NATIVE_IMG_SIZE = 5
 
 # Maximum number of objs in a tuple
 MAX_TUPLE_LEN = 253
@@ -125,6 +129,13 @@ NATIVE_FUNC_PREFIX = "nat_"
 # Maximum number of locals a native func can have (frame.h)
 NATIVE_MAX_NUM_LOCALS = 8
 
+# Native calling convention flags given after the indicator (codeobj.h)
+# e.g. """__NATIVE__ stackargs noalloc
+NATIVE_FLAGS = {"stackargs": 0x01,
+                "noalloc": 0x02,
+                "strviews": 0x04,
+               }
+
 # Issue #51: In Python 2.5, the module identifier changed from '?' to '<module>'
 if float(sys.version[:3]) < 2.5:
     MODULE_IDENTIFIER = "?"
@@ -134,6 +145,44 @@ else:
 # Old #152: Byte to append after the last image in the list
 IMG_LIST_TERMINATOR = "\xFF"
 
+# PyMite-only bytecodes emitted by the optimizer (must match interp.h).
+# Absolute target; pop TOS and jump if it is false/true.
+POP_JUMP_IF_FALSE = 114
+POP_JUMP_IF_TRUE = 115
+
+# Bytecodes the optimizer strips from the instruction stream
+STRIPPED_BCODES = ("NOP", "SET_LINENO")
+
+# Bytecodes after which execution never falls through to the next one
+NO_FALLTHROUGH_BCODES = ("RETURN_VALUE", "JUMP_FORWARD", "JUMP_ABSOLUTE",
+                         "CONTINUE_LOOP", "BREAK_LOOP", "RAISE_VARARGS")
+
+# Binary operators the optimizer folds on two int constants
+FOLDABLE_BINARY_BCODES = {
+    "BINARY_POWER": lambda a, b: a ** b,
+    "BINARY_MULTIPLY": lambda a, b: a * b,
+    "BINARY_DIVIDE": lambda a, b: a // b,
+    "BINARY_FLOOR_DIVIDE": lambda a, b: a // b,
+    "BINARY_MODULO": lambda a, b: a % b,
+    "BINARY_ADD": lambda a, b: a + b,
+    "BINARY_SUBTRACT": lambda a, b: a - b,
+    "BINARY_LSHIFT": lambda a, b: a << b,
+    "BINARY_RSHIFT": lambda a, b: a >> b,
+    "BINARY_AND": lambda a, b: a & b,
+    "BINARY_XOR": lambda a, b: a ^ b,
+    "BINARY_OR": lambda a, b: a | b,
+    }
+
+# Comparisons the optimizer folds (index into dis.cmp_op)
+FOLDABLE_COMPARISONS = {
+    0: lambda a, b: a < b,
+    1: lambda a, b: a <= b,
+    2: lambda a, b: a == b,
+    3: lambda a, b: a != b,
+    4: lambda a, b: a > b,
+    5: lambda a, b: a >= b,
+    }
+
 
 ################################################################
 # GLOBALS
@@ -270,6 +319,11 @@ class PmImgCreator:
         self._U8_to_str = chr
         self._str_to_U8 = ord
 
+        # optimizer defaults for callers that skip set_options (ipm)
+        self.optimize = True
+        self.verbose = False
+        self.optstats = [0, 0, 0, 0]
+
 
     def set_options(self,
                     outfn,
@@ -278,6 +332,8 @@ class PmImgCreator:
                     memspace,
                     nativeFilename,
                     infiles,
+                    optimize=True,
+                    verbose=False,
                    ):
         self.outfn = outfn
         self.imgtype = imgtype
@@ -285,6 +341,8 @@ class PmImgCreator:
         self.memspace = memspace
         self.nativeFilename = nativeFilename
         self.infiles = infiles
+        self.optimize = optimize
+        self.verbose = verbose
 
 ################################################################
 # CONVERSION FUNCTIONS
@@ -324,8 +382,15 @@ class PmImgCreator:
             # try to compile and convert the file
             co = compile(open(fn).read(), fn, 'exec')
             imgs["fns"].append(fn)
+            self.optstats = [0, 0, 0, 0]
             imgs["imgs"].append(self.co_to_str(co))
 
+            # report what the optimizer saved in this module
+            if self.optimize and self.verbose:
+                nbytes, nbytes_opt, ninstrs, ninstrs_opt = self.optstats
+                print "%s: bytecode %d -> %d bytes, %d -> %d instructions" \
+                      % (fn, nbytes, nbytes_opt, ninstrs, ninstrs_opt)
+
         # Append null terminator to list of images
         imgs["fns"].append("img-list-terminator")
         imgs["imgs"].append(IMG_LIST_TERMINATOR)
@@ -448,6 +513,11 @@ class PmImgCreator:
         # filter code object elements
         consts, names, code, nativecode = self._filter_co(co)
 
+        # optimize the bytecode (rewrites the line number table to match)
+        lnotab = co.co_lnotab
+        if self.optimize:
+            consts, code, lnotab = self._optimize_co(co, consts, code)
+
         # Type and size inserted below
 
         # Appends various constant-sized fields to the image
@@ -476,9 +546,9 @@ class PmImgCreator:
         if PM_FEATURES["HAVE_DEBUG_INFO"]:
 
             # Appends line number table (string) to the image
-            assert len(co.co_lnotab) <= MAX_STRING_LEN
+            assert len(lnotab) <= MAX_STRING_LEN
             s = self._U8_to_str(OBJ_TYPE_STR) + \
-                self._U16_to_str(len(co.co_lnotab)) + co.co_lnotab
+                self._U16_to_str(len(lnotab)) + lnotab
             lenlnotab = len(s)
             imgstr += s
 
@@ -539,7 +609,7 @@ class PmImgCreator:
         objtype = OBJ_TYPE_NIM
 
         # Create native image string
-        # (type, argcount, funcindex)
+        # (type, argcount, flags, funcindex)
         imgstr = (self._U8_to_str(OBJ_TYPE_NIM) +
                   self._U8_to_str(co.co_argcount) +
                   code)
@@ -573,8 +643,9 @@ class PmImgCreator:
             If this function has a native indicator,
             extract the native code from the doc string
             and clear the doc string.
+            Parse any native flags on the indicator line.
             Ensure num args is less or equal to
-            NATIVE_MAX_NUM_LOCALS.
+            NATIVE_MAX_NUM_LOCALS, unless the native takes stackargs.
 
         Names/varnames filter:
             Ensure num names is less than 256.
@@ -667,21 +738,31 @@ class PmImgCreator:
             if (consts[0][:NATIVE_INDICATOR_LENGTH] ==
                 NATIVE_INDICATOR):
 
-                # ensure num args is less or equal
-                # to NATIVE_MAX_NUM_LOCALS
-                assert co.co_nlocals <= NATIVE_MAX_NUM_LOCALS
-
                 # extract native code and clear doc string
                 nativecode = consts[0][NATIVE_INDICATOR_LENGTH:]
                 consts[0] = None
 
+                # extract the native flags from the indicator line
+                flagline, nl, nativecode = nativecode.partition("\n")
+                nativecode = nl + nativecode
+                nativeflags = 0
+                for flagname in flagline.split():
+                    assert flagname in NATIVE_FLAGS, \
+                        "unknown native flag %s in %s" % (flagname, co.co_name)
+                    nativeflags |= NATIVE_FLAGS[flagname]
+
+                # ensure num args is less or equal
+                # to NATIVE_MAX_NUM_LOCALS (stackargs natives have no limit)
+                assert ((co.co_nlocals <= NATIVE_MAX_NUM_LOCALS)
+                        or (nativeflags & NATIVE_FLAGS["stackargs"]))
+
                 # If this co is a module
                 # Old #28: Module root must keep its bytecode
                 if co.co_name == MODULE_IDENTIFIER:
                     self.nativemods.append((co.co_filename, nativecode))
 
                 # Else this co is a function;
-                # replace code with native table index
+                # replace code with native flags and table index
                 else:
                     # stdlib code gets a positive index
                     if self.imgtarget == "std":
@@ -689,6 +770,7 @@ class PmImgCreator:
                     # usr code gets a negative index
                     else:
                         code = self._U16_to_str(-len(self.nativetable))
+                    code = self._U8_to_str(nativeflags) + code
 
                     # native function name is
                     # "nat_<modname>_<pyfuncname>".
@@ -724,6 +806,511 @@ class PmImgCreator:
         return consts, names, code, nativecode
 
 
+################################################################
+# OPTIMIZER FUNCTIONS
+################################################################
+
+    # An instruction is a list: [bcode, arg, target instruction, line number].
+    # Jumps refer to their target instruction rather than to an offset
+    # so instructions can be replaced without recomputing offsets.
+    # Replaced instructions become NOPs which are removed by _compact_instrs.
+
+    def _optimize_co(self, co, consts, code):
+        """Run the peephole optimizer over the filtered bytecode.
+
+        Folds constant unary, binary and comparison operations,
+        resolves conditional jumps on constants, fuses
+        JUMP_IF_FALSE/TRUE + POP_TOP into POP_JUMP_IF_FALSE/TRUE,
+        threads jumps to jumps, removes unreachable code and NOPs
+        and drops consts that are no longer loaded.
+
+        Return the new consts list, code string and line number table.
+        """
+        instrs = self._decode_instrs(co, code)
+        nbytes = len(code)
+        ninstrs = len(instrs)
+
+        for i in range(16):
+            changed = self._fuse_cond_jumps(instrs)
+            changed |= self._fold_consts(instrs, consts)
+            changed |= self._thread_jumps(instrs)
+            changed |= self._remove_unreachable(instrs)
+            instrs = self._compact_instrs(instrs)
+            if not changed:
+                break
+
+        consts = self._prune_consts(instrs, consts)
+        code, lnotab = self._encode_instrs(co, instrs)
+
+        self.optstats[0] += nbytes
+        self.optstats[1] += len(code)
+        self.optstats[2] += ninstrs
+        self.optstats[3] += len(instrs)
+        return consts, code, lnotab
+
+
+    def _is_abs_jump(self, c):
+        """Return True if bcode c takes an absolute target offset."""
+        return c in dis.hasjabs or c in (POP_JUMP_IF_FALSE, POP_JUMP_IF_TRUE)
+
+
+    def _decode_instrs(self, co, code):
+        """Decode the code string into a list of instructions.
+
+        Line numbers come from the code object's line number table.
+        """
+        # (offset, line) at which each line starts
+        linestarts = []
+        offset = 0
+        line = co.co_firstlineno
+        lnotab = co.co_lnotab
+        for i in range(0, len(lnotab), 2):
+            offset += ord(lnotab[i])
+            line += ord(lnotab[i + 1])
+            linestarts.append((offset, line))
+
+        instrs = []
+        offsets = []
+        byoffset = {}
+        line = co.co_firstlineno
+        j = 0
+        i = 0
+        while i < len(code):
+            while j < len(linestarts) and linestarts[j][0] <= i:
+                line = linestarts[j][1]
+                j += 1
+            c = ord(code[i])
+            instr = [c, None, None, line]
+            byoffset[i] = instr
+            offsets.append(i)
+            instrs.append(instr)
+            if c < dis.HAVE_ARGUMENT:
+                i += 1
+            else:
+                instr[1] = self._str_to_U16(code[i+1:i+3])
+                i += 3
+
+        # resolve jump offsets to instructions
+        for instr, offset in zip(instrs, offsets):
+            if instr[0] in dis.hasjrel:
+                instr[2] = byoffset[offset + 3 + instr[1]]
+            elif self._is_abs_jump(instr[0]):
+                instr[2] = byoffset[instr[1]]
+        return instrs
+
+
+    def _encode_instrs(self, co, instrs):
+        """Encode instructions into a code string and line number table.
+
+        A JUMP_FORWARD whose target moved behind it becomes a
+        JUMP_ABSOLUTE; the other relative jumps always stay forward.
+        """
+        JUMP_FORWARD = dis.opmap["JUMP_FORWARD"]
+        JUMP_ABSOLUTE = dis.opmap["JUMP_ABSOLUTE"]
+
+        # assign offsets
+        offsets = {}
+        offset = 0
+        for instr in instrs:
+            offsets[id(instr)] = offset
+            if instr[0] < dis.HAVE_ARGUMENT:
+                offset += 1
+            else:
+                offset += 3
+
+        code = []
+        lnotab = []
+        addr = 0
+        line = co.co_firstlineno
+        for instr in instrs:
+            offset = offsets[id(instr)]
+
+            # line number table entry (lines never decrease, see lnotab)
+            if instr[3] > line:
+                da = offset - addr
+                dl = instr[3] - line
+                while da > 255:
+                    lnotab.append("\xff\x00")
+                    da -= 255
+                while dl > 255:
+                    lnotab.append(chr(da) + "\xff")
+                    da = 0
+                    dl -= 255
+                lnotab.append(chr(da) + chr(dl))
+                addr = offset
+                line = instr[3]
+
+            c, arg, target = instr[:3]
+            if target is not None:
+                arg = offsets[id(target)]
+                if c == JUMP_FORWARD and arg < offset:
+                    c = JUMP_ABSOLUTE
+                elif c in dis.hasjrel:
+                    arg -= offset + 3
+                    assert arg >= 0, "relative jump backward."
+            code.append(self._U8_to_str(c))
+            if c >= dis.HAVE_ARGUMENT:
+                code.append(self._U16_to_str(arg))
+
+        return "".join(code), "".join(lnotab)
+
+
+    def _compact_instrs(self, instrs):
+        """Remove NOPs, moving their jump targets to the next instruction."""
+        NOP = dis.opmap["NOP"]
+        stripped = [dis.opmap.get(name) for name in STRIPPED_BCODES]
+
+        # map each stripped instruction to the instruction after it
+        moved = {}
+        following = None
+        for instr in reversed(instrs):
+            if instr[0] in stripped:
+                instr[0] = NOP
+                moved[id(instr)] = following
+            else:
+                following = instr
+
+        # retarget the jumps that remain (removed code may jump past the end)
+        for instr in instrs:
+            if instr[0] != NOP and id(instr[2]) in moved:
+                instr[2] = moved[id(instr[2])]
+                assert instr[2] is not None, "jump past end of code."
+        return [instr for instr in instrs if instr[0] != NOP]
+
+
+    def _jump_targets(self, instrs):
+        """Return the set of ids of instructions that are jumped to."""
+        return set([id(instr[2]) for instr in instrs if instr[2] is not None])
+
+
+    def _next_instr(self, instrs, i):
+        """Return the first non-NOP instruction after index i (or None)."""
+        NOP = dis.opmap["NOP"]
+        for instr in instrs[i+1:]:
+            if instr[0] != NOP:
+                return instr
+        return None
+
+
+    def _fuse_cond_jumps(self, instrs):
+        """Fuse JUMP_IF_FALSE/TRUE into POP_JUMP_IF_FALSE/TRUE.
+
+        CPython 2.6 follows a conditional jump with a POP_TOP on both
+        paths: "JUMP_IF_FALSE L; POP_TOP; ... L: POP_TOP".  The pair
+        becomes "POP_JUMP_IF_FALSE L+1".  A conditional jump to
+        another conditional jump whose outcome is then known
+        is also retargeted.
+        """
+        NOP = dis.opmap["NOP"]
+        POP_TOP = dis.opmap["POP_TOP"]
+        JUMP_IF_FALSE = dis.opmap["JUMP_IF_FALSE"]
+        JUMP_IF_TRUE = dis.opmap["JUMP_IF_TRUE"]
+        popjump = {JUMP_IF_FALSE: POP_JUMP_IF_FALSE,
+                   JUMP_IF_TRUE: POP_JUMP_IF_TRUE}
+
+        index = dict([(id(instr), i) for i, instr in enumerate(instrs)])
+        targets = self._jump_targets(instrs)
+        changed = False
+        for i, instr in enumerate(instrs):
+            if instr[0] not in popjump:
+                continue
+            target = instr[2]
+
+            # the tested value is unchanged at the target, so its
+            # conditional jump goes the same way
+            if target[0] == instr[0]:
+                instr[2] = target[2]
+                targets.add(id(instr[2]))
+                changed = True
+                continue
+            if target[0] in popjump:
+                instr[2] = self._next_instr(instrs, index[id(target)])
+                targets.add(id(instr[2]))
+                changed = True
+                continue
+
+            # both paths pop the tested value
+            following = self._next_instr(instrs, i)
+            if (target[0] == POP_TOP and following[0] == POP_TOP
+                and id(following) not in targets):
+                instr[0] = popjump[instr[0]]
+                instr[2] = self._next_instr(instrs, index[id(target)])
+                targets.add(id(instr[2]))
+                following[0] = NOP
+                changed = True
+        return changed
+
+
+    def _const_value(self, instr, consts):
+        """Return (True, value) if instr loads a constant."""
+        if instr is not None and instr[0] == dis.opmap["LOAD_CONST"]:
+            return True, consts[instr[1]]
+        return False, None
+
+
+    def _const_index(self, consts, value):
+        """Return the index of value in consts, appending it if needed.
+
+        Constants are matched on type and repr, not on ==, so that
+        0.0 and -0.0, or 1, 1.0 and True, stay distinct constants.
+        """
+        key = (type(value), repr(value))
+        for i, c in enumerate(consts):
+            if (type(c), repr(c)) == key:
+                return i
+        consts.append(value)
+        assert len(consts) < 256, "too many constants."
+        return len(consts) - 1
+
+
+    def _is_foldable_int(self, v):
+        """Return True if v is an int that fits the VM's 32-bit int."""
+        return type(v) == types.IntType and -0x80000000 <= v <= 0x7FFFFFFF
+
+
+    def _fold_binary(self, name, a, b):
+        """Return (True, result) if the VM would compute the same result."""
+        if type(a) == type(b) == types.StringType and name == "BINARY_ADD":
+            if len(a) + len(b) <= MAX_STRING_LEN:
+                return True, a + b
+            return False, None
+        if not (self._is_foldable_int(a) and self._is_foldable_int(b)):
+            return False, None
+
+        # the VM's C operators differ from Python's for negative operands
+        if name in ("BINARY_DIVIDE", "BINARY_FLOOR_DIVIDE", "BINARY_MODULO"):
+            if a < 0 or b <= 0:
+                return False, None
+        elif name in ("BINARY_LSHIFT", "BINARY_RSHIFT"):
+            if a < 0 or not 0 <= b < 32:
+                return False, None
+        elif name == "BINARY_POWER":
+            if b < 0 or (b > 32 and abs(a) > 1):
+                return False, None
+
+        v = FOLDABLE_BINARY_BCODES[name](a, b)
+        if self._is_foldable_int(v):
+            return True, v
+        return False, None
+
+
+    def _fold_unary(self, name, a):
+        """Return (True, result) for a foldable unary operation."""
+        if self._is_foldable_int(a):
+            if name == "UNARY_NEGATIVE" and a != -0x80000000:
+                return True, -a
+            if name == "UNARY_POSITIVE":
+                return True, a
+            if name == "UNARY_INVERT":
+                return True, ~a
+        elif type(a) == types.FloatType:
+            if name == "UNARY_NEGATIVE":
+                return True, -a
+            if name == "UNARY_POSITIVE":
+                return True, a
+        return False, None
+
+
+    def _fold_consts(self, instrs, consts):
+        """Fold operations on constants and conditional jumps on constants.
+
+        Only operand instructions that are not jump targets are folded.
+        A folded comparison is only used to resolve the conditional
+        jump that follows it since the image has no bool constant.
+        """
+        NOP = dis.opmap["NOP"]
+        UNARY_NOT = dis.opmap["UNARY_NOT"]
+        COMPARE_OP = dis.opmap["COMPARE_OP"]
+        JUMP_ABSOLUTE = dis.opmap["JUMP_ABSOLUTE"]
+        JUMP_IF_FALSE = dis.opmap["JUMP_IF_FALSE"]
+        JUMP_IF_TRUE = dis.opmap["JUMP_IF_TRUE"]
+        binary = dict([(dis.opmap[name], name)
+                       for name in FOLDABLE_BINARY_BCODES])
+        unary = dict([(dis.opmap[name], name) for name in
+                      ("UNARY_NEGATIVE", "UNARY_POSITIVE", "UNARY_INVERT")])
+        truthy = (types.IntType, types.FloatType, types.StringType,
+                  types.NoneType)
+
+        targets = self._jump_targets(instrs)
+        changed = False
+
+        # previous two live instructions (with none jumped to in between)
+        prev1 = prev2 = None
+        for i, instr in enumerate(instrs):
+            c = instr[0]
+            if c == NOP:
+                continue
+            if id(instr) in targets:
+                prev1 = prev2 = None
+
+            isconst1, a = self._const_value(prev1, consts)
+            isconst2, b = self._const_value(prev2, consts)
+            folded, truth = False, None
+
+            if c in unary and isconst1:
+                folded, v = self._fold_unary(unary[c], a)
+                if folded:
+                    prev1[0] = NOP
+                    instr[:2] = [dis.opmap["LOAD_CONST"],
+                                 self._const_index(consts, v)]
+
+            elif c in binary and isconst1 and isconst2:
+                folded, v = self._fold_binary(binary[c], b, a)
+                if folded:
+                    prev1[0] = prev2[0] = NOP
+                    instr[:2] = [dis.opmap["LOAD_CONST"],
+                                 self._const_index(consts, v)]
+
+            elif (c == COMPARE_OP and isconst1 and isconst2
+                  and instr[1] in FOLDABLE_COMPARISONS):
+                # fold into the pop-jump that tests the result
+                test = self._next_instr(instrs, i)
+                if (test[0] in (POP_JUMP_IF_FALSE, POP_JUMP_IF_TRUE)
+                    and id(test) not in targets
+                    and (type(a) == type(b) == types.StringType
+                         or (self._is_foldable_int(a)
+                             and self._is_foldable_int(b)))):
+                    truth = FOLDABLE_COMPARISONS[instr[1]](b, a)
+                    prev1[0] = prev2[0] = instr[0] = NOP
+                    if truth == (test[0] == POP_JUMP_IF_TRUE):
+                        test[0] = JUMP_ABSOLUTE
+                    else:
+                        test[0] = NOP
+                    folded = True
+
+            elif c == UNARY_NOT:
+                # "not x" under a pop-jump tests x the other way
+                test = self._next_instr(instrs, i)
+                if (test[0] in (POP_JUMP_IF_FALSE, POP_JUMP_IF_TRUE)
+                    and id(test) not in targets):
+                    test[0] = (POP_JUMP_IF_FALSE + POP_JUMP_IF_TRUE) - test[0]
+                    instr[0] = NOP
+                    folded = True
+
+            elif (c in (POP_JUMP_IF_FALSE, POP_JUMP_IF_TRUE) and isconst1
+                  and type(a) in truthy):
+                prev1[0] = NOP
+                if bool(a) == (c == POP_JUMP_IF_TRUE):
+                    instr[0] = JUMP_ABSOLUTE
+                else:
+                    instr[0] = NOP
+                folded = True
+
+            elif (c in (JUMP_IF_FALSE, JUMP_IF_TRUE) and isconst1
+                  and type(a) in truthy):
+                # the value stays on the stack either way
+                if bool(a) == (c == JUMP_IF_TRUE):
+                    instr[0] = JUMP_ABSOLUTE
+                else:
+                    instr[0] = NOP
+                folded = True
+
+            if folded:
+                changed = True
+                prev1 = prev2 = None
+                if instr[0] == dis.opmap["LOAD_CONST"]:
+                    prev1 = instr
+                continue
+            prev2 = prev1
+            prev1 = instr
+
+        return changed
+
+
+    def _thread_jumps(self, instrs):
+        """Retarget jumps to unconditional jumps and remove jumps to next.
+
+        A relative jump is only retargeted forward.
+        """
+        NOP = dis.opmap["NOP"]
+        POP_TOP = dis.opmap["POP_TOP"]
+        JUMP_FORWARD = dis.opmap["JUMP_FORWARD"]
+        JUMP_ABSOLUTE = dis.opmap["JUMP_ABSOLUTE"]
+        uncond = (JUMP_FORWARD, JUMP_ABSOLUTE)
+        threadable = (JUMP_FORWARD, JUMP_ABSOLUTE, POP_JUMP_IF_FALSE,
+                      POP_JUMP_IF_TRUE, dis.opmap["JUMP_IF_FALSE"],
+                      dis.opmap["JUMP_IF_TRUE"], dis.opmap["FOR_ITER"])
+        condjump = (dis.opmap["JUMP_IF_FALSE"], dis.opmap["JUMP_IF_TRUE"])
+
+        index = dict([(id(instr), i) for i, instr in enumerate(instrs)])
+        changed = False
+        for i, instr in enumerate(instrs):
+            if instr[0] not in threadable:
+                continue
+
+            # follow the chain of unconditional jumps (which may loop)
+            target = instr[2]
+            seen = set()
+            while target[0] in uncond and id(target) not in seen:
+                seen.add(id(target))
+                target = target[2]
+            backward = index[id(target)] <= i
+            if target is not instr[2] and (instr[0] in uncond
+                                           or self._is_abs_jump(instr[0])
+                                           or not backward):
+                instr[2] = target
+                changed = True
+
+            # a jump to the next instruction
+            if target is self._next_instr(instrs, i):
+                if instr[0] in uncond or instr[0] in condjump:
+                    instr[0] = NOP
+                    changed = True
+                elif instr[0] in (POP_JUMP_IF_FALSE, POP_JUMP_IF_TRUE):
+                    instr[:3] = [POP_TOP, None, None]
+                    changed = True
+        return changed
+
+
+    def _remove_unreachable(self, instrs):
+        """Replace instructions no path of execution reaches with NOPs."""
+        NOP = dis.opmap["NOP"]
+        nofallthrough = [dis.opmap[name] for name in NO_FALLTHROUGH_BCODES]
+        index = dict([(id(instr), i) for i, instr in enumerate(instrs)])
+
+        reached = [False] * len(instrs)
+        pending = [0]
+        while pending:
+            i = pending.pop()
+            while i < len(instrs) and not reached[i]:
+                reached[i] = True
+                instr = instrs[i]
+                if instr[2] is not None:
+                    pending.append(index[id(instr[2])])
+                if instr[0] in nofallthrough:
+                    break
+                i += 1
+
+        changed = False
+        for i, instr in enumerate(instrs):
+            if not reached[i] and instr[0] != NOP:
+                instr[:3] = [NOP, None, None]
+                changed = True
+        return changed
+
+
+    def _prune_consts(self, instrs, consts):
+        """Drop consts no LOAD_CONST refers to and renumber the rest.
+
+        The first const stays since it is the doc string slot.
+        """
+        LOAD_CONST = dis.opmap["LOAD_CONST"]
+        used = set([0])
+        for instr in instrs:
+            if instr[0] == LOAD_CONST:
+                used.add(instr[1])
+        renum = {}
+        pruned = []
+        for i, c in enumerate(consts):
+            if i in used:
+                renum[i] = len(pruned)
+                pruned.append(c)
+        for instr in instrs:
+            if instr[0] == LOAD_CONST:
+                instr[1] = renum[instr[1]]
+        return pruned
+
+
 ################################################################
 # IMAGE WRITING FUNCTIONS
 ################################################################
@@ -898,7 +1485,8 @@ def parse_cmdline():
     try:
         opts, args = getopt.getopt(sys.argv[1:],
                                    "f:bcsuo:",
-                                   ["memspace=", "native-file="])
+                                   ["memspace=", "native-file=",
+                                    "no-optimize", "verbose"])
     except:
         print __usage__
         sys.exit(EX_USAGE)
@@ -909,6 +1497,8 @@ def parse_cmdline():
     memspace = "ram"
     outfn = None
     nativeFilename = None
+    optimize = True
+    verbose = False
     for opt in opts:
         if opt[0] == "-b":
             imgtype = ".bin"
@@ -932,6 +1522,10 @@ def parse_cmdline():
                 print __usage__
                 sys.exit(EX_USAGE)
             nativeFilename = opt[1]
+        elif opt[0] == "--no-optimize":
+            optimize = False
+        elif opt[0] == "--verbose":
+            verbose = True
         elif opt[0] == "-f":
             pmfeatures_filename = opt[1]
         elif opt[0] == "-o":
@@ -951,13 +1545,16 @@ def parse_cmdline():
         print __usage__
         sys.exit(EX_USAGE)
 
-    return outfn, imgtype, imgtarget, memspace, nativeFilename, args, pmfeatures_filename
+    return outfn, imgtype, imgtarget, memspace, nativeFilename, args, \
+           pmfeatures_filename, optimize, verbose
 
 
 def main():
-    outfn, imgtyp, imgtarget, memspace, natfn, fns, pmfn = parse_cmdline()
+    outfn, imgtyp, imgtarget, memspace, natfn, fns, pmfn, opt, verbose = \
+        parse_cmdline()
     pic = PmImgCreator(pmfn)
-    pic.set_options(outfn, imgtyp, imgtarget, memspace, natfn, fns)
+    pic.set_options(outfn, imgtyp, imgtarget, memspace, natfn, fns, opt,
+                    verbose)
     pic.convert_files()
     pic.write_image_file()
     pic.write_native_file()
@@ -44,19 +44,24 @@ TYPES = (
     'OBJ_TYPE_NIM',
     'OBJ_TYPE_NOB',
     'OBJ_TYPE_THR',
-    0x0E,
+    'OBJ_TYPE_SVW',
     'OBJ_TYPE_BOOL',
     'OBJ_TYPE_CIO',
     'OBJ_TYPE_MTH',
     'OBJ_TYPE_LST',
     'OBJ_TYPE_DIC',
-    0x14,0x15,0x16,0x17,0x18,
+    0x14,
+    'OBJ_TYPE_GEN',
+    'OBJ_TYPE_XRG',
+    'OBJ_TYPE_SET',
+    0x18,
     'OBJ_TYPE_FRM',
     'OBJ_TYPE_BLK',
     'OBJ_TYPE_SEG',
     'OBJ_TYPE_SGL',
     'OBJ_TYPE_SQI',
     'OBJ_TYPE_NFM',
+    'OBJ_TYPE_DTB',
 )
 
 
@@ -0,0 +1,830 @@
+/*
+# This file is Copyright 2013 Dean Hall.
+# This file is part of the PyMite VM.
+# This file is licensed under the MIT License.
+# See the LICENSE file for details.
+*/
+
+
+#undef __FILE_ID__
+#define __FILE_ID__ 0x1C
+
+
+/**
+ * \file
+ * \brief Array Object Type
+ *
+ * Typed numeric array object type operations.
+ *
+ * The kernels are plain counted loops over one C type so that an
+ * optimizing compiler can vectorize them.  The float and int16 kernels
+ * (the usual sample types) also have explicit SSE2 and NEON paths, which
+ * work at any optimization level; they add float lanes in a different
+ * order, so a float sum or dot product may differ in its last bits.
+ */
+
+
+#include "pm.h"
+#ifdef HAVE_ARRAY
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define ARRAY_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define ARRAY_NEON
+#endif
+
+
+/* Return ptrs to the items of an array as each item type */
+#define ARRAY_B(parr) ((int8_t *)ARRAY_GET_ITEMS(parr))
+#define ARRAY_H(parr) ((int16_t *)ARRAY_GET_ITEMS(parr))
+#define ARRAY_I(parr) ((int32_t *)ARRAY_GET_ITEMS(parr))
+#define ARRAY_F(parr) ((float *)ARRAY_GET_ITEMS(parr))
+
+
+/* Returns the int item at the index (not for 'f') */
+static
+int32_t
+array_getInt(pPmObj_t parr, uint16_t index)
+{
+    switch (ARRAY_GET_TYPECODE(parr))
+    {
+        case 'b':
+            return ARRAY_B(parr)[index];
+        case 'h':
+            return ARRAY_H(parr)[index];
+        default:
+            return ARRAY_I(parr)[index];
+    }
+}
+
+
+/* Gets the value of an int or bool, or raises TypeError */
+static
+PmReturn_t
+array_getIntArg(pPmObj_t pobj, int32_t *r_n)
+{
+    PmReturn_t retval = PM_RET_OK;
+
+    if ((OBJ_GET_TYPE(pobj) != OBJ_TYPE_INT)
+        && (OBJ_GET_TYPE(pobj) != OBJ_TYPE_BOOL))
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+    *r_n = ((pPmInt_t)pobj)->val;
+    return retval;
+}
+
+
+#ifdef HAVE_FLOAT
+/* Gets the value of an int, bool or float as a float, or raises TypeError */
+static
+PmReturn_t
+array_getFloatArg(pPmObj_t pobj, float *r_f)
+{
+    PmReturn_t retval = PM_RET_OK;
+    int32_t n;
+
+    if (OBJ_GET_TYPE(pobj) == OBJ_TYPE_FLT)
+    {
+        *r_f = ((pPmFloat_t)pobj)->val;
+        return retval;
+    }
+    retval = array_getIntArg(pobj, &n);
+    *r_f = (float)n;
+    return retval;
+}
+#endif /* HAVE_FLOAT */
+
+
+/* Raises TypeError or ValueError unless the arrays are alike */
+static
+PmReturn_t
+array_checkAlike(pPmObj_t parr1, pPmObj_t parr2)
+{
+    PmReturn_t retval = PM_RET_OK;
+
+    if (ARRAY_GET_TYPECODE(parr1) != ARRAY_GET_TYPECODE(parr2))
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+    }
+    else if (ARRAY_GET_LENGTH(parr1) != ARRAY_GET_LENGTH(parr2))
+    {
+        PM_RAISE(retval, PM_RET_EX_VAL);
+    }
+    return retval;
+}
+
+
+PmReturn_t
+array_new(uint8_t typecode, uint16_t length, pPmObj_t *r_parr)
+{
+    PmReturn_t retval = PM_RET_OK;
+    pPmBytes_t pb;
+    uint32_t nbytes;
+    uint8_t itemshift;
+
+    /* Get log2 of the number of bytes per item */
+    switch (typecode)
+    {
+        case 'b':
+            itemshift = 0;
+            break;
+        case 'h':
+            itemshift = 1;
+            break;
+        case 'i':
+#ifdef HAVE_FLOAT
+        case 'f':
+#endif /* HAVE_FLOAT */
+            itemshift = 2;
+            break;
+        default:
+            PM_RAISE(retval, PM_RET_EX_VAL);
+            return retval;
+    }
+
+    /* Raise MemoryError if the items can not fit in one chunk */
+    nbytes = (uint32_t)length << itemshift;
+    if (nbytes > ARRAY_MAX_BYTES)
+    {
+        PM_RAISE(retval, PM_RET_EX_MEM);
+        return retval;
+    }
+
+    retval = heap_getChunk(sizeof(PmBytes_t) + ARRAY_HDR_SIZE + nbytes,
+                           (uint8_t **)&pb);
+    PM_RETURN_IF_ERROR(retval);
+    OBJ_SET_TYPE(pb, OBJ_TYPE_BYS);
+    pb->length = (uint16_t)(ARRAY_HDR_SIZE + nbytes);
+    pb->users = 1;
+    pb->val[0] = typecode;
+    pb->val[1] = itemshift;
+    pb->val[2] = 0;
+    sli_memset((unsigned char *)ARRAY_GET_ITEMS(pb), '\0', nbytes);
+
+    *r_parr = (pPmObj_t)pb;
+    return retval;
+}
+
+
+PmReturn_t
+array_unwrap(pPmObj_t pobj, pPmObj_t *r_parr)
+{
+    PmReturn_t retval = PM_RET_EX_KEY;
+
+    if (OBJ_GET_TYPE(pobj) == OBJ_TYPE_CLI)
+    {
+        retval = dict_getItem((pPmObj_t)((pPmInstance_t)pobj)->cli_attrs,
+                              PM_NONE,
+                              r_parr);
+    }
+
+    /* Raise TypeError if it is not an instance that holds an array */
+    if ((retval != PM_RET_OK) || (OBJ_GET_TYPE(*r_parr) != OBJ_TYPE_BYS))
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+    }
+    return retval;
+}
+
+
+PmReturn_t
+array_getItem(pPmObj_t parr, int16_t index, pPmObj_t *r_pobj)
+{
+    PmReturn_t retval = PM_RET_OK;
+    uint16_t len = ARRAY_GET_LENGTH(parr);
+
+    /* Adjust a negative index */
+    if (index < 0)
+    {
+        index += len;
+    }
+
+    /* Check the bounds of the index */
+    if ((index < 0) || (index >= len))
+    {
+        PM_RAISE(retval, PM_RET_EX_INDX);
+        return retval;
+    }
+
+#ifdef HAVE_FLOAT
+    if (ARRAY_GET_TYPECODE(parr) == 'f')
+    {
+        return float_new(ARRAY_F(parr)[index], r_pobj);
+    }
+#endif /* HAVE_FLOAT */
+
+    return int_new(array_getInt(parr, index), r_pobj);
+}
+
+
+PmReturn_t
+array_setItem(pPmObj_t parr, int16_t index, pPmObj_t pobj)
+{
+    PmReturn_t retval = PM_RET_OK;
+    uint16_t len = ARRAY_GET_LENGTH(parr);
+    int32_t n;
+
+    /* Adjust a negative index */
+    if (index < 0)
+    {
+        index += len;
+    }
+
+    /* Check the bounds of the index */
+    if ((index < 0) || (index >= len))
+    {
+        PM_RAISE(retval, PM_RET_EX_INDX);
+        return retval;
+    }
+
+#ifdef HAVE_FLOAT
+    if (ARRAY_GET_TYPECODE(parr) == 'f')
+    {
+        return array_getFloatArg(pobj, &(ARRAY_F(parr)[index]));
+    }
+#endif /* HAVE_FLOAT */
+
+    retval = array_getIntArg(pobj, &n);
+    PM_RETURN_IF_ERROR(retval);
+
+    /* Raise OverflowError if the int does not fit the item type */
+    switch (ARRAY_GET_TYPECODE(parr))
+    {
+        case 'b':
+            if ((n < -128) || (n > 127))
+            {
+                PM_RAISE(retval, PM_RET_EX_OFLOW);
+                break;
+            }
+            ARRAY_B(parr)[index] = (int8_t)n;
+            break;
+
+        case 'h':
+            if ((n < -32768) || (n > 32767))
+            {
+                PM_RAISE(retval, PM_RET_EX_OFLOW);
+                break;
+            }
+            ARRAY_H(parr)[index] = (int16_t)n;
+            break;
+
+        default:
+            ARRAY_I(parr)[index] = n;
+            break;
+    }
+    return retval;
+}
+
+
+#ifdef HAVE_FLOAT
+/* Returns the sum of the products of the floats (or just their sum) */
+static
+float
+array_dotFloat(float const *pf1, float const *pf2, uint16_t n)
+{
+    float sum = 0.0;
+    uint16_t i = 0;
+#if defined(ARRAY_SSE2)
+    __m128 acc = _mm_setzero_ps();
+    float lanes[4];
+#elif defined(ARRAY_NEON)
+    float32x4_t acc = vdupq_n_f32(0.0f);
+#endif
+
+#if defined(ARRAY_SSE2)
+    for (; (i + 4) <= n; i += 4)
+    {
+        acc = _mm_add_ps(acc, (pf2 == C_NULL)
+                         ? _mm_loadu_ps(&pf1[i])
+                         : _mm_mul_ps(_mm_loadu_ps(&pf1[i]),
+                                      _mm_loadu_ps(&pf2[i])));
+    }
+    _mm_storeu_ps(lanes, acc);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(ARRAY_NEON)
+    for (; (i + 4) <= n; i += 4)
+    {
+        acc = (pf2 == C_NULL)
+            ? vaddq_f32(acc, vld1q_f32(&pf1[i]))
+            : vmlaq_f32(acc, vld1q_f32(&pf1[i]), vld1q_f32(&pf2[i]));
+    }
+    sum = (vgetq_lane_f32(acc, 0) + vgetq_lane_f32(acc, 1))
+          + (vgetq_lane_f32(acc, 2) + vgetq_lane_f32(acc, 3));
+#endif
+
+    for (; i < n; i++)
+    {
+        sum += (pf2 == C_NULL) ? pf1[i] : pf1[i] * pf2[i];
+    }
+    return sum;
+}
+#endif /* HAVE_FLOAT */
+
+
+/* Returns the sum of the products of the int16s, wrapping at 32 bits */
+static
+uint32_t
+array_dotInt16(int16_t const *ph1, int16_t const *ph2, uint16_t n)
+{
+    uint32_t sum = 0;
+    uint16_t i = 0;
+#if defined(ARRAY_SSE2)
+    __m128i acc = _mm_setzero_si128();
+    int32_t lanes[4];
+#elif defined(ARRAY_NEON)
+    int32x4_t acc = vdupq_n_s32(0);
+#endif
+
+#if defined(ARRAY_SSE2)
+    /* Multiplies eight pairs and adds adjacent products into four lanes */
+    for (; (i + 8) <= n; i += 8)
+    {
+        acc = _mm_add_epi32(acc,
+                            _mm_madd_epi16(
+                                _mm_loadu_si128((__m128i const *)&ph1[i]),
+                                _mm_loadu_si128((__m128i const *)&ph2[i])));
+    }
+    _mm_storeu_si128((__m128i *)lanes, acc);
+    sum = (uint32_t)lanes[0] + (uint32_t)lanes[1]
+          + (uint32_t)lanes[2] + (uint32_t)lanes[3];
+#elif defined(ARRAY_NEON)
+    for (; (i + 4) <= n; i += 4)
+    {
+        acc = vmlal_s16(acc, vld1_s16(&ph1[i]), vld1_s16(&ph2[i]));
+    }
+    sum = (uint32_t)vgetq_lane_s32(acc, 0) + (uint32_t)vgetq_lane_s32(acc, 1)
+          + (uint32_t)vgetq_lane_s32(acc, 2) + (uint32_t)vgetq_lane_s32(acc, 3);
+#endif
+
+    for (; i < n; i++)
+    {
+        sum += (uint32_t)((int32_t)ph1[i] * ph2[i]);
+    }
+    return sum;
+}
+
+
+PmReturn_t
+array_sum(pPmObj_t parr, pPmObj_t *r_pobj)
+{
+    uint32_t sum = 0;
+    uint16_t len = ARRAY_GET_LENGTH(parr);
+    uint16_t i;
+
+    switch (ARRAY_GET_TYPECODE(parr))
+    {
+        case 'b':
+            for (i = 0; i < len; i++)
+            {
+                sum += (uint32_t)ARRAY_B(parr)[i];
+            }
+            break;
+
+        case 'h':
+            for (i = 0; i < len; i++)
+            {
+                sum += (uint32_t)ARRAY_H(parr)[i];
+            }
+            break;
+
+        case 'i':
+            for (i = 0; i < len; i++)
+            {
+                sum += (uint32_t)ARRAY_I(parr)[i];
+            }
+            break;
+
+#ifdef HAVE_FLOAT
+        case 'f':
+            return float_new(array_dotFloat(ARRAY_F(parr), C_NULL, len),
+                             r_pobj);
+#endif /* HAVE_FLOAT */
+    }
+
+    return int_new((int32_t)sum, r_pobj);
+}
+
+
+PmReturn_t
+array_minMax(pPmObj_t parr, uint8_t ismax, pPmObj_t *r_pobj)
+{
+    PmReturn_t retval = PM_RET_OK;
+    int32_t m;
+    int32_t x;
+    uint16_t len = ARRAY_GET_LENGTH(parr);
+    uint16_t i;
+#ifdef HAVE_FLOAT
+    float mf;
+#endif /* HAVE_FLOAT */
+
+    /* Raise ValueError if there are no items */
+    if (len == 0)
+    {
+        PM_RAISE(retval, PM_RET_EX_VAL);
+        return retval;
+    }
+
+#ifdef HAVE_FLOAT
+    if (ARRAY_GET_TYPECODE(parr) == 'f')
+    {
+        mf = ARRAY_F(parr)[0];
+        for (i = 1; i < len; i++)
+        {
+            if (ismax ? (ARRAY_F(parr)[i] > mf) : (ARRAY_F(parr)[i] < mf))
+            {
+                mf = ARRAY_F(parr)[i];
+            }
+        }
+        return float_new(mf, r_pobj);
+    }
+#endif /* HAVE_FLOAT */
+
+    m = array_getInt(parr, 0);
+    for (i = 1; i < len; i++)
+    {
+        x = array_getInt(parr, i);
+        if (ismax ? (x > m) : (x < m))
+        {
+            m = x;
+        }
+    }
+    return int_new(m, r_pobj);
+}
+
+
+PmReturn_t
+array_dot(pPmObj_t parr1, pPmObj_t parr2, pPmObj_t *r_pobj)
+{
+    PmReturn_t retval;
+    uint32_t sum = 0;
+    uint16_t len = ARRAY_GET_LENGTH(parr1);
+    uint16_t i;
+
+    retval = array_checkAlike(parr1, parr2);
+    PM_RETURN_IF_ERROR(retval);
+
+    switch (ARRAY_GET_TYPECODE(parr1))
+    {
+        case 'b':
+            for (i = 0; i < len; i++)
+            {
+                sum += (uint32_t)((int32_t)ARRAY_B(parr1)[i]
+                                  * ARRAY_B(parr2)[i]);
+            }
+            break;
+
+        case 'h':
+            sum = array_dotInt16(ARRAY_H(parr1), ARRAY_H(parr2), len);
+            break;
+
+        case 'i':
+            for (i = 0; i < len; i++)
+            {
+                sum += (uint32_t)ARRAY_I(parr1)[i]
+                       * (uint32_t)ARRAY_I(parr2)[i];
+            }
+            break;
+
+#ifdef HAVE_FLOAT
+        case 'f':
+            return float_new(array_dotFloat(ARRAY_F(parr1), ARRAY_F(parr2),
+                                            len),
+                             r_pobj);
+#endif /* HAVE_FLOAT */
+    }
+
+    return int_new((int32_t)sum, r_pobj);
+}
+
+
+PmReturn_t
+array_scale(pPmObj_t parr, pPmObj_t pmul, pPmObj_t poffset)
+{
+    PmReturn_t retval;
+    uint16_t len = ARRAY_GET_LENGTH(parr);
+    uint16_t i = 0;
+    uint32_t mul;
+    uint32_t offset;
+    int32_t n;
+#ifdef HAVE_FLOAT
+    float fmul;
+    float foffset;
+#if defined(ARRAY_SSE2)
+    __m128 vmul;
+    __m128 voffset;
+#elif defined(ARRAY_NEON)
+    float32x4_t vmul;
+    float32x4_t voffset;
+#endif
+
+    if (ARRAY_GET_TYPECODE(parr) == 'f')
+    {
+        retval = array_getFloatArg(pmul, &fmul);
+        PM_RETURN_IF_ERROR(retval);
+        retval = array_getFloatArg(poffset, &foffset);
+        PM_RETURN_IF_ERROR(retval);
+
+#if defined(ARRAY_SSE2)
+        vmul = _mm_set1_ps(fmul);
+        voffset = _mm_set1_ps(foffset);
+        for (; (i + 4) <= len; i += 4)
+        {
+            _mm_storeu_ps(&(ARRAY_F(parr)[i]),
+                          _mm_add_ps(
+                              _mm_mul_ps(_mm_loadu_ps(&ARRAY_F(parr)[i]),
+                                         vmul),
+                              voffset));
+        }
+#elif defined(ARRAY_NEON)
+        vmul = vdupq_n_f32(fmul);
+        voffset = vdupq_n_f32(foffset);
+        for (; (i + 4) <= len; i += 4)
+        {
+            vst1q_f32(&(ARRAY_F(parr)[i]),
+                      vmlaq_f32(voffset, vld1q_f32(&ARRAY_F(parr)[i]), vmul));
+        }
+#endif
+        for (; i < len; i++)
+        {
+            ARRAY_F(parr)[i] = ARRAY_F(parr)[i] * fmul + foffset;
+        }
+        return retval;
+    }
+#endif /* HAVE_FLOAT */
+
+    retval = array_getIntArg(pmul, &n);
+    PM_RETURN_IF_ERROR(retval);
+    mul = (uint32_t)n;
+    retval = array_getIntArg(poffset, &n);
+    PM_RETURN_IF_ERROR(retval);
+    offset = (uint32_t)n;
+
+    /* Unsigned math wraps where signed overflow would be undefined */
+    switch (ARRAY_GET_TYPECODE(parr))
+    {
+        case 'b':
+            for (i = 0; i < len; i++)
+            {
+                ARRAY_B(parr)[i] =
+                    (int8_t)((uint32_t)ARRAY_B(parr)[i] * mul + offset);
+            }
+            break;
+
+        case 'h':
+            for (i = 0; i < len; i++)
+            {
+                ARRAY_H(parr)[i] =
+                    (int16_t)((uint32_t)ARRAY_H(parr)[i] * mul + offset);
+            }
+            break;
+
+        case 'i':
+            for (i = 0; i < len; i++)
+            {
+                ARRAY_I(parr)[i] =
+                    (int32_t)((uint32_t)ARRAY_I(parr)[i] * mul + offset);
+            }
+            break;
+    }
+    return retval;
+}
+
+
+PmReturn_t
+array_op(pPmObj_t parr1, pPmObj_t parr2, int8_t op)
+{
+    PmReturn_t retval;
+    uint16_t n = ARRAY_GET_LENGTH(parr1);
+    uint16_t i = 0;
+
+    C_ASSERT((op == '+') || (op == '*'));
+
+    retval = array_checkAlike(parr1, parr2);
+    PM_RETURN_IF_ERROR(retval);
+
+    switch (ARRAY_GET_TYPECODE(parr1))
+    {
+        case 'b':
+            for (i = 0; i < n; i++)
+            {
+                ARRAY_B(parr1)[i] = (int8_t)((op == '+')
+                    ? (uint32_t)ARRAY_B(parr1)[i]
+                      + (uint32_t)ARRAY_B(parr2)[i]
+                    : (uint32_t)ARRAY_B(parr1)[i]
+                      * (uint32_t)ARRAY_B(parr2)[i]);
+            }
+            break;
+
+        case 'h':
+#if defined(ARRAY_SSE2)
+            for (; (i + 8) <= n; i += 8)
+            {
+                __m128i x =
+                    _mm_loadu_si128((__m128i const *)&ARRAY_H(parr1)[i]);
+                __m128i y =
+                    _mm_loadu_si128((__m128i const *)&ARRAY_H(parr2)[i]);
+
+                _mm_storeu_si128((__m128i *)&(ARRAY_H(parr1)[i]),
+                                 (op == '+')
+                                 ? _mm_add_epi16(x, y)
+                                 : _mm_mullo_epi16(x, y));
+            }
+#elif defined(ARRAY_NEON)
+            for (; (i + 8) <= n; i += 8)
+            {
+                int16x8_t x = vld1q_s16(&ARRAY_H(parr1)[i]);
+                int16x8_t y = vld1q_s16(&ARRAY_H(parr2)[i]);
+
+                vst1q_s16(&(ARRAY_H(parr1)[i]),
+                          (op == '+') ? vaddq_s16(x, y) : vmulq_s16(x, y));
+            }
+#endif
+            for (; i < n; i++)
+            {
+                ARRAY_H(parr1)[i] = (int16_t)((op == '+')
+                    ? (uint32_t)ARRAY_H(parr1)[i]
+                      + (uint32_t)ARRAY_H(parr2)[i]
+                    : (uint32_t)ARRAY_H(parr1)[i]
+                      * (uint32_t)ARRAY_H(parr2)[i]);
+            }
+            break;
+
+        case 'i':
+            for (i = 0; i < n; i++)
+            {
+                ARRAY_I(parr1)[i] = (int32_t)((op == '+')
+                    ? (uint32_t)ARRAY_I(parr1)[i]
+                      + (uint32_t)ARRAY_I(parr2)[i]
+                    : (uint32_t)ARRAY_I(parr1)[i]
+                      * (uint32_t)ARRAY_I(parr2)[i]);
+            }
+            break;
+
+#ifdef HAVE_FLOAT
+        case 'f':
+#if defined(ARRAY_SSE2)
+            for (; (i + 4) <= n; i += 4)
+            {
+                __m128 x = _mm_loadu_ps(&ARRAY_F(parr1)[i]);
+                __m128 y = _mm_loadu_ps(&ARRAY_F(parr2)[i]);
+
+                _mm_storeu_ps(&(ARRAY_F(parr1)[i]),
+                              (op == '+') ? _mm_add_ps(x, y) : _mm_mul_ps(x, y));
+            }
+#elif defined(ARRAY_NEON)
+            for (; (i + 4) <= n; i += 4)
+            {
+                float32x4_t x = vld1q_f32(&ARRAY_F(parr1)[i]);
+                float32x4_t y = vld1q_f32(&ARRAY_F(parr2)[i]);
+
+                vst1q_f32(&(ARRAY_F(parr1)[i]),
+                          (op == '+') ? vaddq_f32(x, y) : vmulq_f32(x, y));
+            }
+#endif
+            for (; i < n; i++)
+            {
+                ARRAY_F(parr1)[i] = (op == '+')
+                    ? ARRAY_F(parr1)[i] + ARRAY_F(parr2)[i]
+                    : ARRAY_F(parr1)[i] * ARRAY_F(parr2)[i];
+            }
+            break;
+#endif /* HAVE_FLOAT */
+    }
+    return retval;
+}
+
+
+PmReturn_t
+array_movingAverage(pPmObj_t parr, uint16_t n, pPmObj_t *r_parr)
+{
+    PmReturn_t retval = PM_RET_OK;
+    pPmObj_t pnew;
+    int32_t sum = 0;
+    int32_t mean;
+    uint16_t len = ARRAY_GET_LENGTH(parr);
+    uint16_t i;
+    uint8_t objid;
+#ifdef HAVE_FLOAT
+    float fsum = 0.0;
+#endif /* HAVE_FLOAT */
+
+    /* Raise ValueError if a run would be empty or longer than the array */
+    if ((n == 0) || (n > len))
+    {
+        PM_RAISE(retval, PM_RET_EX_VAL);
+        return retval;
+    }
+
+    heap_gcPushTempRoot(parr, &objid);
+    retval = array_new(ARRAY_GET_TYPECODE(parr), len - n + 1, &pnew);
+    heap_gcPopTempRoot(objid);
+    PM_RETURN_IF_ERROR(retval);
+
+    /* Keep a running sum: add the item entering the run, drop the leaving */
+#ifdef HAVE_FLOAT
+    if (ARRAY_GET_TYPECODE(parr) == 'f')
+    {
+        for (i = 0; i < len; i++)
+        {
+            fsum += ARRAY_F(parr)[i];
+            if (i >= n)
+            {
+                fsum -= ARRAY_F(parr)[i - n];
+            }
+            if (i >= (n - 1))
+            {
+                ARRAY_F(pnew)[i - n + 1] = fsum / n;
+            }
+        }
+        *r_parr = pnew;
+        return retval;
+    }
+#endif /* HAVE_FLOAT */
+
+    for (i = 0; i < len; i++)
+    {
+        sum = (int32_t)((uint32_t)sum + (uint32_t)array_getInt(parr, i));
+        if (i >= n)
+        {
+            sum = (int32_t)((uint32_t)sum
+                            - (uint32_t)array_getInt(parr, i - n));
+        }
+        if (i < (n - 1))
+        {
+            continue;
+        }
+
+        /* Floor the mean, as int division does */
+        mean = sum / n;
+        if (((sum % n) != 0) && (sum < 0))
+        {
+            mean--;
+        }
+
+        switch (ARRAY_GET_TYPECODE(parr))
+        {
+            case 'b':
+                ARRAY_B(pnew)[i - n + 1] = (int8_t)mean;
+                break;
+            case 'h':
+                ARRAY_H(pnew)[i - n + 1] = (int16_t)mean;
+                break;
+            default:
+                ARRAY_I(pnew)[i - n + 1] = mean;
+                break;
+        }
+    }
+
+    *r_parr = pnew;
+    return retval;
+}
+
+
+#ifdef HAVE_PRINT
+PmReturn_t
+array_print(pPmObj_t parr)
+{
+    PmReturn_t retval = PM_RET_OK;
+    uint8_t buf[12];
+    uint16_t len = ARRAY_GET_LENGTH(parr);
+    uint16_t i;
+#ifdef HAVE_FLOAT
+    pPmObj_t pf;
+#endif /* HAVE_FLOAT */
+
+    sli_puts((uint8_t *)"array('");
+    plat_putByte(ARRAY_GET_TYPECODE(parr));
+    sli_puts((uint8_t *)"', [");
+    for (i = 0; i < len; i++)
+    {
+        if (i != 0)
+        {
+            plat_putByte(',');
+            plat_putByte(' ');
+        }
+
+#ifdef HAVE_FLOAT
+        if (ARRAY_GET_TYPECODE(parr) == 'f')
+        {
+            retval = float_new(ARRAY_F(parr)[i], &pf);
+            PM_RETURN_IF_ERROR(retval);
+            retval = float_print(pf);
+            PM_RETURN_IF_ERROR(retval);
+            continue;
+        }
+#endif /* HAVE_FLOAT */
+
+        retval = sli_ltoa10(array_getInt(parr, i), buf, sizeof(buf));
+        PM_RETURN_IF_ERROR(retval);
+        sli_puts(buf);
+    }
+
+    plat_putByte(']');
+    return plat_putByte(')');
+}
+#endif /* HAVE_PRINT */
+#endif /* HAVE_ARRAY */
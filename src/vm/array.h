@@ -0,0 +1,177 @@
+/*
+# This file is Copyright 2013 Dean Hall.
+# This file is part of the PyMite VM.
+# This file is licensed under the MIT License.
+# See the LICENSE file for details.
+*/
+
+
+#ifndef __ARRAY_H__
+#define __ARRAY_H__
+
+
+/**
+ * \file
+ * \brief Array Object Type
+ *
+ * Typed numeric array object type header.
+ */
+
+
+/**
+ * Array
+ *
+ * A fixed number of ints or floats of one C type, stored unboxed and
+ * contiguously so that C kernels can run over them:
+ *   'b' int8_t, 'h' int16_t, 'i' int32_t, 'f' float (needs HAVE_FLOAT).
+ *
+ * An array is a bytes container (PmBytes_t, OBJ_TYPE_BYS) whose bytes are
+ * a header of ARRAY_HDR_SIZE bytes followed by the items:
+ *   val[0] the typecode,
+ *   val[1] log2 of the number of bytes per item,
+ *   val[2] unused; it puts the items 8 bytes into the chunk, aligned.
+ * The length of the container counts the header and the items' bytes.
+ * The array the user sees is an instance of array.array that keeps the
+ * container in its None attribute, as a bytearray instance keeps its
+ * bytearray.  All of the array must fit in one chunk, so it holds at most
+ * ARRAY_MAX_BYTES bytes of items.
+ */
+
+/** Number of bytes in front of the items of an array */
+#define ARRAY_HDR_SIZE 3
+
+/** Returns the typecode ('b', 'h', 'i' or 'f') of the array obj */
+#define ARRAY_GET_TYPECODE(parr) (((pPmBytes_t)(parr))->val[0])
+
+/** Returns the number of items in the array obj */
+#define ARRAY_GET_LENGTH(parr) \
+    ((uint16_t)((((pPmBytes_t)(parr))->length - ARRAY_HDR_SIZE) \
+                >> ((pPmBytes_t)(parr))->val[1]))
+
+/** Returns a ptr to the first item of the array obj */
+#define ARRAY_GET_ITEMS(parr) \
+    ((void *)&(((pPmBytes_t)(parr))->val[ARRAY_HDR_SIZE]))
+
+
+/** The most bytes of items that an array can hold */
+#define ARRAY_MAX_BYTES \
+    ((HEAP_MAX_LIVE_CHUNK_SIZE - sizeof(PmBytes_t) - ARRAY_HDR_SIZE) & ~3)
+
+
+/**
+ * Allocates a new array of zeros.
+ *
+ * @param   typecode 'b', 'h', 'i' or 'f'
+ * @param   length Number of items
+ * @param   r_parr Return; Addr of ptr to array
+ * @return  Return status; ValueError if the typecode is unknown,
+ *          MemoryError if the items do not fit in one chunk
+ */
+PmReturn_t array_new(uint8_t typecode, uint16_t length, pPmObj_t *r_parr);
+
+/**
+ * Gets the array held by an instance of array.array.
+ *
+ * @param   pobj Ptr to array instance
+ * @param   r_parr Return; Addr of ptr to array
+ * @return  Return status; TypeError if pobj holds no array
+ */
+PmReturn_t array_unwrap(pPmObj_t pobj, pPmObj_t *r_parr);
+
+/**
+ * Creates an int (or float) object of the item at the index.
+ *
+ * @param   parr Ptr to array
+ * @param   index Index of item (negative counts from the end)
+ * @param   r_pobj Return; Addr of ptr to item
+ * @return  Return status; IndexError if the index is out of range
+ */
+PmReturn_t array_getItem(pPmObj_t parr, int16_t index, pPmObj_t *r_pobj);
+
+/**
+ * Sets the item at the index to the value of an int (or float) object.
+ *
+ * @param   parr Ptr to array
+ * @param   index Index of item (negative counts from the end)
+ * @param   pobj Ptr to int (or float for 'f') object
+ * @return  Return status; OverflowError if the int does not fit the type
+ */
+PmReturn_t array_setItem(pPmObj_t parr, int16_t index, pPmObj_t pobj);
+
+/**
+ * Returns the sum of the items, as an int (wrapping at 32 bits)
+ * or a float.
+ *
+ * @param   parr Ptr to array
+ * @param   r_pobj Return; Addr of ptr to sum
+ * @return  Return status
+ */
+PmReturn_t array_sum(pPmObj_t parr, pPmObj_t *r_pobj);
+
+/**
+ * Returns the least or greatest item.
+ *
+ * @param   parr Ptr to array
+ * @param   ismax Nonzero for the greatest item
+ * @param   r_pobj Return; Addr of ptr to item
+ * @return  Return status; ValueError if the array is empty
+ */
+PmReturn_t array_minMax(pPmObj_t parr, uint8_t ismax, pPmObj_t *r_pobj);
+
+/**
+ * Returns the dot product of two arrays of the same typecode and length.
+ *
+ * @param   parr1 Ptr to array
+ * @param   parr2 Ptr to other array
+ * @param   r_pobj Return; Addr of ptr to int (wrapping at 32 bits) or float
+ * @return  Return status; TypeError if the typecodes differ,
+ *          ValueError if the lengths differ
+ */
+PmReturn_t array_dot(pPmObj_t parr1, pPmObj_t parr2, pPmObj_t *r_pobj);
+
+/**
+ * Sets each item x of the array to x * mul + offset.  An int item
+ * keeps the low bits of the result that fit its type.
+ *
+ * @param   parr Ptr to array
+ * @param   pmul Ptr to int (or float for 'f')
+ * @param   poffset Ptr to int (or float for 'f')
+ * @return  Return status
+ */
+PmReturn_t array_scale(pPmObj_t parr, pPmObj_t pmul, pPmObj_t poffset);
+
+/**
+ * Adds ('+') or multiplies ('*') each item of the first array by the item
+ * at the same index of the second, in place.  An int item keeps the low
+ * bits of the result that fit its type.
+ *
+ * @param   parr1 Ptr to array that is changed
+ * @param   parr2 Ptr to array of the same typecode and length
+ * @param   op '+' or '*'
+ * @return  Return status; TypeError if the typecodes differ,
+ *          ValueError if the lengths differ
+ */
+PmReturn_t array_op(pPmObj_t parr1, pPmObj_t parr2, int8_t op);
+
+/**
+ * Creates an array of the means of each run of n items.
+ * The mean of ints is floored as the / operator does.
+ *
+ * @param   parr Ptr to array
+ * @param   n Number of items in each run
+ * @param   r_parr Return; Addr of ptr to new array of length - n + 1 items
+ * @return  Return status; ValueError if n is not in 1..length
+ */
+PmReturn_t array_movingAverage(pPmObj_t parr, uint16_t n, pPmObj_t *r_parr);
+
+#ifdef HAVE_PRINT
+/**
+ * Prints out an array as array('h', [1, 2, 3]).
+ *
+ * @param   parr Ptr to array
+ * @return  Return status
+ */
+PmReturn_t array_print(pPmObj_t parr);
+#endif /* HAVE_PRINT */
+
+#endif /* __ARRAY_H__ */
@@ -24,14 +24,25 @@
 #define ROUND_UP_TO_MUL_OF_FOUR(n) n = (((n) + 3) & ~3)
 
 
+/** The most bytes a bytes container can hold */
+#define BYTES_MAX_LENGTH ((HEAP_MAX_LIVE_CHUNK_SIZE - sizeof(PmBytes_t)) & ~3)
+
+
 /* Returns a container that can hold at least n bytes */
 static
 PmReturn_t
-bytes_new(int16_t n, pPmObj_t *r_pobj)
+bytes_new(uint16_t n, pPmObj_t *r_pobj)
 {
     PmReturn_t retval = PM_RET_OK;
     pPmBytes_t pb = C_NULL;
 
+    /* Raise MemoryError if the bytes can not fit in one chunk */
+    if (n > BYTES_MAX_LENGTH)
+    {
+        PM_RAISE(retval, PM_RET_EX_MEM);
+        return retval;
+    }
+
     ROUND_UP_TO_MUL_OF_FOUR(n);
 
     /* Allocate a container */
@@ -39,6 +50,7 @@ bytes_new(int16_t n, pPmObj_t *r_pobj)
     PM_RETURN_IF_ERROR(retval);
     OBJ_SET_TYPE(pb, OBJ_TYPE_BYS);
     pb->length = n;
+    pb->users = 1;
 
     *r_pobj = (pPmObj_t)pb;
     return retval;
@@ -63,14 +75,14 @@ bytes_getByteFromObj(pPmObj_t pobj, uint8_t *b)
         *b = (uint8_t)((pPmInt_t)pobj)->val;
     }
 
-    else if (OBJ_GET_TYPE(pobj) == OBJ_TYPE_STR)
+    else if (STRING_IS_STRING(pobj))
     {
-        if (((pPmString_t)pobj)->length != 1)
+        if (STRING_GET_LENGTH(pobj) != 1)
         {
             PM_RAISE(retval, PM_RET_EX_VAL);
             return retval;
         }
-        *b = ((pPmString_t)pobj)->val[0];
+        *b = STRING_GET_VAL(pobj)[0];
     }
 
     else
@@ -81,6 +93,116 @@ bytes_getByteFromObj(pPmObj_t pobj, uint8_t *b)
 }
 
 
+/*
+ * Makes sure the bytearray has a container of its own with room for n bytes.
+ * Otherwise its bytes are copied to a new container, which has room to grow
+ * by half again if grow is true.
+ */
+static
+PmReturn_t
+bytearray_reserve(pPmBytearray_t pba, uint16_t n, uint8_t grow)
+{
+    PmReturn_t retval = PM_RET_OK;
+    pPmBytes_t pb;
+    pPmBytes_t pold;
+    uint32_t size;
+    uint8_t objid;
+
+    pold = pba->val;
+    if ((pold->users == 1) && (((uint32_t)pba->offset + n) <= pold->length))
+    {
+        return retval;
+    }
+
+    size = n;
+    if (grow)
+    {
+        size += (n >> 1);
+        if (size > BYTES_MAX_LENGTH)
+        {
+            size = (n > BYTES_MAX_LENGTH) ? n : BYTES_MAX_LENGTH;
+        }
+    }
+
+    heap_gcPushTempRoot((pPmObj_t)pba, &objid);
+    retval = bytes_new((uint16_t)size, (pPmObj_t *)&pb);
+    heap_gcPopTempRoot(objid);
+    PM_RETURN_IF_ERROR(retval);
+
+    sli_memcpy(&(pb->val[0]), BYTEARRAY_GET_VAL(pba), pba->length);
+    pba->val = pb;
+    pba->offset = 0;
+
+    /* The old container has one user fewer, unless it is too many to count */
+    if ((pold->users > 1) && (pold->users < 255))
+    {
+        pold->users--;
+    }
+    return retval;
+}
+
+
+/* Gets the start and end of a slice, adjusted like a string slice's */
+static
+PmReturn_t
+bytearray_getRange(pPmBytearray_t pba, pPmObj_t pstart, pPmObj_t pend,
+                   uint16_t *r_start, uint16_t *r_end)
+{
+    PmReturn_t retval = PM_RET_OK;
+    int32_t len;
+    int32_t start;
+    int32_t end;
+
+    if ((OBJ_GET_TYPE(pstart) != OBJ_TYPE_INT)
+        || ((pend != PM_NONE) && (OBJ_GET_TYPE(pend) != OBJ_TYPE_INT)))
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    len = pba->length;
+    start = ((pPmInt_t)pstart)->val;
+    end = (pend == PM_NONE) ? len : ((pPmInt_t)pend)->val;
+
+    /* Adjust negative indices and clip both to the bytearray */
+    if (start < 0)
+    {
+        start += len;
+        if (start < 0)
+        {
+            start = 0;
+        }
+    }
+    else if (start > len)
+    {
+        start = len;
+    }
+
+    if (end < 0)
+    {
+        end += len;
+        if (end < 0)
+        {
+            end = 0;
+        }
+    }
+    else if (end > len)
+    {
+        end = len;
+    }
+
+    /* An empty slice */
+    if (end < start)
+    {
+        end = start;
+    }
+
+    *r_start = (uint16_t)start;
+    *r_end = (uint16_t)end;
+    return retval;
+}
+
+
 PmReturn_t
 bytearray_new(pPmObj_t pobj, pPmObj_t *r_pobj)
 {
@@ -89,7 +211,7 @@ bytearray_new(pPmObj_t pobj, pPmObj_t *r_pobj)
     pPmBytes_t pb = C_NULL;
     pPmObj_t pitem;
     int32_t i;
-    int16_t n;
+    uint16_t n;
     uint8_t b;
     uint8_t objid;
 
@@ -117,7 +239,8 @@ bytearray_new(pPmObj_t pobj, pPmObj_t *r_pobj)
             break;
 
         case OBJ_TYPE_STR:
-            n = ((pPmString_t)pobj)->length;
+        case OBJ_TYPE_SVW:
+            n = STRING_GET_LENGTH(pobj);
             break;
 
         case OBJ_TYPE_LST:
@@ -142,6 +265,7 @@ bytearray_new(pPmObj_t pobj, pPmObj_t *r_pobj)
     PM_RETURN_IF_ERROR(retval);
     OBJ_SET_TYPE(pba, OBJ_TYPE_BYA);
     pba->length = n;
+    pba->offset = 0;
     pba->val = C_NULL;
 
     /* Allocate the bytes container */
@@ -159,12 +283,12 @@ bytearray_new(pPmObj_t pobj, pPmObj_t *r_pobj)
             break;
 
         case OBJ_TYPE_BYA:
-            pitem = (pPmObj_t)((pPmBytearray_t)pobj)->val;
-            sli_memcpy(&(pb->val[0]), &(((pPmBytes_t)pitem)->val[0]), n);
+            sli_memcpy(&(pb->val[0]), BYTEARRAY_GET_VAL(pobj), n);
             break;
 
         case OBJ_TYPE_STR:
-            sli_memcpy(&(pb->val[0]), &(((pPmString_t)pobj)->val[0]), n);
+        case OBJ_TYPE_SVW:
+            sli_memcpy(&(pb->val[0]), STRING_GET_VAL(pobj), n);
             break;
 
         case OBJ_TYPE_LST:
@@ -190,7 +314,6 @@ bytearray_getItem(pPmObj_t pobj, int16_t index, pPmObj_t *r_pobj)
 {
     PmReturn_t retval = PM_RET_OK;
     pPmBytearray_t pba;
-    pPmBytes_t pb;
     int32_t n;
 
     pba = (pPmBytearray_t)pobj;
@@ -209,8 +332,7 @@ bytearray_getItem(pPmObj_t pobj, int16_t index, pPmObj_t *r_pobj)
     }
 
     /* Create int from byte at index */
-    pb = pba->val;
-    n = (int32_t)pb->val[index];
+    n = (int32_t)BYTEARRAY_GET_VAL(pba)[index];
     retval = int_new(n, r_pobj);
 
     return retval;
@@ -221,7 +343,6 @@ PmReturn_t
 bytearray_setItem(pPmObj_t pba, int16_t index, pPmObj_t pobj)
 {
     PmReturn_t retval;
-    pPmBytes_t pb;
     uint8_t b = 0;
 
     /* Adjust a negative index */
@@ -239,25 +360,333 @@ bytearray_setItem(pPmObj_t pba, int16_t index, pPmObj_t pobj)
 
     /* Set the item */
     retval = bytes_getByteFromObj(pobj, &b);
-    pb = ((pPmBytearray_t)pba)->val;
-    pb->val[index] = b;
+    PM_RETURN_IF_ERROR(retval);
+    retval = bytearray_reserve((pPmBytearray_t)pba,
+                               ((pPmBytearray_t)pba)->length,
+                               C_FALSE);
+    PM_RETURN_IF_ERROR(retval);
+    BYTEARRAY_GET_VAL(pba)[index] = b;
 
     return retval;
 }
 
 
+PmReturn_t
+bytearray_unwrap(pPmObj_t pobj, pPmObj_t *r_pba)
+{
+    PmReturn_t retval = PM_RET_OK;
+
+    /* If object is an instance, get the thing it is containing */
+    if (OBJ_GET_TYPE(pobj) == OBJ_TYPE_CLI)
+    {
+        retval = dict_getItem((pPmObj_t)((pPmInstance_t)pobj)->cli_attrs,
+                              PM_NONE,
+                              &pobj);
+        if (retval == PM_RET_EX_KEY)
+        {
+            PM_RAISE(retval, PM_RET_EX_TYPE);
+        }
+        PM_RETURN_IF_ERROR(retval);
+    }
+
+    if (OBJ_GET_TYPE(pobj) != OBJ_TYPE_BYA)
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    *r_pba = pobj;
+    return retval;
+}
+
+
+PmReturn_t
+bytearray_wrap(pPmObj_t pba, pPmObj_t *r_pobj)
+{
+    PmReturn_t retval;
+    pPmObj_t pclass;
+    pPmObj_t pcli;
+    uint8_t objid;
+    uint8_t objid2;
+
+    C_ASSERT(OBJ_GET_TYPE(pba) == OBJ_TYPE_BYA);
+
+    retval = dict_getItem(PM_PBUILTINS, PM_BYTEARRAY_STR, &pclass);
+    PM_RETURN_IF_ERROR(retval);
+
+    /* Store the bytearray in the None attribute of a new instance */
+    heap_gcPushTempRoot(pba, &objid);
+    retval = class_instantiate(pclass, &pcli);
+    if (retval == PM_RET_OK)
+    {
+        heap_gcPushTempRoot(pcli, &objid2);
+        retval = dict_setItem((pPmObj_t)((pPmInstance_t)pcli)->cli_attrs,
+                              PM_NONE, pba);
+    }
+    heap_gcPopTempRoot(objid);
+    PM_RETURN_IF_ERROR(retval);
+
+    *r_pobj = pcli;
+    return retval;
+}
+
+
+PmReturn_t
+bytearray_getBuffer(pPmObj_t pobj, uint8_t writable,
+                    uint8_t **r_pbuf, uint16_t *r_len)
+{
+    PmReturn_t retval = PM_RET_OK;
+    pPmObj_t pba;
+
+    /* A string's chars may be read but not written */
+    if (!writable && STRING_IS_STRING(pobj))
+    {
+        *r_pbuf = (uint8_t *)STRING_GET_VAL(pobj);
+        *r_len = STRING_GET_LENGTH(pobj);
+        return retval;
+    }
+
+    retval = bytearray_unwrap(pobj, &pba);
+    PM_RETURN_IF_ERROR(retval);
+
+    /* The bytes may be written, so give the bytearray its own container */
+    if (writable)
+    {
+        retval = bytearray_reserve((pPmBytearray_t)pba,
+                                   ((pPmBytearray_t)pba)->length,
+                                   C_FALSE);
+        PM_RETURN_IF_ERROR(retval);
+    }
+
+    *r_pbuf = BYTEARRAY_GET_VAL(pba);
+    *r_len = ((pPmBytearray_t)pba)->length;
+    return retval;
+}
+
+
+PmReturn_t
+bytearray_slice(pPmObj_t pobj, pPmObj_t pstart, pPmObj_t pend,
+                pPmObj_t *r_pslice)
+{
+    PmReturn_t retval;
+    pPmObj_t pba;
+    pPmBytearray_t pslice;
+    uint16_t start;
+    uint16_t end;
+
+    retval = bytearray_unwrap(pobj, &pba);
+    PM_RETURN_IF_ERROR(retval);
+    retval = bytearray_getRange((pPmBytearray_t)pba, pstart, pend,
+                                &start, &end);
+    PM_RETURN_IF_ERROR(retval);
+
+    /* Allocate a bytearray that uses the same bytes container */
+    retval = heap_getChunk(sizeof(PmBytearray_t), (uint8_t **)&pslice);
+    PM_RETURN_IF_ERROR(retval);
+    OBJ_SET_TYPE(pslice, OBJ_TYPE_BYA);
+    pslice->length = end - start;
+    pslice->offset = ((pPmBytearray_t)pba)->offset + start;
+    pslice->val = ((pPmBytearray_t)pba)->val;
+    if (pslice->val->users < 255)
+    {
+        pslice->val->users++;
+    }
+
+    return bytearray_wrap((pPmObj_t)pslice, r_pslice);
+}
+
+
+PmReturn_t
+bytearray_extend(pPmObj_t pba, pPmObj_t pobj)
+{
+    PmReturn_t retval = PM_RET_OK;
+    pPmObj_t pitem;
+    uint8_t *pdest;
+    uint8_t *psrc;
+    uint16_t len;
+    uint16_t n;
+    uint16_t i;
+
+    C_ASSERT(OBJ_GET_TYPE(pba) == OBJ_TYPE_BYA);
+
+    /* Get the number of bytes to append */
+    if ((OBJ_GET_TYPE(pobj) == OBJ_TYPE_LST)
+        || (OBJ_GET_TYPE(pobj) == OBJ_TYPE_TUP))
+    {
+        retval = seq_getLength(pobj, &n);
+    }
+    else
+    {
+        retval = bytearray_getBuffer(pobj, C_FALSE, &psrc, &n);
+    }
+    PM_RETURN_IF_ERROR(retval);
+
+    /* Raise MemoryError if the length would overflow */
+    len = ((pPmBytearray_t)pba)->length;
+    if (((uint32_t)len + n) > 65535)
+    {
+        PM_RAISE(retval, PM_RET_EX_MEM);
+        return retval;
+    }
+
+    retval = bytearray_reserve((pPmBytearray_t)pba, len + n, C_TRUE);
+    PM_RETURN_IF_ERROR(retval);
+    pdest = BYTEARRAY_GET_VAL(pba) + len;
+
+    if ((OBJ_GET_TYPE(pobj) == OBJ_TYPE_LST)
+        || (OBJ_GET_TYPE(pobj) == OBJ_TYPE_TUP))
+    {
+        for (i = 0; i < n; i++)
+        {
+            retval = seq_getSubscript(pobj, (int16_t)i, &pitem);
+            PM_RETURN_IF_ERROR(retval);
+            retval = bytes_getByteFromObj(pitem, &pdest[i]);
+            PM_RETURN_IF_ERROR(retval);
+        }
+    }
+    else
+    {
+        /* Get the source again; it may be this bytearray, now moved */
+        retval = bytearray_getBuffer(pobj, C_FALSE, &psrc, &i);
+        PM_RETURN_IF_ERROR(retval);
+        sli_memcpy(pdest, psrc, n);
+    }
+
+    ((pPmBytearray_t)pba)->length = len + n;
+    return retval;
+}
+
+
+PmReturn_t
+bytearray_fill(pPmObj_t pba, pPmObj_t pobj, pPmObj_t pstart, pPmObj_t pend)
+{
+    PmReturn_t retval;
+    uint16_t start;
+    uint16_t end;
+    uint8_t b;
+
+    C_ASSERT(OBJ_GET_TYPE(pba) == OBJ_TYPE_BYA);
+
+    retval = bytes_getByteFromObj(pobj, &b);
+    PM_RETURN_IF_ERROR(retval);
+    retval = bytearray_getRange((pPmBytearray_t)pba, pstart, pend,
+                                &start, &end);
+    PM_RETURN_IF_ERROR(retval);
+
+    retval = bytearray_reserve((pPmBytearray_t)pba,
+                               ((pPmBytearray_t)pba)->length,
+                               C_FALSE);
+    PM_RETURN_IF_ERROR(retval);
+    sli_memset(BYTEARRAY_GET_VAL(pba) + start, (char)b, end - start);
+
+    return retval;
+}
+
+
+PmReturn_t
+bytearray_find(pPmObj_t pba, pPmObj_t psub, int16_t start, int16_t *r_index)
+{
+    PmReturn_t retval;
+    uint8_t *pbuf;
+    uint8_t *psubbuf;
+    uint8_t b;
+    uint16_t len;
+    uint16_t sublen;
+    uint16_t i;
+    uint16_t j;
+
+    C_ASSERT(OBJ_GET_TYPE(pba) == OBJ_TYPE_BYA);
+
+    /* An int is a single byte to find */
+    if (OBJ_GET_TYPE(psub) == OBJ_TYPE_INT)
+    {
+        retval = bytes_getByteFromObj(psub, &b);
+        psubbuf = &b;
+        sublen = 1;
+    }
+    else
+    {
+        retval = bytearray_getBuffer(psub, C_FALSE, &psubbuf, &sublen);
+    }
+    PM_RETURN_IF_ERROR(retval);
+
+    pbuf = BYTEARRAY_GET_VAL(pba);
+    len = ((pPmBytearray_t)pba)->length;
+
+    /* Adjust a negative start index */
+    if (start < 0)
+    {
+        start += len;
+        if (start < 0)
+        {
+            start = 0;
+        }
+    }
+
+    *r_index = -1;
+    if (((uint32_t)start + sublen) > len)
+    {
+        return retval;
+    }
+
+    for (i = start; i <= (len - sublen); i++)
+    {
+        for (j = 0; j < sublen; j++)
+        {
+            if (pbuf[i + j] != psubbuf[j])
+            {
+                break;
+            }
+        }
+        if (j == sublen)
+        {
+            *r_index = (int16_t)i;
+            break;
+        }
+    }
+    return retval;
+}
+
+
+int8_t
+bytearray_compare(pPmObj_t pba1, pPmObj_t pba2)
+{
+    uint8_t *pb1;
+    uint8_t *pb2;
+    uint16_t i;
+
+    C_ASSERT(OBJ_GET_TYPE(pba1) == OBJ_TYPE_BYA);
+    C_ASSERT(OBJ_GET_TYPE(pba2) == OBJ_TYPE_BYA);
+
+    if (((pPmBytearray_t)pba1)->length != ((pPmBytearray_t)pba2)->length)
+    {
+        return C_DIFFER;
+    }
+
+    /* Compare every byte (a zero byte does not end a bytearray) */
+    pb1 = BYTEARRAY_GET_VAL(pba1);
+    pb2 = BYTEARRAY_GET_VAL(pba2);
+    for (i = 0; i < ((pPmBytearray_t)pba1)->length; i++)
+    {
+        if (pb1[i] != pb2[i])
+        {
+            return C_DIFFER;
+        }
+    }
+    return C_SAME;
+}
+
+
 #ifdef HAVE_PRINT
 PmReturn_t
 bytearray_print(pPmObj_t pobj)
 {
     PmReturn_t retval;
-    pPmBytes_t pb;
 
     obj_print(PM_BYTEARRAY_STR, C_FALSE, C_FALSE);
     plat_putByte('(');
     plat_putByte('b');
-    pb = ((pPmBytearray_t)pobj)->val;
-    retval = string_printFormattedBytes(&(pb->val[0]),
+    retval = string_printFormattedBytes(BYTEARRAY_GET_VAL(pobj),
                                         C_TRUE,
                                         ((pPmBytearray_t)pobj)->length);
     plat_putByte(')');
@@ -30,6 +30,12 @@ typedef struct PmBytes_s
     /** Physical number of bytes in the C array (below) */
     uint16_t length;
 
+    /**
+     * Number of bytearrays that may use this container.  Counting stops
+     * at 255, after which the container stays shared.
+     */
+    uint8_t users;
+
     /** C array of bytes */
     uint8_t val[1];
 } PmBytes_t,
@@ -49,15 +55,119 @@ typedef struct PmBytearray_s
     /** Bytearray length; logical number of bytes */
     uint16_t length;
 
+    /** Index in the bytes container of this bytearray's first byte */
+    uint16_t offset;
+
     /** Ptr to bytes container (may hold more bytes than length) */
     pPmBytes_t val;
 } PmBytearray_t,
  *pPmBytearray_t;
 
- 
+
+/** Returns a ptr to the first byte of the bytearray obj */
+#define BYTEARRAY_GET_VAL(pba) \
+    (&(((pPmBytearray_t)(pba))->val->val[((pPmBytearray_t)(pba))->offset]))
+
+
 PmReturn_t bytearray_new(pPmObj_t pobj, pPmObj_t *r_pobj);
 PmReturn_t bytearray_getItem(pPmObj_t pobj, int16_t index, pPmObj_t *r_pobj);
 PmReturn_t bytearray_setItem(pPmObj_t pba, int16_t index, pPmObj_t pobj);
 PmReturn_t bytearray_print(pPmObj_t pobj);
 
+/**
+ * Gets the bytearray held by an instance of the bytearray class.
+ * A bytearray object is returned as is.
+ *
+ * @param   pobj Ptr to bytearray instance or bytearray
+ * @param   r_pba Return; Addr of ptr to bytearray
+ * @return  Return status; TypeError if pobj holds no bytearray
+ */
+PmReturn_t bytearray_unwrap(pPmObj_t pobj, pPmObj_t *r_pba);
+
+/**
+ * Creates an instance of the builtin bytearray class holding the bytearray.
+ *
+ * @param   pba Ptr to bytearray
+ * @param   r_pobj Return; Addr of ptr to new bytearray instance
+ * @return  Return status
+ */
+PmReturn_t bytearray_wrap(pPmObj_t pba, pPmObj_t *r_pobj);
+
+/**
+ * Gets a ptr to the bytes of a bytearray (or bytearray instance) so a
+ * native function can read or write them in place.  If writable is false,
+ * strings are accepted too and their chars must not be written.
+ * A writable buffer is only valid until the bytearray is next resized
+ * or sliced, or until the next allocation.
+ *
+ * @param   pobj Ptr to bytearray, bytearray instance or string
+ * @param   writable Nonzero if the bytes will be written
+ * @param   r_pbuf Return; Addr of ptr to first byte
+ * @param   r_len Return; Number of bytes
+ * @return  Return status; TypeError if pobj has no buffer of bytes
+ */
+PmReturn_t bytearray_getBuffer(pPmObj_t pobj, uint8_t writable,
+                               uint8_t **r_pbuf, uint16_t *r_len);
+
+/**
+ * Creates a bytearray instance of the slice [start:end] of the bytearray.
+ * The slice shares the bytes container of the bytearray instead of copying
+ * it; whichever of them is changed first copies the bytes then.  When all
+ * but one of the sharers have copied, the last one changes the container
+ * in place again.
+ *
+ * @param   pobj Ptr to bytearray or bytearray instance
+ * @param   pstart Ptr to int object of slice start index
+ * @param   pend Ptr to int object of slice end index, or None
+ * @param   r_pslice Return; Addr of ptr to new bytearray instance
+ * @return  Return status
+ */
+PmReturn_t bytearray_slice(pPmObj_t pobj, pPmObj_t pstart, pPmObj_t pend,
+                           pPmObj_t *r_pslice);
+
+/**
+ * Appends the bytes of the object to the bytearray.  The object may be
+ * a bytearray, a string or a list or tuple of ints and one-char strings.
+ *
+ * @param   pba Ptr to bytearray
+ * @param   pobj Ptr to object whose bytes are appended
+ * @return  Return status
+ */
+PmReturn_t bytearray_extend(pPmObj_t pba, pPmObj_t pobj);
+
+/**
+ * Sets every byte of the slice [start:end] of the bytearray to the byte
+ * given by an int or one-char string.
+ *
+ * @param   pba Ptr to bytearray
+ * @param   pobj Ptr to int or one-char string
+ * @param   pstart Ptr to int object of start index
+ * @param   pend Ptr to int object of end index, or None
+ * @return  Return status
+ */
+PmReturn_t bytearray_fill(pPmObj_t pba, pPmObj_t pobj,
+                          pPmObj_t pstart, pPmObj_t pend);
+
+/**
+ * Finds the first index at or after start of the byte or bytes given by
+ * an int, a string or a bytearray.
+ *
+ * @param   pba Ptr to bytearray
+ * @param   psub Ptr to int, string or bytearray (or bytearray instance)
+ * @param   start Index to start looking at
+ * @param   r_index Return; Index of the bytes or -1 if they are not found
+ * @return  Return status
+ */
+PmReturn_t bytearray_find(pPmObj_t pba, pPmObj_t psub, int16_t start,
+                          int16_t *r_index);
+
+/**
+ * Compares the bytes of two bytearrays.
+ *
+ * @param   pba1 Ptr to a bytearray
+ * @param   pba2 Ptr to another bytearray
+ * @return  C_SAME if the bytes are equal, C_DIFFER otherwise
+ */
+int8_t bytearray_compare(pPmObj_t pba1, pPmObj_t pba2);
+
 #endif /* __BYTEARRAY_H__ */
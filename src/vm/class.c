@@ -25,6 +25,9 @@
 static uint8_t const *liststr = (uint8_t const *)"list";
 static uint8_t const *dictstr = (uint8_t const *)"dict";
 static uint8_t const *stringstr = (uint8_t const *)"string";
+#ifdef HAVE_SET
+static uint8_t const *setsstr = (uint8_t const *)"sets";
+#endif /* HAVE_SET */
 static uint8_t const *autoboxstr = (uint8_t const *)"_Autobox";
 static uint8_t const *objstr = (uint8_t const *)"obj";
 #endif
@@ -40,7 +43,7 @@ class_new(pPmObj_t pattrs, pPmObj_t pbases, pPmObj_t pname, pPmObj_t *r_pclass)
     /* Ensure types */
     if ((OBJ_GET_TYPE(pattrs) != OBJ_TYPE_DIC)
         || (OBJ_GET_TYPE(pbases) != OBJ_TYPE_TUP)
-        || (OBJ_GET_TYPE(pname) != OBJ_TYPE_STR))
+        || !STRING_IS_STRING(pname))
     {
         PM_RAISE(retval, PM_RET_EX_TYPE);
         return retval;
@@ -101,10 +104,15 @@ class_autobox(pPmObj_t *pobj)
 {
     PmReturn_t retval = PM_RET_OK;
     pPmObj_t pmodule, pstr, pclass, pwrapped, pmodcache;
+    uint8_t objid;
+    uint8_t objid2;
 
     uint8_t const *pliststr = liststr;
     uint8_t const *pdictstr = dictstr;
     uint8_t const *pstringstr = stringstr;
+#ifdef HAVE_SET
+    uint8_t const *psetsstr = setsstr;
+#endif /* HAVE_SET */
 
     uint8_t const *pAutoboxstr = autoboxstr;
     uint8_t const *pobjstr = objstr;
@@ -118,9 +126,14 @@ class_autobox(pPmObj_t *pobj)
     } else if (OBJ_GET_TYPE(*pobj) == OBJ_TYPE_DIC) {
         retval = string_new(&pdictstr, &pstr);
         PM_RETURN_IF_ERROR(retval);
-    } else if (OBJ_GET_TYPE(*pobj) == OBJ_TYPE_STR) {
+    } else if (STRING_IS_STRING(*pobj)) {
         retval = string_new(&pstringstr, &pstr);
         PM_RETURN_IF_ERROR(retval);
+#ifdef HAVE_SET
+    } else if (OBJ_GET_TYPE(*pobj) == OBJ_TYPE_SET) {
+        retval = string_new(&psetsstr, &pstr);
+        PM_RETURN_IF_ERROR(retval);
+#endif /* HAVE_SET */
     } else {
         return retval;
     }
@@ -148,11 +161,16 @@ class_autobox(pPmObj_t *pobj)
     retval = class_instantiate(pclass, &pwrapped);
     PM_RETURN_IF_ERROR(retval);
 
-    /* store object as _Autobox().obj */
+    /* store object as _Autobox().obj (the new instance is not yet a root) */
+    heap_gcPushTempRoot(pwrapped, &objid);
     retval = string_new(&pobjstr, &pstr);
-    PM_RETURN_IF_ERROR(retval);
-    retval = dict_setItem((pPmObj_t)((pPmInstance_t)pwrapped)->cli_attrs,
-                          pstr, *pobj);
+    if (retval == PM_RET_OK)
+    {
+        heap_gcPushTempRoot(pstr, &objid2);
+        retval = dict_setItem((pPmObj_t)((pPmInstance_t)pwrapped)->cli_attrs,
+                              pstr, *pobj);
+    }
+    heap_gcPopTempRoot(objid);
     PM_RETURN_IF_ERROR(retval);
 
     /** replace old object with new instance in place */
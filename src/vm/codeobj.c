@@ -21,57 +21,41 @@
 #include "pm.h"
 
 
-/* The image format is defined by co_to_str() in src/tools/pmImgCreator.py */
-PmReturn_t
-co_loadFromImg(PmMemSpace_t memspace, uint8_t const **paddr, pPmObj_t *r_pco)
+/* Loads the fields of the code image that precede its names tuple */
+static void
+co_loadHeader(PmMemSpace_t memspace, uint8_t const **paddr, pPmCo_t pco)
 {
-    PmReturn_t retval = PM_RET_OK;
-    pPmObj_t pobj;
-    pPmCo_t pco = C_NULL;
-    uint8_t *pchunk;
-    uint8_t objid;
-#ifdef HAVE_DEBUG_INFO
-    uint8_t objtype;
-    uint16_t len_str;
-#endif /* HAVE_DEBUG_INFO */
-
-    /* Store ptr to top of code img (less type byte) */
-    uint8_t const *pci = *paddr - 1;
-
-    /* Get size of code img */
-    uint16_t size = mem_getWord(memspace, paddr);
-
-    /* Allocate a code obj */
-    retval = heap_getChunk(sizeof(PmCo_t), &pchunk);
-    PM_RETURN_IF_ERROR(retval);
-    pco = (pPmCo_t)pchunk;
-
-    /* Fill in the CO struct */
-    OBJ_SET_TYPE(pco, OBJ_TYPE_COB);
-    pco->co_memspace = memspace;
     pco->co_argcount = mem_getByte(memspace, paddr);
     pco->co_flags = mem_getByte(memspace, paddr);
     pco->co_stacksize = mem_getByte(memspace, paddr);
     pco->co_nlocals = mem_getByte(memspace, paddr);
 
-    /* Do not set code image address if image is in RAM.
-     * CIs in RAM have their image address set in obj_loadFromImgObj() */
-    pco->co_codeimgaddr = (memspace == MEMSPACE_RAM) ? C_NULL : pci;
-
-    /* Set these to null in case a GC occurs before their objects are alloc'd */
-    pco->co_names = C_NULL;
-    pco->co_consts = C_NULL;
-    pco->co_codeaddr = C_NULL;
-
 #ifdef HAVE_CLOSURES
     pco->co_nfreevars = mem_getByte(memspace, paddr);
-    pco->co_cellvars = C_NULL;
 #endif /* HAVE_CLOSURES */
 
 #ifdef HAVE_DEBUG_INFO
     pco->co_firstlineno = mem_getWord(memspace, paddr);
-    pco->co_lnotab = C_NULL;
-    pco->co_filename = C_NULL;
+#endif /* HAVE_DEBUG_INFO */
+}
+
+
+/*
+ * Loads the names and consts (and cellvars) tuples from the code image,
+ * starting at the names tuple, then sets the bytecode address last.
+ * The bytecode runs to pend, the end of the code image.
+ */
+static PmReturn_t
+co_loadBody(pPmCo_t pco, uint8_t const **paddr, uint8_t const *pend)
+{
+    PmReturn_t retval = PM_RET_OK;
+    PmMemSpace_t memspace = pco->co_memspace;
+    pPmObj_t pobj;
+    uint8_t objid;
+    uint8_t i;
+#ifdef HAVE_DEBUG_INFO
+    uint8_t objtype;
+    uint16_t len_str;
 #endif /* HAVE_DEBUG_INFO */
 
     /* Load names (tuple obj) */
@@ -81,6 +65,22 @@ co_loadFromImg(PmMemSpace_t memspace, uint8_t const **paddr, pPmObj_t *r_pco)
     PM_RETURN_IF_ERROR(retval);
     pco->co_names = (pPmTuple_t)pobj;
 
+    /*
+     * Names are dict keys and are printed as C strings, so a long name
+     * loaded as a view of the image is made an interned string
+     */
+    for (i = 0; i < pco->co_names->length; i++)
+    {
+        if (OBJ_GET_TYPE(pco->co_names->val[i]) == OBJ_TYPE_SVW)
+        {
+            heap_gcPushTempRoot((pPmObj_t)pco, &objid);
+            retval = string_materialize(pco->co_names->val[i],
+                                        &pco->co_names->val[i]);
+            heap_gcPopTempRoot(objid);
+            PM_RETURN_IF_ERROR(retval);
+        }
+    }
+
 #ifdef HAVE_DEBUG_INFO
     /* Get address in memspace of line number table (including length) */
     objtype = mem_getByte(memspace, paddr);
@@ -121,9 +121,77 @@ co_loadFromImg(PmMemSpace_t memspace, uint8_t const **paddr, pPmObj_t *r_pco)
     }
 #endif /* HAVE_CLOSURES */
 
-    /* Start of bcode always follows consts */
+#ifdef HAVE_JIT
+    pco->co_codelen = (uint16_t)(pend - *paddr);
+#endif /* HAVE_JIT */
+
+    /* Start of bcode always follows consts; setting it marks the CO loaded */
     pco->co_codeaddr = *paddr;
 
+    return retval;
+}
+
+
+/* The image format is defined by co_to_str() in src/tools/pmImgCreator.py */
+PmReturn_t
+co_loadFromImg(PmMemSpace_t memspace, uint8_t const **paddr, pPmObj_t *r_pco)
+{
+    PmReturn_t retval = PM_RET_OK;
+    pPmCo_t pco = C_NULL;
+    uint8_t *pchunk;
+
+    /* Store ptr to top of code img (less type byte) */
+    uint8_t const *pci = *paddr - 1;
+
+    /* Get size of code img */
+    uint16_t size = mem_getWord(memspace, paddr);
+
+    /* Allocate a code obj */
+    retval = heap_getChunk(sizeof(PmCo_t), &pchunk);
+    PM_RETURN_IF_ERROR(retval);
+    pco = (pPmCo_t)pchunk;
+
+    /* Fill in the CO struct */
+    OBJ_SET_TYPE(pco, OBJ_TYPE_COB);
+    pco->co_memspace = memspace;
+    co_loadHeader(memspace, paddr, pco);
+
+    /* Do not set code image address if image is in RAM.
+     * CIs in RAM have their image address set in obj_loadFromImgObj() */
+    pco->co_codeimgaddr = (memspace == MEMSPACE_RAM) ? C_NULL : pci;
+
+    /* Set these to null in case a GC occurs before their objects are alloc'd */
+    pco->co_names = C_NULL;
+    pco->co_consts = C_NULL;
+    pco->co_codeaddr = C_NULL;
+
+#ifdef HAVE_CLOSURES
+    pco->co_cellvars = C_NULL;
+#endif /* HAVE_CLOSURES */
+
+#ifdef HAVE_DEBUG_INFO
+    pco->co_lnotab = C_NULL;
+    pco->co_filename = C_NULL;
+#endif /* HAVE_DEBUG_INFO */
+
+#ifdef HAVE_JIT
+    pco->co_jitcode = C_NULL;
+    pco->co_jitcount = 0;
+#endif /* HAVE_JIT */
+
+    /*
+     * An image outside RAM stays where it is, so the rest of the CO
+     * (and every CO nested in its consts) is loaded by co_resolve()
+     * when a frame is first made to run the CO.
+     * An image in RAM is loaded now because its address is replaced
+     * by that of its code img obj.
+     */
+    if (memspace == MEMSPACE_RAM)
+    {
+        retval = co_loadBody(pco, paddr, pci + size);
+        PM_RETURN_IF_ERROR(retval);
+    }
+
     /* Set addr to point one past end of img */
     *paddr = pci + size;
 
@@ -132,6 +200,27 @@ co_loadFromImg(PmMemSpace_t memspace, uint8_t const **paddr, pPmObj_t *r_pco)
 }
 
 
+PmReturn_t
+co_resolve(pPmCo_t pco)
+{
+    uint8_t const *paddr;
+    uint16_t size;
+
+    /* The CO is already loaded */
+    if (pco->co_codeaddr != C_NULL)
+    {
+        return PM_RET_OK;
+    }
+
+    /* Skip the type and size and reread the header to reach the names */
+    paddr = pco->co_codeimgaddr + 1;
+    size = mem_getWord(pco->co_memspace, &paddr);
+    co_loadHeader(pco->co_memspace, &paddr, pco);
+
+    return co_loadBody(pco, &paddr, pco->co_codeimgaddr + size);
+}
+
+
 void
 co_rSetCodeImgAddr(pPmCo_t pco, uint8_t const *pimg)
 {
@@ -167,6 +256,7 @@ no_loadFromImg(PmMemSpace_t memspace, uint8_t const **paddr, pPmObj_t *r_pno)
     /* Fill in the NO struct */
     OBJ_SET_TYPE(pno, OBJ_TYPE_NOB);
     pno->no_argcount = mem_getByte(memspace, paddr);
+    pno->no_flags = mem_getByte(memspace, paddr);
 
     /* Get index into native fxn table */
     pno->no_funcindx = (int16_t)mem_getWord(memspace, paddr);
@@ -45,7 +45,14 @@
 
 
 /** Native code image size */
-#define NATIVE_IMAGE_SIZE   4
+#define NATIVE_IMAGE_SIZE   5
+
+/** Native flag: args are read in place from the caller's stack, no 8 arg cap */
+#define NO_FLAG_STACKARGS   0x01
+/** Native flag: the native never allocates, so the pre-call GC is skipped */
+#define NO_FLAG_NOALLOC     0x02
+/** Native flag: the native takes string views; others get them as strings */
+#define NO_FLAG_STRVIEWS    0x04
 
 /* Masks for co_flags (from Python's code.h) */
 #define CO_OPTIMIZED 0x01
@@ -102,6 +109,15 @@ typedef struct PmCo_s
     uint8_t co_stacksize;
     /** Number of local variables */
     uint8_t co_nlocals;
+
+#ifdef HAVE_JIT
+    /** Length in bytes of the bytecode */
+    uint16_t co_codelen;
+    /** Backward jumps taken, counted until the CO is compiled */
+    uint16_t co_jitcount;
+    /** Compiled code in the JIT arena, or C_NULL (see jit.h) */
+    struct PmJitCode_s *co_jitcode;
+#endif /* HAVE_JIT */
 } PmCo_t,
  *pPmCo_t;
 
@@ -118,6 +134,8 @@ typedef struct PmNo_s
     PmObjDesc_t od;
     /** expected num args to the func */
     int8_t no_argcount;
+    /** calling convention flags (NO_FLAG_*) */
+    uint8_t no_flags;
     /** index into native function table */
     int16_t no_funcindx;
 } PmNo_t,
@@ -140,8 +158,10 @@ typedef struct PmNo_s
  * (least significant byte comes first in the byte stream).
  *
  * memspace and *paddr determine the start of the code image.
- * Load the code object with values from the code image,
- * including the names and consts tuples.
+ * Load the code object with values from the code image.
+ * The names and consts tuples are loaded now only if the image is in RAM;
+ * otherwise they are loaded by co_resolve() when the CO is first run,
+ * so a function that is never called never loads its names and consts.
  * Leave contents of paddr pointing one byte past end of
  * code img.
  *
@@ -167,6 +187,16 @@ typedef struct PmNo_s
 PmReturn_t
 co_loadFromImg(PmMemSpace_t memspace, uint8_t const **paddr, pPmObj_t *r_pco);
 
+/**
+ * Loads the names and consts tuples of a code object that was loaded
+ * from an image outside RAM.  The loaded tuples stay with the CO,
+ * so a CO that is already loaded is returned unchanged.
+ *
+ * @param   pco Ptr to code object
+ * @return  Return status
+ */
+PmReturn_t co_resolve(pPmCo_t pco);
+
 /**
  * Recursively sets image address of the CO and all its nested COs
  * in its constant pool.  This is done so that an image that was
@@ -183,21 +213,22 @@ void co_rSetCodeImgAddr(pPmCo_t pco, uint8_t const *pimg);
  *
  * An image is a static representation of a Python object.
  * A native image is much smaller than a regular image
- * because only two items of data are needed after the type:
- * the number of args the func expects and the index into
- * the native function table.
+ * because only three items of data are needed after the type:
+ * the number of args the func expects, the calling convention flags
+ * and the index into the native function table.
  * A reference to the image is not needed since it is
  * just as efficient to store the info in RAM as it is to
  * store a pointer and memspace value.
  *
  * memspace and *paddr determine the start of the native image.
- * Loads the argcount and the func index from the native object.
+ * Loads the argcount, flags and func index from the native object.
  * Leaves contents of paddr pointing one byte past end of
  * code img.
  *
  * The native image has the following structure:
  *      -type:      8b - OBJ_TYPE_CIM
  *      -argcount:  8b - number of arguments to this code obj.
+ *      -flags:     8b - calling convention flags (NO_FLAG_*).
  *      -code:      16b - index into native function table.
  *
  * @param   memspace memory space containing image
@@ -21,6 +21,200 @@
 #include "pm.h"
 
 
+/** Number of entries a table with the given number of index slots holds */
+#define DICT_TABLE_CAPACITY(nslots) (((nslots) << 1) / 3)
+
+/** Size in bytes of a table with the given number of index slots */
+#define DICT_TABLE_SIZE(nslots) \
+    (sizeof(PmDictTable_t) \
+     + (DICT_TABLE_CAPACITY(nslots) - 1) * sizeof(PmDictEntry_t) \
+     + (nslots) * sizeof(int16_t))
+
+/** Returns a ptr to the index slots that follow the table's entries */
+#define DICT_TABLE_SLOTS(ptable) \
+    ((int16_t *)&(ptable)->dt_entries[(ptable)->dt_capacity])
+
+
+/* Allocates an empty table with the given number of index slots */
+static PmReturn_t
+dict_tableNew(uint16_t nslots, pPmDictTable_t *r_ptable)
+{
+    PmReturn_t retval;
+    pPmDictTable_t ptable;
+    int16_t *pslots;
+    uint16_t i;
+    uint8_t *pchunk;
+
+    retval = heap_getChunk(DICT_TABLE_SIZE(nslots), &pchunk);
+    PM_RETURN_IF_ERROR(retval);
+
+    ptable = (pPmDictTable_t)pchunk;
+    OBJ_SET_TYPE(ptable, OBJ_TYPE_DTB);
+    ptable->dt_nslots = nslots;
+    ptable->dt_capacity = DICT_TABLE_CAPACITY(nslots);
+    ptable->dt_used = 0;
+    ptable->dt_length = 0;
+    ptable->dt_next = C_NULL;
+
+    pslots = DICT_TABLE_SLOTS(ptable);
+    for (i = 0; i < nslots; i++)
+    {
+        pslots[i] = DICT_SLOT_EMPTY;
+    }
+
+    *r_ptable = ptable;
+    return retval;
+}
+
+
+/*
+ * Probes the table for the key.
+ * Returns the index slot that holds the key's entry.  If the key is not
+ * in the table, returns the one's complement of the slot where it would go
+ * (the first deleted slot on the probe path, else the empty slot).
+ * The table always has empty slots, so the probe ends.
+ */
+static int16_t
+dict_tableProbe(pPmDictTable_t ptable, pPmObj_t pkey, uint16_t hash)
+{
+    int16_t *pslots = DICT_TABLE_SLOTS(ptable);
+    uint16_t mask = ptable->dt_nslots - 1;
+    uint16_t i = hash & mask;
+    uint16_t step = 0;
+    int16_t freeslot = -1;
+    pPmObj_t pk;
+
+    for (;;)
+    {
+        if (pslots[i] == DICT_SLOT_EMPTY)
+        {
+            return ~((freeslot >= 0) ? freeslot : (int16_t)i);
+        }
+
+        if (pslots[i] == DICT_SLOT_DUMMY)
+        {
+            if (freeslot < 0)
+            {
+                freeslot = (int16_t)i;
+            }
+        }
+        else
+        {
+            pk = ptable->dt_entries[pslots[i]].de_key;
+            if ((pk == pkey) || (obj_compare(pk, pkey) == C_SAME))
+            {
+                return (int16_t)i;
+            }
+        }
+
+        /* Triangular probing visits every slot of a power-of-two table */
+        i = (i + ++step) & mask;
+    }
+}
+
+
+/* Appends the pair to a table that has room and does not hold the key */
+static void
+dict_tableAppend(pPmDictTable_t ptable, pPmObj_t pkey, pPmObj_t pval,
+                 uint16_t hash)
+{
+    int16_t slot;
+
+    slot = ~dict_tableProbe(ptable, pkey, hash);
+    DICT_TABLE_SLOTS(ptable)[slot] = ptable->dt_used;
+    ptable->dt_entries[ptable->dt_used].de_key = pkey;
+    ptable->dt_entries[ptable->dt_used].de_val = pval;
+    ptable->dt_used++;
+    ptable->dt_length++;
+}
+
+
+/*
+ * Makes room for one more entry in the full last table of a dict.
+ *
+ * The table is rebuilt without its deleted entries into a table that holds
+ * at least twice its live entries, up to the largest table that fits in
+ * a heap chunk.  If that would free less than a quarter of the largest
+ * table, a new table is chained after the full one instead.
+ * pptable is the link to the full table; on return, *r_ptable is the
+ * table that takes the new entry.
+ */
+static PmReturn_t
+dict_tableGrow(pPmDictTable_t *pptable, pPmDictTable_t *r_ptable)
+{
+    PmReturn_t retval;
+    pPmDictTable_t poldtable = *pptable;
+    pPmDictTable_t pnewtable;
+    pPmDictEntry_t pentry;
+    uint16_t length = poldtable->dt_length;
+    uint16_t nslots = DICT_TABLE_MIN_SLOTS;
+    uint16_t i;
+
+    while ((DICT_TABLE_CAPACITY(nslots) < (length << 1))
+           && (DICT_TABLE_SIZE(nslots << 1) <= HEAP_MAX_LIVE_CHUNK_SIZE))
+    {
+        nslots <<= 1;
+    }
+
+    /* Chain a new table after a largest table that is mostly live */
+    if ((DICT_TABLE_CAPACITY(nslots) - length)
+        < (DICT_TABLE_CAPACITY(nslots) >> 2))
+    {
+        retval = dict_tableNew(DICT_TABLE_MIN_SLOTS, &pnewtable);
+        PM_RETURN_IF_ERROR(retval);
+        poldtable->dt_next = pnewtable;
+        *r_ptable = pnewtable;
+        return retval;
+    }
+
+    /* Rebuild the live entries, in order, into the new table */
+    retval = dict_tableNew(nslots, &pnewtable);
+    PM_RETURN_IF_ERROR(retval);
+    for (i = 0; i < poldtable->dt_used; i++)
+    {
+        pentry = &poldtable->dt_entries[i];
+        if (pentry->de_key != C_NULL)
+        {
+            dict_tableAppend(pnewtable, pentry->de_key, pentry->de_val,
+                             obj_hash(pentry->de_key));
+        }
+    }
+
+    /* Replace the old table in the chain */
+    pnewtable->dt_next = poldtable->dt_next;
+    *pptable = pnewtable;
+    *r_ptable = pnewtable;
+    return heap_freeChunk((pPmObj_t)poldtable);
+}
+
+
+/*
+ * Finds the key in the dict's tables.
+ * Returns PM_RET_OK with the link to the table that holds the key
+ * and the key's index slot, or PM_RET_NO if the key is not in the dict.
+ */
+static PmReturn_t
+dict_find(pPmDict_t pdict, pPmObj_t pkey, uint16_t hash,
+          pPmDictTable_t **r_pptable, int16_t *r_slot)
+{
+    pPmDictTable_t *pptable;
+    int16_t slot;
+
+    for (pptable = &pdict->d_table;
+         *pptable != C_NULL; pptable = &(*pptable)->dt_next)
+    {
+        slot = dict_tableProbe(*pptable, pkey, hash);
+        if (slot >= 0)
+        {
+            *r_pptable = pptable;
+            *r_slot = slot;
+            return PM_RET_OK;
+        }
+    }
+    return PM_RET_NO;
+}
+
+
 PmReturn_t
 dict_new(pPmObj_t *r_pdict)
 {
@@ -36,8 +230,7 @@ dict_new(pPmObj_t *r_pdict)
     pdict = (pPmDict_t)pchunk;
     OBJ_SET_TYPE(pdict, OBJ_TYPE_DIC);
     pdict->length = 0;
-    pdict->d_keys = C_NULL;
-    pdict->d_vals = C_NULL;
+    pdict->d_table = C_NULL;
 
     *r_pdict = (pPmObj_t)pchunk;
     return retval;
@@ -48,6 +241,7 @@ PmReturn_t
 dict_clear(pPmObj_t pdict)
 {
     PmReturn_t retval = PM_RET_OK;
+    pPmDictTable_t ptable;
 
     C_ASSERT(pdict != C_NULL);
 
@@ -61,19 +255,13 @@ dict_clear(pPmObj_t pdict)
     /* clear length */
     ((pPmDict_t)pdict)->length = 0;
 
-    /* Free the keys and values seglists if needed */
-    if (((pPmDict_t)pdict)->d_keys != C_NULL)
-    {
-        PM_RETURN_IF_ERROR(seglist_clear(((pPmDict_t)pdict)->d_keys));
-        PM_RETURN_IF_ERROR(heap_freeChunk((pPmObj_t)
-                                          ((pPmDict_t)pdict)->d_keys));
-        ((pPmDict_t)pdict)->d_keys = C_NULL;
-    }
-    if (((pPmDict_t)pdict)->d_vals != C_NULL)
+    /* Free the tables */
+    while (((pPmDict_t)pdict)->d_table != C_NULL)
     {
-        PM_RETURN_IF_ERROR(seglist_clear(((pPmDict_t)pdict)->d_vals));
-        retval = heap_freeChunk((pPmObj_t)((pPmDict_t)pdict)->d_vals);
-        ((pPmDict_t)pdict)->d_vals = C_NULL;
+        ptable = ((pPmDict_t)pdict)->d_table;
+        ((pPmDict_t)pdict)->d_table = ptable->dt_next;
+        retval = heap_freeChunk((pPmObj_t)ptable);
+        PM_RETURN_IF_ERROR(retval);
     }
     return retval;
 }
@@ -82,14 +270,17 @@ dict_clear(pPmObj_t pdict)
 /*
  * Sets a value in the dict using the given key.
  *
- * Scans dict for the key.  If key val found, replace old
+ * Looks up the key by its hash.  If key val found, replace old
  * with new val.  If no key found, add key/val pair to dict.
  */
 PmReturn_t
 dict_setItem(pPmObj_t pdict, pPmObj_t pkey, pPmObj_t pval)
 {
     PmReturn_t retval = PM_RET_OK;
-    int16_t indx;
+    pPmDictTable_t *pptable;
+    pPmDictTable_t ptable;
+    int16_t slot;
+    uint16_t hash;
 
     C_ASSERT(pdict != C_NULL);
     C_ASSERT(pkey != C_NULL);
@@ -103,8 +294,12 @@ dict_setItem(pPmObj_t pdict, pPmObj_t pkey, pPmObj_t pval)
     }
 
     /* #112: Force Dict keys to be of hashable type */
-    /* If key is not hashable, raise TypeError */
-    if (OBJ_GET_TYPE(pkey) > OBJ_TYPE_HASHABLE_MAX)
+    /* If key is not hashable (a frozenset is), raise TypeError */
+    if ((OBJ_GET_TYPE(pkey) > OBJ_TYPE_HASHABLE_MAX)
+#ifdef HAVE_SET
+        && !((OBJ_GET_TYPE(pkey) == OBJ_TYPE_SET) && SET_IS_FROZEN(pkey))
+#endif /* HAVE_SET */
+       )
     {
         PM_RAISE(retval, PM_RET_EX_TYPE);
         return retval;
@@ -120,35 +315,50 @@ dict_setItem(pPmObj_t pdict, pPmObj_t pkey, pPmObj_t pval)
         pkey = PM_ZERO;
     }
 
+    /* If found a matching key, replace val obj */
+    hash = obj_hash(pkey);
+    if (dict_find((pPmDict_t)pdict, pkey, hash, &pptable, &slot)
+        == PM_RET_OK)
+    {
+        ptable = *pptable;
+        ptable->dt_entries[DICT_TABLE_SLOTS(ptable)[slot]].de_val = pval;
+        return retval;
+    }
+
     /*
      * #115: If this is the first key/value pair to be added to the Dict,
-     * allocate the key and value seglists that hold those items
+     * allocate the table that holds the items
      */
-    if (((pPmDict_t)pdict)->length == 0)
+    if (((pPmDict_t)pdict)->d_table == C_NULL)
     {
-        retval = seglist_new(&((pPmDict_t)pdict)->d_keys);
-        PM_RETURN_IF_ERROR(retval);
-        retval = seglist_new(&((pPmDict_t)pdict)->d_vals);
+        retval = dict_tableNew(DICT_TABLE_MIN_SLOTS,
+                               &((pPmDict_t)pdict)->d_table);
         PM_RETURN_IF_ERROR(retval);
     }
-    else
+
+    /* New keys go in the last table; make room in it if it is full */
+    pptable = &((pPmDict_t)pdict)->d_table;
+    while ((*pptable)->dt_next != C_NULL)
+    {
+        pptable = &(*pptable)->dt_next;
+    }
+    ptable = *pptable;
+    if (ptable->dt_used == ptable->dt_capacity)
     {
-        /* Check for matching key */
-        indx = 0;
-        retval = seglist_findEqual(((pPmDict_t)pdict)->d_keys, pkey, &indx);
+        retval = dict_tableGrow(pptable, &ptable);
+        PM_RETURN_IF_ERROR(retval);
+    }
 
-        /* If found a matching key, replace val obj */
-        if (retval == PM_RET_OK)
-        {
-            retval = seglist_setItem(((pPmDict_t)pdict)->d_vals, pval, indx);
-            return retval;
-        }
+    /* A string view key is stored as a string, so it does not hold its parent */
+    if ((OBJ_GET_TYPE(pkey) == OBJ_TYPE_SVW)
+        && (((pPmStringView_t)pkey)->pstr != C_NULL))
+    {
+        retval = string_materialize(pkey, &pkey);
+        PM_RETURN_IF_ERROR(retval);
     }
 
-    /* Otherwise, insert the key,val pair */
-    retval = seglist_insertItem(((pPmDict_t)pdict)->d_keys, pkey, 0);
-    PM_RETURN_IF_ERROR(retval);
-    retval = seglist_insertItem(((pPmDict_t)pdict)->d_vals, pval, 0);
+    /* Otherwise, append the key,val pair */
+    dict_tableAppend(ptable, pkey, pval, hash);
     ((pPmDict_t)pdict)->length++;
 
     return retval;
@@ -159,7 +369,9 @@ PmReturn_t
 dict_getItem(pPmObj_t pdict, pPmObj_t pkey, pPmObj_t *r_pobj)
 {
     PmReturn_t retval = PM_RET_OK;
-    int16_t indx = 0;
+    pPmDictTable_t *pptable;
+    pPmDictTable_t ptable;
+    int16_t slot;
 
 /*    C_ASSERT(pdict != C_NULL);*/
 
@@ -188,17 +400,18 @@ dict_getItem(pPmObj_t pdict, pPmObj_t pkey, pPmObj_t *r_pobj)
     }
 
     /* check for matching key */
-    retval = seglist_findEqual(((pPmDict_t)pdict)->d_keys, pkey, &indx);
+    retval = dict_find((pPmDict_t)pdict, pkey, obj_hash(pkey),
+                       &pptable, &slot);
     /* if key not found, raise KeyError */
     if (retval == PM_RET_NO)
     {
         PM_RAISE(retval, PM_RET_EX_KEY);
+        return retval;
     }
-    /* return any other error */
-    PM_RETURN_IF_ERROR(retval);
 
-    /* key was found, get obj from vals */
-    retval = seglist_getItem(((pPmDict_t)pdict)->d_vals, indx, r_pobj);
+    /* key was found, get obj from its entry */
+    ptable = *pptable;
+    *r_pobj = ptable->dt_entries[DICT_TABLE_SLOTS(ptable)[slot]].de_val;
     return retval;
 }
 
@@ -208,44 +421,103 @@ PmReturn_t
 dict_delItem(pPmObj_t pdict, pPmObj_t pkey)
 {
     PmReturn_t retval = PM_RET_OK;
-    int16_t indx = 0;
+    pPmDictTable_t *pptable;
+    pPmDictTable_t ptable;
+    pPmDictEntry_t pentry;
+    int16_t slot;
 
     C_ASSERT(pdict != C_NULL);
 
+    /* #147: Change boolean keys to integers */
+    if (pkey == PM_TRUE)
+    {
+        pkey = PM_ONE;
+    }
+    else if (pkey == PM_FALSE)
+    {
+        pkey = PM_ZERO;
+    }
+
     /* Check for matching key */
-    retval = seglist_findEqual(((pPmDict_t)pdict)->d_keys, pkey, &indx);
+    retval = dict_find((pPmDict_t)pdict, pkey, obj_hash(pkey),
+                       &pptable, &slot);
 
     /* Raise KeyError if key is not found */
     if (retval == PM_RET_NO)
     {
         PM_RAISE(retval, PM_RET_EX_KEY);
+        return retval;
     }
 
-    /* Return any other error */
-    PM_RETURN_IF_ERROR(retval);
-
-    /* Remove the key and value */
-    retval = seglist_removeItem(((pPmDict_t)pdict)->d_keys, indx);
-    PM_RETURN_IF_ERROR(retval);
-    retval = seglist_removeItem(((pPmDict_t)pdict)->d_vals, indx);
+    /* Remove the key and value, leaving a deleted slot for later probes */
+    ptable = *pptable;
+    pentry = &ptable->dt_entries[DICT_TABLE_SLOTS(ptable)[slot]];
+    pentry->de_key = C_NULL;
+    pentry->de_val = C_NULL;
+    DICT_TABLE_SLOTS(ptable)[slot] = DICT_SLOT_DUMMY;
+    ptable->dt_length--;
 
     /* Reduce the item count */
     ((pPmDict_t)pdict)->length--;
 
+    /* Free a table that has no live entries left */
+    if (ptable->dt_length == 0)
+    {
+        *pptable = ptable->dt_next;
+        retval = heap_freeChunk((pPmObj_t)ptable);
+    }
+
     return retval;
 }
 #endif /* HAVE_DEL */
 
 
+PmReturn_t
+dict_next(pPmObj_t pdict, uint16_t *pindex,
+          pPmObj_t *r_pkey, pPmObj_t *r_pval)
+{
+    pPmDictTable_t ptable;
+    pPmDictEntry_t pentry;
+    uint16_t base = 0;
+    uint16_t i = *pindex;
+
+    C_ASSERT(OBJ_GET_TYPE(pdict) == OBJ_TYPE_DIC);
+
+    /* The position counts the entries of the tables before it */
+    for (ptable = ((pPmDict_t)pdict)->d_table;
+         ptable != C_NULL; ptable = ptable->dt_next)
+    {
+        for (; i < ptable->dt_used; i++)
+        {
+            pentry = &ptable->dt_entries[i];
+            if (pentry->de_key != C_NULL)
+            {
+                *r_pkey = pentry->de_key;
+                if (r_pval != C_NULL)
+                {
+                    *r_pval = pentry->de_val;
+                }
+                *pindex = base + i + 1;
+                return PM_RET_OK;
+            }
+        }
+        i -= ptable->dt_used;
+        base += ptable->dt_used;
+    }
+
+    return PM_RET_NO;
+}
+
+
 #ifdef HAVE_PRINT
 PmReturn_t
 dict_print(pPmObj_t pdict)
 {
     PmReturn_t retval = PM_RET_OK;
-    int16_t index;
-    pSeglist_t keys,
-      vals;
-    pPmObj_t pobj1;
+    uint16_t index = 0;
+    uint16_t n = 0;
+    pPmObj_t pkey;
+    pPmObj_t pval;
 
     C_ASSERT(pdict != C_NULL);
 
@@ -258,26 +530,18 @@ dict_print(pPmObj_t pdict)
 
     plat_putByte('{');
 
-    keys = ((pPmDict_t)pdict)->d_keys;
-    vals = ((pPmDict_t)pdict)->d_vals;
-
-    /* if dict is empty, raise KeyError */
-    for (index = 0; index < ((pPmDict_t)pdict)->length; index++)
+    while (dict_next(pdict, &index, &pkey, &pval) == PM_RET_OK)
     {
-        if (index != 0)
+        if (n++ != 0)
         {
             plat_putByte(',');
             plat_putByte(' ');
         }
-        retval = seglist_getItem(keys, index, &pobj1);
-        PM_RETURN_IF_ERROR(retval);
-        retval = obj_print(pobj1, C_FALSE, C_TRUE);
+        retval = obj_print(pkey, C_FALSE, C_TRUE);
         PM_RETURN_IF_ERROR(retval);
 
         plat_putByte(':');
-        retval = seglist_getItem(vals, index, &pobj1);
-        PM_RETURN_IF_ERROR(retval);
-        retval = obj_print(pobj1, C_FALSE, C_TRUE);
+        retval = obj_print(pval, C_FALSE, C_TRUE);
         PM_RETURN_IF_ERROR(retval);
     }
 
@@ -290,7 +554,7 @@ PmReturn_t
 dict_update(pPmObj_t pdestdict, pPmObj_t psourcedict, uint8_t omit_underscored)
 {
     PmReturn_t retval = PM_RET_OK;
-    int16_t i;
+    uint16_t index = 0;
     pPmObj_t pkey;
     pPmObj_t pval;
 
@@ -312,14 +576,8 @@ dict_update(pPmObj_t pdestdict, pPmObj_t psourcedict, uint8_t omit_underscored)
     }
 
     /* Iterate over the add-on dict */
-    for (i = 0; i < ((pPmDict_t)psourcedict)->length; i++)
+    while (dict_next(psourcedict, &index, &pkey, &pval) == PM_RET_OK)
     {
-        /* Get the key,val from the add-on dict */
-        retval = seglist_getItem(((pPmDict_t)psourcedict)->d_keys, i, &pkey);
-        PM_RETURN_IF_ERROR(retval);
-        retval = seglist_getItem(((pPmDict_t)psourcedict)->d_vals, i, &pval);
-        PM_RETURN_IF_ERROR(retval);
-
         if (!(omit_underscored && (OBJ_GET_TYPE(pkey) == OBJ_TYPE_STR)
               && ((pPmString_t)pkey)->val[0] == '_'))
         {
@@ -341,7 +599,7 @@ dict_compare(pPmObj_t d1, pPmObj_t d2)
     pPmObj_t pkey1;
     pPmObj_t pval1;
     pPmObj_t pval2;
-    uint16_t i;
+    uint16_t index = 0;
     PmReturn_t retval;
 
     /* Return if lengths are not equal */
@@ -350,14 +608,9 @@ dict_compare(pPmObj_t d1, pPmObj_t d2)
         return C_DIFFER;
     }
 
-    for (i = 0; i < pd1->length; i++)
+    /* Iterate over the key,val pairs of one dict */
+    while (dict_next(d1, &index, &pkey1, &pval1) == PM_RET_OK)
     {
-        /* Get the key,val from one dict */
-        retval = seglist_getItem(pd1->d_keys, i, &pkey1);
-        PM_RETURN_IF_ERROR(retval);
-        retval = seglist_getItem(pd1->d_vals, i, &pval1);
-        PM_RETURN_IF_ERROR(retval);
-
         /* Return if the key,val pair is not in the other dict */
         retval = dict_getItem(d2, pkey1, &pval2);
         if (retval != PM_RET_OK)
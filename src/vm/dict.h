@@ -18,11 +18,67 @@
  */
 
 
+/** Number of index slots in the smallest dict table */
+#define DICT_TABLE_MIN_SLOTS 8
+
+/** Index slot value for a slot that has never been used */
+#define DICT_SLOT_EMPTY (int16_t)-1
+
+/** Index slot value for a slot whose entry was deleted */
+#define DICT_SLOT_DUMMY (int16_t)-2
+
+
+/**
+ * Dict Entry
+ *
+ * A key,value pair.  A deleted entry has a null key.
+ */
+typedef struct PmDictEntry_s
+{
+    /** ptr to key obj */
+    pPmObj_t de_key;
+    /** ptr to val obj */
+    pPmObj_t de_val;
+} PmDictEntry_t,
+ *pPmDictEntry_t;
+
+
+/**
+ * Dict Table
+ *
+ * An open-addressing hash table in one heap chunk.
+ * The entries array holds the key,value pairs in insertion order.
+ * It is followed by dt_nslots index slots (int16_t) that map a key's hash
+ * to the number of its entry, or hold DICT_SLOT_EMPTY or DICT_SLOT_DUMMY.
+ *
+ * A table cannot grow past the heap's max live chunk size.
+ * When the largest table is full, another table is chained after it.
+ * Only the last table in the chain takes new keys.
+ */
+typedef struct PmDictTable_s
+{
+    /** object descriptor */
+    PmObjDesc_t od;
+    /** number of index slots (a power of two) */
+    uint16_t dt_nslots;
+    /** number of entries the table can hold */
+    uint16_t dt_capacity;
+    /** number of entries used, including deleted ones */
+    uint16_t dt_used;
+    /** number of live entries */
+    uint16_t dt_length;
+    /** ptr to the next table in the chain */
+    struct PmDictTable_s *dt_next;
+    /** entries array (the index slots follow it) */
+    PmDictEntry_t dt_entries[1];
+} PmDictTable_t,
+ *pPmDictTable_t;
+
+
 /**
  * Dict
  *
- * Contains ptr to two seglists,
- * one for keys, the other for values;
+ * Contains ptr to a chain of hash tables
  * and a length, the number of key/value pairs.
  */
 typedef struct PmDict_s
@@ -31,10 +87,8 @@ typedef struct PmDict_s
     PmObjDesc_t od;
     /** number of key,value pairs in the dict */
     uint16_t length;
-    /** ptr to seglist containing keys */
-    pSeglist_t d_keys;
-    /** ptr to seglist containing values */
-    pSeglist_t d_vals;
+    /** ptr to the first hash table (null while the dict is empty) */
+    pPmDictTable_t d_table;
 } PmDict_t,
  *pPmDict_t;
 
@@ -85,8 +139,8 @@ PmReturn_t dict_new(pPmObj_t *r_pdict);
  * Sets a value in the dict using the given key.
  *
  * If the dict already contains a matching key, the value is
- * replaced; otherwise the new key,val pair is inserted
- * at the front of the dict (for fast lookup).
+ * replaced; otherwise the new key,val pair is appended
+ * after the dict's other pairs.
  * In the later case, the length of the dict is incremented.
  *
  * @param   pdict ptr to dict in which (key,val) will go
@@ -96,6 +150,20 @@ PmReturn_t dict_new(pPmObj_t *r_pdict);
  */
 PmReturn_t dict_setItem(pPmObj_t pdict, pPmObj_t pkey, pPmObj_t pval);
 
+/**
+ * Gets the next key,value pair in insertion order.
+ * The position is an opaque cursor; start it at zero.
+ * Deleted pairs are skipped.
+ *
+ * @param   pdict ptr to dict to walk
+ * @param   pindex ptr to position; on return, the position after the pair
+ * @param   r_pkey Return; addr of ptr to key obj
+ * @param   r_pval Return; addr of ptr to val obj (may be C_NULL)
+ * @return  PM_RET_OK, or PM_RET_NO if there are no more pairs
+ */
+PmReturn_t dict_next(pPmObj_t pdict, uint16_t *pindex,
+                     pPmObj_t *r_pkey, pPmObj_t *r_pval);
+
 #ifdef HAVE_PRINT
 /**
  * Prints out a dict. Uses obj_print() to print elements.
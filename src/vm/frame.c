@@ -40,6 +40,10 @@ frame_new(pPmObj_t pfunc, pPmObj_t *r_pobj)
         return retval;
     }
 
+    /* Load the names and consts of the code obj on the func's first call */
+    retval = co_resolve(pco);
+    PM_RETURN_IF_ERROR(retval);
+
 #ifdef HAVE_GENERATORS
     /* #207: Initializing a Generator using CALL_FUNC needs extra stack slot */
     fsize = sizeof(PmFrame_t) + (pco->co_stacksize + pco->co_nlocals + 2) * sizeof(pPmObj_t);
@@ -86,6 +90,7 @@ frame_new(pPmObj_t pfunc, pPmObj_t *r_pobj)
 
     /* By default, this is a normal frame, not an import or __init__ one */
     pframe->fo_isImport = 0;
+    pframe->fo_isForIter = 0;
 #ifdef HAVE_CLASSES
     pframe->fo_isInit = 0;
 #endif
@@ -98,3 +103,24 @@ frame_new(pPmObj_t pfunc, pPmObj_t *r_pobj)
     *r_pobj = (pPmObj_t)pframe;
     return retval;
 }
+
+
+#ifdef HAVE_GENERATORS
+PmReturn_t
+frame_newGen(pPmObj_t pframe, pPmObj_t *r_pgen)
+{
+    PmReturn_t retval;
+    uint8_t *pchunk;
+
+    C_ASSERT(OBJ_GET_TYPE(pframe) == OBJ_TYPE_FRM);
+
+    /* Allocate a generator */
+    retval = heap_getChunk(sizeof(PmGenerator_t), &pchunk);
+    PM_RETURN_IF_ERROR(retval);
+    OBJ_SET_TYPE(pchunk, OBJ_TYPE_GEN);
+    ((pPmGenerator_t)pchunk)->g_frame = (pPmFrame_t)pframe;
+
+    *r_pgen = (pPmObj_t)pchunk;
+    return retval;
+}
+#endif /* HAVE_GENERATORS */
@@ -112,6 +112,9 @@ typedef struct PmFrame_s
     /** Frame can be an import-frame that handles RETURN differently */
     uint8_t fo_isImport:1;
 
+    /** Generator frame resumed by FOR_ITER; its RETURN ends that loop */
+    uint8_t fo_isForIter:1;
+
 #ifdef HAVE_CLASSES
     /** Flag to indicate class initailzer frame; handle RETURN differently */
     uint8_t fo_isInit:1;
@@ -155,12 +158,40 @@ typedef struct PmNativeFrame_s
     /** Number of args passed to the native function */
     uint8_t nf_numlocals;
 
+    /** Calling convention flags of the active native (NO_FLAG_*) */
+    uint8_t nf_flags;
+
+    /**
+     * Ptr to the args; points to nf_locals, or to the slice of the
+     * caller's stack for a native declared with NO_FLAG_STACKARGS
+     */
+    pPmObj_t *nf_argv;
+
     /** Local vars */
     pPmObj_t nf_locals[NATIVE_MAX_NUM_LOCALS];
 } PmNativeFrame_t,
  *pPmNativeFrame_t;
 
 
+#ifdef HAVE_GENERATORS
+/**
+ * Generator
+ *
+ * A generator-iterator.  Holds the frame of the generator function
+ * that is resumed each time the generator is iterated.
+ */
+typedef struct PmGenerator_s
+{
+    /** Obligatory obj descriptor */
+    PmObjDesc_t od;
+
+    /** Frame of the generator function */
+    pPmFrame_t g_frame;
+} PmGenerator_t,
+ *pPmGenerator_t;
+#endif /* HAVE_GENERATORS */
+
+
 /**
  * Allocate space for a new frame, fill its fields
  * with respect to the given function object.
@@ -172,4 +203,15 @@ typedef struct PmNativeFrame_s
  */
 PmReturn_t frame_new(pPmObj_t pfunc, pPmObj_t *r_pobj);
 
+#ifdef HAVE_GENERATORS
+/**
+ * Creates a generator that resumes the given frame.
+ *
+ * @param   pframe ptr to the generator function's frame.
+ * @param   r_pgen Return value; the new generator.
+ * @return  Return status.
+ */
+PmReturn_t frame_newGen(pPmObj_t pframe, pPmObj_t *r_pgen);
+#endif /* HAVE_GENERATORS */
+
 #endif /* __FRAME_H__ */
@@ -28,7 +28,7 @@ static uint8_t const *bistr = (uint8_t const *)"__bi";
 
 
 /** Most PyMite globals all in one convenient place */
-volatile PmVmGlobal_t gVmGlobal;
+PM_PLAT_TLS volatile PmVmGlobal_t gVmGlobal;
 
 
 PmReturn_t
@@ -159,10 +159,19 @@ global_init(void)
     gVmGlobal.nativeframe.nf_stack = C_NULL;
     gVmGlobal.nativeframe.nf_active = C_FALSE;
     gVmGlobal.nativeframe.nf_numlocals = 0;
+    gVmGlobal.nativeframe.nf_flags = 0;
+    gVmGlobal.nativeframe.nf_argv =
+        (pPmObj_t *)gVmGlobal.nativeframe.nf_locals;
 
-    /* Create empty threadList */
-    retval = list_new(&pobj);
-    gVmGlobal.threadList = (pPmList_t)pobj;
+#ifdef HAVE_BUDGET_SCHED
+    gVmGlobal.budget = PM_THREAD_BUDGET;
+    gVmGlobal.budgetLeft = PM_THREAD_BUDGET;
+    gVmGlobal.budgetTimed = C_TRUE;
+#endif /* HAVE_BUDGET_SCHED */
+
+    /* Init empty ready queues (the queue heads were cleared above) */
+    gVmGlobal.threadReady = 0;
+    gVmGlobal.threadCount = 0;
 
     /* Init the PmImgPaths with std image info */
     gVmGlobal.imgPaths.memspace[0] = MEMSPACE_PROG;
@@ -223,7 +232,7 @@ global_loadBuiltins(void)
     PM_RETURN_IF_ERROR(retval);
 
     /* Must interpret builtins' root code to set the attrs */
-    C_ASSERT(gVmGlobal.threadList->length == 0);
+    C_ASSERT(gVmGlobal.threadCount == 0);
     interp_addThread((pPmFunc_t)pbimod);
     retval = interpret(INTERP_RETURN_ON_NO_THREADS);
     PM_RETURN_IF_ERROR(retval);
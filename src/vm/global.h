@@ -112,8 +112,20 @@ typedef struct PmVmGlobal_s
     /** Line number for when an error occurs */
     uint16_t errLineNum;
 
-    /** Thread list */
-    pPmList_t threadList;
+    /** Ready queues of threads, one circular list per priority */
+    pPmThread_t threadQueue[PM_THREAD_NUM_PRIORITIES];
+
+    /** Bit n is set while threadQueue[n] is not empty */
+    uint8_t threadReady;
+
+    /** Number of threads in the ready queues */
+    uint16_t threadCount;
+
+    /** Sleeping threads sorted by wake time, linked through next */
+    pPmThread_t threadSleep;
+
+    /** Wake time of the first sleeping thread (read by pm_vmPeriodic()) */
+    uint32_t threadWakeMs;
 
     /** Ptr to current thread */
     pPmThread_t pthread;
@@ -153,11 +165,22 @@ typedef struct PmVmGlobal_s
 
     /** Flag to trigger rescheduling */
     uint8_t reschedule;
+
+#ifdef HAVE_BUDGET_SCHED
+    /** Number of backward jumps and calls in a thread's timeslice */
+    uint16_t budget;
+
+    /** Part of the budget the running thread has not spent yet */
+    uint16_t budgetLeft;
+
+    /** The timer also ends timeslices if true */
+    uint8_t budgetTimed;
+#endif /* HAVE_BUDGET_SCHED */
 } PmVmGlobal_t,
  *pPmVmGlobal_t;
 
 
-extern volatile PmVmGlobal_t gVmGlobal;
+extern PM_PLAT_TLS volatile PmVmGlobal_t gVmGlobal;
 
 
 /**
@@ -26,20 +26,6 @@
 /** The size of the temporary roots stack */
 #define HEAP_NUM_TEMP_ROOTS 24
 
-/**
- * The maximum size a live chunk can be (a live chunk is one that is in use).
- * The live chunk size is determined by the size field in the *object*
- * descriptor.  That field is nine bits with two assumed lsbs (zeros):
- * (0x1FF << 2) == 2044
- */
-#ifdef PM_PLAT_POINTER_SIZE
-#if PM_PLAT_POINTER_SIZE == 8
-#define HEAP_MAX_LIVE_CHUNK_SIZE 2040
-#else
-#define HEAP_MAX_LIVE_CHUNK_SIZE 2044
-#endif
-#endif
-
 /**
  * The maximum size a free chunk can be (a free chunk is one that is not in use).
  * The free chunk size is limited by the size field in the *heap* descriptor.
@@ -183,7 +169,7 @@ typedef struct PmHeap_s
 
 
 /** The PyMite heap */
-static PmHeap_t pmHeap PM_PLAT_HEAP_ATTR;
+static PM_PLAT_TLS PmHeap_t pmHeap PM_PLAT_HEAP_ATTR;
 
 
 #if 0
@@ -209,7 +195,7 @@ heap_gcPrintFreelist(void)
 static void
 heap_dump(void)
 {
-    static int n = 0;
+    static PM_PLAT_TLS int n = 0;
     uint16_t s;
     uint32_t i;
     char filename[17] = "pmheapdump0N.bin\0";
@@ -271,7 +257,7 @@ heap_dump(void)
     fwrite((void *)&gVmGlobal.pcodeStr, sizeof(intptr_t), 1, fp);
     fwrite((void *)&gVmGlobal.builtins, sizeof(intptr_t), 1, fp);
     fwrite((void *)&gVmGlobal.nativeframe, sizeof(intptr_t), 1, fp);
-    fwrite((void *)&gVmGlobal.threadList, sizeof(intptr_t), 1, fp);
+    fwrite((void *)&gVmGlobal.pthread, sizeof(intptr_t), 1, fp);
     fclose(fp);
 }
 #endif
@@ -547,6 +533,10 @@ heap_getChunk(uint16_t requestedsize, uint8_t **r_pchunk)
         requestedsize = HEAP_MIN_CHUNK_SIZE;
     }
 
+    /* A native declared as non-allocating must not request a chunk */
+    C_ASSERT(!(gVmGlobal.nativeframe.nf_active
+               && (gVmGlobal.nativeframe.nf_flags & NO_FLAG_NOALLOC)));
+
     /*
      * Round up the size to a multiple of N bytes,
      * where N is 8 for 64-bit platforms and 4 for all else.
@@ -679,7 +669,15 @@ heap_gcMarkObj(pPmObj_t pobj)
         case OBJ_TYPE_NOB:
         case OBJ_TYPE_BOOL:
         case OBJ_TYPE_CIO:
+        case OBJ_TYPE_XRG:
+            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
+            break;
+
+        case OBJ_TYPE_SVW:
+            /* Mark the view and the string it refers to */
             OBJ_SET_GCVAL(pobj, pmHeap.gcval);
+            retval = heap_gcMarkObj(
+                (pPmObj_t)((pPmStringView_t)pobj)->pstr);
             break;
 
         case OBJ_TYPE_TUP:
@@ -709,12 +707,38 @@ heap_gcMarkObj(pPmObj_t pobj)
             /* Mark the dict head */
             OBJ_SET_GCVAL(pobj, pmHeap.gcval);
 
-            /* Mark the keys seglist */
-            retval = heap_gcMarkObj((pPmObj_t)((pPmDict_t)pobj)->d_keys);
-            PM_RETURN_IF_ERROR(retval);
+            /* Mark the dict's tables */
+            retval = heap_gcMarkObj((pPmObj_t)((pPmDict_t)pobj)->d_table);
+            break;
+
+#ifdef HAVE_SET
+        case OBJ_TYPE_SET:
+            /* Mark the set head */
+            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
+
+            /* Mark the dict of members */
+            retval = heap_gcMarkObj((pPmObj_t)((pPmSet_t)pobj)->s_dict);
+            break;
+#endif /* HAVE_SET */
+
+        case OBJ_TYPE_DTB:
+            /* Mark the table head */
+            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
 
-            /* Mark the vals seglist */
-            retval = heap_gcMarkObj((pPmObj_t)((pPmDict_t)pobj)->d_vals);
+            /* Mark the keys and vals of the used entries (deleted are null) */
+            n = ((pPmDictTable_t)pobj)->dt_used;
+            for (i = 0; i < n; i++)
+            {
+                retval = heap_gcMarkObj(
+                    ((pPmDictTable_t)pobj)->dt_entries[i].de_key);
+                PM_RETURN_IF_ERROR(retval);
+                retval = heap_gcMarkObj(
+                    ((pPmDictTable_t)pobj)->dt_entries[i].de_val);
+                PM_RETURN_IF_ERROR(retval);
+            }
+
+            /* Mark the next table in the chain */
+            retval = heap_gcMarkObj((pPmObj_t)((pPmDictTable_t)pobj)->dt_next);
             break;
 
         case OBJ_TYPE_COB:
@@ -879,32 +903,31 @@ heap_gcMarkObj(pPmObj_t pobj)
         case OBJ_TYPE_SGL:
             /* Mark the seglist obj head */
             OBJ_SET_GCVAL(pobj, pmHeap.gcval);
-
-            /* Mark the seglist's segments */
-            n = ((pSeglist_t)pobj)->sl_length;
-            pobj = (pPmObj_t)((pSeglist_t)pobj)->sl_rootseg;
-            for (i = 0; i < n; i++)
+            if (((pSeglist_t)pobj)->sl_rootseg == C_NULL)
             {
-                /* Mark the segment item */
-                retval = heap_gcMarkObj(((pSegment_t)pobj)->s_val[i % SEGLIST_OBJS_PER_SEG]);
-                PM_RETURN_IF_ERROR(retval);
+                break;
+            }
 
-                /* Mark the segment obj head */
-                if ((i % SEGLIST_OBJS_PER_SEG) == 0)
+            /* Mark the root segment and any full-size segments it holds */
+            OBJ_SET_GCVAL(((pSeglist_t)pobj)->sl_rootseg, pmHeap.gcval);
+            if (((pSeglist_t)pobj)->sl_dirsize != 0)
+            {
+                n = (((pSeglist_t)pobj)->sl_capacity
+                     + SEGLIST_OBJS_PER_SEG - 1) >> SEGLIST_SEG_SHIFT;
+                for (i = 0; i < n; i++)
                 {
-                    OBJ_SET_GCVAL(pobj, pmHeap.gcval);
+                    OBJ_SET_GCVAL(((pSeglist_t)pobj)->sl_rootseg->s_val[i],
+                                  pmHeap.gcval);
                 }
+            }
 
-                /* Point to the next segment */
-                else
-                if ((i % SEGLIST_OBJS_PER_SEG) == (SEGLIST_OBJS_PER_SEG - 1))
-                {
-                    pobj = (pPmObj_t)((pSegment_t)pobj)->next;
-                    if (pobj == C_NULL)
-                    {
-                        break;
-                    }
-                }
+            /* Mark the seglist's items */
+            n = ((pSeglist_t)pobj)->sl_length;
+            for (i = 0; i < n; i++)
+            {
+                retval = heap_gcMarkObj(*SEGLIST_ITEM_SLOT((pSeglist_t)pobj,
+                                                           i));
+                PM_RETURN_IF_ERROR(retval);
             }
             break;
 
@@ -916,6 +939,16 @@ heap_gcMarkObj(pPmObj_t pobj)
             retval = heap_gcMarkObj(((pPmSeqIter_t)pobj)->si_sequence);
             break;
 
+#ifdef HAVE_GENERATORS
+        case OBJ_TYPE_GEN:
+            /* Mark the generator obj head */
+            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
+
+            /* Mark the generator's frame */
+            retval = heap_gcMarkObj((pPmObj_t)((pPmGenerator_t)pobj)->g_frame);
+            break;
+#endif /* HAVE_GENERATORS */
+
         case OBJ_TYPE_THR:
             /* Mark the thread obj head */
             OBJ_SET_GCVAL(pobj, pmHeap.gcval);
@@ -953,7 +986,7 @@ heap_gcMarkObj(pPmObj_t pobj)
                 for (i = 0; i < NATIVE_GET_NUM_ARGS(); i++)
                 {
                     retval =
-                        heap_gcMarkObj(gVmGlobal.nativeframe.nf_locals[i]);
+                        heap_gcMarkObj(gVmGlobal.nativeframe.nf_argv[i]);
                     PM_RETURN_IF_ERROR(retval);
                 }
             }
@@ -989,6 +1022,7 @@ heap_gcMarkRoots(void)
 {
     PmReturn_t retval;
     uint8_t i;
+    pPmThread_t pthread;
 
     /* Toggle the GC marking value so it differs from the last run */
     pmHeap.gcval ^= 1;
@@ -1017,9 +1051,31 @@ heap_gcMarkRoots(void)
     retval = heap_gcMarkObj((pPmObj_t)&gVmGlobal.nativeframe);
     PM_RETURN_IF_ERROR(retval);
 
-    /* Mark the thread list */
-    retval = heap_gcMarkObj((pPmObj_t)gVmGlobal.threadList);
-    PM_RETURN_IF_ERROR(retval);
+    /* Mark the threads in the ready queues */
+    for (i = 0; i < PM_THREAD_NUM_PRIORITIES; i++)
+    {
+        pthread = gVmGlobal.threadQueue[i];
+        if (pthread == C_NULL)
+        {
+            continue;
+        }
+        do
+        {
+            retval = heap_gcMarkObj((pPmObj_t)pthread);
+            PM_RETURN_IF_ERROR(retval);
+            pthread = pthread->next;
+        }
+        while (pthread != gVmGlobal.threadQueue[i]);
+    }
+
+    /* Mark the sleeping threads */
+    for (pthread = gVmGlobal.threadSleep;
+         pthread != C_NULL;
+         pthread = pthread->next)
+    {
+        retval = heap_gcMarkObj((pPmObj_t)pthread);
+        PM_RETURN_IF_ERROR(retval);
+    }
 
     /* Mark the temporary roots */
     for (i = 0; i < pmHeap.temp_root_index; i++)
@@ -1028,6 +1084,26 @@ heap_gcMarkRoots(void)
         PM_RETURN_IF_ERROR(retval);
     }
 
+#ifdef HAVE_PROFILER
+    /* Mark the code objects referenced by the profile (if any) */
+    {
+        uint16_t n;
+        uint16_t nco;
+        pPmCo_t pco;
+
+        nco = (uint16_t)prof_getNumStacks() * PROF_MAX_DEPTH;
+        for (n = 0; n < nco; n++)
+        {
+            pco = prof_getCo(n);
+            if (pco != C_NULL)
+            {
+                retval = heap_gcMarkObj((pPmObj_t)pco);
+                PM_RETURN_IF_ERROR(retval);
+            }
+        }
+    }
+#endif /* HAVE_PROFILER */
+
     return retval;
 }
 
@@ -1048,36 +1124,29 @@ heap_purgeStringCache(uint8_t gcval)
 {
     PmReturn_t retval;
     pPmString_t *ppstrcache;
-    pPmString_t pstr;
+    pPmString_t *ppstr;
+    uint16_t i;
 
-    /* Update string cache pointer if the first string objs are not marked */
     retval = string_getCache(&ppstrcache);
     if (ppstrcache == C_NULL)
     {
         return retval;
     }
-    while ((*ppstrcache != C_NULL) && (OBJ_GET_GCVAL(*ppstrcache) != gcval))
-    {
-        *ppstrcache = (*ppstrcache)->next;
-    }
-    if (*ppstrcache == C_NULL)
-    {
-        return retval;
-    }
 
-    /* Unlink remaining strings that are not marked */
-    for (pstr = *ppstrcache; pstr->next != C_NULL;)
+    /* Unlink the strings that are not marked from each bucket */
+    for (i = 0; i < STRING_CACHE_NUM_BUCKETS; i++)
     {
-        /* Unlink consecutive non-marked strings */
-        while ((pstr->next != C_NULL) && (OBJ_GET_GCVAL(pstr->next) != gcval))
+        ppstr = &ppstrcache[i];
+        while (*ppstr != C_NULL)
         {
-            pstr->next = pstr->next->next;
-        }
-
-        /* If not at end of cache, string must be marked, skip it */
-        if (pstr->next != C_NULL)
-        {
-            pstr = pstr->next;
+            if (OBJ_GET_GCVAL(*ppstr) != gcval)
+            {
+                *ppstr = (*ppstr)->next;
+            }
+            else
+            {
+                ppstr = &(*ppstr)->next;
+            }
         }
     }
 
@@ -1107,9 +1176,9 @@ heap_gcSweep(void)
     while ((uint8_t *)pobj < &pmHeap.base[pmHeap.size])
     {
         /* Skip to the next unmarked or free chunk within the heap */
-        while (!OBJ_GET_FREE(pobj)
-               && (OBJ_GET_GCVAL(pobj) == pmHeap.gcval)
-               && ((uint8_t *)pobj < &pmHeap.base[pmHeap.size]))
+        while (((uint8_t *)pobj < &pmHeap.base[pmHeap.size])
+               && !OBJ_GET_FREE(pobj)
+               && (OBJ_GET_GCVAL(pobj) == pmHeap.gcval))
         {
             pobj = (pPmObj_t)((uint8_t *)pobj + PM_OBJ_GET_SIZE(pobj));
         }
@@ -1201,6 +1270,11 @@ heap_gcRun(void)
 
     C_DEBUG_PRINT(VERBOSITY_LOW, "heap_gcRun()\n");
 
+#ifdef HAVE_PROFILER
+    /* Resolve pending samples while their code objects are still alive */
+    prof_drain();
+#endif /* HAVE_PROFILER */
+
     retval = heap_gcMarkRoots();
     PM_RETURN_IF_ERROR(retval);
 
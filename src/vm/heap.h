@@ -25,6 +25,21 @@
 #define HEAP_GC_NF_THRESHOLD (512)
 
 
+/**
+ * The maximum size a live chunk can be (a live chunk is one that is in use).
+ * The live chunk size is determined by the size field in the *object*
+ * descriptor.  That field is nine bits with two assumed lsbs (zeros):
+ * (0x1FF << 2) == 2044
+ */
+#ifdef PM_PLAT_POINTER_SIZE
+#if PM_PLAT_POINTER_SIZE == 8
+#define HEAP_MAX_LIVE_CHUNK_SIZE 2040
+#else
+#define HEAP_MAX_LIVE_CHUNK_SIZE 2044
+#endif
+#endif
+
+
 #ifdef __DEBUG__
 #define DEBUG_PRINT_HEAP_AVAIL(s) \
     do { uint16_t n; heap_getAvail(&n); printf(s "heap avail = %d\n", n); } \
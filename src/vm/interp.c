@@ -21,6 +21,219 @@
 #include "pm.h"
 
 
+#ifdef HAVE_OPSTATS
+/** Number of times each bytecode was dispatched */
+static PM_PLAT_TLS uint32_t opstatsCount[256];
+
+/** Cycles spent executing each bytecode (see plat_getCycles()) */
+static PM_PLAT_TLS uint64_t opstatsCycles[256];
+
+/** Number of times interpret() ended a timeslice */
+static PM_PLAT_TLS uint32_t opstatsReschedules;
+
+/** Bytecode names for the opstats report; C_NULL for unused bytecodes */
+static char const * const opstatsNames[EXTENDED_ARG + 1] =
+{
+    "STOP_CODE",
+    "POP_TOP",
+    "ROT_TWO",
+    "ROT_THREE",
+    "DUP_TOP",
+    "ROT_FOUR",
+    C_NULL,
+    C_NULL,
+    C_NULL,
+    "NOP",
+    "UNARY_POSITIVE",
+    "UNARY_NEGATIVE",
+    "UNARY_NOT",
+    "UNARY_CONVERT",
+    C_NULL,
+    "UNARY_INVERT",
+    C_NULL,
+    C_NULL,
+    "LIST_APPEND",
+    "BINARY_POWER",
+    "BINARY_MULTIPLY",
+    "BINARY_DIVIDE",
+    "BINARY_MODULO",
+    "BINARY_ADD",
+    "BINARY_SUBTRACT",
+    "BINARY_SUBSCR",
+    "BINARY_FLOOR_DIVIDE",
+    "BINARY_TRUE_DIVIDE",
+    "INPLACE_FLOOR_DIVIDE",
+    "INPLACE_TRUE_DIVIDE",
+    "SLICE_0",
+    "SLICE_1",
+    "SLICE_2",
+    "SLICE_3",
+    C_NULL,
+    C_NULL,
+    C_NULL,
+    C_NULL,
+    C_NULL,
+    C_NULL,
+    "STORE_SLICE_0",
+    "STORE_SLICE_1",
+    "STORE_SLICE_2",
+    "STORE_SLICE_3",
+    C_NULL,
+    C_NULL,
+    C_NULL,
+    C_NULL,
+    C_NULL,
+    C_NULL,
+    "DELETE_SLICE_0",
+    "DELETE_SLICE_1",
+    "DELETE_SLICE_2",
+    "DELETE_SLICE_3",
+    "STORE_MAP",
+    "INPLACE_ADD",
+    "INPLACE_SUBTRACT",
+    "INPLACE_MULTIPLY",
+    "INPLACE_DIVIDE",
+    "INPLACE_MODULO",
+    "STORE_SUBSCR",
+    "DELETE_SUBSCR",
+    "BINARY_LSHIFT",
+    "BINARY_RSHIFT",
+    "BINARY_AND",
+    "BINARY_XOR",
+    "BINARY_OR",
+    "INPLACE_POWER",
+    "GET_ITER",
+    C_NULL,
+    "PRINT_EXPR",
+    "PRINT_ITEM",
+    "PRINT_NEWLINE",
+    "PRINT_ITEM_TO",
+    "PRINT_NEWLINE_TO",
+    "INPLACE_LSHIFT",
+    "INPLACE_RSHIFT",
+    "INPLACE_AND",
+    "INPLACE_XOR",
+    "INPLACE_OR",
+    "BREAK_LOOP",
+    "WITH_CLEANUP",
+    "LOAD_LOCALS",
+    "RETURN_VALUE",
+    "IMPORT_STAR",
+    "EXEC_STMT",
+    "YIELD_VALUE",
+    "POP_BLOCK",
+    "END_FINALLY",
+    "BUILD_CLASS",
+    "STORE_NAME",
+    "DELETE_NAME",
+    "UNPACK_SEQUENCE",
+    "FOR_ITER",
+    C_NULL,
+    "STORE_ATTR",
+    "DELETE_ATTR",
+    "STORE_GLOBAL",
+    "DELETE_GLOBAL",
+    "DUP_TOPX",
+    "LOAD_CONST",
+    "LOAD_NAME",
+    "BUILD_TUPLE",
+    "BUILD_LIST",
+    "BUILD_MAP",
+    "LOAD_ATTR",
+    "COMPARE_OP",
+    "IMPORT_NAME",
+    "IMPORT_FROM",
+    C_NULL,
+    "JUMP_FORWARD",
+    "JUMP_IF_FALSE",
+    "JUMP_IF_TRUE",
+    "JUMP_ABSOLUTE",
+    "POP_JUMP_IF_FALSE",
+    "POP_JUMP_IF_TRUE",
+    "LOAD_GLOBAL",
+    C_NULL,
+    C_NULL,
+    "CONTINUE_LOOP",
+    "SETUP_LOOP",
+    "SETUP_EXCEPT",
+    "SETUP_FINALLY",
+    C_NULL,
+    "LOAD_FAST",
+    "STORE_FAST",
+    "DELETE_FAST",
+    C_NULL,
+    C_NULL,
+    C_NULL,
+    "RAISE_VARARGS",
+    "CALL_FUNCTION",
+    "MAKE_FUNCTION",
+    "BUILD_SLICE",
+    "MAKE_CLOSURE",
+    "LOAD_CLOSURE",
+    "LOAD_DEREF",
+    "STORE_DEREF",
+    C_NULL,
+    C_NULL,
+    "CALL_FUNCTION_VAR",
+    "CALL_FUNCTION_KW",
+    "CALL_FUNCTION_VAR_KW",
+    "EXTENDED_ARG"
+};
+
+#define INTERP_COUNT_RESCHEDULE() opstatsReschedules++
+#else
+#define INTERP_COUNT_RESCHEDULE()
+#endif /* HAVE_OPSTATS */
+
+
+#ifdef HAVE_BUDGET_SCHED
+/**
+ * Spends one unit of the running thread's budget (in interpret() only).
+ * Reschedules when the budget is used up or the reschedule flag is set,
+ * then continues with the (possibly different) running thread.
+ * Not wrapped in do-while, so that an error breaks out of the switch.
+ */
+#define INTERP_SPEND_BUDGET() \
+    if ((--gVmGlobal.budgetLeft == 0) || gVmGlobal.reschedule) \
+    { \
+        INTERP_COUNT_RESCHEDULE(); \
+        retval = interp_reschedule(); \
+        PM_BREAK_IF_ERROR(retval); \
+        continue; \
+    }
+#else
+#define INTERP_SPEND_BUDGET()
+#endif /* HAVE_BUDGET_SCHED */
+
+
+#ifdef HAVE_JIT
+#ifdef HAVE_BUDGET_SCHED
+/** Reschedules if the compiled code spent the last of the budget */
+#define INTERP_JIT_RESCHEDULE() \
+    if ((gVmGlobal.budgetLeft == 0) || gVmGlobal.reschedule) \
+    { \
+        INTERP_COUNT_RESCHEDULE(); \
+        retval = interp_reschedule(); \
+        PM_BREAK_IF_ERROR(retval); \
+    }
+#else
+#define INTERP_JIT_RESCHEDULE()
+#endif /* HAVE_BUDGET_SCHED */
+
+/**
+ * Runs the compiled code of the frame's CO from the target of a backward
+ * jump (see jit_run()), in interpret() only.
+ * Not wrapped in do-while, so that an error breaks out of the switch.
+ */
+#define INTERP_RUN_JIT() \
+    retval = jit_run(PM_FP); \
+    PM_BREAK_IF_ERROR(retval); \
+    INTERP_JIT_RESCHEDULE()
+#else
+#define INTERP_RUN_JIT()
+#endif /* HAVE_JIT */
+
+
 PmReturn_t
 interpret(const uint8_t returnOnNoThreads)
 {
@@ -32,6 +245,13 @@ interpret(const uint8_t returnOnNoThreads)
     int8_t t8 = 0;
     uint8_t bc;
     uint8_t objid, objid2;
+#ifdef HAVE_OPSTATS
+    uint32_t opstart = 0;
+    int16_t opprev = -1;
+#endif /* HAVE_OPSTATS */
+#ifdef HAVE_GENERATORS
+    uint8_t const *pc;
+#endif /* HAVE_GENERATORS */
 
     /* Activate a thread the first time */
     retval = interp_reschedule();
@@ -40,32 +260,61 @@ interpret(const uint8_t returnOnNoThreads)
     /* Interpret loop */
     for (;;)
     {
+#ifdef HAVE_OPSTATS
+        /* Charge the cycles since the last dispatch to that bytecode */
+        if (opprev >= 0)
+        {
+            opstatsCycles[opprev] += (uint32_t)(plat_getCycles() - opstart);
+            opprev = -1;
+        }
+#endif /* HAVE_OPSTATS */
+
         if (gVmGlobal.pthread == C_NULL)
         {
-            if (returnOnNoThreads)
+            if (returnOnNoThreads && (gVmGlobal.threadSleep == C_NULL))
             {
                 /* User chose to return on no threads left */
                 return retval;
             }
 
+#if PM_PLAT_HAS_IDLE
+            /* Every thread is asleep, so idle until the first one wakes */
+            if (gVmGlobal.threadSleep != C_NULL)
+            {
+                plat_idle(gVmGlobal.threadWakeMs);
+            }
+#endif /* PM_PLAT_HAS_IDLE */
+
             /*
              * Without a frame there is nothing to execute, so reschedule
-             * (possibly activating a recently added thread).
+             * (possibly activating a recently added or woken thread).
              */
             retval = interp_reschedule();
             PM_BREAK_IF_ERROR(retval);
             continue;
         }
 
+#ifndef HAVE_BUDGET_SCHED
         /* Reschedule threads if flag is true? */
         if (gVmGlobal.reschedule)
         {
+            INTERP_COUNT_RESCHEDULE();
             retval = interp_reschedule();
             PM_BREAK_IF_ERROR(retval);
+
+            /* Check again, since every thread may be asleep now */
+            continue;
         }
+#endif /* !HAVE_BUDGET_SCHED */
+
+        /* Get byte; post-incrs PM_IP */
+        bc = GET_BCODE();
 
-        /* Get byte; the func post-incrs PM_IP */
-        bc = mem_getByte(PM_FP->fo_memspace, &PM_IP);
+#ifdef HAVE_OPSTATS
+        opstatsCount[bc]++;
+        opprev = bc;
+        opstart = plat_getCycles();
+#endif /* HAVE_OPSTATS */
         switch (bc)
         {
             case POP_TOP:
@@ -169,6 +418,7 @@ interpret(const uint8_t returnOnNoThreads)
             case LIST_APPEND:
                 /* list_append will raise a TypeError if TOS1 is not a list */
                 retval = list_append(TOS1, TOS);
+                PM_BREAK_IF_ERROR(retval);
                 PM_SP -= 2;
                 continue;
 
@@ -199,6 +449,12 @@ interpret(const uint8_t returnOnNoThreads)
 
             case GET_ITER:
 #ifdef HAVE_GENERATORS
+                /* A generator is its own iterator */
+                if (OBJ_GET_TYPE(TOS) == OBJ_TYPE_GEN)
+                {
+                    continue;
+                }
+
                 /* Raise TypeError if TOS is an instance, but not iterable */
                 if (OBJ_GET_TYPE(TOS) == OBJ_TYPE_CLI)
                 {
@@ -212,8 +468,23 @@ interpret(const uint8_t returnOnNoThreads)
                 else
 #endif /* HAVE_GENERATORS */
                 {
+                    /* Copy an xrange; it is its own iterator */
+                    if (OBJ_GET_TYPE(TOS) == OBJ_TYPE_XRG)
+                    {
+                        retval = xrange_getIter(TOS, &pobj1);
+                    }
+
+                    /* A sequence-iterator (such as d.iteritems()) is its own */
+                    else if (OBJ_GET_TYPE(TOS) == OBJ_TYPE_SQI)
+                    {
+                        pobj1 = TOS;
+                    }
+
                     /* Convert sequence to sequence-iterator */
-                    retval = seqiter_new(TOS, &pobj1);
+                    else
+                    {
+                        retval = seqiter_new(TOS, &pobj1);
+                    }
                     PM_BREAK_IF_ERROR(retval);
 
                     /* Put sequence-iterator on top of stack */
@@ -284,7 +555,7 @@ interpret(const uint8_t returnOnNoThreads)
 
                 /* If it's a string replication operation */
                 else if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_INT)
-                         && (OBJ_GET_TYPE(TOS1) == OBJ_TYPE_STR))
+                         && STRING_IS_STRING(TOS1))
                 {
                     t16 = (int16_t)((pPmInt_t)TOS)->val;
                     if (t16 < 0)
@@ -292,6 +563,10 @@ interpret(const uint8_t returnOnNoThreads)
                         t16 = 0;
                     }
 
+                    /* Replication reads a null terminated string */
+                    retval = string_materialize(TOS1, &TOS1);
+                    PM_BREAK_IF_ERROR(retval);
+
                     pobj2 = TOS1;
                     pobj2 = (pPmObj_t)&((pPmString_t)pobj2)->val;
                     retval = string_replicate(
@@ -336,8 +611,31 @@ interpret(const uint8_t returnOnNoThreads)
 
 #ifdef HAVE_STRING_FORMAT
                 /* If it's a string, perform string format */
-                if (OBJ_GET_TYPE(TOS1) == OBJ_TYPE_STR)
+                if (STRING_IS_STRING(TOS1))
                 {
+                    /* Formatting reads null terminated strings */
+                    retval = string_materialize(TOS1, &TOS1);
+                    PM_BREAK_IF_ERROR(retval);
+                    if (OBJ_GET_TYPE(TOS) == OBJ_TYPE_SVW)
+                    {
+                        retval = string_materialize(TOS, &TOS);
+                    }
+                    else if (OBJ_GET_TYPE(TOS) == OBJ_TYPE_TUP)
+                    {
+                        /* An equal string may replace a view in the tuple */
+                        for (t16 = 0; t16 < ((pPmTuple_t)TOS)->length; t16++)
+                        {
+                            pobj1 = ((pPmTuple_t)TOS)->val[t16];
+                            if (OBJ_GET_TYPE(pobj1) == OBJ_TYPE_SVW)
+                            {
+                                retval = string_materialize(
+                                    pobj1, &((pPmTuple_t)TOS)->val[t16]);
+                                PM_BREAK_IF_ERROR(retval);
+                            }
+                        }
+                    }
+                    PM_BREAK_IF_ERROR(retval);
+
                     retval = string_format((pPmString_t)TOS1, TOS, &pobj3);
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
@@ -401,12 +699,9 @@ interpret(const uint8_t returnOnNoThreads)
                 }
 
                 /* #242: If both objs are strings, perform concatenation */
-                if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_STR)
-                    && (OBJ_GET_TYPE(TOS1) == OBJ_TYPE_STR))
+                if (STRING_IS_STRING(TOS) && STRING_IS_STRING(TOS1))
                 {
-                    retval = string_concat((pPmString_t)TOS1,
-                                           (pPmString_t)TOS,
-                                           &pobj3);
+                    retval = string_concat(TOS1, TOS, &pobj3);
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
@@ -466,17 +761,29 @@ interpret(const uint8_t returnOnNoThreads)
                     }
 
                     pobj1 = TOS1;
-#ifdef HAVE_BYTEARRAY
-                    /* If object is an instance, get the thing it contains */
-                    if (OBJ_GET_TYPE(pobj1) == OBJ_TYPE_CLI)
+
+                    /*
+                     * If object is a bytearray or array instance,
+                     * get the thing it contains
+                     */
+                    if ((OBJ_GET_TYPE(pobj1) == OBJ_TYPE_CLI)
+                        && (dict_getItem((pPmObj_t)((pPmInstance_t)pobj1)->cli_attrs,
+                                         PM_NONE,
+                                         &pobj2) == PM_RET_OK))
                     {
-                        retval = dict_getItem((pPmObj_t)((pPmInstance_t)pobj1)->cli_attrs,
-                                              PM_NONE,
-                                              &pobj2);
-                        PM_RETURN_IF_ERROR(retval);
-                        pobj1 = pobj2;
-                    }
+#ifdef HAVE_BYTEARRAY
+                        if (OBJ_GET_TYPE(pobj2) == OBJ_TYPE_BYA)
+                        {
+                            pobj1 = pobj2;
+                        }
 #endif /* HAVE_BYTEARRAY */
+#ifdef HAVE_ARRAY
+                        if (OBJ_GET_TYPE(pobj2) == OBJ_TYPE_BYS)
+                        {
+                            pobj1 = pobj2;
+                        }
+#endif /* HAVE_ARRAY */
+                    }
 
                     /* Ensure the index doesn't overflow */
                     C_ASSERT(((pPmInt_t)TOS)->val <= 0x0000FFFF);
@@ -514,10 +821,21 @@ interpret(const uint8_t returnOnNoThreads)
                     TOS = pobj2;
                 }
 
+#ifdef HAVE_BYTEARRAY
+                /* A bytearray's copy shares its bytes until either changes */
+                else if (OBJ_GET_TYPE(TOS) == OBJ_TYPE_CLI)
+                {
+                    retval = bytearray_slice(TOS, PM_ZERO, PM_NONE, &pobj2);
+                    PM_BREAK_IF_ERROR(retval);
+
+                    TOS = pobj2;
+                }
+#endif /* HAVE_BYTEARRAY */
+
                 /* If TOS is an immutable sequence leave it (no op) */
 
                 /* Raise a TypeError for types that can not be sliced */
-                else if ((OBJ_GET_TYPE(TOS) != OBJ_TYPE_STR)
+                else if (!STRING_IS_STRING(TOS)
                          && (OBJ_GET_TYPE(TOS) != OBJ_TYPE_TUP))
                 {
                     PM_RAISE(retval, PM_RET_EX_TYPE);
@@ -568,6 +886,7 @@ interpret(const uint8_t returnOnNoThreads)
                             continue;
 
                         case OBJ_TYPE_STR:
+                        case OBJ_TYPE_SVW:
                             retval = string_slice(pobj1, pstart, pend, pstride, &pobj2);
                             PM_BREAK_IF_ERROR(retval);
                             TOS = pobj2;
@@ -579,6 +898,15 @@ interpret(const uint8_t returnOnNoThreads)
                             TOS = pobj2;
                             continue;
 
+#ifdef HAVE_BYTEARRAY
+                        case OBJ_TYPE_CLI:
+                            /* Raises TypeError if it is not a bytearray */
+                            retval = bytearray_slice(pobj1, pstart, pend, &pobj2);
+                            PM_BREAK_IF_ERROR(retval);
+                            TOS = pobj2;
+                            continue;
+#endif /* HAVE_BYTEARRAY */
+
                         default:
                             PM_RAISE(retval, PM_RET_EX_TYPE);
                             break;
@@ -628,9 +956,13 @@ interpret(const uint8_t returnOnNoThreads)
                                           PM_NONE,
                                           &pobj2);
 
-                    /* Raise TypeError if instance isn't a ByteArray */
+                    /* Raise TypeError if instance isn't a ByteArray or array */
                     if ((retval == PM_RET_EX_KEY)
-                        || (OBJ_GET_TYPE(pobj2) != OBJ_TYPE_BYA))
+                        || ((OBJ_GET_TYPE(pobj2) != OBJ_TYPE_BYA)
+#ifdef HAVE_ARRAY
+                            && (OBJ_GET_TYPE(pobj2) != OBJ_TYPE_BYS)
+#endif /* HAVE_ARRAY */
+                           ))
                     {
                         PM_RAISE(retval, PM_RET_EX_TYPE);
                         break;
@@ -645,9 +977,20 @@ interpret(const uint8_t returnOnNoThreads)
                         break;
                     }
 
-                    retval = bytearray_setItem(pobj2,
+#ifdef HAVE_ARRAY
+                    if (OBJ_GET_TYPE(pobj2) == OBJ_TYPE_BYS)
+                    {
+                        retval = array_setItem(pobj2,
                                                (int16_t)(((pPmInt_t)TOS)->val),
                                                TOS2);
+                    }
+                    else
+#endif /* HAVE_ARRAY */
+                    {
+                        retval = bytearray_setItem(pobj2,
+                                                   (int16_t)(((pPmInt_t)TOS)->val),
+                                                   TOS2);
+                    }
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP -= 3;
                     continue;
@@ -735,6 +1078,28 @@ interpret(const uint8_t returnOnNoThreads)
                     continue;
                 }
 
+#ifdef HAVE_SET
+                /* If both objs are sets, intersect them */
+                if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_SET)
+                    && (OBJ_GET_TYPE(TOS1) == OBJ_TYPE_SET))
+                {
+                    /* An in-place op changes a set, but not a frozenset */
+                    if ((bc == INPLACE_AND) && !SET_IS_FROZEN(TOS1))
+                    {
+                        retval = set_intersectionUpdate(TOS1, TOS);
+                        pobj3 = TOS1;
+                    }
+                    else
+                    {
+                        retval = set_intersection(TOS1, TOS, &pobj3);
+                    }
+                    PM_BREAK_IF_ERROR(retval);
+                    PM_SP--;
+                    TOS = pobj3;
+                    continue;
+                }
+#endif /* HAVE_SET */
+
                 /* Otherwise raise a TypeError */
                 PM_RAISE(retval, PM_RET_EX_TYPE);
                 break;
@@ -771,6 +1136,28 @@ interpret(const uint8_t returnOnNoThreads)
                     continue;
                 }
 
+#ifdef HAVE_SET
+                /* If both objs are sets, unite them */
+                if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_SET)
+                    && (OBJ_GET_TYPE(TOS1) == OBJ_TYPE_SET))
+                {
+                    /* An in-place op changes a set, but not a frozenset */
+                    if ((bc == INPLACE_OR) && !SET_IS_FROZEN(TOS1))
+                    {
+                        retval = set_update(TOS1, TOS);
+                        pobj3 = TOS1;
+                    }
+                    else
+                    {
+                        retval = set_union(TOS1, TOS, &pobj3);
+                    }
+                    PM_BREAK_IF_ERROR(retval);
+                    PM_SP--;
+                    TOS = pobj3;
+                    continue;
+                }
+#endif /* HAVE_SET */
+
                 /* Otherwise raise a TypeError */
                 PM_RAISE(retval, PM_RET_EX_TYPE);
                 break;
@@ -883,7 +1270,27 @@ interpret(const uint8_t returnOnNoThreads)
                 /* If returning function was a generator */
                 if (((pPmFrame_t)pobj1)->fo_func->f_co->co_flags & CO_GENERATOR)
                 {
-                    /* Raise a StopIteration exception */
+                    /*
+                     * Back the expired frame up onto this RETURN_VALUE so that
+                     * resuming an exhausted generator raises StopIteration
+                     */
+                    ((pPmFrame_t)pobj1)->fo_ip--;
+
+                    /*
+                     * If the generator was resumed by FOR_ITER, end that loop
+                     * the same way FOR_ITER does for an exhausted sequence
+                     * (PM_IP is just past that FOR_ITER and its arg)
+                     */
+                    if (((pPmFrame_t)pobj1)->fo_isForIter)
+                    {
+                        pc = PM_IP - 2;
+                        t16 = mem_getWord(PM_FP->fo_memspace, &pc);
+                        PM_SP--;
+                        PM_IP += t16;
+                        continue;
+                    }
+
+                    /* Otherwise raise a StopIteration exception */
                     PM_RAISE(retval, PM_RET_EX_STOP);
                     break;
                 }
@@ -1068,6 +1475,21 @@ interpret(const uint8_t returnOnNoThreads)
                 t16 = GET_ARG();
 
 #ifdef HAVE_GENERATORS
+                /* If TOS is a generator, resume its frame directly */
+                if (OBJ_GET_TYPE(TOS) == OBJ_TYPE_GEN)
+                {
+                    pobj1 = (pPmObj_t)((pPmGenerator_t)TOS)->g_frame;
+
+                    /* The value of the yield expression is None */
+                    *(((pPmFrame_t)pobj1)->fo_sp)++ = PM_NONE;
+
+                    /* The yield (or return) comes back to this FOR_ITER */
+                    ((pPmFrame_t)pobj1)->fo_back = PM_FP;
+                    ((pPmFrame_t)pobj1)->fo_isForIter = 1;
+                    PM_FP = (pPmFrame_t)pobj1;
+                    continue;
+                }
+
                 /* If TOS is an instance, call next method */
                 if (OBJ_GET_TYPE(TOS) == OBJ_TYPE_CLI)
                 {
@@ -1086,6 +1508,13 @@ interpret(const uint8_t returnOnNoThreads)
                 }
                 else
 #endif /* HAVE_GENERATORS */
+
+                /* Compute the next int of an xrange */
+                if (OBJ_GET_TYPE(TOS) == OBJ_TYPE_XRG)
+                {
+                    retval = xrange_getNext(TOS, &pobj2);
+                }
+                else
                 {
                     /* Get the next item in the sequence iterator */
                     retval = seqiter_getNext(TOS, &pobj2);
@@ -1311,20 +1740,11 @@ interpret(const uint8_t returnOnNoThreads)
                 continue;
 
             case BUILD_LIST:
+                /* Build the list from the items on the stack in one pass */
                 t16 = GET_ARG();
-                retval = list_new(&pobj1);
-                PM_BREAK_IF_ERROR(retval);
-                for (; --t16 >= 0;)
-                {
-                    /* Insert obj into list */
-                    heap_gcPushTempRoot(pobj1, &objid);
-                    retval = list_insert(pobj1, 0, TOS);
-                    heap_gcPopTempRoot(objid);
-                    PM_BREAK_IF_ERROR(retval);
-                    PM_SP--;
-                }
-                /* Test again outside for loop */
+                retval = list_newFromArray(PM_SP - t16, t16, &pobj1);
                 PM_BREAK_IF_ERROR(retval);
+                PM_SP -= t16;
 
                 /* push list onto stack */
                 PM_PUSH(pobj1);
@@ -1370,6 +1790,17 @@ interpret(const uint8_t returnOnNoThreads)
                 }
 #endif /* HAVE_CLASSES */
 
+#ifdef HAVE_GENERATORS
+                /* A generator's methods are those of the Generator class */
+                else if (OBJ_GET_TYPE(TOS) == OBJ_TYPE_GEN)
+                {
+                    retval = dict_getItem(PM_PBUILTINS, PM_GENERATOR_STR,
+                                          &pobj1);
+                    PM_BREAK_IF_ERROR(retval);
+                    pobj1 = (pPmObj_t)((pPmClass_t)pobj1)->cl_attrs;
+                }
+#endif /* HAVE_GENERATORS */
+
                 /* Other types result in an AttributeError */
                 else
                 {
@@ -1412,8 +1843,11 @@ interpret(const uint8_t returnOnNoThreads)
 
 #ifdef HAVE_CLASSES
                 /* If obj is an instance and attr is a func, create method */
-                if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_CLI) &&
-                    (OBJ_GET_TYPE(pobj3) == OBJ_TYPE_FXN))
+                if (((OBJ_GET_TYPE(TOS) == OBJ_TYPE_CLI)
+#ifdef HAVE_GENERATORS
+                     || (OBJ_GET_TYPE(TOS) == OBJ_TYPE_GEN)
+#endif /* HAVE_GENERATORS */
+                    ) && (OBJ_GET_TYPE(pobj3) == OBJ_TYPE_FXN))
                 {
                     pobj2 = pobj3;
                     retval = class_method(TOS, pobj2, &pobj3);
@@ -1645,10 +2079,47 @@ interpret(const uint8_t returnOnNoThreads)
                 /* Get target offset (bytes) */
                 t16 = GET_ARG();
 
+#if defined(HAVE_BUDGET_SCHED) || defined(HAVE_JIT)
+                /* A backward jump spends from the budget and runs the JIT */
+                if ((PM_FP->fo_func->f_co->co_codeaddr + t16) < PM_IP)
+                {
+                    PM_IP = PM_FP->fo_func->f_co->co_codeaddr + t16;
+                    INTERP_SPEND_BUDGET();
+                    INTERP_RUN_JIT();
+                    continue;
+                }
+#endif /* HAVE_BUDGET_SCHED || HAVE_JIT */
+
                 /* Jump to base_ip + arg */
                 PM_IP = PM_FP->fo_func->f_co->co_codeaddr + t16;
                 continue;
 
+            case POP_JUMP_IF_FALSE:
+            case POP_JUMP_IF_TRUE:
+                /* Get target offset (bytes) and pop the condition */
+                t16 = GET_ARG();
+                pobj1 = PM_POP();
+
+                /* Fall through if the condition does not select the jump */
+                if ((bc == POP_JUMP_IF_FALSE) != obj_isFalse(pobj1))
+                {
+                    continue;
+                }
+
+#if defined(HAVE_BUDGET_SCHED) || defined(HAVE_JIT)
+                /* A backward jump spends from the budget and runs the JIT */
+                if ((PM_FP->fo_func->f_co->co_codeaddr + t16) < PM_IP)
+                {
+                    PM_IP = PM_FP->fo_func->f_co->co_codeaddr + t16;
+                    INTERP_SPEND_BUDGET();
+                    INTERP_RUN_JIT();
+                    continue;
+                }
+#endif /* HAVE_BUDGET_SCHED || HAVE_JIT */
+
+                PM_IP = PM_FP->fo_func->f_co->co_codeaddr + t16;
+                continue;
+
             case LOAD_GLOBAL:
                 /* Get name */
                 t16 = GET_ARG();
@@ -1781,57 +2252,6 @@ interpret(const uint8_t returnOnNoThreads)
                     "interpret(), CALL_FUNCTION on <obj type=%d @ %p>\n",
                     OBJ_GET_TYPE(pobj1), pobj1);
 
-#ifdef HAVE_GENERATORS
-                /* If the callable is a generator function (can't be native) */
-                if ((OBJ_GET_TYPE(pobj1) == OBJ_TYPE_FXN)
-                    && (OBJ_GET_TYPE(((pPmFunc_t)pobj1)->f_co) == OBJ_TYPE_COB)
-                    && (((pPmFunc_t)pobj1)->f_co->co_flags & CO_GENERATOR))
-                {
-#ifdef HAVE_DEFAULTARGS
-                    /* Num required args := argcount - num default args */
-                    t8 = ((pPmFunc_t)pobj1)->f_co->co_argcount;
-                    if (((pPmFunc_t)pobj1)->f_defaultargs != C_NULL)
-                    {
-                        t8 -= ((pPmTuple_t)((pPmFunc_t)pobj1)->f_defaultargs)->
-                            length;
-                    }
-
-                    /*
-                     * Raise a TypeError if num args passed
-                     * is more than allowed or less than required
-                     */
-                    if (((t16 & ((uint8_t)0xFF))
-                         > ((pPmFunc_t)pobj1)->f_co->co_argcount)
-                        || ((t16 & ((uint8_t)0xFF)) < t8))
-#else
-                    if ((t16 & ((uint8_t)0xFF)) !=
-                        ((pPmFunc_t)pobj1)->f_co->co_argcount)
-#endif /* HAVE_DEFAULTARGS */
-                    {
-                        PM_RAISE(retval, PM_RET_EX_TYPE);
-                        break;
-                    }
-
-                    /* Collect the function and arguments into a tuple */
-                    retval = tuple_new(t16 + 1, &pobj2);
-                    heap_gcPushTempRoot(pobj2, &objid2);
-                    PM_GOTO_IF_ERROR(retval, CALL_FUNC_CLEANUP);
-                    sli_memcpy((uint8_t *)&((pPmTuple_t)pobj2)->val,
-                               (uint8_t *)&STACK(t16),
-                               (t16 + 1) * sizeof(pPmObj_t));
-
-                    /* Remove old args, push func/args tuple as one arg */
-                    PM_SP -= t16;
-                    PM_PUSH(pobj2);
-                    t16 = 1;
-
-                    /* Set pobj1 and stack to create an instance of Generator */
-                    retval = dict_getItem(PM_PBUILTINS, PM_GENERATOR_STR,
-                                          &pobj1);
-                    C_ASSERT(retval == PM_RET_OK);
-                    STACK(t16) = pobj1;
-                }
-#endif /* HAVE_GENERATORS */
 
 #ifdef HAVE_CLASSES
                 /* If the callable is a class, create an instance of it */
@@ -2026,6 +2446,27 @@ CALL_FUNC_FOR_ITER:
                     /* Pop func obj */
                     pobj3 = PM_POP();
 
+#ifdef HAVE_GENERATORS
+                    /* #207: Calling a generator func returns a generator */
+                    if (((pPmFunc_t)pobj1)->f_co->co_flags & CO_GENERATOR)
+                    {
+#ifdef HAVE_CLASSES
+                        /* Raise TypeError if __init__ is a generator */
+                        if (((pPmFrame_t)pobj2)->fo_isInit)
+                        {
+                            PM_RAISE(retval, PM_RET_EX_TYPE);
+                            goto CALL_FUNC_CLEANUP;
+                        }
+#endif /* HAVE_CLASSES */
+
+                        /* The frame runs when the generator is resumed */
+                        retval = frame_newGen(pobj2, &pobj3);
+                        PM_GOTO_IF_ERROR(retval, CALL_FUNC_CLEANUP);
+                        PM_PUSH(pobj3);
+                        goto CALL_FUNC_CLEANUP;
+                    }
+#endif /* HAVE_GENERATORS */
+
                     /* Keep ref to current frame */
                     ((pPmFrame_t)pobj2)->fo_back = PM_FP;
 
@@ -2037,21 +2478,56 @@ CALL_FUNC_FOR_ITER:
                 else if (OBJ_GET_TYPE(((pPmFunc_t)pobj1)->f_co) ==
                          OBJ_TYPE_NOB)
                 {
-                    /* Set number of locals (arguments) */
+                    pobj2 = (pPmObj_t)((pPmFunc_t)pobj1)->f_co;
+
+                    /* Pass string views as strings unless the native takes views */
+                    if (!(((pPmNo_t)pobj2)->no_flags & NO_FLAG_STRVIEWS))
+                    {
+                        int16_t i;
+
+                        for (i = 0; i < t16; i++)
+                        {
+                            if (OBJ_GET_TYPE(STACK(i)) == OBJ_TYPE_SVW)
+                            {
+                                retval = string_materialize(STACK(i),
+                                                            &STACK(i));
+                                PM_GOTO_IF_ERROR(retval, CALL_FUNC_CLEANUP);
+                            }
+                        }
+                    }
+
+                    /* Set number of locals (arguments) and calling flags */
                     gVmGlobal.nativeframe.nf_numlocals = (uint8_t)t16;
+                    gVmGlobal.nativeframe.nf_flags = ((pPmNo_t)pobj2)->no_flags;
+
+                    /* Args are read in place from the caller's stack */
+                    if (((pPmNo_t)pobj2)->no_flags & NO_FLAG_STACKARGS)
+                    {
+                        gVmGlobal.nativeframe.nf_argv = PM_SP - t16;
+                        PM_SP -= t16;
+                    }
 
                     /* Pop args from stack */
-                    while (--t16 >= 0)
+                    else
                     {
-                        gVmGlobal.nativeframe.nf_locals[t16] = PM_POP();
+                        gVmGlobal.nativeframe.nf_argv =
+                            (pPmObj_t *)gVmGlobal.nativeframe.nf_locals;
+                        while (--t16 >= 0)
+                        {
+                            gVmGlobal.nativeframe.nf_locals[t16] = PM_POP();
+                        }
                     }
 
                     /* Set flag, so the GC knows a native session is active */
                     gVmGlobal.nativeframe.nf_active = C_TRUE;
 
 #ifdef HAVE_GC
-                    /* If the heap is low on memory, run the GC */
-                    if (heap_getAvail() < HEAP_GC_NF_THRESHOLD)
+                    /*
+                     * If the heap is low on memory, run the GC
+                     * (unless the native has declared it never allocates)
+                     */
+                    if (!(((pPmNo_t)pobj2)->no_flags & NO_FLAG_NOALLOC)
+                        && (heap_getAvail() < HEAP_GC_NF_THRESHOLD))
                     {
                         retval = heap_gcRun();
                         PM_GOTO_IF_ERROR(retval, CALL_FUNC_CLEANUP);
@@ -2062,7 +2538,6 @@ CALL_FUNC_FOR_ITER:
                     PM_SP--;
 
                     /* Get native function index */
-                    pobj2 = (pPmObj_t)((pPmFunc_t)pobj1)->f_co;
                     t16 = ((pPmNo_t)pobj2)->no_funcindx;
 
                     /*
@@ -2117,6 +2592,7 @@ CALL_FUNC_FOR_ITER:
 CALL_FUNC_CLEANUP:
                 heap_gcPopTempRoot(objid);
                 PM_BREAK_IF_ERROR(retval);
+                INTERP_SPEND_BUDGET();
                 continue;
 
             case MAKE_FUNCTION:
@@ -2264,13 +2740,13 @@ CALL_FUNC_CLEANUP:
         PM_REPORT_IF_ERROR(retval);
 
         /* If this is the last thread, return the error code */
-        if ((gVmGlobal.threadList->length <= 1) && (retval != PM_RET_OK))
+        if ((gVmGlobal.threadCount <= 1) && (gVmGlobal.threadSleep == C_NULL)
+            && (retval != PM_RET_OK))
         {
             break;
         }
 
-        retval = list_remove((pPmObj_t)gVmGlobal.threadList,
-                             (pPmObj_t)gVmGlobal.pthread);
+        retval = thread_dequeue(gVmGlobal.pthread);
         gVmGlobal.pthread = C_NULL;
         PM_BREAK_IF_ERROR(retval);
 
@@ -2286,27 +2762,23 @@ PmReturn_t
 interp_reschedule(void)
 {
     PmReturn_t retval = PM_RET_OK;
-    static uint8_t threadIndex = (uint8_t)0;
-    pPmObj_t pobj;
 
-    /* If there are no threads in the runnable list, null the active thread */
-    if (gVmGlobal.threadList->length == 0)
-    {
-        gVmGlobal.pthread = C_NULL;
-    }
+#ifdef HAVE_PROFILER
+    /* Keep the sample ring from filling up */
+    prof_drain();
+#endif /* HAVE_PROFILER */
 
-    /* Otherwise, get the next thread in the list (round robin) */
-    else
-    {
-        if (++threadIndex >= gVmGlobal.threadList->length)
-        {
-            threadIndex = (uint8_t)0;
-        }
-        retval = list_getItem((pPmObj_t)gVmGlobal.threadList, threadIndex,
-                              &pobj);
-        gVmGlobal.pthread = (pPmThread_t)pobj;
-        PM_RETURN_IF_ERROR(retval);
-    }
+    /* Make the threads that are done sleeping ready */
+    retval = thread_wakeUp();
+    PM_RETURN_IF_ERROR(retval);
+
+    /* Get the next ready thread; C_NULL if no thread is ready */
+    gVmGlobal.pthread = thread_getNext();
+
+#ifdef HAVE_BUDGET_SCHED
+    /* The thread starts its timeslice with the whole budget */
+    gVmGlobal.budgetLeft = gVmGlobal.budget;
+#endif /* HAVE_BUDGET_SCHED */
 
     /* Clear flag to indicate a reschedule has occurred */
     interp_setRescheduleFlag(0);
@@ -2316,35 +2788,212 @@ interp_reschedule(void)
 
 PmReturn_t
 interp_addThread(pPmFunc_t pfunc)
+{
+    return interp_addThreadAtPriority(pfunc, PM_THREAD_PRIORITY_DEFAULT, 0);
+}
+
+
+PmReturn_t
+interp_addThreadAtPriority(pPmFunc_t pfunc, uint8_t priority, uint32_t delay)
 {
     PmReturn_t retval;
     pPmObj_t pframe;
     pPmObj_t pthread;
-    uint8_t objid1, objid2;
+    uint8_t objid;
+
+    C_ASSERT(priority < PM_THREAD_NUM_PRIORITIES);
 
     /* Create a frame for the func */
     retval = frame_new((pPmObj_t)pfunc, &pframe);
     PM_RETURN_IF_ERROR(retval);
 
     /* Create a thread with this new frame */
-    heap_gcPushTempRoot(pframe, &objid1);
+    heap_gcPushTempRoot(pframe, &objid);
     retval = thread_new(pframe, &pthread);
-    if (retval != PM_RET_OK)
+    heap_gcPopTempRoot(objid);
+    PM_RETURN_IF_ERROR(retval);
+
+    /*
+     * Add thread to the end of its ready queue, or let it sleep through
+     * the delay; either makes it a GC root
+     */
+    ((pPmThread_t)pthread)->priority = priority;
+    if (delay != 0)
+    {
+        return thread_sleep((pPmThread_t)pthread, delay);
+    }
+    return thread_enqueue((pPmThread_t)pthread);
+}
+
+
+void
+interp_setRescheduleFlag(uint8_t boolean)
+{
+    gVmGlobal.reschedule = boolean;
+}
+
+
+#ifdef HAVE_OPSTATS
+/*
+ * Fills order with the executed bytecodes sorted by descending cycles.
+ * Returns the number of executed bytecodes.
+ */
+static uint16_t
+interp_sortOpStats(uint8_t *order)
+{
+    uint16_t n = 0;
+    uint16_t i;
+    uint16_t j;
+
+    /* Insertion sort; there are at most 256 entries */
+    for (i = 0; i < 256; i++)
+    {
+        if (opstatsCount[i] == 0)
+        {
+            continue;
+        }
+        for (j = n; (j > 0) && (opstatsCycles[order[j - 1]] < opstatsCycles[i]);
+             j--)
+        {
+            order[j] = order[j - 1];
+        }
+        order[j] = (uint8_t)i;
+        n++;
+    }
+    return n;
+}
+
+
+/* Prints the unsigned value right-aligned in a field of the given width */
+static void
+interp_printOpStatsNum(uint64_t val, uint8_t width)
+{
+    uint8_t buf[21];
+    uint8_t i = sizeof(buf) - 1;
+
+    buf[i] = '\0';
+    do
+    {
+        buf[--i] = (uint8_t)('0' + (val % 10));
+        val /= 10;
+    }
+    while ((val != 0) && (i > 0));
+
+    while (width-- > (uint8_t)(sizeof(buf) - 1 - i))
     {
-        heap_gcPopTempRoot(objid1);
-        return retval;
+        plat_putByte(' ');
     }
+    sli_puts(&buf[i]);
+}
+
+
+PmReturn_t
+interp_getOpStats(pPmObj_t *r_pstats)
+{
+    PmReturn_t retval;
+    pPmObj_t plist;
+    pPmObj_t ptup;
+    pPmObj_t pint;
+    uint8_t order[256];
+    uint16_t n;
+    uint16_t i;
+    uint8_t objid1;
+    uint8_t objid2;
+
+    retval = tuple_new(2, r_pstats);
+    PM_RETURN_IF_ERROR(retval);
+    heap_gcPushTempRoot(*r_pstats, &objid1);
+
+    retval = int_new((int32_t)(opstatsReschedules & 0x7FFFFFFF), &pint);
+    PM_GOTO_IF_ERROR(retval, GET_OPSTATS_CLEANUP);
+    ((pPmTuple_t)*r_pstats)->val[0] = pint;
 
-    /* Add thread to end of list */
-    heap_gcPushTempRoot(pthread, &objid2);
-    retval = list_append((pPmObj_t)gVmGlobal.threadList, pthread);
+    retval = list_new(&plist);
+    PM_GOTO_IF_ERROR(retval, GET_OPSTATS_CLEANUP);
+    ((pPmTuple_t)*r_pstats)->val[1] = plist;
+
+    /* Append (bytecode, count, cycles) for each executed bytecode */
+    n = interp_sortOpStats(order);
+    for (i = 0; i < n; i++)
+    {
+        retval = tuple_new(3, &ptup);
+        PM_GOTO_IF_ERROR(retval, GET_OPSTATS_CLEANUP);
+        heap_gcPushTempRoot(ptup, &objid2);
+        retval = list_append(plist, ptup);
+        heap_gcPopTempRoot(objid2);
+        PM_GOTO_IF_ERROR(retval, GET_OPSTATS_CLEANUP);
+
+        retval = int_new(order[i], &pint);
+        PM_GOTO_IF_ERROR(retval, GET_OPSTATS_CLEANUP);
+        ((pPmTuple_t)ptup)->val[0] = pint;
+
+        /* Python ints are 32 bits; saturate rather than wrap */
+        retval = int_new((opstatsCount[order[i]] > 0x7FFFFFFF)
+                         ? 0x7FFFFFFF : (int32_t)opstatsCount[order[i]],
+                         &pint);
+        PM_GOTO_IF_ERROR(retval, GET_OPSTATS_CLEANUP);
+        ((pPmTuple_t)ptup)->val[1] = pint;
+
+        retval = int_new((opstatsCycles[order[i]] > 0x7FFFFFFF)
+                         ? 0x7FFFFFFF : (int32_t)opstatsCycles[order[i]],
+                         &pint);
+        PM_GOTO_IF_ERROR(retval, GET_OPSTATS_CLEANUP);
+        ((pPmTuple_t)ptup)->val[2] = pint;
+    }
+
+GET_OPSTATS_CLEANUP:
     heap_gcPopTempRoot(objid1);
     return retval;
 }
 
 
 void
-interp_setRescheduleFlag(uint8_t boolean)
+interp_clearOpStats(void)
 {
-    gVmGlobal.reschedule = boolean;
+    sli_memset((uint8_t *)opstatsCount, 0, sizeof(opstatsCount));
+    sli_memset((uint8_t *)opstatsCycles, 0, sizeof(opstatsCycles));
+    opstatsReschedules = 0;
+}
+
+
+void
+interp_printOpStats(void)
+{
+    uint8_t order[256];
+    uint8_t buf[5];
+    uint16_t n;
+    uint16_t i;
+    uint8_t len;
+    uint8_t const *pname;
+
+    n = interp_sortOpStats(order);
+
+    sli_puts((uint8_t *)"\nbytecode                    count           cycles\n");
+    for (i = 0; i < n; i++)
+    {
+        /* Print the bytecode's name, or its number if it has none */
+        pname = (order[i] <= EXTENDED_ARG)
+                ? (uint8_t const *)opstatsNames[order[i]] : C_NULL;
+        if (pname == C_NULL)
+        {
+            buf[0] = '0';
+            buf[1] = 'x';
+            sli_btoa16(order[i], &buf[2], sizeof(buf) - 2, C_TRUE);
+            pname = buf;
+        }
+        sli_puts((uint8_t *)pname);
+        for (len = (uint8_t)sli_strlen((char const *)pname); len < 20; len++)
+        {
+            plat_putByte(' ');
+        }
+
+        interp_printOpStatsNum(opstatsCount[order[i]], 13);
+        interp_printOpStatsNum(opstatsCycles[order[i]], 17);
+        plat_putByte('\n');
+    }
+
+    sli_puts((uint8_t *)"reschedules: ");
+    interp_printOpStatsNum(opstatsReschedules, 0);
+    plat_putByte('\n');
 }
+#endif /* HAVE_OPSTATS */
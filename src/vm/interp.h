@@ -24,6 +24,13 @@
 #define INTERP_LOOP_FOREVER          0
 #define INTERP_RETURN_ON_NO_THREADS  1
 
+#ifdef HAVE_BUDGET_SCHED
+/** Default number of backward jumps and calls in a thread's timeslice */
+#ifndef PM_THREAD_BUDGET
+#define PM_THREAD_BUDGET 1000
+#endif
+#endif /* HAVE_BUDGET_SCHED */
+
 
 /** Frame pointer ; currently for single thread */
 #define PM_FP (gVmGlobal.pthread->pframe)
@@ -46,14 +53,30 @@
 #define PM_POP()        (*(--PM_SP))
 /** pushes an obj on the stack */
 #define PM_PUSH(pobj)   (*(PM_SP++) = (pobj))
-/** gets the argument (S16) from the instruction stream */
-#define GET_ARG()       mem_getWord(PM_FP->fo_memspace, &PM_IP)
+/** true if the current frame's bytecode can be read through PM_IP */
+#if PM_PLAT_PROGMEM_DIRECT
+#define IP_IS_DIRECT()  ((PM_FP->fo_memspace == MEMSPACE_RAM) \
+                         || (PM_FP->fo_memspace == MEMSPACE_PROG))
+#else
+#define IP_IS_DIRECT()  (PM_FP->fo_memspace == MEMSPACE_RAM)
+#endif /* PM_PLAT_PROGMEM_DIRECT */
+/** gets the bytecode (U8) from the instruction stream */
+#define GET_BCODE()     (IP_IS_DIRECT() \
+                         ? *(PM_IP++) \
+                         : mem_getByte(PM_FP->fo_memspace, &PM_IP))
+/** gets the argument (S16) from the instruction stream (little endian) */
+#define GET_ARG()       (IP_IS_DIRECT() \
+                         ? (PM_IP += 2, \
+                            (uint16_t)(PM_IP[-2] | (PM_IP[-1] << 8))) \
+                         : mem_getWord(PM_FP->fo_memspace, &PM_IP))
 
 /** pushes an obj in the only stack slot of the native frame */
 #define NATIVE_SET_TOS(pobj) (gVmGlobal.nativeframe.nf_stack = \
                         (pobj))
 /** gets the nth local var from the native frame locals */
-#define NATIVE_GET_LOCAL(n) (gVmGlobal.nativeframe.nf_locals[n])
+#define NATIVE_GET_LOCAL(n) (gVmGlobal.nativeframe.nf_argv[n])
+/** gets a pointer to the array of args passed to the native fxn */
+#define NATIVE_GET_ARGV()   (gVmGlobal.nativeframe.nf_argv)
 /** gets a pointer to the frame that called this native fxn */
 #define NATIVE_GET_PFRAME()   (*ppframe)
 /** gets the number of args passed to the native fxn */
@@ -213,8 +236,8 @@ typedef enum PmBcode_e
     JUMP_IF_FALSE,
     JUMP_IF_TRUE,               /* 0x70 */
     JUMP_ABSOLUTE,
-    UNUSED_72,
-    UNUSED_73,
+    POP_JUMP_IF_FALSE,          /* PyMite only, emitted by pmImgCreator */
+    POP_JUMP_IF_TRUE,
     LOAD_GLOBAL,
     UNUSED_75,
     UNUSED_76,
@@ -288,8 +311,9 @@ PmReturn_t interpret(const uint8_t returnOnNoThreads);
 /**
  * Selects a thread to run and changes the VM internal variables to
  * let the switch-loop execute the chosen one in the next iteration.
- * For the moment the algorithm is primitive and will change the
- * thread each time it is called in a round-robin fashion.
+ * Runs the highest priority ready thread; threads of equal priority
+ * take turns in a round-robin fashion (see thread_getNext()).
+ * With HAVE_BUDGET_SCHED, the chosen thread gets the whole budget.
  */
 PmReturn_t interp_reschedule(void);
 
@@ -305,6 +329,18 @@ PmReturn_t interp_reschedule(void);
  */
 PmReturn_t interp_addThread(pPmFunc_t pfunc);
 
+/**
+ * Like interp_addThread(), but the new thread runs at the given priority
+ * instead of PM_THREAD_PRIORITY_DEFAULT, and only after the given delay.
+ *
+ * @param pfunc Ptr to function to be executed as a thread.
+ * @param priority Priority less than PM_THREAD_NUM_PRIORITIES.
+ * @param delay Milliseconds the thread sleeps before it first runs.
+ * @return Return status
+ */
+PmReturn_t interp_addThreadAtPriority(pPmFunc_t pfunc, uint8_t priority,
+                                      uint32_t delay);
+
 /**
  * Sets the  reschedule flag.
  *
@@ -313,4 +349,22 @@ PmReturn_t interp_addThread(pPmFunc_t pfunc);
  */
 void interp_setRescheduleFlag(uint8_t boolean);
 
+#ifdef HAVE_OPSTATS
+/**
+ * Creates the tuple (reschedules, [(bytecode, count, cycles), ...])
+ * from the bytecode statistics gathered by interpret().
+ * The list is sorted by descending cycles; values saturate at 0x7FFFFFFF.
+ *
+ * @param r_pstats Return by reference; the new stats tuple
+ * @return Return status
+ */
+PmReturn_t interp_getOpStats(pPmObj_t *r_pstats);
+
+/** Resets the bytecode statistics gathered by interpret() */
+void interp_clearOpStats(void);
+
+/** Prints the bytecode statistics as a table sorted by descending cycles */
+void interp_printOpStats(void);
+#endif /* HAVE_OPSTATS */
+
 #endif /* __INTERP_H__ */
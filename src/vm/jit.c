@@ -0,0 +1,940 @@
+/*
+# This file is Copyright 2013 Dean Hall.
+# This file is part of the PyMite VM.
+# This file is licensed under the MIT License.
+# See the LICENSE file for details.
+*/
+
+
+#undef __FILE_ID__
+#define __FILE_ID__ 0x1D
+
+
+/**
+ * \file
+ * \brief Template JIT
+ *
+ * x86-64 templates for the bytecodes and the compiler that stitches them.
+ */
+
+
+#include <stddef.h>
+
+#include "pm.h"
+
+
+#ifdef HAVE_JIT
+
+/* Flags in the high bits of jc_offs entries */
+#define JIT_OFFS_MASK   0x00FFFFFFUL
+#define JIT_OFFS_EXIT   0x40000000UL  /**< Code returns to the interpreter */
+#define JIT_OFFS_TARGET 0x80000000UL  /**< Instruction is a jump target */
+
+/** co_jitcount of a code object that is never compiled */
+#define JIT_NEVER 0xFFFF
+
+/** Compiled code of a CO, called at its entry stub */
+typedef PmReturn_t (*pPmJitFunc_t)(pPmFrame_t pframe, uint8_t const *pentry);
+
+/** State of one pass of jit_emitCo() */
+typedef struct PmJitEmit_s
+{
+    /** Start of the code in the arena; C_NULL while sizing the code */
+    uint8_t *pcode;
+
+    /** Offset of the next byte of the instructions' code */
+    uint32_t pos;
+
+    /** Offset of the next byte of the stubs that follow the code */
+    uint32_t stubpos;
+
+    /** Offset of the common exit */
+    uint32_t exitpos;
+
+    /** The CO's table of offsets (see PmJitCode_t) */
+    uint32_t *offs;
+} PmJitEmit_t,
+ *pPmJitEmit_t;
+
+
+/** The executable arena and the bytes of it used by compiled code */
+static PM_PLAT_TLS uint8_t *jitArena = C_NULL;
+static PM_PLAT_TLS uint32_t jitUsed = 0;
+
+
+/*
+ * Templates
+ *
+ * Compiled code keeps the frame in rbx, the frame's stack pointer in r12
+ * and the CO's bytecode address in r15; [rsp] is a scratch slot in which
+ * helper functions return an object.  A template that calls a helper
+ * stores r12 in fo_sp first, so a GC sees the whole stack.
+ * Code returns to the interpreter through the common exit with eax
+ * holding the return status and rcx the new instruction pointer.
+ * Zeros are holes for the operands, displacements and jump targets that
+ * are patched in at the offset given in the comment.
+ */
+
+/* Entry stub: jitEntry(pframe, pentry) jumps to the code at pentry */
+static uint8_t const jitEntry[] =
+{
+    0x53,                               /* push rbx */
+    0x41, 0x54,                         /* push r12 */
+    0x41, 0x57,                         /* push r15 */
+    0x48, 0x83, 0xEC, 0x10,             /* sub rsp, 16 */
+    0x48, 0x89, 0xFB,                   /* mov rbx, rdi */
+    0x4C, 0x8B, 0xA3, 0, 0, 0, 0,       /* mov r12, [rbx + fo_sp] @15 */
+    0x49, 0xBF, 0, 0, 0, 0, 0, 0, 0, 0, /* mov r15, co_codeaddr @21 */
+    0xFF, 0xE6,                         /* jmp rsi */
+};
+
+/* Common exit */
+static uint8_t const jitExit[] =
+{
+    0x48, 0x89, 0x8B, 0, 0, 0, 0,       /* mov [rbx + fo_ip], rcx @3 */
+    0x4C, 0x89, 0xA3, 0, 0, 0, 0,       /* mov [rbx + fo_sp], r12 @10 */
+    0x48, 0x83, 0xC4, 0x10,             /* add rsp, 16 */
+    0x41, 0x5F,                         /* pop r15 */
+    0x41, 0x5C,                         /* pop r12 */
+    0x5B,                               /* pop rbx */
+    0xC3,                               /* ret */
+};
+
+/* Returns PM_RET_OK; precedes jitExitAt */
+static uint8_t const jitExitOk[] =
+{
+    0x31, 0xC0,                         /* xor eax, eax */
+};
+
+/* Returns eax to the interpreter at a bytecode offset */
+static uint8_t const jitExitAt[] =
+{
+    0x49, 0x8D, 0x8F, 0, 0, 0, 0,       /* lea rcx, [r15 + offset] @3 */
+    0xE9, 0, 0, 0, 0,                   /* jmp exit @8 */
+};
+
+/* Jumps to an instruction */
+static uint8_t const jitJump[] =
+{
+    0xE9, 0, 0, 0, 0,                   /* jmp target @1 */
+};
+
+#ifdef HAVE_BUDGET_SCHED
+/* Spends one unit of the budget; precedes jitCheckReschedule */
+static uint8_t const jitSpendBudget[] =
+{
+    0x48, 0xB8, 0, 0, 0, 0, 0, 0, 0, 0, /* mov rax, &budgetLeft @2 */
+    0x66, 0xFF, 0x08,                   /* dec word [rax] */
+    0x0F, 0x84, 0, 0, 0, 0,             /* je exit at target @15 */
+};
+#endif /* HAVE_BUDGET_SCHED */
+
+/* Backward jump: returns to the interpreter if it must reschedule */
+static uint8_t const jitCheckReschedule[] =
+{
+    0x48, 0xB8, 0, 0, 0, 0, 0, 0, 0, 0, /* mov rax, &reschedule @2 */
+    0x80, 0x38, 0x00,                   /* cmp byte [rax], 0 */
+    0x0F, 0x85, 0, 0, 0, 0,             /* jne exit at target @15 */
+    0xE9, 0, 0, 0, 0,                   /* jmp target @20 */
+};
+
+/* LOAD_FAST */
+static uint8_t const jitLoadFast[] =
+{
+    0x48, 0x8B, 0x83, 0, 0, 0, 0,       /* mov rax, [rbx + local] @3 */
+    0x49, 0x89, 0x04, 0x24,             /* mov [r12], rax */
+    0x49, 0x83, 0xC4, 0x08,             /* add r12, 8 */
+};
+
+/* STORE_FAST */
+static uint8_t const jitStoreFast[] =
+{
+    0x49, 0x83, 0xEC, 0x08,             /* sub r12, 8 */
+    0x49, 0x8B, 0x04, 0x24,             /* mov rax, [r12] */
+    0x48, 0x89, 0x83, 0, 0, 0, 0,       /* mov [rbx + local], rax @11 */
+};
+
+/* LOAD_CONST */
+static uint8_t const jitLoadConst[] =
+{
+    0x48, 0xB8, 0, 0, 0, 0, 0, 0, 0, 0, /* mov rax, const @2 */
+    0x49, 0x89, 0x04, 0x24,             /* mov [r12], rax */
+    0x49, 0x83, 0xC4, 0x08,             /* add r12, 8 */
+};
+
+/* POP_TOP */
+static uint8_t const jitPopTop[] =
+{
+    0x49, 0x83, 0xEC, 0x08,             /* sub r12, 8 */
+};
+
+/* ROT_TWO */
+static uint8_t const jitRotTwo[] =
+{
+    0x49, 0x8B, 0x44, 0x24, 0xF8,       /* mov rax, [r12 - 8] */
+    0x49, 0x8B, 0x4C, 0x24, 0xF0,       /* mov rcx, [r12 - 16] */
+    0x49, 0x89, 0x4C, 0x24, 0xF8,       /* mov [r12 - 8], rcx */
+    0x49, 0x89, 0x44, 0x24, 0xF0,       /* mov [r12 - 16], rax */
+};
+
+/* ROT_THREE */
+static uint8_t const jitRotThree[] =
+{
+    0x49, 0x8B, 0x44, 0x24, 0xF8,       /* mov rax, [r12 - 8] */
+    0x49, 0x8B, 0x4C, 0x24, 0xF0,       /* mov rcx, [r12 - 16] */
+    0x49, 0x8B, 0x54, 0x24, 0xE8,       /* mov rdx, [r12 - 24] */
+    0x49, 0x89, 0x4C, 0x24, 0xF8,       /* mov [r12 - 8], rcx */
+    0x49, 0x89, 0x54, 0x24, 0xF0,       /* mov [r12 - 16], rdx */
+    0x49, 0x89, 0x44, 0x24, 0xE8,       /* mov [r12 - 24], rax */
+};
+
+/* DUP_TOP */
+static uint8_t const jitDupTop[] =
+{
+    0x49, 0x8B, 0x44, 0x24, 0xF8,       /* mov rax, [r12 - 8] */
+    0x49, 0x89, 0x04, 0x24,             /* mov [r12], rax */
+    0x49, 0x83, 0xC4, 0x08,             /* add r12, 8 */
+};
+
+/* Int binary op: checks TOS1 and TOS are ints and loads TOS1's value */
+static uint8_t const jitIntGuard[] =
+{
+    0x49, 0x8B, 0x7C, 0x24, 0xF0,       /* mov rdi, [r12 - 16] */
+    0x49, 0x8B, 0x74, 0x24, 0xF8,       /* mov rsi, [r12 - 8] */
+    0x0F, 0xB7, 0x07,                   /* movzx eax, word [rdi] */
+    0xC1, 0xE8, OD_TYPE_SHIFT,          /* shr eax, OD_TYPE_SHIFT */
+    0x83, 0xF8, OBJ_TYPE_INT,           /* cmp eax, OBJ_TYPE_INT */
+    0x0F, 0x85, 0, 0, 0, 0,             /* jne guard @21 */
+    0x0F, 0xB7, 0x06,                   /* movzx eax, word [rsi] */
+    0xC1, 0xE8, OD_TYPE_SHIFT,          /* shr eax, OD_TYPE_SHIFT */
+    0x83, 0xF8, OBJ_TYPE_INT,           /* cmp eax, OBJ_TYPE_INT */
+    0x0F, 0x85, 0, 0, 0, 0,             /* jne guard @36 */
+    0x8B, 0xBF, 0, 0, 0, 0,             /* mov edi, [rdi + val] @42 */
+};
+
+/* Int binary ops on edi and TOS's value; each ends in the val @-4 */
+static uint8_t const jitIntAdd[] =
+{
+    0x03, 0xBE, 0, 0, 0, 0,             /* add edi, [rsi + val] */
+};
+static uint8_t const jitIntSub[] =
+{
+    0x2B, 0xBE, 0, 0, 0, 0,             /* sub edi, [rsi + val] */
+};
+static uint8_t const jitIntMul[] =
+{
+    0x0F, 0xAF, 0xBE, 0, 0, 0, 0,       /* imul edi, [rsi + val] */
+};
+static uint8_t const jitIntAnd[] =
+{
+    0x23, 0xBE, 0, 0, 0, 0,             /* and edi, [rsi + val] */
+};
+static uint8_t const jitIntOr[] =
+{
+    0x0B, 0xBE, 0, 0, 0, 0,             /* or edi, [rsi + val] */
+};
+static uint8_t const jitIntXor[] =
+{
+    0x33, 0xBE, 0, 0, 0, 0,             /* xor edi, [rsi + val] */
+};
+
+/* Calls helper(edi or rdi, &scratch) */
+static uint8_t const jitCall[] =
+{
+    0x4C, 0x89, 0xA3, 0, 0, 0, 0,       /* mov [rbx + fo_sp], r12 @3 */
+    0x48, 0x89, 0xE6,                   /* mov rsi, rsp */
+    0x48, 0xB8, 0, 0, 0, 0, 0, 0, 0, 0, /* mov rax, helper @12 */
+    0xFF, 0xD0,                         /* call rax */
+    0x85, 0xC0,                         /* test eax, eax */
+    0x0F, 0x85, 0, 0, 0, 0,             /* jne error @26 */
+};
+
+/* Int binary op: replaces TOS1 and TOS with the result */
+static uint8_t const jitIntResult[] =
+{
+    0x48, 0x8B, 0x04, 0x24,             /* mov rax, [rsp] */
+    0x49, 0x83, 0xEC, 0x08,             /* sub r12, 8 */
+    0x49, 0x89, 0x44, 0x24, 0xF8,       /* mov [r12 - 8], rax */
+};
+
+/* COMPARE_OP: checks TOS1 and TOS are ints or bools and compares them */
+static uint8_t const jitCompareInt[] =
+{
+    0x49, 0x8B, 0x7C, 0x24, 0xF0,       /* mov rdi, [r12 - 16] */
+    0x49, 0x8B, 0x74, 0x24, 0xF8,       /* mov rsi, [r12 - 8] */
+    0xBA, 0, 0, 0, 0,                   /* mov edx, type mask @11 */
+    0x0F, 0xB7, 0x07,                   /* movzx eax, word [rdi] */
+    0xC1, 0xE8, OD_TYPE_SHIFT,          /* shr eax, OD_TYPE_SHIFT */
+    0x0F, 0xA3, 0xC2,                   /* bt edx, eax */
+    0x0F, 0x83, 0, 0, 0, 0,             /* jnc guard @26 */
+    0x0F, 0xB7, 0x06,                   /* movzx eax, word [rsi] */
+    0xC1, 0xE8, OD_TYPE_SHIFT,          /* shr eax, OD_TYPE_SHIFT */
+    0x0F, 0xA3, 0xC2,                   /* bt edx, eax */
+    0x0F, 0x83, 0, 0, 0, 0,             /* jnc guard @41 */
+    0x8B, 0x87, 0, 0, 0, 0,             /* mov eax, [rdi + val] @47 */
+    0x3B, 0x86, 0, 0, 0, 0,             /* cmp eax, [rsi + val] @53 */
+};
+
+/* COMPARE_OP is and is not: compares TOS1 and TOS */
+static uint8_t const jitCompareIs[] =
+{
+    0x49, 0x8B, 0x44, 0x24, 0xF0,       /* mov rax, [r12 - 16] */
+    0x49, 0x3B, 0x44, 0x24, 0xF8,       /* cmp rax, [r12 - 8] */
+};
+
+/* COMPARE_OP: replaces TOS1 and TOS with the bool of the condition */
+static uint8_t const jitCompareResult[] =
+{
+    0x48, 0xB8, 0, 0, 0, 0, 0, 0, 0, 0, /* mov rax, PM_FALSE @2 */
+    0x48, 0xBA, 0, 0, 0, 0, 0, 0, 0, 0, /* mov rdx, PM_TRUE @12 */
+    0x48, 0x0F, 0x40, 0xC2,             /* cmovcc rax, rdx @22 */
+    0x49, 0x83, 0xEC, 0x08,             /* sub r12, 8 */
+    0x49, 0x89, 0x44, 0x24, 0xF8,       /* mov [r12 - 8], rax */
+};
+
+/* COMPARE_OP fused with POP_JUMP_IF_*: pops TOS1 and TOS and branches */
+static uint8_t const jitCompareJump[] =
+{
+    0x4D, 0x8D, 0x64, 0x24, 0xF0,       /* lea r12, [r12 - 16] */
+    0x0F, 0x80, 0, 0, 0, 0,             /* jcc target @6 @7 */
+};
+
+/* POP_JUMP_IF_*: pops TOS and branches on its truth */
+static uint8_t const jitPopJump[] =
+{
+    0x49, 0x83, 0xEC, 0x08,             /* sub r12, 8 */
+    0x49, 0x8B, 0x3C, 0x24,             /* mov rdi, [r12] */
+    0x48, 0xB8, 0, 0, 0, 0, 0, 0, 0, 0, /* mov rax, PM_FALSE @10 */
+    0x48, 0x39, 0xC7,                   /* cmp rdi, rax */
+    0x0F, 0x84, 0, 0, 0, 0,             /* je false @23 */
+    0x48, 0xB8, 0, 0, 0, 0, 0, 0, 0, 0, /* mov rax, PM_TRUE @29 */
+    0x48, 0x39, 0xC7,                   /* cmp rdi, rax */
+    0x0F, 0x84, 0, 0, 0, 0,             /* je true @42 */
+    0x48, 0xB8, 0, 0, 0, 0, 0, 0, 0, 0, /* mov rax, obj_isFalse @48 */
+    0xFF, 0xD0,                         /* call rax */
+    0x84, 0xC0,                         /* test al, al */
+    0x0F, 0x85, 0, 0, 0, 0,             /* jne false @62 */
+    0xE9, 0, 0, 0, 0,                   /* jmp true @67 */
+};
+
+/* FOR_ITER over an xrange or a sequence iterator */
+static uint8_t const jitForIter[] =
+{
+    0x49, 0x8B, 0x7C, 0x24, 0xF8,       /* mov rdi, [r12 - 8] */
+    0x0F, 0xB7, 0x07,                   /* movzx eax, word [rdi] */
+    0xC1, 0xE8, OD_TYPE_SHIFT,          /* shr eax, OD_TYPE_SHIFT */
+    0x48, 0xB9, 0, 0, 0, 0, 0, 0, 0, 0, /* mov rcx, seqiter_getNext @13 */
+    0x48, 0xBA, 0, 0, 0, 0, 0, 0, 0, 0, /* mov rdx, xrange_getNext @23 */
+    0x83, 0xF8, OBJ_TYPE_XRG,           /* cmp eax, OBJ_TYPE_XRG */
+    0x48, 0x0F, 0x44, 0xCA,             /* cmove rcx, rdx */
+    0x74, 0x09,                         /* je call */
+    0x83, 0xF8, OBJ_TYPE_SQI,           /* cmp eax, OBJ_TYPE_SQI */
+    0x0F, 0x85, 0, 0, 0, 0,             /* jne guard @45 */
+    0x48, 0x89, 0x3C, 0x24,             /* call: mov [rsp], rdi */
+    0x4C, 0x89, 0xA3, 0, 0, 0, 0,       /* mov [rbx + fo_sp], r12 @56 */
+    0x48, 0x89, 0xE6,                   /* mov rsi, rsp */
+    0xFF, 0xD1,                         /* call rcx */
+    0x3D, PM_RET_EX_STOP, 0, 0, 0,      /* cmp eax, PM_RET_EX_STOP */
+    0x0F, 0x84, 0, 0, 0, 0,             /* je stop @72 */
+    0x85, 0xC0,                         /* test eax, eax */
+    0x0F, 0x85, 0, 0, 0, 0,             /* jne error @80 */
+    0x48, 0x8B, 0x04, 0x24,             /* mov rax, [rsp] */
+    0x49, 0x89, 0x04, 0x24,             /* mov [r12], rax */
+    0x49, 0x83, 0xC4, 0x08,             /* add r12, 8 */
+};
+
+/* FOR_ITER at the end of the iteration: pops the iterator and jumps */
+static uint8_t const jitForIterStop[] =
+{
+    0x49, 0x83, 0xEC, 0x08,             /* sub r12, 8 */
+    0xE9, 0, 0, 0, 0,                   /* jmp target @5 */
+};
+
+/* LOAD_GLOBAL */
+static uint8_t const jitLoadGlobal[] =
+{
+    0x48, 0x89, 0xDF,                   /* mov rdi, rbx */
+    0x48, 0xBE, 0, 0, 0, 0, 0, 0, 0, 0, /* mov rsi, name @5 */
+    0x48, 0x89, 0xE2,                   /* mov rdx, rsp */
+    0x48, 0xB8, 0, 0, 0, 0, 0, 0, 0, 0, /* mov rax, jit_loadGlobal @18 */
+    0xFF, 0xD0,                         /* call rax */
+    0x85, 0xC0,                         /* test eax, eax */
+    0x0F, 0x85, 0, 0, 0, 0,             /* jne guard @32 */
+    0x48, 0x8B, 0x04, 0x24,             /* mov rax, [rsp] */
+    0x49, 0x89, 0x04, 0x24,             /* mov [r12], rax */
+    0x49, 0x83, 0xC4, 0x08,             /* add r12, 8 */
+};
+
+/* x86 condition code of each comparison (signed); (cc ^ 1) negates it */
+static uint8_t const jitCompareCc[COMP_IS_NOT + 1] =
+{
+    0x0C,   /* COMP_LT: l */
+    0x0E,   /* COMP_LE: le */
+    0x04,   /* COMP_EQ: e */
+    0x05,   /* COMP_NE: ne */
+    0x0F,   /* COMP_GT: g */
+    0x0D,   /* COMP_GE: ge */
+    0x00,   /* COMP_IN: not compiled */
+    0x00,   /* COMP_NOT_IN: not compiled */
+    0x04,   /* COMP_IS: e */
+    0x05,   /* COMP_IS_NOT: ne */
+};
+
+
+/* LOAD_GLOBAL for compiled code; on failure the interpreter raises */
+static PmReturn_t
+jit_loadGlobal(pPmFrame_t pframe, pPmObj_t pname, pPmObj_t *r_pobj)
+{
+    PmReturn_t retval;
+
+    retval = dict_getItem((pPmObj_t)pframe->fo_globals, pname, r_pobj);
+    if (retval == PM_RET_EX_KEY)
+    {
+        retval = dict_getItem(PM_PBUILTINS, pname, r_pobj);
+    }
+    return retval;
+}
+
+
+/*
+ * Copies a template to the code at *pcur (pem->pos or pem->stubpos)
+ * and returns the template's offset.  Only counts bytes while sizing.
+ */
+static uint32_t
+jit_put(pPmJitEmit_t pem, uint32_t *pcur, uint8_t const *ptmpl, uint8_t size)
+{
+    uint32_t at = *pcur;
+
+    if (pem->pcode != C_NULL)
+    {
+        sli_memcpy(pem->pcode + at, ptmpl, size);
+    }
+    *pcur += size;
+    return at;
+}
+
+
+/* Patches a 32-bit operand or displacement into the code */
+static void
+jit_patch32(pPmJitEmit_t pem, uint32_t at, uint32_t val)
+{
+    if (pem->pcode != C_NULL)
+    {
+        sli_memcpy(pem->pcode + at, (uint8_t const *)&val, sizeof(val));
+    }
+}
+
+
+/* Patches a 64-bit address into the code */
+static void
+jit_patchPtr(pPmJitEmit_t pem, uint32_t at, void const *ptr)
+{
+    if (pem->pcode != C_NULL)
+    {
+        sli_memcpy(pem->pcode + at, (uint8_t const *)&ptr, sizeof(ptr));
+    }
+}
+
+
+/* Patches the rel32 of a jump at offset at to reach offset target */
+static void
+jit_patchRel(pPmJitEmit_t pem, uint32_t at, uint32_t target)
+{
+    jit_patch32(pem, at, target - (at + 4));
+}
+
+
+/* Patches a byte (such as a condition code) into the code */
+static void
+jit_patch8(pPmJitEmit_t pem, uint32_t at, uint8_t val)
+{
+    if (pem->pcode != C_NULL)
+    {
+        pem->pcode[at] = val;
+    }
+}
+
+
+/*
+ * Puts an exit to the interpreter at bytecode offset ip and returns its
+ * offset.  The exit returns PM_RET_OK if ok, otherwise the status in eax.
+ */
+static uint32_t
+jit_putExit(pPmJitEmit_t pem, uint32_t *pcur, uint16_t ip, uint8_t ok)
+{
+    uint32_t at = *pcur;
+    uint32_t pos;
+
+    if (ok)
+    {
+        jit_put(pem, pcur, jitExitOk, sizeof(jitExitOk));
+    }
+    pos = jit_put(pem, pcur, jitExitAt, sizeof(jitExitAt));
+    jit_patch32(pem, pos + 3, ip);
+    jit_patchRel(pem, pos + 8, pem->exitpos);
+    return at;
+}
+
+
+/*
+ * Puts a backward jump to bytecode offset target and returns its offset.
+ * Like interpret(), it spends from the budget (or checks the reschedule
+ * flag) and returns to the interpreter at the target to reschedule.
+ */
+static uint32_t
+jit_putBackJump(pPmJitEmit_t pem, uint32_t *pcur, uint16_t target)
+{
+    uint32_t exit;
+    uint32_t at;
+    uint32_t pos;
+
+    exit = jit_putExit(pem, &pem->stubpos, target, C_TRUE);
+    at = *pcur;
+
+#ifdef HAVE_BUDGET_SCHED
+    pos = jit_put(pem, pcur, jitSpendBudget, sizeof(jitSpendBudget));
+    jit_patchPtr(pem, pos + 2, (void const *)&gVmGlobal.budgetLeft);
+    jit_patchRel(pem, pos + 15, exit);
+#endif /* HAVE_BUDGET_SCHED */
+
+    pos = jit_put(pem, pcur, jitCheckReschedule, sizeof(jitCheckReschedule));
+    jit_patchPtr(pem, pos + 2, (void const *)&gVmGlobal.reschedule);
+    jit_patchRel(pem, pos + 15, exit);
+    jit_patchRel(pem, pos + 20, pem->offs[target] & JIT_OFFS_MASK);
+    return at;
+}
+
+
+/*
+ * Returns the offset of code that branches to bytecode offset target from
+ * the instruction that ends at next.  A backward branch goes to a stub.
+ */
+static uint32_t
+jit_branch(pPmJitEmit_t pem, uint16_t target, uint16_t next)
+{
+    if (target >= next)
+    {
+        return pem->offs[target] & JIT_OFFS_MASK;
+    }
+    return jit_putBackJump(pem, &pem->stubpos, target);
+}
+
+
+/* Puts a call of the helper, which returns an object in the scratch slot */
+static void
+jit_putCall(pPmJitEmit_t pem, void const *phelper, uint32_t error)
+{
+    uint32_t pos;
+
+    pos = jit_put(pem, &pem->pos, jitCall, sizeof(jitCall));
+    jit_patch32(pem, pos + 3, offsetof(PmFrame_t, fo_sp));
+    jit_patchPtr(pem, pos + 12, phelper);
+    jit_patchRel(pem, pos + 26, error);
+}
+
+
+/* Marks the jump targets in offs; C_FALSE if a jump leaves the bytecode */
+static uint8_t
+jit_markTargets(pPmCo_t pco, uint32_t *offs)
+{
+    uint8_t const *pip = pco->co_codeaddr;
+    uint32_t target;
+    uint16_t arg;
+    uint8_t bc;
+
+    while (pip < (pco->co_codeaddr + pco->co_codelen))
+    {
+        bc = mem_getByte(pco->co_memspace, &pip);
+        if (bc < HAVE_ARGUMENT)
+        {
+            continue;
+        }
+        arg = mem_getWord(pco->co_memspace, &pip);
+
+        switch (bc)
+        {
+            case JUMP_FORWARD:
+            case JUMP_IF_FALSE:
+            case JUMP_IF_TRUE:
+            case FOR_ITER:
+                target = (uint32_t)(pip - pco->co_codeaddr) + arg;
+                break;
+
+            case JUMP_ABSOLUTE:
+            case CONTINUE_LOOP:
+            case POP_JUMP_IF_FALSE:
+            case POP_JUMP_IF_TRUE:
+                target = arg;
+                break;
+
+            default:
+                continue;
+        }
+
+        if (target >= pco->co_codelen)
+        {
+            return C_FALSE;
+        }
+        offs[target] |= JIT_OFFS_TARGET;
+    }
+    return C_TRUE;
+}
+
+
+/*
+ * Stitches the templates for the CO's bytecode.  Fills in pem->offs
+ * and leaves the size of the code in pem->pos and pem->stubpos.
+ */
+static void
+jit_emitCo(pPmCo_t pco, pPmJitEmit_t pem)
+{
+    PmMemSpace_t memspace = pco->co_memspace;
+    uint8_t const *pip = pco->co_codeaddr;
+    uint8_t const *pnext;
+    uint8_t const *ptmpl = C_NULL;
+    uint8_t size = 0;
+    uint32_t pos;
+    uint32_t guard;
+    uint32_t error;
+    uint32_t taken;
+    uint16_t ip;
+    uint16_t next;
+    uint16_t arg = 0;
+    uint8_t bc;
+    uint8_t cc;
+
+    pos = jit_put(pem, &pem->pos, jitEntry, sizeof(jitEntry));
+    jit_patch32(pem, pos + 15, offsetof(PmFrame_t, fo_sp));
+    jit_patchPtr(pem, pos + 21, pco->co_codeaddr);
+    pem->exitpos = jit_put(pem, &pem->pos, jitExit, sizeof(jitExit));
+    jit_patch32(pem, pem->exitpos + 3, offsetof(PmFrame_t, fo_ip));
+    jit_patch32(pem, pem->exitpos + 10, offsetof(PmFrame_t, fo_sp));
+
+    while (pip < (pco->co_codeaddr + pco->co_codelen))
+    {
+        ip = (uint16_t)(pip - pco->co_codeaddr);
+        bc = mem_getByte(memspace, &pip);
+        if (bc >= HAVE_ARGUMENT)
+        {
+            arg = mem_getWord(memspace, &pip);
+        }
+        next = (uint16_t)(pip - pco->co_codeaddr);
+        pem->offs[ip] = (pem->offs[ip] & JIT_OFFS_TARGET) | pem->pos;
+
+        switch (bc)
+        {
+            case NOP:
+                continue;
+
+            case POP_TOP:
+                jit_put(pem, &pem->pos, jitPopTop, sizeof(jitPopTop));
+                continue;
+
+            case ROT_TWO:
+                jit_put(pem, &pem->pos, jitRotTwo, sizeof(jitRotTwo));
+                continue;
+
+            case ROT_THREE:
+                jit_put(pem, &pem->pos, jitRotThree, sizeof(jitRotThree));
+                continue;
+
+            case DUP_TOP:
+                jit_put(pem, &pem->pos, jitDupTop, sizeof(jitDupTop));
+                continue;
+
+            case LOAD_FAST:
+                pos = jit_put(pem, &pem->pos, jitLoadFast,
+                              sizeof(jitLoadFast));
+                jit_patch32(pem, pos + 3, offsetof(PmFrame_t, fo_locals)
+                                          + arg * sizeof(pPmObj_t));
+                continue;
+
+            case STORE_FAST:
+                pos = jit_put(pem, &pem->pos, jitStoreFast,
+                              sizeof(jitStoreFast));
+                jit_patch32(pem, pos + 11, offsetof(PmFrame_t, fo_locals)
+                                           + arg * sizeof(pPmObj_t));
+                continue;
+
+            case LOAD_CONST:
+                pos = jit_put(pem, &pem->pos, jitLoadConst,
+                              sizeof(jitLoadConst));
+                jit_patchPtr(pem, pos + 2, pco->co_consts->val[arg]);
+                continue;
+
+            case LOAD_GLOBAL:
+                guard = jit_putExit(pem, &pem->stubpos, ip, C_TRUE);
+                pos = jit_put(pem, &pem->pos, jitLoadGlobal,
+                              sizeof(jitLoadGlobal));
+                jit_patchPtr(pem, pos + 5, pco->co_names->val[arg]);
+                jit_patchPtr(pem, pos + 18, (void const *)jit_loadGlobal);
+                jit_patchRel(pem, pos + 32, guard);
+                continue;
+
+            case BINARY_ADD:
+            case INPLACE_ADD:
+            case BINARY_SUBTRACT:
+            case INPLACE_SUBTRACT:
+            case BINARY_MULTIPLY:
+            case INPLACE_MULTIPLY:
+            case BINARY_AND:
+            case INPLACE_AND:
+            case BINARY_OR:
+            case INPLACE_OR:
+            case BINARY_XOR:
+            case INPLACE_XOR:
+                switch (bc)
+                {
+                    /* *INDENT-OFF* */
+                    case BINARY_ADD:
+                    case INPLACE_ADD:
+                        ptmpl = jitIntAdd; size = sizeof(jitIntAdd); break;
+                    case BINARY_SUBTRACT:
+                    case INPLACE_SUBTRACT:
+                        ptmpl = jitIntSub; size = sizeof(jitIntSub); break;
+                    case BINARY_MULTIPLY:
+                    case INPLACE_MULTIPLY:
+                        ptmpl = jitIntMul; size = sizeof(jitIntMul); break;
+                    case BINARY_AND:
+                    case INPLACE_AND:
+                        ptmpl = jitIntAnd; size = sizeof(jitIntAnd); break;
+                    case BINARY_OR:
+                    case INPLACE_OR:
+                        ptmpl = jitIntOr; size = sizeof(jitIntOr); break;
+                    default:
+                        ptmpl = jitIntXor; size = sizeof(jitIntXor); break;
+                    /* *INDENT-ON* */
+                }
+
+                /* Other types return to the interpreter before the op */
+                guard = jit_putExit(pem, &pem->stubpos, ip, C_TRUE);
+                error = jit_putExit(pem, &pem->stubpos, next, C_FALSE);
+                pos = jit_put(pem, &pem->pos, jitIntGuard,
+                              sizeof(jitIntGuard));
+                jit_patchRel(pem, pos + 21, guard);
+                jit_patchRel(pem, pos + 36, guard);
+                jit_patch32(pem, pos + 42, offsetof(PmInt_t, val));
+                pos = jit_put(pem, &pem->pos, ptmpl, size);
+                jit_patch32(pem, pos + size - 4, offsetof(PmInt_t, val));
+                jit_putCall(pem, (void const *)int_new, error);
+                jit_put(pem, &pem->pos, jitIntResult, sizeof(jitIntResult));
+                continue;
+
+            case COMPARE_OP:
+                if ((arg == COMP_IS) || (arg == COMP_IS_NOT))
+                {
+                    jit_put(pem, &pem->pos, jitCompareIs,
+                            sizeof(jitCompareIs));
+                }
+                else if (arg <= COMP_GE)
+                {
+                    guard = jit_putExit(pem, &pem->stubpos, ip, C_TRUE);
+                    pos = jit_put(pem, &pem->pos, jitCompareInt,
+                                  sizeof(jitCompareInt));
+                    jit_patch32(pem, pos + 11, (1 << OBJ_TYPE_INT)
+                                               | (1 << OBJ_TYPE_BOOL));
+                    jit_patchRel(pem, pos + 26, guard);
+                    jit_patchRel(pem, pos + 41, guard);
+                    jit_patch32(pem, pos + 47, offsetof(PmInt_t, val));
+                    jit_patch32(pem, pos + 53, offsetof(PmInt_t, val));
+                }
+                else
+                {
+                    break;
+                }
+                cc = jitCompareCc[arg];
+
+                /* Branch on the flags if a POP_JUMP_IF_* follows */
+                pnext = pip;
+                if ((next < pco->co_codelen)
+                    && !(pem->offs[next] & JIT_OFFS_TARGET))
+                {
+                    bc = mem_getByte(memspace, &pnext);
+                }
+                if ((pnext != pip)
+                    && ((bc == POP_JUMP_IF_FALSE) || (bc == POP_JUMP_IF_TRUE)))
+                {
+                    arg = mem_getWord(memspace, &pnext);
+                    pip = pnext;
+                    next = (uint16_t)(pip - pco->co_codeaddr);
+                    if (bc == POP_JUMP_IF_FALSE)
+                    {
+                        cc ^= 1;
+                    }
+                    pos = jit_put(pem, &pem->pos, jitCompareJump,
+                                  sizeof(jitCompareJump));
+                    jit_patch8(pem, pos + 6, 0x80 | cc);
+                    jit_patchRel(pem, pos + 7, jit_branch(pem, arg, next));
+                    continue;
+                }
+
+                pos = jit_put(pem, &pem->pos, jitCompareResult,
+                              sizeof(jitCompareResult));
+                jit_patchPtr(pem, pos + 2, PM_FALSE);
+                jit_patchPtr(pem, pos + 12, PM_TRUE);
+                jit_patch8(pem, pos + 22, 0x40 | cc);
+                continue;
+
+            case JUMP_FORWARD:
+                pos = jit_put(pem, &pem->pos, jitJump, sizeof(jitJump));
+                jit_patchRel(pem, pos + 1,
+                             pem->offs[next + arg] & JIT_OFFS_MASK);
+                continue;
+
+            case JUMP_ABSOLUTE:
+            case CONTINUE_LOOP:
+                if (arg < next)
+                {
+                    jit_putBackJump(pem, &pem->pos, arg);
+                    continue;
+                }
+                pos = jit_put(pem, &pem->pos, jitJump, sizeof(jitJump));
+                jit_patchRel(pem, pos + 1, pem->offs[arg] & JIT_OFFS_MASK);
+                continue;
+
+            case POP_JUMP_IF_FALSE:
+            case POP_JUMP_IF_TRUE:
+                pos = jit_put(pem, &pem->pos, jitPopJump, sizeof(jitPopJump));
+                jit_patchPtr(pem, pos + 10, PM_FALSE);
+                jit_patchPtr(pem, pos + 29, PM_TRUE);
+                jit_patchPtr(pem, pos + 48, (void const *)obj_isFalse);
+                taken = jit_branch(pem, arg, next);
+                if (bc == POP_JUMP_IF_FALSE)
+                {
+                    jit_patchRel(pem, pos + 23, taken);
+                    jit_patchRel(pem, pos + 42, pem->pos);
+                    jit_patchRel(pem, pos + 62, taken);
+                    jit_patchRel(pem, pos + 67, pem->pos);
+                }
+                else
+                {
+                    jit_patchRel(pem, pos + 23, pem->pos);
+                    jit_patchRel(pem, pos + 42, taken);
+                    jit_patchRel(pem, pos + 62, pem->pos);
+                    jit_patchRel(pem, pos + 67, taken);
+                }
+                continue;
+
+            case FOR_ITER:
+                /* Generators and instances switch frames, so interpret */
+                guard = jit_putExit(pem, &pem->stubpos, ip, C_TRUE);
+                error = jit_putExit(pem, &pem->stubpos, next, C_FALSE);
+                taken = jit_put(pem, &pem->stubpos, jitForIterStop,
+                                sizeof(jitForIterStop));
+                jit_patchRel(pem, taken + 5,
+                             pem->offs[next + arg] & JIT_OFFS_MASK);
+                pos = jit_put(pem, &pem->pos, jitForIter, sizeof(jitForIter));
+                jit_patchPtr(pem, pos + 13, (void const *)seqiter_getNext);
+                jit_patchPtr(pem, pos + 23, (void const *)xrange_getNext);
+                jit_patchRel(pem, pos + 45, guard);
+                jit_patch32(pem, pos + 56, offsetof(PmFrame_t, fo_sp));
+                jit_patchRel(pem, pos + 72, taken);
+                jit_patchRel(pem, pos + 80, error);
+                continue;
+
+            default:
+                break;
+        }
+
+        /* Any other bytecode returns to the interpreter, which runs it */
+        jit_putExit(pem, &pem->pos, ip, C_TRUE);
+        pem->offs[ip] |= JIT_OFFS_EXIT;
+    }
+}
+
+
+void
+jit_init(void)
+{
+    if (jitArena == C_NULL)
+    {
+        jitArena = plat_jitMap(PM_JIT_ARENA_SIZE);
+    }
+
+    /* The code objects of the previous VM are gone */
+    jitUsed = 0;
+}
+
+
+uint8_t
+jit_compile(pPmCo_t pco)
+{
+    PmJitEmit_t em;
+    pPmJitCode_t pjc;
+    uint32_t hdrsize;
+
+    if (pco->co_jitcode != C_NULL)
+    {
+        return C_TRUE;
+    }
+
+    /* Any failure below is final */
+    pco->co_jitcount = JIT_NEVER;
+
+    /* The table of offsets precedes the code, which is 16-byte aligned */
+    hdrsize = (offsetof(PmJitCode_t, jc_offs)
+               + pco->co_codelen * sizeof(uint32_t) + 15) & ~15UL;
+    if ((jitArena == C_NULL) || (jitUsed + hdrsize > PM_JIT_ARENA_SIZE))
+    {
+        return C_FALSE;
+    }
+    pjc = (pPmJitCode_t)(jitArena + jitUsed);
+    sli_memset((uint8_t *)pjc->jc_offs, 0,
+               pco->co_codelen * sizeof(uint32_t));
+    if (!jit_markTargets(pco, pjc->jc_offs))
+    {
+        return C_FALSE;
+    }
+
+    /* Size the code, then stitch it if it fits, with the stubs after it */
+    em.pcode = C_NULL;
+    em.pos = 0;
+    em.stubpos = 0;
+    em.offs = pjc->jc_offs;
+    jit_emitCo(pco, &em);
+    if ((jitUsed + hdrsize + em.pos + em.stubpos) > PM_JIT_ARENA_SIZE)
+    {
+        return C_FALSE;
+    }
+    em.pcode = jitArena + jitUsed + hdrsize;
+    em.stubpos = em.pos;
+    em.pos = 0;
+    jit_emitCo(pco, &em);
+
+    pjc->jc_code = em.pcode;
+    jitUsed = (jitUsed + hdrsize + em.stubpos + 15) & ~15UL;
+    pco->co_jitcode = pjc;
+    return C_TRUE;
+}
+
+
+PmReturn_t
+jit_run(pPmFrame_t pframe)
+{
+    pPmCo_t pco = pframe->fo_func->f_co;
+    pPmJitCode_t pjc = pco->co_jitcode;
+    uint32_t offs;
+
+    /* Count the jump until the CO is hot, then compile it */
+    if (pjc == C_NULL)
+    {
+        if ((pco->co_jitcount == JIT_NEVER)
+            || (++pco->co_jitcount < PM_JIT_THRESHOLD)
+            || !jit_compile(pco))
+        {
+            return PM_RET_OK;
+        }
+        pjc = pco->co_jitcode;
+    }
+
+    /* Run the compiled code unless it would return at once */
+    offs = pjc->jc_offs[pframe->fo_ip - pco->co_codeaddr];
+    if ((offs == 0) || (offs & JIT_OFFS_EXIT))
+    {
+        return PM_RET_OK;
+    }
+    return ((pPmJitFunc_t)pjc->jc_code)(pframe,
+                                        pjc->jc_code + (offs & JIT_OFFS_MASK));
+}
+
+#endif /* HAVE_JIT */
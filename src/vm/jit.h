@@ -0,0 +1,95 @@
+/*
+# This file is Copyright 2013 Dean Hall.
+# This file is part of the PyMite VM.
+# This file is licensed under the MIT License.
+# See the LICENSE file for details.
+*/
+
+
+#ifndef __JIT_H__
+#define __JIT_H__
+
+
+/**
+ * \file
+ * \brief Template JIT
+ *
+ * Compiles the bytecode of hot code objects to x86-64 machine code.
+ * Each bytecode is translated by copying a precompiled template of
+ * machine code into an executable arena obtained from plat_jitMap() and
+ * patching its operands and jump targets in place.  Bytecodes without a
+ * template, and any template whose type checks fail or whose helper
+ * function raises, return to the interpreter, which carries on from the
+ * same instruction.  Calls, returns, yields and other frame switches
+ * are always left to the interpreter.
+ *
+ * Compiled code is only entered at the target of a backward jump and
+ * spends the scheduler budget (or checks the reschedule flag) at its own
+ * backward jumps exactly as interpret() does.
+ * It embeds addresses of the VM's globals and of constant objects,
+ * so it must only run on the OS thread that compiled it.
+ */
+
+
+#ifdef HAVE_JIT
+
+/** Backward jumps a code object takes before it is compiled */
+#ifndef PM_JIT_THRESHOLD
+#define PM_JIT_THRESHOLD 64
+#endif
+
+/** Size in bytes of the executable arena of each VM */
+#ifndef PM_JIT_ARENA_SIZE
+#define PM_JIT_ARENA_SIZE 0x40000
+#endif
+
+/** Compiled code of one code object, at the start of its arena space */
+typedef struct PmJitCode_s
+{
+    /** The entry stub, followed by the code of each instruction */
+    uint8_t *jc_code;
+
+    /**
+     * Offset into jc_code of each instruction's code, indexed by the
+     * instruction's offset into the bytecode; zero if there is none.
+     * Holds co_codelen entries.
+     */
+    uint32_t jc_offs[1];
+} PmJitCode_t,
+ *pPmJitCode_t;
+
+
+/**
+ * Maps the executable arena (once per OS thread) and discards
+ * the code compiled for the previous VM.  Called by pm_init().
+ */
+void jit_init(void);
+
+/**
+ * Compiles the code object into the arena.
+ * Does nothing if the CO is already compiled.  If the CO cannot be
+ * compiled (the arena is full or missing, or the bytecode has a jump
+ * out of bounds) it is marked so that it is never tried again.
+ *
+ * @param pco Code object, already loaded (see co_resolve())
+ * @return C_TRUE if the CO has compiled code
+ */
+uint8_t jit_compile(pPmCo_t pco);
+
+/**
+ * Called by interpret() at a backward jump, once PM_IP holds the target.
+ * Counts the jump against the frame's code object, compiling the CO
+ * when the count reaches PM_JIT_THRESHOLD, then runs its compiled code
+ * from the frame's instruction pointer until the code returns to the
+ * interpreter.  The frame's instruction and stack pointers are up to date
+ * on return; in budget mode, the caller must then reschedule if
+ * the budget is spent.
+ *
+ * @param pframe The running frame
+ * @return Return status; an exception raised by the compiled code
+ */
+PmReturn_t jit_run(pPmFrame_t pframe);
+
+#endif /* HAVE_JIT */
+
+#endif /* __JIT_H__ */
@@ -21,21 +21,40 @@
 #include "pm.h"
 
 
-PmReturn_t
-list_append(pPmObj_t plist, pPmObj_t pobj)
+/** The number of items list_appendSlice() gathers before appending them */
+#define LIST_SLICE_BUF_LEN 16
+
+/** Runs of at most this many items are sorted by insertion, not merging */
+#define LIST_SORT_RUN_LEN 8
+
+
+/* The items and keys of a list being sorted, and a buffer for merging */
+typedef struct PmListSort_s
 {
-    PmReturn_t retval;
-    uint8_t objid;
+    /** Seglist of items */
+    pSeglist_t ls_items;
 
-    C_ASSERT(plist != C_NULL);
-    C_ASSERT(pobj != C_NULL);
+    /** Seglist of keys; the same as ls_items if the items are the keys */
+    pSeglist_t ls_keys;
 
-    /* If plist is not a list, raise a TypeError exception */
-    if (OBJ_GET_TYPE(plist) != OBJ_TYPE_LST)
-    {
-        PM_RAISE(retval, PM_RET_EX_TYPE);
-        return retval;
-    }
+    /** Buffer of n/2 items followed by n/2 keys (if there are keys) */
+    pSeglist_t ls_buf;
+
+    /** Index in ls_buf of the first key */
+    int16_t ls_bufkeys;
+} PmListSort_t,
+ *pPmListSort_t;
+
+
+/*
+ * Appends the n objects at ppobjs to the list.
+ * The caller must keep the list and the objects reachable.
+ */
+static PmReturn_t
+list_appendItems(pPmObj_t plist, pPmObj_t const *ppobjs, int16_t n)
+{
+    PmReturn_t retval;
+    uint8_t objid;
 
     /* Create new seglist if needed */
     if (((pPmList_t)plist)->length == 0)
@@ -44,19 +63,69 @@ list_append(pPmObj_t plist, pPmObj_t pobj)
         PM_RETURN_IF_ERROR(retval);
     }
 
-    /* Append object to list */
+    /* Append objects to list */
     heap_gcPushTempRoot((pPmObj_t)((pPmList_t)plist)->val, &objid);
-    retval = seglist_appendItem(((pPmList_t)plist)->val, pobj);
+    retval = seglist_appendItems(((pPmList_t)plist)->val, ppobjs, n);
     heap_gcPopTempRoot(objid);
-    PM_RETURN_IF_ERROR(retval);
+    ((pPmList_t)plist)->length = ((pPmList_t)plist)->val->sl_length;
+
+    return retval;
+}
 
-    /* Increment list length */
-    ((pPmList_t)plist)->length++;
 
+/*
+ * Appends n items of psrclist, from index start stepping by stride, to plist.
+ * Gathers the items in a buffer and appends a buffer's worth at a time.
+ * The caller must keep both lists reachable.
+ */
+static PmReturn_t
+list_appendSlice(pPmObj_t plist, pPmObj_t psrclist,
+                 int16_t start, int16_t n, int16_t stride)
+{
+    PmReturn_t retval = PM_RET_OK;
+    pPmObj_t items[LIST_SLICE_BUF_LEN];
+    pSeglist_t psrc;
+    int8_t i = 0;
+
+    psrc = ((pPmList_t)psrclist)->val;
+    while (n > 0)
+    {
+        items[i++] = *SEGLIST_ITEM_SLOT(psrc, start);
+        start += stride;
+        n--;
+
+        /* Append when the buffer is full or the last item is in it */
+        if ((i == LIST_SLICE_BUF_LEN) || (n == 0))
+        {
+            retval = list_appendItems(plist, items, i);
+            PM_RETURN_IF_ERROR(retval);
+            i = 0;
+        }
+    }
     return retval;
 }
 
 
+PmReturn_t
+list_append(pPmObj_t plist, pPmObj_t pobj)
+{
+    PmReturn_t retval;
+
+    C_ASSERT(plist != C_NULL);
+    C_ASSERT(pobj != C_NULL);
+
+    /* If plist is not a list, raise a TypeError exception */
+    if (OBJ_GET_TYPE(plist) != OBJ_TYPE_LST)
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    /* Append object to list */
+    return list_appendItems(plist, &pobj, 1);
+}
+
+
 PmReturn_t
 list_getItem(pPmObj_t plist, int16_t index, pPmObj_t *r_pobj)
 {
@@ -159,6 +228,27 @@ list_new(pPmObj_t *r_pobj)
 }
 
 
+PmReturn_t
+list_newFromArray(pPmObj_t const *ppobjs, int16_t n, pPmObj_t *r_pobj)
+{
+    PmReturn_t retval;
+    uint8_t objid;
+
+    C_ASSERT(n >= 0);
+
+    retval = list_new(r_pobj);
+    PM_RETURN_IF_ERROR(retval);
+
+    if (n > 0)
+    {
+        heap_gcPushTempRoot(*r_pobj, &objid);
+        retval = list_appendItems(*r_pobj, ppobjs, n);
+        heap_gcPopTempRoot(objid);
+    }
+    return retval;
+}
+
+
 PmReturn_t
 list_copy(pPmObj_t pobj, pPmObj_t *r_pobj)
 {
@@ -171,9 +261,7 @@ list_replicate(pPmObj_t psrclist, int16_t n, pPmObj_t *r_pnewlist)
 {
     PmReturn_t retval = PM_RET_OK;
     int16_t i = 0;
-    int16_t j = 0;
     int16_t length = 0;
-    pPmObj_t pitem = C_NULL;
     uint8_t objid;
 
     C_ASSERT(psrclist != C_NULL);
@@ -192,19 +280,13 @@ list_replicate(pPmObj_t psrclist, int16_t n, pPmObj_t *r_pnewlist)
     PM_RETURN_IF_ERROR(retval);
 
     /* Copy srclist the designated number of times */
+    heap_gcPushTempRoot(*r_pnewlist, &objid);
     for (i = n; i > 0; i--)
     {
-        /* Iterate over the length of srclist */
-        for (j = 0; j < length; j++)
-        {
-            retval = list_getItem(psrclist, j, &pitem);
-            PM_RETURN_IF_ERROR(retval);
-            heap_gcPushTempRoot(*r_pnewlist, &objid);
-            retval = list_append(*r_pnewlist, pitem);
-            heap_gcPopTempRoot(objid);
-            PM_RETURN_IF_ERROR(retval);
-        }
+        retval = list_appendSlice(*r_pnewlist, psrclist, 0, length, 1);
+        PM_BREAK_IF_ERROR(retval);
     }
+    heap_gcPopTempRoot(objid);
     return retval;
 }
 
@@ -352,6 +434,191 @@ list_delItem(pPmObj_t plist, int16_t index)
 }
 
 
+/* Puts the item and key into the slot at the index */
+static void
+list_sortPut(pPmListSort_t ps, int16_t index, pPmObj_t pitem, pPmObj_t pkey)
+{
+    *SEGLIST_ITEM_SLOT(ps->ls_items, index) = pitem;
+    *SEGLIST_ITEM_SLOT(ps->ls_keys, index) = pkey;
+}
+
+
+/*
+ * Sorts the items in [lo, hi) by insertion.  An item moves left only past
+ * items whose keys are greater, so items with equal keys keep their order.
+ * If a compare fails, the items are all still in the run.
+ */
+static PmReturn_t
+list_sortRun(pPmListSort_t ps, int16_t lo, int16_t hi)
+{
+    PmReturn_t retval = PM_RET_OK;
+    pPmObj_t pitem;
+    pPmObj_t pkey;
+    int16_t i;
+    int16_t j;
+    int8_t order;
+
+    for (i = lo + 1; i < hi; i++)
+    {
+        pitem = *SEGLIST_ITEM_SLOT(ps->ls_items, i);
+        pkey = *SEGLIST_ITEM_SLOT(ps->ls_keys, i);
+        for (j = i; j > lo; j--)
+        {
+            retval = obj_order(*SEGLIST_ITEM_SLOT(ps->ls_keys, j - 1), pkey,
+                               &order);
+            if ((retval != PM_RET_OK) || (order <= 0))
+            {
+                break;
+            }
+            list_sortPut(ps, j, *SEGLIST_ITEM_SLOT(ps->ls_items, j - 1),
+                         *SEGLIST_ITEM_SLOT(ps->ls_keys, j - 1));
+        }
+        list_sortPut(ps, j, pitem, pkey);
+        PM_RETURN_IF_ERROR(retval);
+    }
+    return retval;
+}
+
+
+/*
+ * Sorts the items in [lo, hi) by sorting each half, then moving the left
+ * half (never longer than the right) into the buffer and merging it with
+ * the right half.  A tie takes the left item, so the sort is stable.
+ * If a compare fails, the items are all still in the run.
+ */
+static PmReturn_t
+list_sortMerge(pPmListSort_t ps, int16_t lo, int16_t hi)
+{
+    PmReturn_t retval;
+    int16_t mid;
+    int16_t i;
+    int16_t j;
+    int16_t k;
+    int8_t order;
+
+    if ((hi - lo) <= LIST_SORT_RUN_LEN)
+    {
+        return list_sortRun(ps, lo, hi);
+    }
+
+    mid = lo + (hi - lo) / 2;
+    retval = list_sortMerge(ps, lo, mid);
+    PM_RETURN_IF_ERROR(retval);
+    retval = list_sortMerge(ps, mid, hi);
+    PM_RETURN_IF_ERROR(retval);
+
+    /* The halves are already in order if the left's last is not greater */
+    retval = obj_order(*SEGLIST_ITEM_SLOT(ps->ls_keys, mid - 1),
+                       *SEGLIST_ITEM_SLOT(ps->ls_keys, mid), &order);
+    if ((retval != PM_RET_OK) || (order <= 0))
+    {
+        return retval;
+    }
+
+    for (i = 0; i < (mid - lo); i++)
+    {
+        *SEGLIST_ITEM_SLOT(ps->ls_buf, i) =
+            *SEGLIST_ITEM_SLOT(ps->ls_items, lo + i);
+        *SEGLIST_ITEM_SLOT(ps->ls_buf, ps->ls_bufkeys + i) =
+            *SEGLIST_ITEM_SLOT(ps->ls_keys, lo + i);
+    }
+
+    /* Merge until either half is used up; the right's rest stays put */
+    i = 0;
+    j = mid;
+    k = lo;
+    while ((i < (mid - lo)) && (j < hi))
+    {
+        retval = obj_order(*SEGLIST_ITEM_SLOT(ps->ls_keys, j),
+                           *SEGLIST_ITEM_SLOT(ps->ls_buf, ps->ls_bufkeys + i),
+                           &order);
+        PM_BREAK_IF_ERROR(retval);
+        if (order < 0)
+        {
+            list_sortPut(ps, k++, *SEGLIST_ITEM_SLOT(ps->ls_items, j),
+                         *SEGLIST_ITEM_SLOT(ps->ls_keys, j));
+            j++;
+        }
+        else
+        {
+            list_sortPut(ps, k++, *SEGLIST_ITEM_SLOT(ps->ls_buf, i),
+                         *SEGLIST_ITEM_SLOT(ps->ls_buf, ps->ls_bufkeys + i));
+            i++;
+        }
+    }
+
+    /* Put back the rest of the left half (exactly fills the gap before j) */
+    for (; i < (mid - lo); i++)
+    {
+        list_sortPut(ps, k++, *SEGLIST_ITEM_SLOT(ps->ls_buf, i),
+                     *SEGLIST_ITEM_SLOT(ps->ls_buf, ps->ls_bufkeys + i));
+    }
+    return retval;
+}
+
+
+PmReturn_t
+list_sort(pPmObj_t plist, pPmObj_t pkeys)
+{
+    PmReturn_t retval = PM_RET_OK;
+    PmListSort_t s;
+    int16_t n;
+    int16_t nbuf;
+    int16_t i;
+    uint8_t objid;
+
+    /* Raise TypeError if it's not a list, or the keys are not a list */
+    if ((OBJ_GET_TYPE(plist) != OBJ_TYPE_LST)
+        || ((pkeys != C_NULL) && (OBJ_GET_TYPE(pkeys) != OBJ_TYPE_LST)))
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    /* Raise ValueError if there is not one key per item */
+    n = ((pPmList_t)plist)->length;
+    if ((pkeys != C_NULL) && (((pPmList_t)pkeys)->length != n))
+    {
+        PM_RAISE(retval, PM_RET_EX_VAL);
+        return retval;
+    }
+
+    if (n < 2)
+    {
+        return retval;
+    }
+
+    s.ls_items = ((pPmList_t)plist)->val;
+    s.ls_keys = (pkeys == C_NULL) ? s.ls_items : ((pPmList_t)pkeys)->val;
+
+    /* Make one buffer big enough for the left half of any merge */
+    s.ls_bufkeys = (n / 2);
+    nbuf = (pkeys == C_NULL) ? s.ls_bufkeys : (2 * s.ls_bufkeys);
+    retval = seglist_new(&s.ls_buf);
+    PM_RETURN_IF_ERROR(retval);
+    heap_gcPushTempRoot((pPmObj_t)s.ls_buf, &objid);
+    for (i = 0; i < nbuf; i++)
+    {
+        retval = seglist_appendItem(s.ls_buf, PM_NONE);
+        PM_BREAK_IF_ERROR(retval);
+    }
+
+    /* With no keys, the buffer's keys are its items */
+    if (pkeys == C_NULL)
+    {
+        s.ls_bufkeys = 0;
+    }
+
+    if (retval == PM_RET_OK)
+    {
+        retval = list_sortMerge(&s, 0, n);
+    }
+    heap_gcPopTempRoot(objid);
+
+    return retval;
+}
+
+
 #ifdef HAVE_PRINT
 PmReturn_t
 list_print(pPmObj_t plist)
@@ -428,8 +695,7 @@ list_slice(pPmObj_t plist, pPmObj_t pstart, pPmObj_t pend, pPmObj_t pstride, pPm
     int32_t stride;
     uint16_t len;
     pPmObj_t pslice;
-    int16_t i;
-    pPmObj_t pitem;
+    int32_t n;
     uint8_t objid;
 
     len = ((pPmList_t)plist)->length;
@@ -496,21 +762,30 @@ list_slice(pPmObj_t plist, pPmObj_t pstart, pPmObj_t pend, pPmObj_t pstride, pPm
 
     stride = ((pPmInt_t)pstride)-> val;
 
+    /* Raise ValueError if the stride is not positive */
+    if (stride <= 0)
+    {
+        PM_RAISE(retval, PM_RET_EX_VAL);
+        return retval;
+    }
+
+    /* Count the items in the slice; the stride only matters if n > 1 */
+    n = (end > start) ? ((end - start + stride - 1) / stride) : 0;
+    if (n <= 1)
+    {
+        stride = 1;
+    }
+
     /* Create the sequence to hold the slice */
     retval = list_new(&pslice);
     PM_RETURN_IF_ERROR(retval);
 
     /* Fill the slice */
-    for (i = start; i < end; i += stride)
-    {
-        retval = list_getItem(plist, i, &pitem);
-        PM_RETURN_IF_ERROR(retval);
-
-        heap_gcPushTempRoot(pslice, &objid);
-        retval = list_append(pslice, pitem);
-        heap_gcPopTempRoot(objid);
-        PM_RETURN_IF_ERROR(retval);
-    }
+    heap_gcPushTempRoot(pslice, &objid);
+    retval = list_appendSlice(pslice, plist, (int16_t)start, (int16_t)n,
+                              (int16_t)stride);
+    heap_gcPopTempRoot(objid);
+    PM_RETURN_IF_ERROR(retval);
 
     *r_pslice = pslice;
     return retval;
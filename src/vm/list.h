@@ -19,7 +19,8 @@
 /**
  * List obj
  *
- * Mutable ordered sequence of objects.  Contains ptr to linked list of nodes.
+ * Mutable ordered sequence of objects.  Contains ptr to a seglist,
+ * a growable array that holds the ptrs to the objects.
  */
 typedef struct PmList_s
 {
@@ -29,7 +30,7 @@ typedef struct PmList_s
     /** List length; number of objs linked */
     uint16_t length;
 
-    /** Ptr to linked list of nodes */
+    /** Ptr to seglist of items */
     pSeglist_t val;
 } PmList_t,
  *pPmList_t;
@@ -49,6 +50,20 @@ typedef struct PmList_s
  */
 PmReturn_t list_new(pPmObj_t *r_pobj);
 
+/**
+ * Allocates a new List object holding the n objects at ppobjs, in order.
+ *
+ * Builds the list's seglist in one pass instead of inserting the objects
+ * one at a time.  BUILD_LIST passes the objects on the operand stack.
+ *
+ * @param   ppobjs Ptr to the first of n contiguous object pointers
+ * @param   n Number of objects
+ * @param   r_pobj Return; addr of ptr to obj
+ * @return  Return status
+ */
+PmReturn_t list_newFromArray(pPmObj_t const *ppobjs, int16_t n,
+                             pPmObj_t *r_pobj);
+
 /**
  * Gets the object in the list at the index.
  *
@@ -147,6 +162,21 @@ PmReturn_t list_index(pPmObj_t plist, pPmObj_t pitem, uint16_t *r_index);
  */
 PmReturn_t list_delItem(pPmObj_t plist, int16_t index);
 
+/**
+ * Sorts the list in place, in ascending order of the items or of their
+ * keys.  The sort is stable: items with equal keys keep their order.
+ * It is a merge sort that takes O(n log n) compares and allocates only
+ * one buffer of n/2 items (and n/2 keys), before the first compare.
+ * If a compare fails, the list holds all its items in some order.
+ *
+ * @param   plist Ptr to list obj
+ * @param   pkeys Ptr to list of one key per item, which is sorted along
+ *          with the items, or C_NULL to order the items themselves
+ * @return  Return status; TypeError if two keys have no order (see
+ *          obj_order()), ValueError if there is not one key per item
+ */
+PmReturn_t list_sort(pPmObj_t plist, pPmObj_t pkeys);
+
 #ifdef HAVE_PRINT
 /**
  * Prints out a list. Uses obj_print() to print elements.
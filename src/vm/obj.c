@@ -126,6 +126,10 @@ obj_isFalse(pPmObj_t pobj)
             /* An empty string is false */
             return ((pPmString_t)pobj)->length == 0;
 
+        case OBJ_TYPE_SVW:
+            /* An empty string view is false */
+            return ((pPmStringView_t)pobj)->length == 0;
+
         case OBJ_TYPE_TUP:
             /* An empty tuple is false */
             return ((pPmTuple_t)pobj)->length == 0;
@@ -138,6 +142,16 @@ obj_isFalse(pPmObj_t pobj)
             /* An empty dict is false */
             return ((pPmDict_t)pobj)->length == 0;
 
+#ifdef HAVE_SET
+        case OBJ_TYPE_SET:
+            /* An empty set is false */
+            return SET_GET_LENGTH(pobj) == 0;
+#endif /* HAVE_SET */
+
+        case OBJ_TYPE_XRG:
+            /* An empty xrange is false */
+            return ((pPmXrange_t)pobj)->xr_length == 0;
+
         case OBJ_TYPE_BOOL:
             /* C int zero means false */
             return ((pPmBoolean_t) pobj)->val == 0;
@@ -158,6 +172,7 @@ obj_isIn(pPmObj_t pobj, pPmObj_t pitem)
 {
     PmReturn_t retval = PM_RET_NO;
     pPmObj_t ptestItem;
+    uint8_t const *pc;
     int16_t i;
     uint8_t c;
 
@@ -178,32 +193,34 @@ obj_isIn(pPmObj_t pobj, pPmObj_t pitem)
             break;
 
         case OBJ_TYPE_STR:
+        case OBJ_TYPE_SVW:
             /* Raise a TypeError if item is not a string */
-            if ((OBJ_GET_TYPE(pitem) != OBJ_TYPE_STR))
+            if (!STRING_IS_STRING(pitem))
             {
                 retval = PM_RET_EX_TYPE;
                 break;
             }
 
             /* Empty string is alway present */
-            if (((pPmString_t)pitem)->length == 0)
+            if (STRING_GET_LENGTH(pitem) == 0)
             {
                 retval = PM_RET_OK;
                 break;
             }
 
             /* Raise a ValueError if the string is more than 1 char */
-            else if (((pPmString_t)pitem)->length != 1)
+            else if (STRING_GET_LENGTH(pitem) != 1)
             {
                 retval = PM_RET_EX_VAL;
                 break;
             }
 
             /* Iterate over string to find char */
-            c = ((pPmString_t)pitem)->val[0];
-            for (i = 0; i < ((pPmString_t)pobj)->length; i++)
+            c = STRING_GET_VAL(pitem)[0];
+            pc = STRING_GET_VAL(pobj);
+            for (i = 0; i < STRING_GET_LENGTH(pobj); i++)
             {
-                if (c == ((pPmString_t)pobj)->val[i])
+                if (c == pc[i])
                 {
                     retval = PM_RET_OK;
                     break;
@@ -234,6 +251,33 @@ obj_isIn(pPmObj_t pobj, pPmObj_t pitem)
             }
             break;
 
+#ifdef HAVE_SET
+        case OBJ_TYPE_SET:
+            /* Look the item up among the set's members */
+            retval = set_isIn(pobj, pitem);
+            break;
+#endif /* HAVE_SET */
+
+        case OBJ_TYPE_XRG:
+        {
+            /* Compute which int of the xrange the item would be */
+            pPmXrange_t pxr = (pPmXrange_t)pobj;
+            int32_t offset;
+
+            if (OBJ_GET_TYPE(pitem) != OBJ_TYPE_INT)
+            {
+                break;
+            }
+            offset = ((pPmInt_t)pitem)->val - pxr->xr_start;
+            if (((offset % pxr->xr_step) == 0)
+                && ((offset / pxr->xr_step) >= 0)
+                && ((offset / pxr->xr_step) < pxr->xr_length))
+            {
+                retval = PM_RET_OK;
+            }
+            break;
+        }
+
         default:
             retval = PM_RET_EX_TYPE;
             break;
@@ -260,6 +304,12 @@ obj_compare(pPmObj_t pobj1, pPmObj_t pobj2)
         return C_SAME;
     }
 
+    /* A string view equals a string of the same contents */
+    if (STRING_IS_STRING(pobj1) && STRING_IS_STRING(pobj2))
+    {
+        return string_compare(pobj1, pobj2);
+    }
+
     /* If types are different, objs must differ */
     if (OBJ_GET_TYPE(pobj1) != OBJ_GET_TYPE(pobj2))
     {
@@ -312,9 +362,6 @@ obj_compare(pPmObj_t pobj1, pPmObj_t pobj2)
         }
 #endif /* HAVE_FLOAT */
 
-        case OBJ_TYPE_STR:
-            return string_compare((pPmString_t)pobj1, (pPmString_t)pobj2);
-
         case OBJ_TYPE_TUP:
         case OBJ_TYPE_LST:
 #ifdef HAVE_BYTEARRAY
@@ -325,6 +372,11 @@ obj_compare(pPmObj_t pobj1, pPmObj_t pobj2)
         case OBJ_TYPE_DIC:
             return dict_compare(pobj1, pobj2);
 
+#ifdef HAVE_SET
+        case OBJ_TYPE_SET:
+            return set_compare(pobj1, pobj2);
+#endif /* HAVE_SET */
+
         default:
             break;
     }
@@ -334,6 +386,176 @@ obj_compare(pPmObj_t pobj1, pPmObj_t pobj2)
 }
 
 
+PmReturn_t
+obj_order(pPmObj_t pobj1, pPmObj_t pobj2, int8_t *r_order)
+{
+    PmReturn_t retval = PM_RET_OK;
+    uint8_t const *pc1;
+    uint8_t const *pc2;
+    uint16_t len1;
+    uint16_t len2;
+    uint16_t i;
+#ifdef HAVE_FLOAT
+    float f1;
+    float f2;
+#endif /* HAVE_FLOAT */
+
+    /* Ints and bools order by value */
+    if (((OBJ_GET_TYPE(pobj1) == OBJ_TYPE_INT)
+         || (OBJ_GET_TYPE(pobj1) == OBJ_TYPE_BOOL))
+        && ((OBJ_GET_TYPE(pobj2) == OBJ_TYPE_INT)
+            || (OBJ_GET_TYPE(pobj2) == OBJ_TYPE_BOOL)))
+    {
+        *r_order = (((pPmInt_t)pobj1)->val < ((pPmInt_t)pobj2)->val) ? -1
+                 : (((pPmInt_t)pobj1)->val > ((pPmInt_t)pobj2)->val);
+        return retval;
+    }
+
+#ifdef HAVE_FLOAT
+    /* A float and an int (or bool) order as two floats */
+    if (((OBJ_GET_TYPE(pobj1) == OBJ_TYPE_FLT)
+         && ((OBJ_GET_TYPE(pobj2) == OBJ_TYPE_FLT)
+             || (OBJ_GET_TYPE(pobj2) == OBJ_TYPE_INT)
+             || (OBJ_GET_TYPE(pobj2) == OBJ_TYPE_BOOL)))
+        || ((OBJ_GET_TYPE(pobj2) == OBJ_TYPE_FLT)
+            && ((OBJ_GET_TYPE(pobj1) == OBJ_TYPE_INT)
+                || (OBJ_GET_TYPE(pobj1) == OBJ_TYPE_BOOL))))
+    {
+        f1 = (OBJ_GET_TYPE(pobj1) == OBJ_TYPE_FLT)
+            ? ((pPmFloat_t)pobj1)->val : (float)((pPmInt_t)pobj1)->val;
+        f2 = (OBJ_GET_TYPE(pobj2) == OBJ_TYPE_FLT)
+            ? ((pPmFloat_t)pobj2)->val : (float)((pPmInt_t)pobj2)->val;
+        *r_order = (f1 < f2) ? -1 : (f1 > f2);
+        return retval;
+    }
+#endif /* HAVE_FLOAT */
+
+    /* Strings order by their bytes, then by length */
+    if (STRING_IS_STRING(pobj1) && STRING_IS_STRING(pobj2))
+    {
+        pc1 = STRING_GET_VAL(pobj1);
+        pc2 = STRING_GET_VAL(pobj2);
+        len1 = STRING_GET_LENGTH(pobj1);
+        len2 = STRING_GET_LENGTH(pobj2);
+        for (i = 0; (i < len1) && (i < len2); i++)
+        {
+            if (pc1[i] != pc2[i])
+            {
+                *r_order = (pc1[i] < pc2[i]) ? -1 : 1;
+                return retval;
+            }
+        }
+        *r_order = (len1 < len2) ? -1 : (len1 > len2);
+        return retval;
+    }
+
+    /* Tuples order by their first unequal items, then by length */
+    if ((OBJ_GET_TYPE(pobj1) == OBJ_TYPE_TUP)
+        && (OBJ_GET_TYPE(pobj2) == OBJ_TYPE_TUP))
+    {
+        len1 = ((pPmTuple_t)pobj1)->length;
+        len2 = ((pPmTuple_t)pobj2)->length;
+        for (i = 0; (i < len1) && (i < len2); i++)
+        {
+            retval = obj_order(((pPmTuple_t)pobj1)->val[i],
+                               ((pPmTuple_t)pobj2)->val[i], r_order);
+            PM_RETURN_IF_ERROR(retval);
+            if (*r_order != 0)
+            {
+                return retval;
+            }
+        }
+        *r_order = (len1 < len2) ? -1 : (len1 > len2);
+        return retval;
+    }
+
+    /* Raise TypeError if the objects have no order */
+    PM_RAISE(retval, PM_RET_EX_TYPE);
+    return retval;
+}
+
+
+uint16_t
+obj_hash(pPmObj_t pobj)
+{
+    uint16_t hash;
+    int16_t i;
+    pPmObj_t pitem;
+
+#ifdef HAVE_FLOAT
+    union
+    {
+        float f;
+        uint32_t u;
+    } fltbits;
+#endif /* HAVE_FLOAT */
+
+    C_ASSERT(pobj != C_NULL);
+
+    switch (OBJ_GET_TYPE(pobj))
+    {
+        case OBJ_TYPE_NON:
+            return 0;
+
+        case OBJ_TYPE_INT:
+        case OBJ_TYPE_BOOL:
+            return (uint16_t)((uint32_t)((pPmInt_t)pobj)->val
+                              ^ ((uint32_t)((pPmInt_t)pobj)->val >> 16));
+
+#ifdef HAVE_FLOAT
+        case OBJ_TYPE_FLT:
+            /* Zero and negative zero are equal, so they must hash alike */
+            if (((pPmFloat_t)pobj)->val == 0.0)
+            {
+                return 0;
+            }
+            fltbits.f = ((pPmFloat_t)pobj)->val;
+            return (uint16_t)(fltbits.u ^ (fltbits.u >> 16));
+#endif /* HAVE_FLOAT */
+
+        case OBJ_TYPE_STR:
+        case OBJ_TYPE_SVW:
+            return string_hash(pobj);
+
+        case OBJ_TYPE_TUP:
+            /* Combine item hashes; a list or dict item hashes as its type */
+            hash = (uint16_t)((pPmTuple_t)pobj)->length;
+            for (i = 0; i < ((pPmTuple_t)pobj)->length; i++)
+            {
+                pitem = ((pPmTuple_t)pobj)->val[i];
+                hash = (hash << 5) + hash
+                    + ((OBJ_GET_TYPE(pitem) > OBJ_TYPE_HASHABLE_MAX)
+                       ? OBJ_GET_TYPE(pitem) : obj_hash(pitem));
+            }
+            return hash;
+
+#ifdef HAVE_SET
+        case OBJ_TYPE_SET:
+            /* Sets compare by their members, so they hash by them too */
+            return set_hash(pobj);
+#endif /* HAVE_SET */
+
+#ifdef HAVE_BYTEARRAY
+        case OBJ_TYPE_CLI:
+            /* An instance that wraps an object compares by that object */
+            if (dict_getItem((pPmObj_t)((pPmInstance_t)pobj)->cli_attrs,
+                             PM_NONE, &pitem) == PM_RET_OK)
+            {
+                return (OBJ_GET_TYPE(pitem) > OBJ_TYPE_HASHABLE_MAX)
+                    ? OBJ_GET_TYPE(pitem) : obj_hash(pitem);
+            }
+            break;
+#endif /* HAVE_BYTEARRAY */
+
+        default:
+            break;
+    }
+
+    /* All other types compare by identity, so hash the address */
+    return (uint16_t)((intptr_t)pobj >> 2);
+}
+
+
 #ifdef HAVE_PRINT
 PmReturn_t
 obj_print(pPmObj_t pobj, uint8_t is_expr_repr, uint8_t is_nested)
@@ -365,6 +587,7 @@ obj_print(pPmObj_t pobj, uint8_t is_expr_repr, uint8_t is_nested)
             break;
 #endif /* HAVE_FLOAT */
         case OBJ_TYPE_STR:
+        case OBJ_TYPE_SVW:
             retval = string_print(pobj, (is_expr_repr || is_nested));
             break;
         case OBJ_TYPE_TUP:
@@ -376,6 +599,14 @@ obj_print(pPmObj_t pobj, uint8_t is_expr_repr, uint8_t is_nested)
         case OBJ_TYPE_DIC:
             retval = dict_print(pobj);
             break;
+#ifdef HAVE_SET
+        case OBJ_TYPE_SET:
+            retval = set_print(pobj);
+            break;
+#endif /* HAVE_SET */
+        case OBJ_TYPE_XRG:
+            retval = xrange_print(pobj);
+            break;
         case OBJ_TYPE_BOOL:
             sli_puts(
                 (((pPmBoolean_t) pobj)->val == C_TRUE)
@@ -384,21 +615,31 @@ obj_print(pPmObj_t pobj, uint8_t is_expr_repr, uint8_t is_nested)
             break;
 
         case OBJ_TYPE_CLI:
-#ifdef HAVE_BYTEARRAY
+            /* A bytearray or array instance prints what it contains */
             {
                 pPmObj_t pobj2;
 
                 retval = dict_getItem((pPmObj_t)((pPmInstance_t)pobj)->cli_attrs,
                                       PM_NONE,
                                       (pPmObj_t *)&pobj2);
+#ifdef HAVE_BYTEARRAY
                 if ((retval == PM_RET_OK)
                     && (OBJ_GET_TYPE(pobj2) == OBJ_TYPE_BYA))
                 {
                     retval = bytearray_print(pobj2);
                     break;
                 }
-            }
 #endif /* HAVE_BYTEARRAY */
+#ifdef HAVE_ARRAY
+                if ((retval == PM_RET_OK)
+                    && (OBJ_GET_TYPE(pobj2) == OBJ_TYPE_BYS))
+                {
+                    retval = array_print(pobj2);
+                    break;
+                }
+#endif /* HAVE_ARRAY */
+                retval = PM_RET_OK;
+            }
 
         case OBJ_TYPE_COB:
         case OBJ_TYPE_MOD:
@@ -411,6 +652,9 @@ obj_print(pPmObj_t pobj, uint8_t is_expr_repr, uint8_t is_nested)
         case OBJ_TYPE_CIO:
         case OBJ_TYPE_MTH:
         case OBJ_TYPE_SQI:
+#ifdef HAVE_GENERATORS
+        case OBJ_TYPE_GEN:
+#endif /* HAVE_GENERATORS */
         {
             uint8_t buf[17];
             sli_puts((uint8_t *)"<obj type 0x");
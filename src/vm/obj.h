@@ -137,6 +137,9 @@ typedef enum PmType_e
     /** Thread */
     OBJ_TYPE_THR = 0x0D,
 
+    /** String view (a slice that shares its parent string's chars) */
+    OBJ_TYPE_SVW = 0x0E,
+
     /** Boolean object */
     OBJ_TYPE_BOOL = 0x0F,
 
@@ -160,11 +163,24 @@ typedef enum PmType_e
     OBJ_TYPE_BYA = 0x14,
 #endif /* HAVE_BYTEARRAY */
 
+#ifdef HAVE_GENERATORS
+    /** Generator-iterator (holds its frame) */
+    OBJ_TYPE_GEN = 0x15,
+#endif /* HAVE_GENERATORS */
+
+    /** Xrange (ints of an arithmetic sequence, computed on demand) */
+    OBJ_TYPE_XRG = 0x16,
+
+#ifdef HAVE_SET
+    /** Set or frozenset (members are the keys of a dict) */
+    OBJ_TYPE_SET = 0x17,
+#endif /* HAVE_SET */
+
     /* All types after this are not accessible to the user */
     OBJ_TYPE_ACCESSIBLE_MAX = 0x18,
 
 #ifdef HAVE_BYTEARRAY
-    /** Bytes (mutable container for Bytearray type) */
+    /** Bytes (mutable container for the bytearray and array types) */
     OBJ_TYPE_BYS = 0x18,
 #endif /* HAVE_BYTEARRAY */
 
@@ -185,6 +201,9 @@ typedef enum PmType_e
 
     /** Native frame (there is only one) */
     OBJ_TYPE_NFM = 0x1E,
+
+    /** Dict hash table (within a dict) */
+    OBJ_TYPE_DTB = 0x1F,
 } PmType_t, *pPmType_t;
 
 
@@ -300,6 +319,30 @@ PmReturn_t obj_isIn(pPmObj_t pobj, pPmObj_t pitem);
  */
 int8_t obj_compare(pPmObj_t pobj1, pPmObj_t pobj2);
 
+/**
+ * Finds the order of two objects, as the < and > operators would.
+ * Ints, bools and floats order by value, strings by their bytes and
+ * tuples by their items.
+ *
+ * @param   pobj1 Ptr to first object.
+ * @param   pobj2 Ptr to second object.
+ * @param   r_order Return; -1, 0 or 1 if pobj1 is less than, equal to
+ *          or greater than pobj2.
+ * @return  Return status; TypeError if the objects have no order.
+ */
+PmReturn_t obj_order(pPmObj_t pobj1, pPmObj_t pobj2, int8_t *r_order);
+
+/**
+ * Returns the hash of a hashable object.
+ *
+ * Objects that obj_compare() finds equivalent have the same hash.
+ * Objects that compare by identity hash their address.
+ *
+ * @param   pobj Ptr to object to hash.
+ * @return  The object's hash.
+ */
+uint16_t obj_hash(pPmObj_t pobj);
+
 /**
  * Print an object, thereby using objects helpers.
  *
@@ -66,4 +66,32 @@ PmReturn_t plat_getMsTicks(uint32_t *r_ticks);
  */
 void plat_reportError(PmReturn_t result);
 
+/**
+ * Waits, ideally in a low-power state, until pm_timerMsTicks reaches until
+ * (or something else needs the VM's attention).  May return early.
+ * Only required when plat.h defines PM_PLAT_HAS_IDLE to 1.
+ */
+void plat_idle(uint32_t until);
+
+#ifdef HAVE_OPSTATS
+/**
+ * Returns a free-running count of CPU cycles (or of the finest timer
+ * available).  The count may wrap; only differences are used.
+ * Only required when plat.h defines PM_PLAT_HAS_CYCLES to 1.
+ */
+uint32_t plat_getCycles(void);
+#endif /* HAVE_OPSTATS */
+
+#ifdef HAVE_JIT
+/**
+ * Maps size bytes of memory that is writable and executable,
+ * for the machine code compiled by the JIT.
+ * Only required when plat.h defines PM_PLAT_HAS_JIT to 1.
+ *
+ * @param size Number of bytes to map
+ * @return Address of the memory, or C_NULL if it cannot be mapped
+ */
+uint8_t *plat_jitMap(uint32_t size);
+#endif /* HAVE_JIT */
+
 #endif /* __PLAT_H__ */
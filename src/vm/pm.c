@@ -26,10 +26,10 @@
 
 
 /** Stores the timer millisecond-ticks since system start */
-volatile uint32_t pm_timerMsTicks = 0;
+PM_PLAT_TLS volatile uint32_t pm_timerMsTicks = 0;
 
 /** Stores tick timestamp of last scheduler run */
-volatile uint32_t pm_lastRescheduleTimestamp = 0;
+PM_PLAT_TLS volatile uint32_t pm_lastRescheduleTimestamp = 0;
 
 
 PmReturn_t
@@ -49,6 +49,11 @@ pm_init(uint8_t *heap_base, uint32_t heap_size,
     retval = global_init();
     PM_RETURN_IF_ERROR(retval);
 
+#ifdef HAVE_JIT
+    /* Discard code compiled for a previous VM on this OS thread */
+    jit_init();
+#endif /* HAVE_JIT */
+
     /* Load usr image info if given */
     if (pusrimg != C_NULL)
     {
@@ -87,6 +92,10 @@ pm_run(uint8_t const *modstr)
     heap_gcPopTempRoot(objid1);
     retval = interpret(INTERP_RETURN_ON_NO_THREADS);
 
+#ifdef HAVE_OPSTATS
+    interp_printOpStats();
+#endif /* HAVE_OPSTATS */
+
     /*
      * De-initialize the hardware platform.
      * Ignore plat_deinit's retval so interpret's retval returns to caller.
@@ -106,7 +115,7 @@ pm_vmPeriodic(uint16_t usecsSinceLastCall)
      * microseconds for the next run. Thus, usecsSinceLastCall must be
      * less than 2^16-1000 so it will not overflow usecResidual.
      */
-    static uint16_t usecResidual = 0;
+    static PM_PLAT_TLS uint16_t usecResidual = 0;
 
     C_ASSERT(usecsSinceLastCall < 64536);
 
@@ -117,12 +126,27 @@ pm_vmPeriodic(uint16_t usecsSinceLastCall)
         pm_timerMsTicks++;
     }
 
+#ifdef HAVE_PROFILER
+    prof_sample();
+#endif /* HAVE_PROFILER */
+
     /* Check if enough time has passed for a scheduler run */
-    if ((pm_timerMsTicks - pm_lastRescheduleTimestamp)
-        >= PM_THREAD_TIMESLICE_MS)
+    if (((pm_timerMsTicks - pm_lastRescheduleTimestamp)
+         >= PM_THREAD_TIMESLICE_MS)
+#ifdef HAVE_BUDGET_SCHED
+        && gVmGlobal.budgetTimed
+#endif /* HAVE_BUDGET_SCHED */
+        )
     {
         interp_setRescheduleFlag((uint8_t)1);
         pm_lastRescheduleTimestamp = pm_timerMsTicks;
     }
+
+    /* Wake the first sleeping thread on time */
+    else if ((gVmGlobal.threadSleep != C_NULL)
+             && ((int32_t)(pm_timerMsTicks - gVmGlobal.threadWakeMs) >= 0))
+    {
+        interp_setRescheduleFlag((uint8_t)1);
+    }
     return PM_RET_OK;
 }
@@ -183,16 +183,15 @@ typedef enum PmReturn_e
     PM_RET_EX_STOP = 0xEF,      /**< Stop iteration */
     PM_RET_EX_WARN = 0xF0,      /**< Warning */
     PM_RET_EX_OFLOW = 0xF1,     /**< Overflow */
+    PM_RET_EX_RUNTIME = 0xF2,   /**< Runtime error */
 } PmReturn_t;
 
 
-extern volatile uint32_t pm_timerMsTicks;
-
-
 /* WARNING: The order of the following includes is critical */
 #include "plat.h"
 #include "pmfeatures.h"
 #include "pmEmptyPlatformDefs.h"
+#include "pmFeatureDependencies.h"
 #include "sli.h"
 #include "mem.h"
 #include "obj.h"
@@ -204,6 +203,7 @@ extern volatile uint32_t pm_timerMsTicks;
 #include "seglist.h"
 #include "list.h"
 #include "dict.h"
+#include "set.h"
 #include "codeobj.h"
 #include "func.h"
 #include "module.h"
@@ -216,6 +216,12 @@ extern volatile uint32_t pm_timerMsTicks;
 #include "float.h"
 #include "plat_interface.h"
 #include "bytearray.h"
+#include "array.h"
+#include "prof.h"
+#include "jit.h"
+
+
+extern PM_PLAT_TLS volatile uint32_t pm_timerMsTicks;
 
 
 /** Pointer to a native function used for lookup tables in interp.c */
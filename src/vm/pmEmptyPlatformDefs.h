@@ -28,4 +28,52 @@
 #define PM_PLAT_HEAP_ATTR
 #endif
 
+/**
+ * Define as 1 if MEMSPACE_PROG can be read with an ordinary pointer
+ * dereference (as on the desktop and other von Neumann targets).
+ * The interpreter then fetches bytecodes from program memory inline
+ * rather than calling plat_memGetByte() for every byte.
+ * If not defined, program memory is only accessed through the platform.
+ */
+#if !defined(PM_PLAT_PROGMEM_DIRECT) || defined(__DOXYGEN__)
+#define PM_PLAT_PROGMEM_DIRECT 0
+#endif
+
+/**
+ * Define a storage class specifier for the VM's global state.
+ * Define it as a thread-local specifier (such as __thread) to run
+ * independent VMs in parallel, one per OS thread of a process: each thread
+ * calls pm_init() and pm_run() with its own heap, and the platform must
+ * call pm_vmPeriodic() on each VM thread.
+ * If not defined, make it empty (there is only one VM).
+ */
+#if !defined(PM_PLAT_TLS) || defined(__DOXYGEN__)
+#define PM_PLAT_TLS
+#endif
+
+/**
+ * Define as 1 if the platform implements plat_idle().
+ * When every thread is asleep, the interpreter then calls plat_idle()
+ * instead of polling the timer in a busy loop.
+ */
+#if !defined(PM_PLAT_HAS_IDLE) || defined(__DOXYGEN__)
+#define PM_PLAT_HAS_IDLE 0
+#endif
+
+/**
+ * Define as 1 if the platform implements plat_getCycles().
+ * HAVE_OPSTATS may only be defined on such a platform.
+ */
+#if !defined(PM_PLAT_HAS_CYCLES) || defined(__DOXYGEN__)
+#define PM_PLAT_HAS_CYCLES 0
+#endif
+
+/**
+ * Define as 1 if the platform is x86-64 and implements plat_jitMap().
+ * HAVE_JIT may only be defined on such a platform.
+ */
+#if !defined(PM_PLAT_HAS_JIT) || defined(__DOXYGEN__)
+#define PM_PLAT_HAS_JIT 0
+#endif
+
 #endif /* __PM_EMPTY_PLATFORM_DEFS_H__ */
@@ -132,11 +132,27 @@
  * --------------
  *
  * When defined, the code to support the bytearray type is included in the
- * build.  NOTE: If this is defined, the bytearray class in src/lib/__bi.py
- * must also be uncommented.
+ * build.  Without it, the methods of the bytearray class in src/lib/__bi.py
+ * raise SystemError.
  * Issue #289 Create bytearray datatype
  *
  *
+ * HAVE_SET
+ * --------
+ *
+ * When defined, the code to support the set and frozenset types is included
+ * in the build, as is the sets module of their methods.  Without it, set()
+ * and frozenset() raise SystemError.
+ *
+ *
+ * HAVE_ARRAY
+ * ----------
+ *
+ * When defined, the code to support typed numeric arrays is included in the
+ * build, as is the array module.  An array's items are held in the bytes
+ * container of the bytearray type, so HAVE_ARRAY requires HAVE_BYTEARRAY.
+ *
+ *
  * HAVE_DEBUG_INFO
  * ---------------
  *
@@ -157,6 +173,54 @@
  *
  *      printf "Number = %4d" % someNumber
  *      pirntf "PI approx = %1.2" % 3.1415
+ *
+ *
+ * HAVE_OPSTATS
+ * ------------
+ *
+ * When defined, interpret() counts how often each bytecode is dispatched,
+ * accumulates the cycles spent in each (using plat_getCycles()) and counts
+ * the timeslices ended by interpret().  The statistics are
+ * available from sys.opstats() and are printed as a table when pm_run()
+ * returns.  This slows the interpreter down, so it is meant for profiling;
+ * when undefined none of this code is compiled.
+ * REQUIRES the platform to define PM_PLAT_HAS_CYCLES to 1 in plat.h and to
+ * implement plat_getCycles()
+ *
+ *
+ * HAVE_PROFILER
+ * -------------
+ *
+ * When defined, the sampling profiler is included in the build.  While it is
+ * enabled by sys.profile(), each call to pm_vmPeriodic() records the running
+ * thread's frame chain; sys.profdump() prints the samples as a flat profile,
+ * a call tree or collapsed stacks for flamegraph tools.
+ * The profiler resolves line numbers, so it needs HAVE_DEBUG_INFO.
+ *
+ *
+ * HAVE_BUDGET_SCHED
+ * -----------------
+ *
+ * When defined, interpret() no longer reads the volatile reschedule flag
+ * before every bytecode.  Instead each thread gets a budget of backward jumps
+ * and calls (PM_THREAD_BUDGET by default) each time it is scheduled; the
+ * budget and the reschedule flag are checked only at those points, so the
+ * timer merely ends a timeslice early.  sys.budget() sets the budget and
+ * can turn the timer off, which makes thread interleaving deterministic.
+ *
+ *
+ * HAVE_JIT
+ * --------
+ *
+ * When defined, a code object whose backward jumps reach PM_JIT_THRESHOLD
+ * is compiled to machine code by stitching together a template for each
+ * bytecode (see jit.h).  Loops of local variable, int and comparison
+ * bytecodes then run without dispatch; other bytecodes, type mismatches and
+ * exceptions return to interpret().  With HAVE_OPSTATS the time spent in
+ * compiled code is charged to the jump that entered it, and the profiler
+ * sees such a frame at the head of its loop.
+ * REQUIRES the platform to define PM_PLAT_HAS_JIT to 1 in plat.h and to
+ * implement plat_jitMap()
  */
 
 /* Check for dependencies */
@@ -180,6 +244,24 @@
 #error HAVE_BYTEARRAY requires HAVE_CLASSES
 #endif
 
+#if defined(HAVE_ARRAY) && !defined(HAVE_BYTEARRAY)
+#error HAVE_ARRAY requires HAVE_BYTEARRAY
+#endif
+
 #if defined(HAVE_SNPRINTF_FORMAT) && !defined(HAVE_STRING_FORMAT)
 #error HAVE_SNPRINTF_FORMAT requires HAVE_STRING_FORMAT
+#endif
+
+#if defined(HAVE_OPSTATS) && !PM_PLAT_HAS_CYCLES
+#error HAVE_OPSTATS requires a platform that defines PM_PLAT_HAS_CYCLES
+#endif
+
+#if defined(HAVE_PROFILER) && !defined(HAVE_DEBUG_INFO)
+#error HAVE_PROFILER requires HAVE_DEBUG_INFO
+#endif
+
+#if defined(HAVE_JIT) && !PM_PLAT_HAS_JIT
+#error HAVE_JIT requires a platform that defines PM_PLAT_HAS_JIT
+#endif
+
 #endif /* __PM_EMPTY_PM_FEATURES_H__ */
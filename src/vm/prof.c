@@ -0,0 +1,457 @@
+/*
+# This file is Copyright 2013 Dean Hall.
+# This file is part of the PyMite VM.
+# This file is licensed under the MIT License.
+# See the LICENSE file for details.
+*/
+
+
+#undef __FILE_ID__
+#define __FILE_ID__ 0x1A
+
+
+/**
+ * \file
+ * \brief Sampling Profiler
+ *
+ * Timer driven sampling of the running thread's frame chain.
+ */
+
+
+#include "pm.h"
+
+
+#ifdef HAVE_PROFILER
+
+/** One sample of a frame chain; innermost frame first */
+typedef struct PmProfSample_s
+{
+    /** Number of frames recorded */
+    uint8_t depth;
+
+    /** Code object of each frame */
+    pPmCo_t co[PROF_MAX_DEPTH];
+
+    /** Offset of each frame's instruction pointer into its bytecode */
+    uint16_t ip[PROF_MAX_DEPTH];
+} PmProfSample_t,
+ *pPmProfSample_t;
+
+/** One unique call stack of the profile; innermost frame first */
+typedef struct PmProfStack_s
+{
+    /** Number of frames; zero marks an unused entry */
+    uint8_t depth;
+
+    /** Code object of each frame */
+    pPmCo_t co[PROF_MAX_DEPTH];
+
+    /** Source line of each frame */
+    uint16_t line[PROF_MAX_DEPTH];
+
+    /** Number of samples of this call stack */
+    uint32_t count;
+} PmProfStack_t,
+ *pPmProfStack_t;
+
+
+/** Sampling is on when true */
+static PM_PLAT_TLS volatile uint8_t profEnabled = C_FALSE;
+
+/*
+ * Lock-free single producer (timer tick), single consumer (VM) ring.
+ * Only prof_sample() writes profHead and only prof_drain() writes profTail.
+ */
+static PM_PLAT_TLS PmProfSample_t profRing[PROF_RING_SIZE];
+static PM_PLAT_TLS volatile uint16_t profHead = 0;
+static PM_PLAT_TLS volatile uint16_t profTail = 0;
+
+/** Samples lost because the ring was full */
+static PM_PLAT_TLS volatile uint32_t profDropped = 0;
+
+/** Unique call stacks and the samples that did not fit in the table */
+static PM_PLAT_TLS PmProfStack_t profStacks[PROF_MAX_STACKS];
+static PM_PLAT_TLS uint8_t profNumStacks = 0;
+static PM_PLAT_TLS uint32_t profOverflow = 0;
+
+
+/* Returns the source line of the bytecode at offset ip in the code object */
+static uint16_t
+prof_getLine(pPmCo_t pco, uint16_t ip)
+{
+    uint8_t const *plnotab = pco->co_lnotab;
+    uint16_t len_lnotab;
+    uint16_t bcsum = 0;
+    uint16_t linesum = pco->co_firstlineno;
+    uint16_t i;
+
+    /*
+     * The IP points past the sampled bytecode, so find the last line entry
+     * that starts before it.  Algorithm is the same as in lnotab_notes.txt
+     */
+    len_lnotab = mem_getWord(pco->co_memspace, &plnotab);
+    for (i = 0; i < len_lnotab; i += 2)
+    {
+        bcsum += mem_getByte(pco->co_memspace, &plnotab);
+        if (bcsum >= ip)
+        {
+            break;
+        }
+        linesum += mem_getByte(pco->co_memspace, &plnotab);
+    }
+    return linesum;
+}
+
+
+/* Prints a frame as file:func:line */
+static PmReturn_t
+prof_printFrame(pPmCo_t pco, uint16_t line)
+{
+    PmReturn_t retval;
+    pPmObj_t pstr;
+    uint8_t const *pfn = pco->co_filename;
+    uint8_t buf[12];
+    uint8_t c;
+
+    while ((c = mem_getByte(pco->co_memspace, &pfn)) != '\0')
+    {
+        plat_putByte(c);
+    }
+    plat_putByte(':');
+
+    /* The last name in the names tuple of the code obj is the name */
+    retval = tuple_getItem((pPmObj_t)pco->co_names, -1, &pstr);
+    PM_RETURN_IF_ERROR(retval);
+    sli_puts(((pPmString_t)pstr)->val);
+    plat_putByte(':');
+
+    retval = sli_ltoa10(line, buf, sizeof(buf));
+    sli_puts(buf);
+    return retval;
+}
+
+
+/* Prints count right-aligned in 8 columns */
+static void
+prof_printCount(uint32_t count)
+{
+    uint8_t buf[12];
+    int8_t len;
+
+    sli_ltoa10((int32_t)count, buf, sizeof(buf));
+    for (len = (int8_t)sli_strlen((char const *)buf); len < 8; len++)
+    {
+        plat_putByte(' ');
+    }
+    sli_puts(buf);
+    plat_putByte(' ');
+}
+
+
+/*
+ * Prints the call tree of the stacks in pidx, which share their outermost
+ * level frames, as one line per distinct frame at that level.
+ */
+static PmReturn_t
+prof_printTree(uint8_t const *pidx, uint8_t n, uint8_t level)
+{
+    PmReturn_t retval = PM_RET_OK;
+    uint8_t group[PROF_MAX_STACKS];
+    uint8_t done[PROF_MAX_STACKS];
+    uint8_t ngroup;
+    uint8_t i;
+    uint8_t j;
+    uint8_t k;
+    pPmProfStack_t ps;
+    pPmProfStack_t pt;
+    uint32_t count;
+
+    sli_memset(done, 0, n);
+    for (i = 0; i < n; i++)
+    {
+        ps = &profStacks[pidx[i]];
+        if (done[i] || (ps->depth <= level))
+        {
+            continue;
+        }
+
+        /* Collect the stacks that have the same frame at this level */
+        ngroup = 0;
+        count = 0;
+        for (j = i; j < n; j++)
+        {
+            pt = &profStacks[pidx[j]];
+            if (!done[j] && (pt->depth > level)
+                && (pt->co[pt->depth - 1 - level]
+                    == ps->co[ps->depth - 1 - level])
+                && (pt->line[pt->depth - 1 - level]
+                    == ps->line[ps->depth - 1 - level]))
+            {
+                done[j] = C_TRUE;
+                group[ngroup++] = pidx[j];
+                count += pt->count;
+            }
+        }
+
+        prof_printCount(count);
+        for (k = 0; k < level; k++)
+        {
+            sli_puts((uint8_t *)"  ");
+        }
+        retval = prof_printFrame(ps->co[ps->depth - 1 - level],
+                                 ps->line[ps->depth - 1 - level]);
+        PM_RETURN_IF_ERROR(retval);
+        plat_putByte('\n');
+
+        retval = prof_printTree(group, ngroup, level + 1);
+        PM_RETURN_IF_ERROR(retval);
+    }
+    return retval;
+}
+
+
+void
+prof_enable(uint8_t enable)
+{
+    if (enable)
+    {
+        /* Discard the old profile; stop sampling while doing so */
+        profEnabled = C_FALSE;
+        profTail = profHead;
+        sli_memset((uint8_t *)profStacks, 0, sizeof(profStacks));
+        profNumStacks = 0;
+        profOverflow = 0;
+        profDropped = 0;
+        profEnabled = C_TRUE;
+    }
+    else
+    {
+        profEnabled = C_FALSE;
+        prof_drain();
+    }
+}
+
+
+/* Warning: Can be called in interrupt context! */
+void
+prof_sample(void)
+{
+    pPmFrame_t pframe;
+    pPmProfSample_t psample;
+    uint16_t head;
+    uint8_t depth = 0;
+
+    if (!profEnabled || (gVmGlobal.pthread == C_NULL))
+    {
+        return;
+    }
+
+    /* Drop the sample if the ring is full */
+    head = profHead;
+    if ((uint16_t)(head - profTail) >= PROF_RING_SIZE)
+    {
+        profDropped++;
+        return;
+    }
+
+    /* Record the frame chain, innermost first */
+    psample = &profRing[head & (PROF_RING_SIZE - 1)];
+    for (pframe = gVmGlobal.pthread->pframe;
+         (pframe != C_NULL) && (depth < PROF_MAX_DEPTH);
+         pframe = pframe->fo_back)
+    {
+        psample->co[depth] = pframe->fo_func->f_co;
+        psample->ip[depth] =
+            (uint16_t)(pframe->fo_ip - pframe->fo_func->f_co->co_codeaddr);
+        depth++;
+    }
+    psample->depth = depth;
+
+    /* Publish the sample only after it is complete */
+    if (depth > 0)
+    {
+        profHead = head + 1;
+    }
+}
+
+
+void
+prof_drain(void)
+{
+    pPmProfSample_t psample;
+    pPmProfStack_t ps;
+    uint16_t line[PROF_MAX_DEPTH];
+    uint8_t i;
+    uint8_t d;
+
+    while (profTail != profHead)
+    {
+        psample = &profRing[profTail & (PROF_RING_SIZE - 1)];
+        for (d = 0; d < psample->depth; d++)
+        {
+            line[d] = prof_getLine(psample->co[d], psample->ip[d]);
+        }
+
+        /* Count the sample in its stack entry */
+        for (i = 0; i < profNumStacks; i++)
+        {
+            ps = &profStacks[i];
+            if (ps->depth != psample->depth)
+            {
+                continue;
+            }
+            for (d = 0; d < ps->depth; d++)
+            {
+                if ((ps->co[d] != psample->co[d]) || (ps->line[d] != line[d]))
+                {
+                    break;
+                }
+            }
+            if (d == ps->depth)
+            {
+                ps->count++;
+                break;
+            }
+        }
+
+        /* Or create its entry if there is room */
+        if (i == profNumStacks)
+        {
+            if (profNumStacks < PROF_MAX_STACKS)
+            {
+                ps = &profStacks[profNumStacks++];
+                ps->depth = psample->depth;
+                for (d = 0; d < psample->depth; d++)
+                {
+                    ps->co[d] = psample->co[d];
+                    ps->line[d] = line[d];
+                }
+                ps->count = 1;
+            }
+            else
+            {
+                profOverflow++;
+            }
+        }
+
+        profTail++;
+    }
+}
+
+
+uint8_t
+prof_getNumStacks(void)
+{
+    return profNumStacks;
+}
+
+
+pPmCo_t
+prof_getCo(uint16_t n)
+{
+    pPmProfStack_t ps = &profStacks[n / PROF_MAX_DEPTH];
+
+    return ((n % PROF_MAX_DEPTH) < ps->depth)
+           ? ps->co[n % PROF_MAX_DEPTH] : C_NULL;
+}
+
+
+PmReturn_t
+prof_print(uint8_t fmt)
+{
+    PmReturn_t retval = PM_RET_OK;
+    uint8_t idx[PROF_MAX_STACKS];
+    uint32_t self[PROF_MAX_STACKS];
+    uint8_t buf[12];
+    pPmProfStack_t ps;
+    uint8_t n;
+    uint8_t i;
+    uint8_t j;
+    int8_t d;
+
+    prof_drain();
+    for (n = 0; n < profNumStacks; n++)
+    {
+        idx[n] = n;
+    }
+
+    switch (fmt)
+    {
+        case PROF_FMT_FLAT:
+            /* Sum the self samples of stacks with the same innermost line */
+            for (i = 0; i < n; i++)
+            {
+                self[i] = profStacks[i].count;
+                for (j = 0; j < i; j++)
+                {
+                    if ((self[j] != 0)
+                        && (profStacks[j].co[0] == profStacks[i].co[0])
+                        && (profStacks[j].line[0] == profStacks[i].line[0]))
+                    {
+                        self[j] += self[i];
+                        self[i] = 0;
+                        break;
+                    }
+                }
+            }
+
+            /* Print the lines by descending sample count */
+            for (;;)
+            {
+                j = n;
+                for (i = 0; i < n; i++)
+                {
+                    if ((self[i] != 0) && ((j == n) || (self[i] > self[j])))
+                    {
+                        j = i;
+                    }
+                }
+                if (j == n)
+                {
+                    break;
+                }
+                prof_printCount(self[j]);
+                retval = prof_printFrame(profStacks[j].co[0],
+                                         profStacks[j].line[0]);
+                PM_RETURN_IF_ERROR(retval);
+                plat_putByte('\n');
+                self[j] = 0;
+            }
+
+            /* Report the samples that are not in the profile */
+            if ((profDropped + profOverflow) != 0)
+            {
+                prof_printCount(profDropped + profOverflow);
+                sli_puts((uint8_t *)"<lost>\n");
+            }
+            break;
+
+        case PROF_FMT_TREE:
+            retval = prof_printTree(idx, n, 0);
+            break;
+
+        case PROF_FMT_COLLAPSED:
+            /* One line per stack, outermost frame first */
+            for (i = 0; i < n; i++)
+            {
+                ps = &profStacks[i];
+                for (d = ps->depth - 1; d >= 0; d--)
+                {
+                    retval = prof_printFrame(ps->co[d], ps->line[d]);
+                    PM_RETURN_IF_ERROR(retval);
+                    plat_putByte((d > 0) ? ';' : ' ');
+                }
+                sli_ltoa10((int32_t)ps->count, buf, sizeof(buf));
+                sli_puts(buf);
+                plat_putByte('\n');
+            }
+            break;
+
+        default:
+            PM_RAISE(retval, PM_RET_EX_VAL);
+            break;
+    }
+    return retval;
+}
+
+#endif /* HAVE_PROFILER */
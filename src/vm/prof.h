@@ -0,0 +1,100 @@
+/*
+# This file is Copyright 2013 Dean Hall.
+# This file is part of the PyMite VM.
+# This file is licensed under the MIT License.
+# See the LICENSE file for details.
+*/
+
+
+#ifndef __PROF_H__
+#define __PROF_H__
+
+
+/**
+ * \file
+ * \brief Sampling Profiler
+ *
+ * Samples the running thread's frame chain from the timer tick
+ * (pm_vmPeriodic) into a ring buffer.  The VM drains the ring into a
+ * table of unique call stacks, with line numbers resolved from co_lnotab,
+ * which is printed as a flat profile, a call tree or collapsed stacks.
+ */
+
+
+#ifdef HAVE_PROFILER
+
+/** Number of samples the ring buffer holds (must be a power of 2) */
+#ifndef PROF_RING_SIZE
+#define PROF_RING_SIZE 64
+#endif
+
+/** Maximum number of frames recorded per sample */
+#ifndef PROF_MAX_DEPTH
+#define PROF_MAX_DEPTH 8
+#endif
+
+/** Maximum number of unique call stacks in the profile (at most 255) */
+#ifndef PROF_MAX_STACKS
+#define PROF_MAX_STACKS 128
+#endif
+
+/** prof_print() formats */
+#define PROF_FMT_FLAT       0
+#define PROF_FMT_TREE       1
+#define PROF_FMT_COLLAPSED  2
+
+
+/**
+ * Enables or disables sampling.  Enabling discards any previous profile.
+ *
+ * @param enable Sample on each timer tick if true
+ */
+void prof_enable(uint8_t enable);
+
+/**
+ * Records the running thread's code objects and instruction offsets
+ * in the ring buffer, if sampling is enabled.
+ * Called from pm_vmPeriodic(), so it may run in interrupt context;
+ * it neither allocates nor blocks.  A sample is dropped if the ring is full.
+ */
+void prof_sample(void);
+
+/**
+ * Moves the samples in the ring buffer into the profile.
+ * Must be called in VM context, at least once per ring's worth of ticks
+ * and before the GC runs, so the sampled code objects are still alive.
+ */
+void prof_drain(void);
+
+/**
+ * Returns the number of call stacks in the profile.  They fill the
+ * first entries of the table, so the GC only looks at the code objects
+ * of that many stacks.
+ *
+ * @return Number of call stacks
+ */
+uint8_t prof_getNumStacks(void);
+
+/**
+ * Returns the nth code object referenced by the profile so the GC
+ * can mark it; C_NULL if that slot is unused.
+ *
+ * @param n Index less than PROF_MAX_STACKS * PROF_MAX_DEPTH
+ * @return Code object or C_NULL
+ */
+pPmCo_t prof_getCo(uint16_t n);
+
+/**
+ * Prints the profile.
+ *
+ * @param fmt PROF_FMT_FLAT for self samples per line,
+ *            PROF_FMT_TREE for an indented call tree of inclusive samples,
+ *            PROF_FMT_COLLAPSED for one "frame;frame;frame count" line
+ *            per call stack (the input format of flamegraph tools)
+ * @return Return status
+ */
+PmReturn_t prof_print(uint8_t fmt);
+
+#endif /* HAVE_PROFILER */
+
+#endif /* __PROF_H__ */
@@ -14,29 +14,19 @@
  * \file
  * \brief Segmented list data type and operations
  *
- * The segmented list is used to implement the Python
- * List and Dict data types.
- * The segmented list is used in preference to the linked list
- * in order to reduce the memory overhead.
+ * The segmented list is used to implement the Python List data type.
+ * A seglist is a growable array of ptrs to objects, so getting and setting
+ * an item is O(1) and appending is O(1) amortized.
  *
- * Unused slots in the segments are expected to contain C_NULL.
+ * Each segment's capacity doubles as it fills, from SEGLIST_MIN_OBJS
+ * (or the size of a bulk append) up to SEGLIST_OBJS_PER_SEG.  A short seglist has one segment.
+ * Once that is full, the root segment becomes a directory of ptrs to the
+ * segments, which also doubles as it fills.  All segments but the last are
+ * full-size.  The full-size segment and the directory each fit in a heap
+ * chunk.
  *
- * List implementation:
- * When used in a List, the Seglist.currseg field points
- * to the last segment in the list.
- * The function seglist_appendItem() should be used to append
- * items to the List.
- * Inserting and deleting List items is a more complicated
- * matter.
- *
- * Dict implementation:
- * The currseg field is meaningless since rootseg always
- * points to the current active segment.
- * The function seglist_pushItem() should be used to put
- * items in the Dict.
- * A Dict uses one Seglist for keys and another for values.
- * A Dict entry's (key, value) pair share the same index in
- * the Seglist.
+ * Inserting and removing items moves the items after the index
+ * with sli_memmove(), one segment at a time.
  */
 
 
@@ -50,35 +40,233 @@
  */
 #define SEGLIST_CLEAR_SEGMENTS 1
 
+/** The size in bytes of a segment that holds n ptrs */
+#define SEGLIST_SEG_SIZE(n) \
+    (sizeof(Segment_t) + ((n) - 1) * sizeof(pPmObj_t))
+
+/**
+ * The most segment ptrs a directory can hold.  It is limited by the size of
+ * a heap chunk and by the seglist's capacity fitting in an int16_t.
+ */
+#define SEGLIST_DIR_MAX \
+    ((((HEAP_MAX_LIVE_CHUNK_SIZE - sizeof(Segment_t)) / sizeof(pPmObj_t) + 1) \
+      < (0x7FFF >> SEGLIST_SEG_SHIFT)) \
+     ? (int16_t)((HEAP_MAX_LIVE_CHUNK_SIZE - sizeof(Segment_t)) \
+                 / sizeof(pPmObj_t) + 1) \
+     : (int16_t)(0x7FFF >> SEGLIST_SEG_SHIFT))
+
+
+/*
+ * Allocates a segment that holds n ptrs.
+ * Copies the first ncopy ptrs from psrc if it is not C_NULL.
+ */
+static PmReturn_t
+seglist_newSeg(int16_t n, pSegment_t psrc, int16_t ncopy, pSegment_t *r_pseg)
+{
+    PmReturn_t retval;
+    uint8_t *pchunk;
+
+    retval = heap_getChunk(SEGLIST_SEG_SIZE(n), &pchunk);
+    PM_RETURN_IF_ERROR(retval);
+    *r_pseg = (pSegment_t)pchunk;
+    OBJ_SET_TYPE(*r_pseg, OBJ_TYPE_SEG);
+
+    if (psrc != C_NULL)
+    {
+        sli_memcpy((unsigned char *)(*r_pseg)->s_val,
+                   (unsigned char *)psrc->s_val, ncopy * sizeof(pPmObj_t));
+    }
+    return retval;
+}
+
+
+/*
+ * Makes room for at least n objects in the seglist.
+ * The last segment doubles in capacity until it is full-size;
+ * then a segment is added to the directory, which doubles as it fills.
+ * A segment grows straight to the size needed if that is more than double,
+ * so appending many objects at once allocates only what they need.
+ * The seglist must be reachable by the GC.  A new segment or directory
+ * is linked in before the next allocation, so the GC never sees one
+ * that is only partly set up.
+ */
+static PmReturn_t
+seglist_grow(pSeglist_t pseglist, int32_t n)
+{
+    PmReturn_t retval = PM_RET_OK;
+    pSegment_t pseg;
+    pSegment_t *ppslot;
+    int16_t base;
+    int16_t lastcap;
+    int16_t capacity;
+    int16_t nsegs;
+
+    /* Raise a MemoryError if the directory can not hold enough segments */
+    if (n > ((int32_t)SEGLIST_DIR_MAX << SEGLIST_SEG_SHIFT))
+    {
+        PM_RAISE(retval, PM_RET_EX_MEM);
+        return retval;
+    }
+
+    while (pseglist->sl_capacity < n)
+    {
+        /* All segments before the last one are full-size */
+        lastcap = pseglist->sl_capacity & (SEGLIST_OBJS_PER_SEG - 1);
+        base = pseglist->sl_capacity - lastcap;
+        nsegs = base >> SEGLIST_SEG_SHIFT;
+
+        /* If the last segment is full (or there is none), add a segment */
+        if (lastcap == 0)
+        {
+            if ((pseglist->sl_dirsize == 0) && (nsegs > 0))
+            {
+                /* Make the lone segment the first one in a new directory */
+                retval = seglist_newSeg(SEGLIST_MIN_OBJS, C_NULL, 0, &pseg);
+                PM_RETURN_IF_ERROR(retval);
+                pseg->s_val[0] = (pPmObj_t)pseglist->sl_rootseg;
+                pseglist->sl_rootseg = pseg;
+                pseglist->sl_dirsize = SEGLIST_MIN_OBJS;
+            }
+            else if ((nsegs > 0) && (nsegs == pseglist->sl_dirsize))
+            {
+                /* Double the directory */
+                capacity = nsegs << 1;
+                if (capacity > SEGLIST_DIR_MAX)
+                {
+                    capacity = SEGLIST_DIR_MAX;
+                }
+                retval = seglist_newSeg(capacity, pseglist->sl_rootseg,
+                                        nsegs, &pseg);
+                PM_RETURN_IF_ERROR(retval);
+#if SEGLIST_CLEAR_SEGMENTS
+                retval = heap_freeChunk((pPmObj_t)pseglist->sl_rootseg);
+#endif
+                pseglist->sl_rootseg = pseg;
+                pseglist->sl_dirsize = capacity;
+                PM_RETURN_IF_ERROR(retval);
+            }
+            lastcap = SEGLIST_MIN_OBJS >> 1;
+        }
+
+        /*
+         * Double the last segment's capacity, or make it just big enough
+         * to hold the n objects if that is more
+         */
+        capacity = lastcap << 1;
+        if ((base + capacity) < n)
+        {
+            capacity = ((n - base) < SEGLIST_OBJS_PER_SEG)
+                       ? (int16_t)(n - base) : SEGLIST_OBJS_PER_SEG;
+        }
+        else if (capacity > SEGLIST_OBJS_PER_SEG)
+        {
+            capacity = SEGLIST_OBJS_PER_SEG;
+        }
+
+        /* Find the slot that holds the last segment */
+        if (pseglist->sl_dirsize == 0)
+        {
+            ppslot = &pseglist->sl_rootseg;
+        }
+        else
+        {
+            ppslot = (pSegment_t *)&pseglist->sl_rootseg->s_val[nsegs];
+        }
+
+        /* Replace the last segment with a bigger copy, or add a new one */
+        retval = seglist_newSeg(capacity,
+                                (base == pseglist->sl_capacity)
+                                ? C_NULL : *ppslot,
+                                pseglist->sl_length - base, &pseg);
+        PM_RETURN_IF_ERROR(retval);
+#if SEGLIST_CLEAR_SEGMENTS
+        if (base != pseglist->sl_capacity)
+        {
+            retval = heap_freeChunk((pPmObj_t)*ppslot);
+        }
+#endif
+        *ppslot = pseg;
+        pseglist->sl_capacity = base + capacity;
+        PM_RETURN_IF_ERROR(retval);
+    }
+
+    return retval;
+}
+
 
 PmReturn_t
 seglist_appendItem(pSeglist_t pseglist, pPmObj_t pobj)
 {
-    return seglist_insertItem(pseglist, pobj, pseglist->sl_length);
+    return seglist_appendItems(pseglist, &pobj, 1);
+}
+
+
+PmReturn_t
+seglist_appendItems(pSeglist_t pseglist, pPmObj_t const *ppobjs, int16_t n)
+{
+    PmReturn_t retval;
+    pPmObj_t *pslot;
+    int16_t indx;
+    int16_t m;
+
+    C_ASSERT(pseglist != C_NULL);
+    C_ASSERT(n >= 0);
+
+    retval = seglist_grow(pseglist, (int32_t)pseglist->sl_length + n);
+    PM_RETURN_IF_ERROR(retval);
+
+    /* Copy as many objects at a time as fit in the rest of a segment */
+    indx = pseglist->sl_length;
+    while (n > 0)
+    {
+        m = SEGLIST_OBJS_PER_SEG - (indx & (SEGLIST_OBJS_PER_SEG - 1));
+        if (m > n)
+        {
+            m = n;
+        }
+        pslot = SEGLIST_ITEM_SLOT(pseglist, indx);
+        sli_memcpy((unsigned char *)pslot, (unsigned char *)ppobjs,
+                   m * sizeof(pPmObj_t));
+        ppobjs += m;
+        indx += m;
+        n -= m;
+    }
+    pseglist->sl_length = indx;
+
+    return retval;
 }
 
 
 PmReturn_t
 seglist_clear(pSeglist_t pseglist)
 {
-    pSegment_t pseg1 = C_NULL;
-    pSegment_t pseg2 = C_NULL;
+    int16_t i;
 
 #if SEGLIST_CLEAR_SEGMENTS
-    /* Deallocate all linked segments */
-    pseg1 = ((pSeglist_t)pseglist)->sl_rootseg;
-    while (pseg1 != C_NULL)
+    /* Deallocate the full-size segments and the directory */
+    if (pseglist->sl_dirsize != 0)
+    {
+        for (i = ((pseglist->sl_capacity + SEGLIST_OBJS_PER_SEG - 1)
+                  >> SEGLIST_SEG_SHIFT) - 1; i >= 0; i--)
+        {
+            PM_RETURN_IF_ERROR(heap_freeChunk(pseglist->sl_rootseg->s_val[i]));
+        }
+    }
+
+    /* Deallocate the root segment */
+    if (pseglist->sl_rootseg != C_NULL)
     {
-        pseg2 = pseg1->next;
-        PM_RETURN_IF_ERROR(heap_freeChunk((pPmObj_t)pseg1));
-        pseg1 = pseg2;
+        PM_RETURN_IF_ERROR(heap_freeChunk((pPmObj_t)pseglist->sl_rootseg));
     }
+#else
+    (void)i;
 #endif
 
     /* Clear seglist fields */
-    ((pSeglist_t)pseglist)->sl_rootseg = C_NULL;
-    ((pSeglist_t)pseglist)->sl_lastseg = C_NULL;
-    ((pSeglist_t)pseglist)->sl_length = 0;
+    pseglist->sl_rootseg = C_NULL;
+    pseglist->sl_length = 0;
+    pseglist->sl_capacity = 0;
+    pseglist->sl_dirsize = 0;
 
     return PM_RET_OK;
 }
@@ -87,50 +275,19 @@ seglist_clear(pSeglist_t pseglist)
 PmReturn_t
 seglist_findEqual(pSeglist_t pseglist, pPmObj_t pobj, int16_t *r_index)
 {
-    pSegment_t pseg;
-    int8_t i = 0;
-    uint8_t segindex;
-
     C_ASSERT(pseglist != C_NULL);
     C_ASSERT(pobj != C_NULL);
     C_ASSERT((*r_index >= 0));
     C_ASSERT((*r_index == 0) || (*r_index < pseglist->sl_length));
 
-    /* Walk out to the starting segment */
-    pseg = pseglist->sl_rootseg;
-    for (i = (*r_index / SEGLIST_OBJS_PER_SEG); i > (int8_t)0; i--)
+    for (; *r_index < pseglist->sl_length; (*r_index)++)
     {
-        C_ASSERT(pseg != C_NULL);
-        pseg = pseg->next;
-    }
-
-    /* Set the starting index within the segment */
-    segindex = *r_index % SEGLIST_OBJS_PER_SEG;
-
-    /* Search the remaining segments */
-    for (; pseg != C_NULL; pseg = pseg->next)
-    {
-        while (segindex < SEGLIST_OBJS_PER_SEG)
+        /* If items are equal, return with index of found item */
+        if (obj_compare(pobj, *SEGLIST_ITEM_SLOT(pseglist, *r_index))
+            == C_SAME)
         {
-            /* If past the end of the seglist, return no item found */
-            if (*r_index >= pseglist->sl_length)
-            {
-                return PM_RET_NO;
-            }
-
-            /* If items are equal, return with index of found item */
-            if (obj_compare(pobj, pseg->s_val[segindex]) == C_SAME)
-            {
-                return PM_RET_OK;
-            }
-
-            /* Proceed to next item */
-            segindex++;
-            (*r_index)++;
+            return PM_RET_OK;
         }
-
-        /* Proceed to next segment */
-        segindex = 0;
     }
     return PM_RET_NO;
 }
@@ -139,24 +296,11 @@ seglist_findEqual(pSeglist_t pseglist, pPmObj_t pobj, int16_t *r_index)
 PmReturn_t
 seglist_getItem(pSeglist_t pseglist, int16_t index, pPmObj_t *r_pobj)
 {
-    pSegment_t pseg;
-    int16_t i;
-
     C_ASSERT(pseglist != C_NULL);
     C_ASSERT(index >= 0);
     C_ASSERT(index < pseglist->sl_length);
 
-    /* Walk out to the proper segment */
-    pseg = pseglist->sl_rootseg;
-    C_ASSERT(pseg != C_NULL);
-    for (i = (index / SEGLIST_OBJS_PER_SEG); i > 0; i--)
-    {
-        pseg = pseg->next;
-        C_ASSERT(pseg != C_NULL);
-    }
-
-    /* Return ptr to obj in this seg at the index */
-    *r_pobj = pseg->s_val[index % SEGLIST_OBJS_PER_SEG];
+    *r_pobj = *SEGLIST_ITEM_SLOT(pseglist, index);
     return PM_RET_OK;
 }
 
@@ -164,71 +308,47 @@ seglist_getItem(pSeglist_t pseglist, int16_t index, pPmObj_t *r_pobj)
 PmReturn_t
 seglist_insertItem(pSeglist_t pseglist, pPmObj_t pobj, int16_t index)
 {
-    PmReturn_t retval = PM_RET_OK;
-    pSegment_t pseg = C_NULL;
-    pPmObj_t pobj1 = C_NULL;
-    pPmObj_t pobj2 = C_NULL;
-    int8_t indx = (int8_t)0;
-    int16_t i = 0;
-    uint8_t *pchunk;
+    PmReturn_t retval;
+    pPmObj_t *pslot;
+    int16_t i;
+    int16_t lo;
 
+    C_ASSERT(index >= 0);
     C_ASSERT(index <= pseglist->sl_length);
 
-    /* If a new seg is needed */
-    if ((pseglist->sl_length % SEGLIST_OBJS_PER_SEG) == 0)
+    retval = seglist_grow(pseglist, (int32_t)pseglist->sl_length + 1);
+    PM_RETURN_IF_ERROR(retval);
+
+    /*
+     * Move the items from the index onward up by one, starting at the end.
+     * Slot i receives item i - 1; the items in the same segment as slot i
+     * move together.
+     */
+    i = pseglist->sl_length;
+    while (i > index)
     {
-        /* Alloc and init new segment */
-        retval = heap_getChunk(sizeof(Segment_t), &pchunk);
-        PM_RETURN_IF_ERROR(retval);
-        pseg = (pSegment_t)pchunk;
-        OBJ_SET_TYPE(pseg, OBJ_TYPE_SEG);
-        sli_memset((unsigned char *)pseg->s_val,
-                   0, SEGLIST_OBJS_PER_SEG * sizeof(pPmObj_t));
-        pseg->next = C_NULL;
-
-        /* If this is the first seg, set as root */
-        if (pseglist->sl_rootseg == C_NULL)
-        {
-            pseglist->sl_rootseg = pseg;
-        }
+        pslot = SEGLIST_ITEM_SLOT(pseglist, i);
 
-        /* Else append the seg to the end */
-        else
+        /* Item i - 1 is the last one in the previous segment */
+        if ((i & (SEGLIST_OBJS_PER_SEG - 1)) == 0)
         {
-            pseglist->sl_lastseg->next = pseg;
+            *pslot = *SEGLIST_ITEM_SLOT(pseglist, i - 1);
+            i--;
+            continue;
         }
 
-        /* Either way, this is now the last segment */
-        pseglist->sl_lastseg = pseg;
-    }
-
-    /* Walk out to the segment for insertion */
-    pseg = pseglist->sl_rootseg;
-    C_ASSERT(pseg != C_NULL);
-    for (i = (index / SEGLIST_OBJS_PER_SEG); i > 0; i--)
-    {
-        pseg = pseg->next;
-        C_ASSERT(pseg != C_NULL);
-    }
-
-    /* Insert obj and ripple copy all those afterward */
-    indx = index % SEGLIST_OBJS_PER_SEG;;
-    pobj1 = pobj;
-    while (pobj1 != C_NULL)
-    {
-        pobj2 = pseg->s_val[indx];
-        pseg->s_val[indx] = pobj1;
-        pobj1 = pobj2;
-        indx++;
-
-        /* If indx exceeds this seg, go to next seg */
-        if ((indx >= SEGLIST_OBJS_PER_SEG) && (pobj1 != C_NULL))
+        lo = i & ~(SEGLIST_OBJS_PER_SEG - 1);
+        if (lo < index)
         {
-            pseg = pseg->next;
-            C_ASSERT(pseg != C_NULL);
-            indx = (int8_t)0;
+            lo = index;
         }
+        sli_memmove((unsigned char *)(pslot - (i - lo) + 1),
+                    (unsigned char *)(pslot - (i - lo)),
+                    (i - lo) * sizeof(pPmObj_t));
+        i = lo;
     }
+
+    *SEGLIST_ITEM_SLOT(pseglist, index) = pobj;
     pseglist->sl_length++;
     return retval;
 }
@@ -244,8 +364,9 @@ seglist_new(pSeglist_t *r_pseglist)
 
     OBJ_SET_TYPE(*r_pseglist, OBJ_TYPE_SGL);
     (*r_pseglist)->sl_rootseg = C_NULL;
-    (*r_pseglist)->sl_lastseg = C_NULL;
     (*r_pseglist)->sl_length = 0;
+    (*r_pseglist)->sl_capacity = 0;
+    (*r_pseglist)->sl_dirsize = 0;
     return retval;
 }
 
@@ -253,22 +374,10 @@ seglist_new(pSeglist_t *r_pseglist)
 PmReturn_t
 seglist_setItem(pSeglist_t pseglist, pPmObj_t pobj, int16_t index)
 {
-    pSegment_t pseg;
-    int16_t i;
-
-    C_ASSERT(index <= pseglist->sl_length);
-
-    /* Walk out to the proper segment */
-    pseg = pseglist->sl_rootseg;
-    C_ASSERT(pseg != C_NULL);
-    for (i = (index / SEGLIST_OBJS_PER_SEG); i > 0; i--)
-    {
-        pseg = pseg->next;
-        C_ASSERT(pseg != C_NULL);
-    }
+    C_ASSERT(index >= 0);
+    C_ASSERT(index < pseglist->sl_length);
 
-    /* Set item in this seg at the index */
-    pseg->s_val[index % SEGLIST_OBJS_PER_SEG] = pobj;
+    *SEGLIST_ITEM_SLOT(pseglist, index) = pobj;
     return PM_RET_OK;
 }
 
@@ -276,83 +385,71 @@ seglist_setItem(pSeglist_t pseglist, pPmObj_t pobj, int16_t index)
 PmReturn_t
 seglist_removeItem(pSeglist_t pseglist, uint16_t index)
 {
-    pSegment_t pseg;
-    int16_t i,
-      k;
+    pPmObj_t *pslot;
+    int16_t i;
+    int16_t hi;
+    int16_t last;
+    int16_t nsegs;
 
     C_ASSERT(index < pseglist->sl_length);
 
-    /* Walk through the segments */
-    pseg = pseglist->sl_rootseg;
-    C_ASSERT(pseg != C_NULL);
-    for (i = (index / SEGLIST_OBJS_PER_SEG); i > 0; i--)
-    {
-        pseg = pseg->next;
-        C_ASSERT(pseg != C_NULL);
-    }
-
     /*
-     * pseg now points to the correct segment of the item to be removed, so
-     * start ripple copying all following items up to the last
-     * in the last segment
+     * Move the items after the index down by one.
+     * Slot i receives item i + 1; the items in the same segment as slot i
+     * move together.
      */
-
-    for (i = index; i < ((pseglist->sl_length) - 1); i++)
+    last = pseglist->sl_length - 1;
+    i = index;
+    while (i < last)
     {
-        k = i % SEGLIST_OBJS_PER_SEG;
+        pslot = SEGLIST_ITEM_SLOT(pseglist, i);
 
-        /* Copy element i+1 to slot i */
-        if ((k + 1) == SEGLIST_OBJS_PER_SEG)
+        /* Item i + 1 is the first one in the next segment */
+        if ((i & (SEGLIST_OBJS_PER_SEG - 1)) == (SEGLIST_OBJS_PER_SEG - 1))
         {
-            /* Source is first item in next segment */
-            pseg->s_val[i % SEGLIST_OBJS_PER_SEG] = (pseg->next)->s_val[0];
-            pseg = pseg->next;
+            *pslot = *SEGLIST_ITEM_SLOT(pseglist, i + 1);
+            i++;
+            continue;
         }
-        else
+
+        hi = i | (SEGLIST_OBJS_PER_SEG - 1);
+        if (hi > last)
         {
-            /* Source and target are in the same segment */
-            pseg->s_val[k] = pseg->s_val[k + 1];
+            hi = last;
         }
+        sli_memmove((unsigned char *)pslot, (unsigned char *)(pslot + 1),
+                    (hi - i) * sizeof(pPmObj_t));
+        i = hi;
     }
+    pseglist->sl_length = last;
 
-    pseglist->sl_length -= 1;
-
-    /* Remove the last segment if it was emptied */
-    if (pseglist->sl_length % SEGLIST_OBJS_PER_SEG == 0)
+    /* Recycle the segments if the seglist is now empty */
+    if (pseglist->sl_length == 0)
     {
-        pseg = pseglist->sl_rootseg;
+        return seglist_clear(pseglist);
+    }
 
-        /* Find the segment before the last */
-        for (i = 0; i < ((pseglist->sl_length - 1) / SEGLIST_OBJS_PER_SEG);
-             i++)
-        {
-            pseg = pseg->next;
-            C_ASSERT(pseg != C_NULL);
-        }
-        if (pseg->next == C_NULL)
-        {
-            /*
-             * Seglist is now completely empty and the last segment can be
-             * recycled.
-             */
 #if SEGLIST_CLEAR_SEGMENTS
-            PM_RETURN_IF_ERROR(heap_freeChunk((pPmObj_t)pseg));
-#endif
-            pseglist->sl_lastseg = C_NULL;
-            pseglist->sl_rootseg = C_NULL;
-        }
-        else
+    /*
+     * Free the last segment once the items fit in the ones before it
+     * with half a segment to spare, so that alternating appends and
+     * removes do not thrash the heap
+     */
+    if (pseglist->sl_dirsize != 0)
+    {
+        nsegs = (pseglist->sl_capacity - 1) >> SEGLIST_SEG_SHIFT;
+        if ((nsegs > 0)
+            && ((pseglist->sl_length + (SEGLIST_OBJS_PER_SEG >> 1))
+                <= (nsegs << SEGLIST_SEG_SHIFT)))
         {
-            /* At least one segment remains */
-            pseglist->sl_lastseg = pseg;
-            pseg->next = C_NULL;
+            pseglist->sl_capacity = nsegs << SEGLIST_SEG_SHIFT;
+            PM_RETURN_IF_ERROR(
+                heap_freeChunk(pseglist->sl_rootseg->s_val[nsegs]));
         }
     }
-    else
-    {
-        /* Zero out the now unused slot */
-        pseg->s_val[pseglist->sl_length % SEGLIST_OBJS_PER_SEG] = C_NULL;
-    }
+#else
+    (void)nsegs;
+#endif
 
     return PM_RET_OK;
 }
@@ -14,14 +14,14 @@
  * \file
  * \brief Segmented List data structure
  *
- * A seglist is a linked list of segments.
- * A segment is an array of ptrs to objects
- * (with a pointer to the next segment).
- * Seglists are used to implement Lists and Dicts.
+ * A seglist is a growable array of ptrs to objects.
+ * Seglists are used to implement Lists.
  *
- * This implementation of Seglist is straight.
- * That is, the next pointer in the final segment
- * contains C_NULL.
+ * A seglist of up to SEGLIST_OBJS_PER_SEG items keeps them in a single
+ * segment whose capacity doubles as it fills.  A longer seglist keeps them
+ * in full-size segments followed by one that doubles as it fills, and its
+ * root segment is a directory of ptrs to those segments.
+ * Either way, getting or setting an item is O(1).
  *
  * This implementation of Seglist is dense.
  * That is, there are no gaps in a segment.
@@ -30,8 +30,26 @@
  */
 
 
-/** Defines the length of the object array in a segment */
-#define SEGLIST_OBJS_PER_SEG 8
+/** Defines log2 of the number of object ptrs in a full-size segment */
+#define SEGLIST_SEG_SHIFT 7
+
+/** Defines the number of object ptrs in a full-size segment */
+#define SEGLIST_OBJS_PER_SEG (1 << SEGLIST_SEG_SHIFT)
+
+/** Defines the capacity of a new segment */
+#define SEGLIST_MIN_OBJS 4
+
+
+/**
+ * Gets the address of the slot that holds the item at the index.
+ * The index must be less than the seglist's capacity.
+ */
+#define SEGLIST_ITEM_SLOT(pseglist, index) \
+    (((pseglist)->sl_dirsize == 0) \
+     ? &(pseglist)->sl_rootseg->s_val[(index)] \
+     : &((pSegment_t)(pseglist)->sl_rootseg->s_val[(index) \
+                                                   >> SEGLIST_SEG_SHIFT]) \
+        ->s_val[(index) & (SEGLIST_OBJS_PER_SEG - 1)])
 
 
 /** Segment - an array of ptrs to objs */
@@ -39,34 +57,32 @@ typedef struct Segment_s
 {
     /** object descriptor */
     PmObjDesc_t od;
-    /** array of ptrs to objs */
-    pPmObj_t s_val[SEGLIST_OBJS_PER_SEG];
-    /** ptr to next segment */
-    struct Segment_s *next;
+    /** array of ptrs to objs (or to full-size segments in a directory) */
+    pPmObj_t s_val[1];
 } Segment_t,
  *pSegment_t;
 
 
-/** Seglist - linked list of segments with current index info */
+/** Seglist - growable array of ptrs to objs */
 typedef struct Seglist_s
 {
     /** object descriptor */
     PmObjDesc_t od;
-    /** index of (one past) last obj in last segment */
+    /** number of objs in the seglist */
     int16_t sl_length;
-    /** ptr to first segment in list */
+    /** number of objs the segments can hold */
+    int16_t sl_capacity;
+    /** number of segment ptrs the directory can hold; 0 if there is none */
+    int16_t sl_dirsize;
+    /** ptr to the only segment, or to the directory of full-size segments */
     pSegment_t sl_rootseg;
-    /** ptr to last segment */
-    pSegment_t sl_lastseg;
 } Seglist_t,
  *pSeglist_t;
 
 
 /**
  * Puts the new object at the end of the list.
- * This is intended for the List type where
- * the List index matches the order of the Seglist index.
- * Makes room if necessary by adding new segments.
+ * Makes room if necessary by growing the segments.
  *
  * @param pseglist Ptr to seglist
  * @param pobj Pointer to object to append
@@ -75,7 +91,20 @@ typedef struct Seglist_s
 PmReturn_t seglist_appendItem(pSeglist_t pseglist, pPmObj_t pobj);
 
 /**
- * Clears the the seglist by unlinking the root segment.
+ * Puts n objects, in order, at the end of the list.
+ * Makes room for all n objects before appending any of them,
+ * so if an allocation fails, no objects have been appended.
+ *
+ * @param pseglist Ptr to seglist
+ * @param ppobjs Ptr to the first of n contiguous object pointers
+ * @param n Number of objects to append
+ * @return Return status
+ */
+PmReturn_t seglist_appendItems(pSeglist_t pseglist, pPmObj_t const *ppobjs,
+                               int16_t n);
+
+/**
+ * Clears the the seglist by freeing its segments.
  *
  * @param pseglist Ptr to seglist to empty
  */
@@ -83,7 +112,7 @@ PmReturn_t seglist_clear(pSeglist_t pseglist);
 
 /**
  * Finds the first obj equal to pobj in the seglist.
- * Starts searching the list at the given segnum and indx.
+ * Starts searching the list at the index given by r_index.
  *
  * @param   pseglist The seglist to search
  * @param   pobj The object to match
@@ -97,9 +126,7 @@ PmReturn_t seglist_findEqual(pSeglist_t pseglist,
                              pPmObj_t pobj, int16_t *r_index);
 
 /**
- * Gets the item in the seglist at the given coordinates.
- * The segment number and the index within the segment
- * are the coordinates of the object to get.
+ * Gets the item in the seglist at the given index.
  *
  * @param   pseglist Ptr to seglist to scan
  * @param   index Index of item to get
@@ -120,11 +147,9 @@ PmReturn_t seglist_new(pSeglist_t *r_pseglist);
 
 
 /**
- * Puts the item in the next available slot in the first available segment.
- * This is intended for the Dict type where
- * the Seglist index is insignificant.
- * Pushing an object assures it will be found early
- * during a call to seglist_findEqual().
+ * Inserts the item before the given index.
+ * Makes room if necessary by growing the segments
+ * and moves the items from the index onward up by one.
  *
  * @param   pseglist Ptr to seglist in which object is placed.
  * @param   pobj Ptr to object which is inserted.
@@ -136,9 +161,9 @@ PmReturn_t seglist_insertItem(pSeglist_t pseglist,
                               pPmObj_t pobj, int16_t index);
 
 /**
- * Puts the item in the designated slot and segment.
+ * Puts the item in the slot at the given index.
  * This is intended to be used after seglist_findEqual()
- * returns the proper indeces.
+ * returns the proper index.
  *
  * @param   pseglist Ptr to seglist in which object is placed.
  * @param   pobj Ptr to object which is set.
@@ -150,6 +175,7 @@ PmReturn_t seglist_setItem(pSeglist_t pseglist, pPmObj_t pobj, int16_t index);
 
 /**
  * Removes the item at the given index.
+ * Moves the items after the index down by one.
  *
  * @param   pseglist Ptr to seglist in which object is removed.
  * @param   index Index into seglist of where to put object.
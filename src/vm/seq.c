@@ -50,18 +50,7 @@ seq_compare(pPmObj_t pobj1, pPmObj_t pobj2)
 #ifdef HAVE_BYTEARRAY
     else if (OBJ_GET_TYPE(pobj1) == OBJ_TYPE_BYA)
     {
-        /* Return if the lengths differ */
-        l1 = ((pPmBytearray_t)pobj1)->length;
-        l2 = ((pPmBytearray_t)pobj2)->length;
-        if (l1 != l2)
-        {
-            return C_DIFFER;
-        }
-
-        return sli_strncmp((char const *)&(((pPmBytes_t)((pPmBytearray_t)pobj1)->val)->val),
-                           (char const *)&(((pPmBytes_t)((pPmBytearray_t)pobj2)->val)->val),
-                           l1)
-               ? C_DIFFER : C_SAME;
+        return bytearray_compare(pobj1, pobj2);
     }
 #endif /* HAVE_BYTEARRAY */
 
@@ -112,6 +101,10 @@ seq_getLength(pPmObj_t pobj, uint16_t *r_index)
             *r_index = ((pPmString_t)pobj)->length;
             break;
 
+        case OBJ_TYPE_SVW:
+            *r_index = ((pPmStringView_t)pobj)->length;
+            break;
+
         case OBJ_TYPE_TUP:
             *r_index = ((pPmTuple_t)pobj)->length;
             break;
@@ -126,10 +119,20 @@ seq_getLength(pPmObj_t pobj, uint16_t *r_index)
             break;
 #endif /* HAVE_BYTEARRAY */
 
+#ifdef HAVE_ARRAY
+        case OBJ_TYPE_BYS:
+            *r_index = ARRAY_GET_LENGTH(pobj);
+            break;
+#endif /* HAVE_ARRAY */
+
         case OBJ_TYPE_DIC:
             *r_index = ((pPmDict_t)pobj)->length;
             break;
 
+        case OBJ_TYPE_XRG:
+            *r_index = ((pPmXrange_t)pobj)->xr_length;
+            break;
+
         default:
             /* Raise TypeError, non-sequence object */
             PM_RAISE(retval, PM_RET_EX_TYPE);
@@ -145,27 +148,28 @@ PmReturn_t
 seq_getSubscript(pPmObj_t pobj, int16_t index, pPmObj_t *r_pobj)
 {
     PmReturn_t retval;
-    pSeglist_t pkeys;
+    uint16_t pos;
     uint8_t c;
 
     switch (OBJ_GET_TYPE(pobj))
     {
         case OBJ_TYPE_STR:
+        case OBJ_TYPE_SVW:
             /* Adjust for negative index */
             if (index < 0)
             {
-                index += ((pPmString_t)pobj)->length;
+                index += STRING_GET_LENGTH(pobj);
             }
 
             /* Raise IndexError if index is out of bounds */
-            if ((index < 0) || (index > ((pPmString_t)pobj)->length))
+            if ((index < 0) || (index >= STRING_GET_LENGTH(pobj)))
             {
                 PM_RAISE(retval, PM_RET_EX_INDX);
                 break;
             }
 
             /* Get the character from the string */
-            c = ((pPmString_t)pobj)->val[index];
+            c = STRING_GET_VAL(pobj)[index];
 
             /* Create a new string from the character */
             retval = string_newFromChar(c, r_pobj);
@@ -187,10 +191,47 @@ seq_getSubscript(pPmObj_t pobj, int16_t index, pPmObj_t *r_pobj)
             break;
 #endif /* HAVE_BYTEARRAY */
 
+#ifdef HAVE_ARRAY
+        case OBJ_TYPE_BYS:
+            retval = array_getItem(pobj, index, r_pobj);
+            break;
+#endif /* HAVE_ARRAY */
+
         /* Issue #176 Add support to iterate over keys in a dict */
         case OBJ_TYPE_DIC:
-            pkeys = ((pPmDict_t)pobj)->d_keys;
-            retval = seglist_getItem(pkeys, index, r_pobj);
+            /* Raise IndexError if index is out of bounds */
+            if ((index < 0) || (index >= ((pPmDict_t)pobj)->length))
+            {
+                PM_RAISE(retval, PM_RET_EX_INDX);
+                break;
+            }
+
+            /* Walk the keys in insertion order up to the index */
+            pos = 0;
+            do
+            {
+                retval = dict_next(pobj, &pos, r_pobj, C_NULL);
+            }
+            while ((retval == PM_RET_OK) && (--index >= 0));
+            break;
+
+        case OBJ_TYPE_XRG:
+            /* Adjust for negative index */
+            if (index < 0)
+            {
+                index += ((pPmXrange_t)pobj)->xr_length;
+            }
+
+            /* Raise IndexError if index is out of bounds */
+            if ((index < 0) || (index >= ((pPmXrange_t)pobj)->xr_length))
+            {
+                PM_RAISE(retval, PM_RET_EX_INDX);
+                break;
+            }
+
+            /* Compute the int */
+            retval = int_new(((pPmXrange_t)pobj)->xr_start
+                             + index * ((pPmXrange_t)pobj)->xr_step, r_pobj);
             break;
 
         default:
@@ -206,36 +247,115 @@ seq_getSubscript(pPmObj_t pobj, int16_t index, pPmObj_t *r_pobj)
 PmReturn_t
 seqiter_getNext(pPmObj_t pobj, pPmObj_t *r_pitem)
 {
-    PmReturn_t retval;
+    PmReturn_t retval = PM_RET_OK;
+    pPmSeqIter_t psi = (pPmSeqIter_t)pobj;
+    pPmObj_t pseq;
+    pPmObj_t pkey;
+    pPmObj_t pval;
     uint16_t length;
+    uint16_t pos;
 
     C_ASSERT(pobj != C_NULL);
     C_ASSERT(*r_pitem != C_NULL);
     C_ASSERT(OBJ_GET_TYPE(pobj) == OBJ_TYPE_SQI);
 
-    /*
-     * Raise TypeError if sequence iterator's object is not a sequence
-     * otherwise, the get sequence's length
-     */
-    retval = seq_getLength(((pPmSeqIter_t)pobj)->si_sequence, &length);
-    PM_RETURN_IF_ERROR(retval);
-
-    /* Raise StopIteration if at the end of the sequence */
-    if (((pPmSeqIter_t)pobj)->si_index == length)
+    /* Raise StopIteration if the iterator is already exhausted */
+    pseq = psi->si_sequence;
+    if (pseq == C_NULL)
     {
-        /* Make null the pointer to the sequence */
-        ((pPmSeqIter_t)pobj)->si_sequence = C_NULL;
         PM_RAISE(retval, PM_RET_EX_STOP);
         return retval;
     }
 
-    /* Get the item at the current index */
-    retval = seq_getSubscript(((pPmSeqIter_t)pobj)->si_sequence,
-                              ((pPmSeqIter_t)pobj)->si_index, r_pitem);
+    /* Get the item at the current index directly for the common types */
+    switch (OBJ_GET_TYPE(pseq))
+    {
+        case OBJ_TYPE_LST:
+            /* The list may have been shortened during the loop */
+            if (psi->si_index >= ((pPmList_t)pseq)->length)
+            {
+                break;
+            }
+
+            *r_pitem = *SEGLIST_ITEM_SLOT(((pPmList_t)pseq)->val,
+                                          psi->si_index);
+            psi->si_index++;
+            return retval;
+
+        case OBJ_TYPE_TUP:
+            if (psi->si_index >= ((pPmTuple_t)pseq)->length)
+            {
+                break;
+            }
+            *r_pitem = ((pPmTuple_t)pseq)->val[psi->si_index++];
+            return retval;
+
+        case OBJ_TYPE_STR:
+        case OBJ_TYPE_SVW:
+            if (psi->si_index >= STRING_GET_LENGTH(pseq))
+            {
+                break;
+            }
+            retval = string_newFromChar(
+                STRING_GET_VAL(pseq)[psi->si_index++], r_pitem);
+            return retval;
+
+        case OBJ_TYPE_DIC:
+            /* Raise RuntimeError if the dict changed size during the loop */
+            if (((pPmDict_t)pseq)->length != psi->si_length)
+            {
+                PM_RAISE(retval, PM_RET_EX_RUNTIME);
+                return retval;
+            }
+
+            /* The index is the dict's cursor over its entries */
+            pos = (uint16_t)psi->si_index;
+            if (dict_next(pseq, &pos, &pkey, &pval) != PM_RET_OK)
+            {
+                break;
+            }
+            psi->si_index = (int16_t)pos;
+
+            if (psi->si_kind == SEQITER_KEYS)
+            {
+                *r_pitem = pkey;
+            }
+            else if (psi->si_kind == SEQITER_VALUES)
+            {
+                *r_pitem = pval;
+            }
 
-    /* Increment the index */
-    ((pPmSeqIter_t)pobj)->si_index++;
+            /* The dict holds the key and value while the tuple is made */
+            else
+            {
+                retval = tuple_new(2, r_pitem);
+                PM_RETURN_IF_ERROR(retval);
+                ((pPmTuple_t)*r_pitem)->val[0] = pkey;
+                ((pPmTuple_t)*r_pitem)->val[1] = pval;
+            }
+            return retval;
 
+        default:
+            /*
+             * Raise TypeError if sequence iterator's object is not a sequence
+             * otherwise, the get sequence's length
+             */
+            retval = seq_getLength(pseq, &length);
+            PM_RETURN_IF_ERROR(retval);
+            if (psi->si_index >= length)
+            {
+                break;
+            }
+
+            /* Get the item at the current index */
+            retval = seq_getSubscript(pseq, psi->si_index, r_pitem);
+            psi->si_index++;
+            return retval;
+    }
+
+    /* At the end of the sequence, make null the pointer to the sequence */
+    psi->si_sequence = C_NULL;
+    PM_RAISE(retval, PM_RET_EX_STOP);
     return retval;
 }
 
@@ -250,8 +370,16 @@ seqiter_new(pPmObj_t pobj, pPmObj_t *r_pobj)
     C_ASSERT(pobj != C_NULL);
     C_ASSERT(*r_pobj != C_NULL);
 
+#ifdef HAVE_SET
+    /* A set is iterated as the keys of its dict */
+    if (OBJ_GET_TYPE(pobj) == OBJ_TYPE_SET)
+    {
+        pobj = (pPmObj_t)((pPmSet_t)pobj)->s_dict;
+    }
+#endif /* HAVE_SET */
+
     /* Raise a TypeError if pobj is not a sequence */
-    if ((OBJ_GET_TYPE(pobj) != OBJ_TYPE_STR)
+    if (!STRING_IS_STRING(pobj)
         && (OBJ_GET_TYPE(pobj) != OBJ_TYPE_TUP)
         && (OBJ_GET_TYPE(pobj) != OBJ_TYPE_LST)
         && (OBJ_GET_TYPE(pobj) != OBJ_TYPE_DIC))
@@ -269,7 +397,171 @@ seqiter_new(pPmObj_t pobj, pPmObj_t *r_pobj)
     OBJ_SET_TYPE(psi, OBJ_TYPE_SQI);
     psi->si_sequence = pobj;
     psi->si_index = 0;
+    psi->si_length = 0;
+    psi->si_kind = SEQITER_KEYS;
+    if (OBJ_GET_TYPE(pobj) == OBJ_TYPE_DIC)
+    {
+        psi->si_length = ((pPmDict_t)pobj)->length;
+    }
 
     *r_pobj = (pPmObj_t)psi;
     return retval;
 }
+
+
+PmReturn_t
+seqiter_newDict(pPmObj_t pdict, uint8_t kind, pPmObj_t *r_pobj)
+{
+    PmReturn_t retval;
+
+    /* Raise TypeError if it's not a dict */
+    if (OBJ_GET_TYPE(pdict) != OBJ_TYPE_DIC)
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+
+    retval = seqiter_new(pdict, r_pobj);
+    PM_RETURN_IF_ERROR(retval);
+    ((pPmSeqIter_t)*r_pobj)->si_kind = kind;
+    return retval;
+}
+
+
+PmReturn_t
+xrange_new(int32_t start, int32_t stop, int32_t step, pPmObj_t *r_pobj)
+{
+    PmReturn_t retval;
+    uint8_t *pchunk;
+    pPmXrange_t pxr;
+    uint32_t length;
+
+    /* Raise ValueError if step is zero */
+    if (step == 0)
+    {
+        PM_RAISE(retval, PM_RET_EX_VAL);
+        return retval;
+    }
+
+    /*
+     * Count the ints; the length is zero if stop is not reached.
+     * The distance and the step's magnitude always fit in a uint32_t.
+     */
+    if ((step > 0) && (start < stop))
+    {
+        length = ((uint32_t)stop - (uint32_t)start - 1) / (uint32_t)step + 1;
+    }
+    else if ((step < 0) && (start > stop))
+    {
+        length = ((uint32_t)start - (uint32_t)stop - 1)
+                 / ((uint32_t)0 - (uint32_t)step) + 1;
+    }
+    else
+    {
+        length = 0;
+    }
+
+    /* Raise OverflowError if the length does not fit in an int */
+    if (length > 0x7FFFFFFF)
+    {
+        PM_RAISE(retval, PM_RET_EX_OFLOW);
+        return retval;
+    }
+
+    /* Alloc a chunk for the xrange obj */
+    retval = heap_getChunk(sizeof(PmXrange_t), &pchunk);
+    PM_RETURN_IF_ERROR(retval);
+
+    /* Set the xrange's fields */
+    pxr = (pPmXrange_t)pchunk;
+    OBJ_SET_TYPE(pxr, OBJ_TYPE_XRG);
+    pxr->xr_start = start;
+    pxr->xr_step = step;
+    pxr->xr_length = (int32_t)length;
+
+    *r_pobj = (pPmObj_t)pxr;
+    return retval;
+}
+
+
+PmReturn_t
+xrange_getIter(pPmObj_t pobj, pPmObj_t *r_pobj)
+{
+    PmReturn_t retval;
+    uint8_t *pchunk;
+
+    C_ASSERT(OBJ_GET_TYPE(pobj) == OBJ_TYPE_XRG);
+
+    /* Alloc a chunk for the copy */
+    retval = heap_getChunk(sizeof(PmXrange_t), &pchunk);
+    PM_RETURN_IF_ERROR(retval);
+
+    /* Copy the xrange's fields */
+    OBJ_SET_TYPE(pchunk, OBJ_TYPE_XRG);
+    ((pPmXrange_t)pchunk)->xr_start = ((pPmXrange_t)pobj)->xr_start;
+    ((pPmXrange_t)pchunk)->xr_step = ((pPmXrange_t)pobj)->xr_step;
+    ((pPmXrange_t)pchunk)->xr_length = ((pPmXrange_t)pobj)->xr_length;
+
+    *r_pobj = (pPmObj_t)pchunk;
+    return retval;
+}
+
+
+PmReturn_t
+xrange_getNext(pPmObj_t pobj, pPmObj_t *r_pitem)
+{
+    PmReturn_t retval;
+    pPmXrange_t pxr = (pPmXrange_t)pobj;
+
+    C_ASSERT(OBJ_GET_TYPE(pobj) == OBJ_TYPE_XRG);
+
+    /* Raise StopIteration if at the end of the xrange */
+    if (pxr->xr_length == 0)
+    {
+        PM_RAISE(retval, PM_RET_EX_STOP);
+        return retval;
+    }
+
+    /* Get the first int and drop it from the iterator */
+    retval = int_new(pxr->xr_start, r_pitem);
+    PM_RETURN_IF_ERROR(retval);
+    pxr->xr_start += pxr->xr_step;
+    pxr->xr_length--;
+
+    return retval;
+}
+
+
+#ifdef HAVE_PRINT
+PmReturn_t
+xrange_print(pPmObj_t pobj)
+{
+    PmReturn_t retval;
+    pPmXrange_t pxr = (pPmXrange_t)pobj;
+    uint8_t buf[12];
+
+    C_ASSERT(OBJ_GET_TYPE(pobj) == OBJ_TYPE_XRG);
+
+    /* Print the args that differ from the defaults, as in "xrange(1, 5)" */
+    sli_puts((uint8_t *)"xrange(");
+    if ((pxr->xr_start != 0) || (pxr->xr_step != 1))
+    {
+        retval = sli_ltoa10(pxr->xr_start, buf, sizeof(buf));
+        PM_RETURN_IF_ERROR(retval);
+        sli_puts(buf);
+        sli_puts((uint8_t *)", ");
+    }
+    retval = sli_ltoa10(pxr->xr_start + pxr->xr_length * pxr->xr_step,
+                        buf, sizeof(buf));
+    PM_RETURN_IF_ERROR(retval);
+    sli_puts(buf);
+    if (pxr->xr_step != 1)
+    {
+        sli_puts((uint8_t *)", ");
+        retval = sli_ltoa10(pxr->xr_step, buf, sizeof(buf));
+        PM_RETURN_IF_ERROR(retval);
+        sli_puts(buf);
+    }
+    return plat_putByte(')');
+}
+#endif /* HAVE_PRINT */
@@ -16,11 +16,24 @@
  */
 
 
+/** A dict iterator gives the keys of the dict */
+#define SEQITER_KEYS 0
+
+/** A dict iterator gives the values of the dict */
+#define SEQITER_VALUES 1
+
+/** A dict iterator gives (key, value) tuples of the dict */
+#define SEQITER_ITEMS 2
+
+
 /**
  * Sequence Iterator Object
  *
  * Instances of this object are created by GET_ITER and used by FOR_ITER.
  * Stores a pointer to a sequence and an index int16_t.
+ * Over a dict, the index is the dict's cursor (see dict_next()) and the
+ * dict's length is kept, so that a change of length during the loop
+ * raises RuntimeError instead of skipping or repeating keys.
  */
 typedef struct PmSeqIter_s
 {
@@ -32,10 +45,41 @@ typedef struct PmSeqIter_s
 
     /** Index value */
     int16_t si_index;
+
+    /** Length of the dict when the iterator was made */
+    uint16_t si_length;
+
+    /** What a dict iterator gives: SEQITER_KEYS, _VALUES or _ITEMS */
+    uint8_t si_kind;
 } PmSeqIter_t,
  *pPmSeqIter_t;
 
 
+/**
+ * Xrange Object
+ *
+ * Instances of this object are created by xrange().  Computes its ints
+ * on demand from its start and step, so it takes the same memory
+ * regardless of its length.
+ * GET_ITER makes a private copy that FOR_ITER advances in place.
+ */
+typedef struct PmXrange_s
+{
+    /** Object descriptor */
+    PmObjDesc_t od;
+
+    /** First int */
+    int32_t xr_start;
+
+    /** Difference between consecutive ints */
+    int32_t xr_step;
+
+    /** Number of ints */
+    int32_t xr_length;
+} PmXrange_t,
+ *pPmXrange_t;
+
+
 /**
  * Compares two sequences for equality
  *
@@ -83,4 +127,56 @@ PmReturn_t seqiter_getNext(pPmObj_t pobj, pPmObj_t *r_pitem);
  */
 PmReturn_t seqiter_new(pPmObj_t pobj, pPmObj_t *r_pobj);
 
+/**
+ * Returns a new iterator over the keys, values or items of a dict,
+ * which walks the dict's tables in place without copying them.
+ *
+ * @param   pdict Ptr to dict.
+ * @param   kind SEQITER_KEYS, SEQITER_VALUES or SEQITER_ITEMS
+ * @param   r_pobj Return by reference, new sequence iterator
+ * @return  Return status; TypeError if pdict is not a dict.
+ */
+PmReturn_t seqiter_newDict(pPmObj_t pdict, uint8_t kind, pPmObj_t *r_pobj);
+
+/**
+ * Returns a new xrange object of the ints from start up to, but not
+ * including, stop, counting by step
+ *
+ * @param   start First int.
+ * @param   stop Int that ends the sequence.
+ * @param   step Nonzero difference between consecutive ints.
+ * @param   r_pobj Return by reference, new xrange
+ * @return  Return status.
+ */
+PmReturn_t xrange_new(int32_t start, int32_t stop, int32_t step,
+                      pPmObj_t *r_pobj);
+
+/**
+ * Returns a copy of the xrange for GET_ITER to hand to FOR_ITER
+ *
+ * @param   pobj Ptr to xrange.
+ * @param   r_pobj Return by reference, new xrange iterator
+ * @return  Return status.
+ */
+PmReturn_t xrange_getIter(pPmObj_t pobj, pPmObj_t *r_pobj);
+
+/**
+ * Returns the next int from the xrange iterator and advances it
+ *
+ * @param   pobj Ptr to xrange iterator.
+ * @param   r_pitem Return arg, the next int.
+ * @return  Return status; PM_RET_EX_STOP at the end of the xrange.
+ */
+PmReturn_t xrange_getNext(pPmObj_t pobj, pPmObj_t *r_pitem);
+
+#ifdef HAVE_PRINT
+/**
+ * Prints out an xrange the way it would be constructed
+ *
+ * @param pobj Object to print.
+ * @return Return status
+ */
+PmReturn_t xrange_print(pPmObj_t pobj);
+#endif /* HAVE_PRINT */
+
 #endif /* __SEQ_H__ */
@@ -0,0 +1,300 @@
+/*
+# This file is Copyright 2013 Dean Hall.
+# This file is part of the PyMite VM.
+# This file is licensed under the MIT License.
+# See the LICENSE file for details.
+*/
+
+
+#undef __FILE_ID__
+#define __FILE_ID__ 0x1B
+
+
+/**
+ * \file
+ * \brief Set Object Type
+ *
+ * Set and frozenset object type operations.
+ */
+
+
+#include "pm.h"
+#ifdef HAVE_SET
+
+
+PmReturn_t
+set_new(uint8_t frozen, pPmObj_t *r_pset)
+{
+    PmReturn_t retval;
+    pPmSet_t pset;
+    pPmObj_t pdict;
+    uint8_t *pchunk;
+    uint8_t objid;
+
+    /* Allocate a set */
+    retval = heap_getChunk(sizeof(PmSet_t), &pchunk);
+    PM_RETURN_IF_ERROR(retval);
+    pset = (pPmSet_t)pchunk;
+    OBJ_SET_TYPE(pset, OBJ_TYPE_SET);
+    pset->s_frozen = frozen;
+    pset->s_dict = C_NULL;
+
+    /* Create the dict that holds the members */
+    heap_gcPushTempRoot((pPmObj_t)pset, &objid);
+    retval = dict_new(&pdict);
+    heap_gcPopTempRoot(objid);
+    PM_RETURN_IF_ERROR(retval);
+    pset->s_dict = (pPmDict_t)pdict;
+
+    *r_pset = (pPmObj_t)pset;
+    return retval;
+}
+
+
+PmReturn_t
+set_add(pPmObj_t pset, pPmObj_t pitem)
+{
+    C_ASSERT(OBJ_GET_TYPE(pset) == OBJ_TYPE_SET);
+
+    /* A member is a key of the set's dict; a member already there is kept */
+    return dict_setItem((pPmObj_t)((pPmSet_t)pset)->s_dict, pitem, PM_NONE);
+}
+
+
+#ifdef HAVE_DEL
+PmReturn_t
+set_remove(pPmObj_t pset, pPmObj_t pitem)
+{
+    C_ASSERT(OBJ_GET_TYPE(pset) == OBJ_TYPE_SET);
+
+    return dict_delItem((pPmObj_t)((pPmSet_t)pset)->s_dict, pitem);
+}
+#endif /* HAVE_DEL */
+
+
+PmReturn_t
+set_isIn(pPmObj_t pset, pPmObj_t pitem)
+{
+    PmReturn_t retval;
+    pPmObj_t pval;
+
+    C_ASSERT(OBJ_GET_TYPE(pset) == OBJ_TYPE_SET);
+
+    retval = dict_getItem((pPmObj_t)((pPmSet_t)pset)->s_dict, pitem, &pval);
+    if (retval == PM_RET_EX_KEY)
+    {
+        retval = PM_RET_NO;
+    }
+    return retval;
+}
+
+
+PmReturn_t
+set_update(pPmObj_t pset, pPmObj_t pseq)
+{
+    PmReturn_t retval = PM_RET_OK;
+    pPmObj_t pitem;
+    uint16_t index = 0;
+    uint16_t length;
+    uint8_t objid;
+
+    C_ASSERT(OBJ_GET_TYPE(pset) == OBJ_TYPE_SET);
+
+    switch (OBJ_GET_TYPE(pseq))
+    {
+        case OBJ_TYPE_SET:
+            /* The members of a set are the keys of its dict */
+            pseq = (pPmObj_t)((pPmSet_t)pseq)->s_dict;
+            /* Fallthrough */
+
+        case OBJ_TYPE_DIC:
+            while (dict_next(pseq, &index, &pitem, C_NULL) == PM_RET_OK)
+            {
+                retval = set_add(pset, pitem);
+                PM_RETURN_IF_ERROR(retval);
+            }
+            break;
+
+        default:
+            /* Raise TypeError if the object is not a sequence */
+            retval = seq_getLength(pseq, &length);
+            PM_RETURN_IF_ERROR(retval);
+
+            for (index = 0; index < length; index++)
+            {
+                retval = seq_getSubscript(pseq, (int16_t)index, &pitem);
+                PM_RETURN_IF_ERROR(retval);
+
+                /* The item may be new (a char of a string) */
+                heap_gcPushTempRoot(pitem, &objid);
+                retval = set_add(pset, pitem);
+                heap_gcPopTempRoot(objid);
+                PM_RETURN_IF_ERROR(retval);
+            }
+            break;
+    }
+
+    return retval;
+}
+
+
+PmReturn_t
+set_union(pPmObj_t pset, pPmObj_t pseq, pPmObj_t *r_pset)
+{
+    PmReturn_t retval;
+    pPmObj_t pnew;
+    uint8_t objid;
+
+    C_ASSERT(OBJ_GET_TYPE(pset) == OBJ_TYPE_SET);
+
+    retval = set_new(((pPmSet_t)pset)->s_frozen, &pnew);
+    PM_RETURN_IF_ERROR(retval);
+
+    heap_gcPushTempRoot(pnew, &objid);
+    retval = set_update(pnew, pset);
+    if (retval == PM_RET_OK)
+    {
+        retval = set_update(pnew, pseq);
+    }
+    heap_gcPopTempRoot(objid);
+    PM_RETURN_IF_ERROR(retval);
+
+    *r_pset = pnew;
+    return retval;
+}
+
+
+PmReturn_t
+set_intersection(pPmObj_t pset, pPmObj_t pseq, pPmObj_t *r_pset)
+{
+    PmReturn_t retval;
+    pPmObj_t pother = pseq;
+    pPmObj_t pnew = C_NULL;
+    pPmObj_t pitem;
+    uint16_t index = 0;
+    uint8_t objid;
+    uint8_t objid2;
+
+    C_ASSERT(OBJ_GET_TYPE(pset) == OBJ_TYPE_SET);
+
+    /* Members are looked up in the other object, so make it a set */
+    if (OBJ_GET_TYPE(pseq) != OBJ_TYPE_SET)
+    {
+        retval = set_new(C_TRUE, &pother);
+        PM_RETURN_IF_ERROR(retval);
+        heap_gcPushTempRoot(pother, &objid);
+        retval = set_update(pother, pseq);
+        heap_gcPopTempRoot(objid);
+        PM_RETURN_IF_ERROR(retval);
+    }
+
+    heap_gcPushTempRoot(pother, &objid);
+    retval = set_new(((pPmSet_t)pset)->s_frozen, &pnew);
+    if (retval == PM_RET_OK)
+    {
+        /* Keep each member of the set that is in the other */
+        heap_gcPushTempRoot(pnew, &objid2);
+        while (dict_next((pPmObj_t)((pPmSet_t)pset)->s_dict, &index,
+                         &pitem, C_NULL) == PM_RET_OK)
+        {
+            retval = set_isIn(pother, pitem);
+            if (retval == PM_RET_OK)
+            {
+                retval = set_add(pnew, pitem);
+            }
+            else if (retval == PM_RET_NO)
+            {
+                retval = PM_RET_OK;
+            }
+            PM_BREAK_IF_ERROR(retval);
+        }
+    }
+    heap_gcPopTempRoot(objid);
+    PM_RETURN_IF_ERROR(retval);
+
+    *r_pset = pnew;
+    return retval;
+}
+
+
+PmReturn_t
+set_intersectionUpdate(pPmObj_t pset, pPmObj_t pseq)
+{
+    PmReturn_t retval;
+    pPmObj_t pnew;
+
+    C_ASSERT(OBJ_GET_TYPE(pset) == OBJ_TYPE_SET);
+
+    /* Take the members of the intersection; its set head becomes garbage */
+    retval = set_intersection(pset, pseq, &pnew);
+    PM_RETURN_IF_ERROR(retval);
+    ((pPmSet_t)pset)->s_dict = ((pPmSet_t)pnew)->s_dict;
+
+    return retval;
+}
+
+
+int8_t
+set_compare(pPmObj_t pset1, pPmObj_t pset2)
+{
+    C_ASSERT(OBJ_GET_TYPE(pset1) == OBJ_TYPE_SET);
+    C_ASSERT(OBJ_GET_TYPE(pset2) == OBJ_TYPE_SET);
+
+    /* All values are None, so the dicts match if their keys do */
+    return dict_compare((pPmObj_t)((pPmSet_t)pset1)->s_dict,
+                        (pPmObj_t)((pPmSet_t)pset2)->s_dict);
+}
+
+
+uint16_t
+set_hash(pPmObj_t pset)
+{
+    uint16_t hash;
+    uint16_t h;
+    uint16_t index = 0;
+    pPmObj_t pitem;
+
+    C_ASSERT(OBJ_GET_TYPE(pset) == OBJ_TYPE_SET);
+
+    /* Combine the member hashes so their order does not matter */
+    hash = SET_GET_LENGTH(pset);
+    while (dict_next((pPmObj_t)((pPmSet_t)pset)->s_dict, &index,
+                     &pitem, C_NULL) == PM_RET_OK)
+    {
+        h = obj_hash(pitem);
+        hash ^= h ^ (h << 7);
+    }
+    return hash;
+}
+
+
+#ifdef HAVE_PRINT
+PmReturn_t
+set_print(pPmObj_t pset)
+{
+    PmReturn_t retval = PM_RET_OK;
+    uint16_t index = 0;
+    uint16_t n = 0;
+    pPmObj_t pitem;
+
+    C_ASSERT(OBJ_GET_TYPE(pset) == OBJ_TYPE_SET);
+
+    sli_puts(SET_IS_FROZEN(pset)
+             ? (uint8_t *)"frozenset([" : (uint8_t *)"set([");
+    while (dict_next((pPmObj_t)((pPmSet_t)pset)->s_dict, &index,
+                     &pitem, C_NULL) == PM_RET_OK)
+    {
+        if (n++ != 0)
+        {
+            plat_putByte(',');
+            plat_putByte(' ');
+        }
+        retval = obj_print(pitem, C_FALSE, C_TRUE);
+        PM_RETURN_IF_ERROR(retval);
+    }
+
+    plat_putByte(']');
+    return plat_putByte(')');
+}
+#endif /* HAVE_PRINT */
+#endif /* HAVE_SET */
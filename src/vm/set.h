@@ -0,0 +1,163 @@
+/*
+# This file is Copyright 2013 Dean Hall.
+# This file is part of the PyMite VM.
+# This file is licensed under the MIT License.
+# See the LICENSE file for details.
+*/
+
+
+#ifndef __SET_H__
+#define __SET_H__
+
+
+/**
+ * \file
+ * \brief Set Object Type
+ *
+ * Set and frozenset object type header.
+ */
+
+
+/** Returns true if the set obj is a frozenset */
+#define SET_IS_FROZEN(pset) (((pPmSet_t)(pset))->s_frozen != 0)
+
+/** Returns the number of members of the set obj */
+#define SET_GET_LENGTH(pset) (((pPmSet_t)(pset))->s_dict->length)
+
+
+/**
+ * Set
+ *
+ * An unordered collection of unique hashable objects.
+ * The members are the keys of a dict whose values are all None,
+ * so a set is hashed and probed exactly as a dict is.
+ * A frozenset is a set that cannot be changed after it is made;
+ * unlike a set, it is hashable.
+ */
+typedef struct PmSet_s
+{
+    /** Object descriptor */
+    PmObjDesc_t od;
+
+    /** Nonzero if this is a frozenset */
+    uint8_t s_frozen;
+
+    /** Dict whose keys are the members */
+    pPmDict_t s_dict;
+} PmSet_t,
+ *pPmSet_t;
+
+
+/**
+ * Allocates a new, empty set.
+ *
+ * @param   frozen Nonzero to make a frozenset
+ * @param   r_pset Return; Addr of ptr to set
+ * @return  Return status
+ */
+PmReturn_t set_new(uint8_t frozen, pPmObj_t *r_pset);
+
+/**
+ * Adds the item to the set if it is not already a member.
+ * Raises TypeError if the item is not hashable.
+ * Does not check whether the set is frozen, so frozensets can be filled.
+ *
+ * @param   pset Ptr to set
+ * @param   pitem Ptr to item to add
+ * @return  Return status
+ */
+PmReturn_t set_add(pPmObj_t pset, pPmObj_t pitem);
+
+#ifdef HAVE_DEL
+/**
+ * Removes the item from the set.
+ * Raises KeyError if the item is not a member.
+ *
+ * @param   pset Ptr to set
+ * @param   pitem Ptr to item to remove
+ * @return  Return status
+ */
+PmReturn_t set_remove(pPmObj_t pset, pPmObj_t pitem);
+#endif /* HAVE_DEL */
+
+/**
+ * Tests if the item is a member of the set.
+ *
+ * @param   pset Ptr to set
+ * @param   pitem Ptr to item to find
+ * @return  PM_RET_OK if the item is a member, PM_RET_NO if not
+ */
+PmReturn_t set_isIn(pPmObj_t pset, pPmObj_t pitem);
+
+/**
+ * Adds every item of the iterable to the set.
+ * The iterable may be a set, dict (its keys), string, tuple, list
+ * or any other object that seq_getSubscript() supports.
+ *
+ * @param   pset Ptr to set
+ * @param   pseq Ptr to iterable object
+ * @return  Return status
+ */
+PmReturn_t set_update(pPmObj_t pset, pPmObj_t pseq);
+
+/**
+ * Creates a new set with the members of the set and the items of
+ * the iterable.  The new set is a frozenset if pset is.
+ *
+ * @param   pset Ptr to set
+ * @param   pseq Ptr to iterable object
+ * @param   r_pset Return; Addr of ptr to new set
+ * @return  Return status
+ */
+PmReturn_t set_union(pPmObj_t pset, pPmObj_t pseq, pPmObj_t *r_pset);
+
+/**
+ * Creates a new set with the members of the set that are also
+ * items of the iterable.  The new set is a frozenset if pset is.
+ *
+ * @param   pset Ptr to set
+ * @param   pseq Ptr to iterable object
+ * @param   r_pset Return; Addr of ptr to new set
+ * @return  Return status
+ */
+PmReturn_t set_intersection(pPmObj_t pset, pPmObj_t pseq, pPmObj_t *r_pset);
+
+/**
+ * Removes the members of the set that are not items of the iterable.
+ *
+ * @param   pset Ptr to set
+ * @param   pseq Ptr to iterable object
+ * @return  Return status
+ */
+PmReturn_t set_intersectionUpdate(pPmObj_t pset, pPmObj_t pseq);
+
+/**
+ * Returns C_SAME if the two sets have the same members.
+ * A set and a frozenset with the same members are the same.
+ *
+ * @param   pset1 Ptr to a set
+ * @param   pset2 Ptr to another set
+ * @return  C_SAME or C_DIFFER
+ */
+int8_t set_compare(pPmObj_t pset1, pPmObj_t pset2);
+
+/**
+ * Returns the hash of the members of a set, which does not depend on
+ * their order.  Only a frozenset can be a dict key or set member.
+ *
+ * @param   pset Ptr to a set
+ * @return  Hash of the members
+ */
+uint16_t set_hash(pPmObj_t pset);
+
+#ifdef HAVE_PRINT
+/**
+ * Prints out a set as set([...]) or frozenset([...]).
+ *
+ * @param   pset Ptr to set
+ * @return  Return status
+ */
+PmReturn_t set_print(pPmObj_t pset);
+#endif /* HAVE_PRINT */
+
+#endif /* __SET_H__ */
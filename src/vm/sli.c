@@ -73,6 +73,26 @@ sli_memcpy(unsigned char *to, unsigned char const *from, unsigned int n)
 }
 
 
+void *
+sli_memmove(unsigned char *to, unsigned char const *from, unsigned int n)
+{
+    /* Copy forward unless the destination overlaps the end of the source */
+    if ((to <= from) || (to >= (from + n)))
+    {
+        return sli_memcpy(to, from, n);
+    }
+
+    /* Copy backward */
+    to += n;
+    from += n;
+    for (; n > 0; n--)
+    {
+        *--to = *--from;
+    }
+    return to;
+}
+
+
 int
 sli_strlen(char const *s)
 {
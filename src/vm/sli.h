@@ -50,6 +50,7 @@
 #include <string.h>
 
 #define sli_memcpy(to, from, n) memcpy((to), (from), (n))
+#define sli_memmove(to, from, n) memmove((to), (from), (n))
 #define sli_strcmp(s1, s2)      strcmp((s1),(s2))
 #define sli_strlen(s)           strlen(s)
 #define sli_strncmp(s1, s2, n)  strncmp((s1),(s2),(n))
@@ -67,6 +68,18 @@
  */
 void *sli_memcpy(unsigned char *to, unsigned char const *from, unsigned int n);
 
+/**
+ * Copies a block of memory in RAM.  The blocks may overlap.
+ *
+ * @param   to The destination address.
+ * @param   from The source address.
+ * @param   n The number of bytes to copy.
+ * @return  The initial pointer value of the destination
+ * @see     memmove
+ */
+void *sli_memmove(unsigned char *to, unsigned char const *from,
+                  unsigned int n);
+
 /**
  * Compares two strings.
  *
@@ -21,16 +21,130 @@
 
 
 #if USE_STRING_CACHE
-/** String obj cachche: a list of all string objects. */
-static pPmString_t pstrcache = C_NULL;
+/** String obj cache: a hash table of all string objects. */
+static PM_PLAT_TLS pPmString_t pstrcache[STRING_CACHE_NUM_BUCKETS];
 #endif /* USE_STRING_CACHE */
 
 
+/** The number of bytes a string buffer can hold when it is first made */
+#define STRING_BUF_MIN_CAPACITY 16
+
+/**
+ * The number of bytes a string buffer's chunk can hold,
+ * leaving room for a null terminator
+ */
+#define STRING_BUF_CAPACITY(pbuf) \
+    (PM_OBJ_GET_SIZE(pbuf) - sizeof(PmString_t))
+
 /* The following 2 ascii values are used to escape printing to ipm */
 #define REPLY_TERMINATOR 0x04
 #define ESCAPE_CHAR 0x1B
 
 
+/*
+ * This function does not fill in the string contents
+ * and should only be called by other string functions.
+ * The new string is not in the string cache; pass it to string_intern()
+ * once it is filled.
+ */
+static PmReturn_t
+string_newFromLength(uint16_t len, pPmObj_t *r_pstring)
+{
+    PmReturn_t retval;
+    pPmString_t pstr;
+    uint8_t *pchunk;
+
+    /* Get space for String obj */
+    retval = heap_getChunk(sizeof(PmString_t) + len, &pchunk);
+    PM_RETURN_IF_ERROR(retval);
+    pstr = (pPmString_t)pchunk;
+
+    /* Fill the string obj */
+    OBJ_SET_TYPE(pstr, OBJ_TYPE_STR);
+    pstr->length = len;
+    pstr->hash = 0;
+
+#if USE_STRING_CACHE
+    pstr->next = C_NULL;
+#endif
+
+    *r_pstring = (pPmObj_t)pstr;
+    return retval;
+}
+
+
+/*
+ * Makes a string view of len chars at pval, which are held by the parent
+ * string pparent (or are in program memory if pparent is C_NULL).
+ */
+static PmReturn_t
+string_newView(uint8_t const *pval, uint16_t len, pPmString_t pparent,
+               pPmObj_t *r_pview)
+{
+    PmReturn_t retval;
+    pPmStringView_t pview;
+    uint8_t *pchunk;
+
+    retval = heap_getChunk(sizeof(PmStringView_t), &pchunk);
+    PM_RETURN_IF_ERROR(retval);
+    pview = (pPmStringView_t)pchunk;
+    OBJ_SET_TYPE(pview, OBJ_TYPE_SVW);
+    pview->length = len;
+    pview->hash = 0;
+    pview->val = pval;
+    pview->pstr = pparent;
+
+    *r_pview = (pPmObj_t)pview;
+    return retval;
+}
+
+
+/*
+ * Interns a newly filled String object.
+ * If USE_STRING_CACHE is defined nonzero, looks for a twin in the string
+ * cache bucket of the string's hash.  If found, frees the new string and
+ * returns the twin.  Otherwise, inserts the new string into the cache.
+ */
+static PmReturn_t
+string_intern(pPmString_t pstr, pPmObj_t *r_pstring)
+{
+#if USE_STRING_CACHE
+    pPmString_t *ppbucket;
+    pPmString_t pcacheentry;
+    uint16_t hash;
+
+    hash = string_hash((pPmObj_t)pstr);
+    ppbucket = &pstrcache[hash & (STRING_CACHE_NUM_BUCKETS - 1)];
+
+    /* Check for twin string in cache */
+    for (pcacheentry = *ppbucket;
+         pcacheentry != C_NULL; pcacheentry = pcacheentry->next)
+    {
+        /* If string already exists */
+        if ((pcacheentry->hash == hash)
+            && (pcacheentry->length == pstr->length)
+            && (sli_strncmp((char const *)&(pcacheentry->val),
+                            (char const *)&(pstr->val),
+                            pstr->length) == 0))
+        {
+            /* Return ptr to old */
+            *r_pstring = (pPmObj_t)pcacheentry;
+
+            /* Free the string */
+            return heap_freeChunk((pPmObj_t)pstr);
+        }
+    }
+
+    /* Insert string obj into cache */
+    pstr->next = *ppbucket;
+    *ppbucket = pstr;
+#endif /* USE_STRING_CACHE */
+
+    *r_pstring = (pPmObj_t)pstr;
+    return PM_RET_OK;
+}
+
+
 /*
  * If USE_STRING_CACHE is defined nonzero, the string cache
  * will be searched for an existing String object.
@@ -46,15 +160,23 @@ string_create(PmMemSpace_t memspace, uint8_t const **paddr, int16_t len,
     uint8_t *pdst = C_NULL;
     uint8_t const *psrc = C_NULL;
 
-#if USE_STRING_CACHE
-    pPmString_t pcacheentry = C_NULL;
-#endif /* USE_STRING_CACHE */
     uint8_t *pchunk;
 
     /* If loading from an image, get length from the image */
     if (len < 0)
     {
         len = mem_getWord(memspace, paddr);
+
+#if PM_PLAT_PROGMEM_DIRECT
+        /* A long string in program memory is viewed in place, not copied */
+        if ((memspace == MEMSPACE_PROG)
+            && (len >= STRING_IMAGE_VIEW_MIN_LENGTH))
+        {
+            retval = string_newView(*paddr, len, C_NULL, r_pstring);
+            *paddr += len;
+            return retval;
+        }
+#endif /* PM_PLAT_PROGMEM_DIRECT */
     }
 
     /* If loading from a C string, get its strlen (first null) */
@@ -71,6 +193,7 @@ string_create(PmMemSpace_t memspace, uint8_t const **paddr, int16_t len,
     /* Fill the string obj */
     OBJ_SET_TYPE(pstr, OBJ_TYPE_STR);
     pstr->length = len * n;
+    pstr->hash = 0;
 
     /* Copy C-string into String obj */
     pdst = (uint8_t *)&(pstr->val);
@@ -89,31 +212,7 @@ string_create(PmMemSpace_t memspace, uint8_t const **paddr, int16_t len,
         *pdst = 0;
     }
 
-#if USE_STRING_CACHE
-    /* Check for twin string in cache */
-    for (pcacheentry = pstrcache;
-         pcacheentry != C_NULL; pcacheentry = pcacheentry->next)
-    {
-        /* If string already exists */
-        if (string_compare(pcacheentry, pstr) == C_SAME)
-        {
-            /* Free the string */
-            retval = heap_freeChunk((pPmObj_t)pstr);
-
-            /* Return ptr to old */
-            *r_pstring = (pPmObj_t)pcacheentry;
-            return retval;
-        }
-    }
-
-    /* Insert string obj into cache */
-    pstr->next = pstrcache;
-    pstrcache = pstr;
-
-#endif /* USE_STRING_CACHE */
-
-    *r_pstring = (pPmObj_t)pstr;
-    return PM_RET_OK;
+    return string_intern(pstr, r_pstring);
 }
 
 
@@ -128,68 +227,113 @@ string_newFromChar(uint8_t const c, pPmObj_t *r_pstring)
     cstr[1] = '\0';
     pcstr = cstr;
 
-    retval = string_new(&pcstr, r_pstring);
+    /* Give the length so that a null character makes a 1-char string */
+    retval = string_newWithLen(&pcstr, 1, r_pstring);
+
+    return retval;
+}
+
 
-    /* If c was a null character, force the length to 1 */
-    if (c == '\0')
+int8_t
+string_compare(pPmObj_t pstr1, pPmObj_t pstr2)
+{
+    uint16_t len;
+
+    if (pstr1 == pstr2)
     {
-        ((pPmString_t)*r_pstring)->length = 1;
+        return C_SAME;
     }
 
-    return retval;
+#if USE_STRING_CACHE
+    /* Every string is interned, so equal strings are the same object */
+    if ((OBJ_GET_TYPE(pstr1) == OBJ_TYPE_STR)
+        && (OBJ_GET_TYPE(pstr2) == OBJ_TYPE_STR))
+    {
+        return C_DIFFER;
+    }
+#endif /* USE_STRING_CACHE */
+
+    /* Return false if lengths are not equal */
+    len = STRING_GET_LENGTH(pstr1);
+    if (len != STRING_GET_LENGTH(pstr2))
+    {
+        return C_DIFFER;
+    }
+
+    /* Compare the strings' contents */
+    return sli_strncmp((char const *)STRING_GET_VAL(pstr1),
+                       (char const *)STRING_GET_VAL(pstr2),
+                       len) == 0 ? C_SAME : C_DIFFER;
 }
 
 
-#ifdef HAVE_SLICE
-/* 
- * This function does not fill in the string contents 
- * and should only be called by other string functions
- */
-static PmReturn_t
-string_newFromLength(uint16_t len, pPmObj_t *r_pstring)
+uint16_t
+string_hash(pPmObj_t pstr)
 {
-    PmReturn_t retval;
-    pPmString_t pstr;
-    uint8_t *pchunk;
-
-    /* Get space for String obj */
-    retval = heap_getChunk(sizeof(PmString_t) + len, &pchunk);
-    PM_RETURN_IF_ERROR(retval);
-    pstr = (pPmString_t)pchunk;
+    uint16_t *phash;
+    uint8_t const *pc;
+    uint16_t hash;
+    uint16_t len;
+    uint16_t i;
 
-    /* Fill the string obj */
-    OBJ_SET_TYPE(pstr, OBJ_TYPE_STR);
-    pstr->length = len;
+    /* Return the cached hash if it has been computed */
+    phash = (OBJ_GET_TYPE(pstr) == OBJ_TYPE_STR)
+            ? &((pPmString_t)pstr)->hash
+            : &((pPmStringView_t)pstr)->hash;
+    if (*phash != 0)
+    {
+        return *phash;
+    }
 
-#if USE_STRING_CACHE
-    pstr->next = C_NULL;
-#endif
+    /* Compute the hash (djb2) of the string's contents */
+    pc = STRING_GET_VAL(pstr);
+    len = STRING_GET_LENGTH(pstr);
+    hash = 5381;
+    for (i = 0; i < len; i++)
+    {
+        hash = (hash << 5) + hash + pc[i];
+    }
 
-    *r_pstring = (pPmObj_t)pstr;
-    return retval;
+    /* Zero means not computed, so never cache it */
+    if (hash == 0)
+    {
+        hash = 1;
+    }
+    *phash = hash;
+    return hash;
 }
-#endif /* HAVE_SLICE */
 
 
-int8_t
-string_compare(pPmString_t pstr1, pPmString_t pstr2)
+PmReturn_t
+string_materialize(pPmObj_t pobj, pPmObj_t *r_pstring)
 {
-    /* Return false if lengths are not equal */
-    if (pstr1->length != pstr2->length)
+    PmReturn_t retval;
+    pPmObj_t pstr;
+    uint16_t len;
+
+    if (OBJ_GET_TYPE(pobj) == OBJ_TYPE_STR)
     {
-        return C_DIFFER;
+        *r_pstring = pobj;
+        return PM_RET_OK;
     }
 
-    /* Compare the strings' contents */
-    return sli_strncmp((char const *)&(pstr1->val),
-                       (char const *)&(pstr2->val),
-                       pstr1->length) == 0 ? C_SAME : C_DIFFER;
+    C_ASSERT(OBJ_GET_TYPE(pobj) == OBJ_TYPE_SVW);
+
+    /* Copy the view's chars into a new string and intern it */
+    len = ((pPmStringView_t)pobj)->length;
+    retval = string_newFromLength(len, &pstr);
+    PM_RETURN_IF_ERROR(retval);
+    sli_memcpy(((pPmString_t)pstr)->val, STRING_GET_VAL(pobj), len);
+    ((pPmString_t)pstr)->val[len] = '\0';
+    ((pPmString_t)pstr)->hash = ((pPmStringView_t)pobj)->hash;
+
+    return string_intern((pPmString_t)pstr, r_pstring);
 }
 
 
 #ifdef HAVE_PRINT
 PmReturn_t
-string_printFormattedBytes(uint8_t *pb, uint8_t is_escaped, uint16_t n)
+string_printFormattedBytes(uint8_t const *pb, uint8_t is_escaped, uint16_t n)
 {
     uint16_t i;
     uint8_t ch;
@@ -259,15 +403,15 @@ string_print(pPmObj_t pstr, uint8_t is_escaped)
     C_ASSERT(pstr != C_NULL);
 
     /* Ensure string obj */
-    if (OBJ_GET_TYPE(pstr) != OBJ_TYPE_STR)
+    if (!STRING_IS_STRING(pstr))
     {
         PM_RAISE(retval, PM_RET_EX_TYPE);
         return retval;
     }
 
-    retval = string_printFormattedBytes(&(((pPmString_t)pstr)->val[0]),
+    retval = string_printFormattedBytes(STRING_GET_VAL(pstr),
                                         is_escaped,
-                                        ((pPmString_t)pstr)->length);
+                                        STRING_GET_LENGTH(pstr));
 
     return retval;
 }
@@ -277,7 +421,14 @@ string_print(pPmObj_t pstr, uint8_t is_escaped)
 PmReturn_t
 string_cacheInit(void)
 {
-    pstrcache = C_NULL;
+#if USE_STRING_CACHE
+    uint16_t i;
+
+    for (i = 0; i < STRING_CACHE_NUM_BUCKETS; i++)
+    {
+        pstrcache[i] = C_NULL;
+    }
+#endif /* USE_STRING_CACHE */
 
     return PM_RET_OK;
 }
@@ -287,7 +438,7 @@ PmReturn_t
 string_getCache(pPmString_t **r_ppstrcache)
 {
 #if USE_STRING_CACHE
-    *r_ppstrcache = &pstrcache;
+    *r_ppstrcache = pstrcache;
 #else
     *r_ppstrcache = C_NULL;
 #endif
@@ -296,58 +447,192 @@ string_getCache(pPmString_t **r_ppstrcache)
 
 
 PmReturn_t
-string_concat(pPmString_t pstr1, pPmString_t pstr2, pPmObj_t *r_pstring)
+string_concat(pPmObj_t pstr1, pPmObj_t pstr2, pPmObj_t *r_pstring)
 {
     PmReturn_t retval = PM_RET_OK;
     pPmString_t pstr = C_NULL;
     uint8_t *pdst = C_NULL;
     uint8_t const *psrc = C_NULL;
-#if USE_STRING_CACHE
-    pPmString_t pcacheentry = C_NULL;
-#endif /* USE_STRING_CACHE */
     uint8_t *pchunk;
     uint16_t len;
 
     /* Create the String obj */
-    len = pstr1->length + pstr2->length;
+    len = STRING_GET_LENGTH(pstr1) + STRING_GET_LENGTH(pstr2);
     retval = heap_getChunk(sizeof(PmString_t) + len, &pchunk);
     PM_RETURN_IF_ERROR(retval);
     pstr = (pPmString_t)pchunk;
     OBJ_SET_TYPE(pstr, OBJ_TYPE_STR);
     pstr->length = len;
+    pstr->hash = 0;
 
     /* Concatenate C-strings into String obj and apply null terminator */
     pdst = (uint8_t *)&(pstr->val);
-    psrc = (uint8_t const *)&(pstr1->val);
-    mem_copy(MEMSPACE_RAM, &pdst, &psrc, pstr1->length);
-    psrc = (uint8_t const *)&(pstr2->val);
-    mem_copy(MEMSPACE_RAM, &pdst, &psrc, pstr2->length);
+    psrc = STRING_GET_VAL(pstr1);
+    mem_copy(MEMSPACE_RAM, &pdst, &psrc, STRING_GET_LENGTH(pstr1));
+    psrc = STRING_GET_VAL(pstr2);
+    mem_copy(MEMSPACE_RAM, &pdst, &psrc, STRING_GET_LENGTH(pstr2));
     *pdst = '\0';
 
-#if USE_STRING_CACHE
-    /* Check for twin string in cache */
-    for (pcacheentry = pstrcache;
-         pcacheentry != C_NULL; pcacheentry = pcacheentry->next)
+    return string_intern(pstr, r_pstring);
+}
+
+
+/*
+ * Gets the bytes of item i of a string, list or tuple being joined.
+ * An item of a string is one character.
+ * Raises TypeError if an item of a list or tuple is not a string.
+ */
+static PmReturn_t
+string_joinItem(pPmObj_t pseq, uint16_t i, uint8_t const **r_pc,
+                uint16_t *r_len)
+{
+    PmReturn_t retval = PM_RET_OK;
+    pPmObj_t pitem;
+
+    if (STRING_IS_STRING(pseq))
     {
-        /* If string already exists */
-        if (string_compare(pcacheentry, pstr) == C_SAME)
+        *r_pc = &STRING_GET_VAL(pseq)[i];
+        *r_len = 1;
+        return retval;
+    }
+
+    retval = seq_getSubscript(pseq, (int16_t)i, &pitem);
+    PM_RETURN_IF_ERROR(retval);
+    if (!STRING_IS_STRING(pitem))
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+    *r_pc = STRING_GET_VAL(pitem);
+    *r_len = STRING_GET_LENGTH(pitem);
+    return retval;
+}
+
+
+PmReturn_t
+string_join(pPmString_t psep, pPmObj_t pseq, pPmObj_t *r_pstring)
+{
+    PmReturn_t retval = PM_RET_OK;
+    pPmObj_t pstr;
+    uint8_t const *pc;
+    uint8_t *pdst;
+    uint32_t len;
+    uint16_t itemlen;
+    uint16_t n;
+    uint16_t i;
+
+    /* Raise TypeError if the sequence is not a string, list or tuple */
+    if (!STRING_IS_STRING(pseq)
+        && (OBJ_GET_TYPE(pseq) != OBJ_TYPE_LST)
+        && (OBJ_GET_TYPE(pseq) != OBJ_TYPE_TUP))
+    {
+        PM_RAISE(retval, PM_RET_EX_TYPE);
+        return retval;
+    }
+    retval = seq_getLength(pseq, &n);
+    PM_RETURN_IF_ERROR(retval);
+
+    /* Sum the lengths of the items and separators */
+    len = (n > 0) ? (uint32_t)(n - 1) * psep->length : 0;
+    for (i = 0; i < n; i++)
+    {
+        retval = string_joinItem(pseq, i, &pc, &itemlen);
+        PM_RETURN_IF_ERROR(retval);
+        len += itemlen;
+    }
+
+    /* Raise MemoryError if the result can not fit in a chunk */
+    if (len > (HEAP_MAX_LIVE_CHUNK_SIZE - sizeof(PmString_t)))
+    {
+        PM_RAISE(retval, PM_RET_EX_MEM);
+        return retval;
+    }
+
+    /* Fill one new string with the items and separators, then intern it */
+    retval = string_newFromLength((uint16_t)len, &pstr);
+    PM_RETURN_IF_ERROR(retval);
+    pdst = ((pPmString_t)pstr)->val;
+    for (i = 0; i < n; i++)
+    {
+        if (i > 0)
         {
-            /* Free the string */
-            retval = heap_freeChunk((pPmObj_t)pstr);
+            sli_memcpy(pdst, psep->val, psep->length);
+            pdst += psep->length;
+        }
+        retval = string_joinItem(pseq, i, &pc, &itemlen);
+        PM_RETURN_IF_ERROR(retval);
+        sli_memcpy(pdst, pc, itemlen);
+        pdst += itemlen;
+    }
+    *pdst = '\0';
 
-            /* Return ptr to old */
-            *r_pstring = (pPmObj_t)pcacheentry;
+    return string_intern((pPmString_t)pstr, r_pstring);
+}
+
+
+PmReturn_t
+string_bufReserve(pPmObj_t pbuf, uint16_t n, pPmObj_t *r_pbuf)
+{
+    PmReturn_t retval = PM_RET_OK;
+    uint32_t len;
+    uint32_t capacity;
+
+    len = (pbuf == C_NULL) ? 0 : ((pPmString_t)pbuf)->length;
+    capacity = (pbuf == C_NULL) ? 0 : STRING_BUF_CAPACITY(pbuf);
+
+    /* Return the same buffer if there is room for n more bytes */
+    if ((pbuf != C_NULL) && ((len + n) <= capacity))
+    {
+        *r_pbuf = pbuf;
+        return retval;
+    }
+
+    /* Double the capacity, or more if that is not enough */
+    capacity = (capacity < STRING_BUF_MIN_CAPACITY)
+               ? STRING_BUF_MIN_CAPACITY : (capacity << 1);
+    if (capacity < (len + n))
+    {
+        capacity = len + n;
+    }
+
+    /* Clip to the largest chunk; raise MemoryError if that is too small */
+    if (capacity > (HEAP_MAX_LIVE_CHUNK_SIZE - sizeof(PmString_t)))
+    {
+        capacity = HEAP_MAX_LIVE_CHUNK_SIZE - sizeof(PmString_t);
+        if (capacity < (len + n))
+        {
+            PM_RAISE(retval, PM_RET_EX_MEM);
             return retval;
         }
     }
 
-    /* Insert string obj into cache */
-    pstr->next = pstrcache;
-    pstrcache = pstr;
-#endif /* USE_STRING_CACHE */
+    /* Copy the contents to a bigger buffer, which is not in the cache */
+    retval = string_newFromLength((uint16_t)capacity, r_pbuf);
+    PM_RETURN_IF_ERROR(retval);
+    ((pPmString_t)*r_pbuf)->length = (uint16_t)len;
+    if (len > 0)
+    {
+        sli_memcpy(((pPmString_t)*r_pbuf)->val, ((pPmString_t)pbuf)->val,
+                   len);
+    }
+    return retval;
+}
 
-    *r_pstring = (pPmObj_t)pstr;
-    return PM_RET_OK;
+
+PmReturn_t
+string_bufGetValue(pPmObj_t pbuf, pPmObj_t *r_pstring)
+{
+    PmReturn_t retval;
+    pPmObj_t pstr;
+    uint16_t len;
+
+    len = ((pPmString_t)pbuf)->length;
+    retval = string_newFromLength(len, &pstr);
+    PM_RETURN_IF_ERROR(retval);
+    sli_memcpy(((pPmString_t)pstr)->val, ((pPmString_t)pbuf)->val, len);
+    ((pPmString_t)pstr)->val[len] = '\0';
+
+    return string_intern((pPmString_t)pstr, r_pstring);
 }
 
 
@@ -375,9 +660,6 @@ string_format(pPmString_t pstr, pPmObj_t parg, pPmObj_t *r_pstring)
     uint8_t expectedargcount = 0;
     pPmString_t pnewstr;
     uint8_t *pchunk;
-#if USE_STRING_CACHE
-    pPmString_t pcacheentry = C_NULL;
-#endif /* USE_STRING_CACHE */
 
     /* Get the first arg */
     pobj = parg;
@@ -504,6 +786,7 @@ string_format(pPmString_t pstr, pPmObj_t parg, pPmObj_t *r_pstring)
     pnewstr = (pPmString_t)pchunk;
     OBJ_SET_TYPE(pnewstr, OBJ_TYPE_STR);
     pnewstr->length = strsize;
+    pnewstr->hash = 0;
 
     /* Fill contents of String obj */
     strindex = 0;
@@ -611,31 +894,7 @@ string_format(pPmString_t pstr, pPmObj_t parg, pPmObj_t *r_pstring)
     }
     pnewstr->val[strindex] = '\0';
 
-#if USE_STRING_CACHE
-    /* Check for twin string in cache */
-    for (pcacheentry = pstrcache;
-         pcacheentry != C_NULL; pcacheentry = pcacheentry->next)
-    {
-        /* If string already exists */
-        if (string_compare(pcacheentry, pnewstr) == C_SAME)
-        {
-            /* Free the string */
-            retval = heap_freeChunk((pPmObj_t)pnewstr);
-
-            /* Return ptr to old */
-            *r_pstring = (pPmObj_t)pcacheentry;
-            return retval;
-        }
-    }
-
-    /* Insert string obj into cache */
-    pnewstr->next = pstrcache;
-    pstrcache = pnewstr;
-
-#endif /* USE_STRING_CACHE */
-
-    *r_pstring = (pPmObj_t)pnewstr;
-    return PM_RET_OK;
+    return string_intern(pnewstr, r_pstring);
 }
 #endif /* HAVE_STRING_FORMAT */
 
@@ -651,10 +910,12 @@ string_slice(pPmObj_t pstring, pPmObj_t pstart, pPmObj_t pend, pPmObj_t pstride,
     int32_t stride;
     uint16_t len;
     pPmObj_t pslice;
+    pPmString_t pparent;
+    uint8_t const *pc;
     int16_t i;
     int16_t j;
 
-    len = ((pPmString_t)pstring)->length;
+    len = STRING_GET_LENGTH(pstring);
 
     /* Handle the start index */
     if (OBJ_GET_TYPE(pstart) != OBJ_TYPE_INT)
@@ -717,26 +978,58 @@ string_slice(pPmObj_t pstring, pPmObj_t pstart, pPmObj_t pend, pPmObj_t pstride,
     }
     stride = ((pPmInt_t)pstride)-> val;
 
+    /* Raise ValueError if the stride is not positive */
+    if (stride <= 0)
+    {
+        PM_RAISE(retval, PM_RET_EX_VAL);
+        return retval;
+    }
+
+    /* A slice of the whole string is the string itself */
+    if ((start == 0) && (end == len) && (stride == 1))
+    {
+        *r_pslice = pstring;
+        return retval;
+    }
+
     /* New meaning for variable len */
     if (end > start)
     {
-        len = (end - start) / stride;
+        len = (end - start + stride - 1) / stride;
     }
     else
     {
         len = 0;
     }
+
+    /*
+     * Make a view of a long enough slice, unless its parent is much longer
+     * (a view of program memory has no parent to keep alive)
+     */
+    if ((stride == 1) && (len >= STRING_VIEW_MIN_LENGTH))
+    {
+        pparent = (OBJ_GET_TYPE(pstring) == OBJ_TYPE_STR)
+                  ? (pPmString_t)pstring
+                  : ((pPmStringView_t)pstring)->pstr;
+        if ((pparent == C_NULL)
+            || (pparent->length <= (uint32_t)len * STRING_VIEW_MAX_RATIO))
+        {
+            return string_newView(&STRING_GET_VAL(pstring)[start], len,
+                                  pparent, r_pslice);
+        }
+    }
+
     retval = string_newFromLength(len, &pslice);
     PM_RETURN_IF_ERROR(retval);
 
     /* Copy characters to slice and append null terminator */
+    pc = STRING_GET_VAL(pstring);
     for (j = 0, i = start; i < end; i += stride)
     {
-        ((pPmString_t)pslice)->val[j++] = ((pPmString_t)pstring)->val[i];
+        ((pPmString_t)pslice)->val[j++] = pc[i];
     }
     ((pPmString_t)pslice)->val[j++] = '\0';
 
-    *r_pslice = pslice;
-    return retval;
+    return string_intern((pPmString_t)pslice, r_pslice);
 }
 #endif /* HAVE_SLICE */
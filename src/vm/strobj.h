@@ -21,6 +21,63 @@
 /** Set to nonzero to enable string cache.  DO NOT REMOVE THE DEFINITION. */
 #define USE_STRING_CACHE 1
 
+/**
+ * Number of hash buckets in the string cache (must be a power of two).
+ * A platform may define this in plat.h to trade RAM for lookup time.
+ */
+#ifndef STRING_CACHE_NUM_BUCKETS
+#define STRING_CACHE_NUM_BUCKETS 64
+#endif
+
+/**
+ * A slice of a string at least this long is made as a string view
+ * (if its parent is not too much larger); a shorter slice is copied.
+ * A platform may define this in plat.h.
+ */
+#ifndef STRING_VIEW_MIN_LENGTH
+#define STRING_VIEW_MIN_LENGTH 8
+#endif
+
+/**
+ * A slice is copied instead of viewed if its parent string is more than this
+ * many times longer, so a small view does not keep a large string alive.
+ * A platform may define this in plat.h.
+ */
+#ifndef STRING_VIEW_MAX_RATIO
+#define STRING_VIEW_MAX_RATIO 8
+#endif
+
+/**
+ * Minimum length of a string constant in program memory that is loaded as a
+ * view of the code image instead of being copied to the heap and interned.
+ * Shorter constants are mostly identifiers that repeat across modules, so
+ * interning them saves more than viewing them would.
+ * A platform may define this in plat.h.
+ */
+#ifndef STRING_IMAGE_VIEW_MIN_LENGTH
+#define STRING_IMAGE_VIEW_MIN_LENGTH 16
+#endif
+
+/** Returns true if the object is a string or a string view */
+#define STRING_IS_STRING(pobj) \
+    ((OBJ_GET_TYPE(pobj) == OBJ_TYPE_STR) \
+     || (OBJ_GET_TYPE(pobj) == OBJ_TYPE_SVW))
+
+/**
+ * Returns a pointer to the chars of a string or string view.
+ * The chars of a view are not null terminated.
+ */
+#define STRING_GET_VAL(pobj) \
+    ((OBJ_GET_TYPE(pobj) == OBJ_TYPE_STR) \
+     ? (uint8_t const *)((pPmString_t)(pobj))->val \
+     : ((pPmStringView_t)(pobj))->val)
+
+/** Returns the length of a string or string view */
+#define STRING_GET_LENGTH(pobj) \
+    ((OBJ_GET_TYPE(pobj) == OBJ_TYPE_STR) \
+     ? ((pPmString_t)(pobj))->length \
+     : ((pPmStringView_t)(pobj))->length)
+
 
 /**
  * Loads a string from image
@@ -81,8 +138,11 @@ typedef struct PmString_s
     /** Length of string */
     uint16_t length;
 
+    /** Hash of the string's contents; zero until string_hash() computes it */
+    uint16_t hash;
+
 #if USE_STRING_CACHE
-    /** Ptr to next string in cache */
+    /** Ptr to next string in the same cache bucket */
     struct PmString_s *next;
 #endif                          /* USE_STRING_CACHE */
 
@@ -97,6 +157,39 @@ typedef struct PmString_s
  *pPmString_t;
 
 
+/**
+ * String view obj
+ *
+ * A string that refers to chars held elsewhere instead of holding a copy:
+ * in its parent string (made by slicing) or in a code image in directly
+ * addressable program memory (a string constant).  To Python code it is
+ * a str.  It is not in the string cache; it is materialized into an
+ * interned string where one is needed: as a dict key (if it has a parent)
+ * and as an arg to a native function that is not declared to take views.
+ */
+typedef struct PmStringView_s
+{
+    /** Object descriptor */
+    PmObjDesc_t od;
+
+    /** Length of the view */
+    uint16_t length;
+
+    /** Hash of the view's contents; zero until string_hash() computes it */
+    uint16_t hash;
+
+    /** Ptr to the view's first char */
+    uint8_t const *val;
+
+    /**
+     * Ptr to the parent string that holds the chars (never a view),
+     * or C_NULL if the chars are in program memory
+     */
+    pPmString_t pstr;
+} PmStringView_t,
+ *pPmStringView_t;
+
+
 /***************************************************************
  * Prototypes
  **************************************************************/
@@ -104,6 +197,8 @@ typedef struct PmString_s
 /**
  * Creates a new String obj.
  * If len is less than zero, load from a String image.
+ *      A string of at least STRING_IMAGE_VIEW_MIN_LENGTH chars in MEMSPACE_PROG
+ *      is returned as a view of the image if PM_PLAT_PROGMEM_DIRECT.
  * If len is zero, copy from a C string (which has a null terminator)
  * If len is positive, copy as many chars as given in the len argument
  *      A string image has the following structure:
@@ -142,20 +237,42 @@ PmReturn_t string_create(PmMemSpace_t memspace, uint8_t const **paddr,
 PmReturn_t string_newFromChar(uint8_t const c, pPmObj_t *r_pstring);
 
 /**
- * Compares two String objects for equality.
+ * Compares two String objects (or string views) for equality.
+ * With the string cache, every string is interned, so two strings are
+ * compared by pointer; a view is compared by its contents.
  *
- * @param   pstr1 Ptr to first string
- * @param   pstr2 Ptr to second string
+ * @param   pstr1 Ptr to first string or view
+ * @param   pstr2 Ptr to second string or view
  * @return  C_SAME if the strings are equivalent, C_DIFFER otherwise
  */
-int8_t string_compare(pPmString_t pstr1, pPmString_t pstr2);
+int8_t string_compare(pPmObj_t pstr1, pPmObj_t pstr2);
+
+/**
+ * Returns the hash of a String object's (or string view's) contents.
+ * The hash is computed on the first call and cached in the object.
+ *
+ * @param   pstr Ptr to string or view
+ * @return  The string's hash (never zero)
+ */
+uint16_t string_hash(pPmObj_t pstr);
+
+/**
+ * Returns the interned String object with the contents of the given string
+ * or string view.  A string is returned as is.
+ *
+ * @param   pobj Ptr to string or view
+ * @param   r_pstring Return by reference; ptr to String obj
+ *          (may be the address pobj was read from)
+ * @return  Return status
+ */
+PmReturn_t string_materialize(pPmObj_t pobj, pPmObj_t *r_pstring);
 
 #ifdef HAVE_PRINT
 /**
  * Sends out a string object bytewise. Escaping and framing is configurable
  * via is_escaped.
  *
- * @param pstr Ptr to string object
+ * @param pstr Ptr to string object or string view
  * @param is_escaped If 0, print out string as is. Otherwise escape unprintable
  *                   characters and surround string with single quotes.
  * @return Return status
@@ -172,20 +289,66 @@ PmReturn_t string_print(pPmObj_t pstr, uint8_t is_escaped);
 PmReturn_t string_cacheInit(void);
 
 
-/** Returns a pointer to the base of the string cache */
+/**
+ * Returns a pointer to the string cache, an array of
+ * STRING_CACHE_NUM_BUCKETS lists of strings chained by their next field.
+ * A string is in the bucket selected by the low bits of its hash.
+ */
 PmReturn_t string_getCache(pPmString_t **r_ppstrcache);
 
 /**
  * Returns a new string object that is the concatenation
- * of the two given strings.
+ * of the two given strings (or string views).
  *
- * @param pstr1 First source string
- * @param pstr2 Second source string
+ * @param pstr1 First source string or view
+ * @param pstr2 Second source string or view
  * @param r_pstring Return arg; ptr to new string object
  * @return Return status
  */
 PmReturn_t
-string_concat(pPmString_t pstr1, pPmString_t pstr2, pPmObj_t *r_pstring);
+string_concat(pPmObj_t pstr1, pPmObj_t pstr2, pPmObj_t *r_pstring);
+
+/**
+ * Returns a new string object that is the strings in the given list
+ * or tuple (or the characters of the given string) joined by the separator.
+ * Sums the lengths first, so the result is made with one allocation
+ * and interned once.
+ * Raises TypeError if pseq is not a string, list or tuple,
+ * or if it holds a non-string.
+ *
+ * @param psep Separator string
+ * @param pseq String, or list or tuple of strings
+ * @param r_pstring Return arg; ptr to new string object
+ * @return Return status
+ */
+PmReturn_t
+string_join(pPmString_t psep, pPmObj_t pseq, pPmObj_t *r_pstring);
+
+/**
+ * Makes room for n more bytes in a string buffer.
+ *
+ * A string buffer is a String object that is not in the string cache and is
+ * never given to Python code.  Its length is the number of bytes in use and
+ * its chunk may hold more.  If there is not enough room, a new buffer with
+ * at least twice the capacity is returned holding a copy of the contents.
+ * The caller must then drop its reference to the old buffer and may free it.
+ *
+ * @param pbuf String buffer, or C_NULL to make a new empty one
+ * @param n Number of bytes to make room for
+ * @param r_pbuf Return arg; ptr to the buffer with room for n more bytes
+ * @return Return status; MemoryError if the contents would not fit in
+ *         a chunk
+ */
+PmReturn_t string_bufReserve(pPmObj_t pbuf, uint16_t n, pPmObj_t *r_pbuf);
+
+/**
+ * Returns a new string object holding the contents of a string buffer.
+ *
+ * @param pbuf String buffer
+ * @param r_pstring Return arg; ptr to new string object
+ * @return Return status
+ */
+PmReturn_t string_bufGetValue(pPmObj_t pbuf, pPmObj_t *r_pstring);
 
 /**
  * Returns a new string object that is created from the given format string
@@ -207,16 +370,19 @@ PmReturn_t string_format(pPmString_t pstr, pPmObj_t parg, pPmObj_t *r_pstring);
  * @param n Number of bytes to print
  * @return Return status
  */
-PmReturn_t string_printFormattedBytes(uint8_t *pb,
+PmReturn_t string_printFormattedBytes(uint8_t const *pb,
                                       uint8_t is_escaped,
                                       uint16_t n);
 #endif /* HAVE_PRINT */
 
 #ifdef HAVE_SLICE
 /**
- * Creates a new string containing the described slice of the given string
+ * Creates a new string containing the described slice of the given string.
+ * A slice with a stride of one that is at least STRING_VIEW_MIN_LENGTH long
+ * is made as a view of the parent string (unless the parent is more than
+ * STRING_VIEW_MAX_RATIO times longer), which is neither copied nor interned.
  *
- * @param   pstring Ptr to string obj
+ * @param   pstring Ptr to string obj or string view
  * @param   pstart Ptr to int object of slice start index
  * @param   pend Ptr to int object of slice end index
  * @param   pstride Ptr to int object of slice stride value
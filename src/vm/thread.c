@@ -45,6 +45,166 @@ thread_new(pPmObj_t pframe, pPmObj_t *r_pobj)
     OBJ_SET_TYPE(pthread, OBJ_TYPE_THR);
     pthread->pframe = (pPmFrame_t)pframe;
     pthread->interpctrl = INTERP_CTRL_CONT;
+    pthread->next = C_NULL;
+    pthread->prev = C_NULL;
+    pthread->priority = PM_THREAD_PRIORITY_DEFAULT;
 
     return retval;
 }
+
+
+PmReturn_t
+thread_enqueue(pPmThread_t pthread)
+{
+    pPmThread_t phead;
+    uint8_t pri = pthread->priority;
+
+    C_ASSERT(pri < PM_THREAD_NUM_PRIORITIES);
+    C_ASSERT(pthread->next == C_NULL);
+
+    phead = gVmGlobal.threadQueue[pri];
+
+    /* The thread is alone in its queue */
+    if (phead == C_NULL)
+    {
+        pthread->next = pthread;
+        pthread->prev = pthread;
+        gVmGlobal.threadQueue[pri] = pthread;
+        gVmGlobal.threadReady |= (uint8_t)(1 << pri);
+    }
+
+    /* Insert before the head, which is the tail of the circular queue */
+    else
+    {
+        pthread->next = phead;
+        pthread->prev = phead->prev;
+        phead->prev->next = pthread;
+        phead->prev = pthread;
+    }
+    gVmGlobal.threadCount++;
+    return PM_RET_OK;
+}
+
+
+PmReturn_t
+thread_dequeue(pPmThread_t pthread)
+{
+    uint8_t pri = pthread->priority;
+
+    C_ASSERT(pthread->next != C_NULL);
+
+    /* Empty the queue if this is its only thread */
+    if (pthread->next == pthread)
+    {
+        gVmGlobal.threadQueue[pri] = C_NULL;
+        gVmGlobal.threadReady &= (uint8_t)~(1 << pri);
+    }
+
+    /* Otherwise unlink the thread, moving the head on if necessary */
+    else
+    {
+        pthread->prev->next = pthread->next;
+        pthread->next->prev = pthread->prev;
+        if (gVmGlobal.threadQueue[pri] == pthread)
+        {
+            gVmGlobal.threadQueue[pri] = pthread->next;
+        }
+    }
+    pthread->next = C_NULL;
+    pthread->prev = C_NULL;
+    gVmGlobal.threadCount--;
+    return PM_RET_OK;
+}
+
+
+pPmThread_t
+thread_getNext(void)
+{
+    pPmThread_t pthread;
+    uint8_t pri = PM_THREAD_NUM_PRIORITIES - 1;
+
+    if (gVmGlobal.threadReady == 0)
+    {
+        return C_NULL;
+    }
+
+    /* Find the highest priority that has a ready thread */
+    while ((gVmGlobal.threadReady & (uint8_t)(1 << pri)) == 0)
+    {
+        pri--;
+    }
+
+    /* Take the head and rotate the queue (round robin) */
+    pthread = gVmGlobal.threadQueue[pri];
+    gVmGlobal.threadQueue[pri] = pthread->next;
+    return pthread;
+}
+
+
+PmReturn_t
+thread_sleep(pPmThread_t pthread, uint32_t ms)
+{
+    PmReturn_t retval;
+    pPmThread_t pprev = C_NULL;
+    pPmThread_t pnext;
+    uint32_t now;
+
+    C_ASSERT(pthread->next == C_NULL);
+
+    retval = plat_getMsTicks(&now);
+    PM_RETURN_IF_ERROR(retval);
+    pthread->wakeMs = now + ms;
+
+    /* Insert after the sleepers that wake no later (wrap-safe compare) */
+    pnext = gVmGlobal.threadSleep;
+    while ((pnext != C_NULL)
+           && ((int32_t)(pnext->wakeMs - pthread->wakeMs) <= 0))
+    {
+        pprev = pnext;
+        pnext = pnext->next;
+    }
+    pthread->next = pnext;
+    if (pprev == C_NULL)
+    {
+        gVmGlobal.threadSleep = pthread;
+        gVmGlobal.threadWakeMs = pthread->wakeMs;
+    }
+    else
+    {
+        pprev->next = pthread;
+    }
+    return retval;
+}
+
+
+PmReturn_t
+thread_wakeUp(void)
+{
+    PmReturn_t retval = PM_RET_OK;
+    pPmThread_t pthread;
+    uint32_t now;
+
+    if (gVmGlobal.threadSleep == C_NULL)
+    {
+        return retval;
+    }
+
+    retval = plat_getMsTicks(&now);
+    PM_RETURN_IF_ERROR(retval);
+
+    /* Wake the threads from the front of the list until one is not due */
+    while (((pthread = gVmGlobal.threadSleep) != C_NULL)
+           && ((int32_t)(now - pthread->wakeMs) >= 0))
+    {
+        gVmGlobal.threadSleep = pthread->next;
+        pthread->next = C_NULL;
+        retval = thread_enqueue(pthread);
+        PM_RETURN_IF_ERROR(retval);
+    }
+
+    if (gVmGlobal.threadSleep != C_NULL)
+    {
+        gVmGlobal.threadWakeMs = gVmGlobal.threadSleep->wakeMs;
+    }
+    return retval;
+}
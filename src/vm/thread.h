@@ -24,6 +24,20 @@
  /** Frequency in Hz to switch threads */
 #define THREAD_RESCHEDULE_FREQUENCY    10
 
+/** Number of thread priorities; 0 is the lowest */
+#ifndef PM_THREAD_NUM_PRIORITIES
+#define PM_THREAD_NUM_PRIORITIES       4
+#endif
+
+/** Priority of threads that are started without one */
+#ifndef PM_THREAD_PRIORITY_DEFAULT
+#define PM_THREAD_PRIORITY_DEFAULT     1
+#endif
+
+#if PM_THREAD_NUM_PRIORITIES > 8
+#error PM_THREAD_NUM_PRIORITIES must not exceed 8
+#endif
+
 
 /**
  * Interpreter return values
@@ -65,6 +79,18 @@ typedef struct PmThread_s
      * A negative value signals an error exit.
      */
     PmInterpCtrl_t interpctrl;
+
+    /** next thread in the ready queue (circular) */
+    struct PmThread_s *next;
+
+    /** previous thread in the ready queue (circular) */
+    struct PmThread_s *prev;
+
+    /** scheduling priority; the higher, the sooner the thread runs */
+    uint8_t priority;
+
+    /** time (pm_timerMsTicks) at which a sleeping thread becomes ready */
+    uint32_t wakeMs;
 } PmThread_t,
  *pPmThread_t;
 
@@ -78,4 +104,50 @@ typedef struct PmThread_s
  */
 PmReturn_t thread_new(pPmObj_t pframe, pPmObj_t *r_pobj);
 
+/**
+ * Appends the thread to the ready queue of its priority.  O(1).
+ *
+ * @param pthread Thread that is in no ready queue.
+ * @return Return status
+ */
+PmReturn_t thread_enqueue(pPmThread_t pthread);
+
+/**
+ * Removes the thread from its ready queue.  O(1).
+ *
+ * @param pthread Thread that is in a ready queue.
+ * @return Return status
+ */
+PmReturn_t thread_dequeue(pPmThread_t pthread);
+
+/**
+ * Returns the thread to run next: the head of the highest priority
+ * ready queue, which is then rotated so that threads of equal priority
+ * take turns.  Lower priorities only run while no higher one is ready.
+ * O(1).
+ *
+ * @return Ptr to thread or C_NULL if no thread is ready.
+ */
+pPmThread_t thread_getNext(void);
+
+/**
+ * Puts a thread that is in no ready queue to sleep for the given time.
+ * Sleeping threads are kept in a list sorted by wake time, which is
+ * linked through the same fields as the ready queues.
+ * O(number of sleeping threads).
+ *
+ * @param pthread Thread that is in no ready queue.
+ * @param ms Milliseconds until the thread becomes ready.
+ * @return Return status
+ */
+PmReturn_t thread_sleep(pPmThread_t pthread, uint32_t ms);
+
+/**
+ * Moves the sleeping threads whose wake time has come to their ready queues.
+ * O(1) per thread woken.
+ *
+ * @return Return status
+ */
+PmReturn_t thread_wakeUp(void);
+
 #endif /* __THREAD_H__ */